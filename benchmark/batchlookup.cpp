@@ -0,0 +1,74 @@
+/*
+ * File: batchlookup.cpp
+ * ---------------------
+ * Lookup throughput on a table much larger than the caches: a loop of
+ * single find calls against getMany over chunks of the same probe keys
+ * (about half of them present), for both hash table engines.
+ * Usage: ./batchlookup [N] [probes] [chunk]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include "myhashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Policy>
+void probeMap(const char *name, int n, const MyVector<int> &probes, int chunk) {
+    MyHashMap<int, int, Policy> map(n);
+    for(int i = 0; i < n; ++i) {
+        map.put(i * 2, i);
+    }
+
+    long long singleSum = 0;
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < probes.size(); ++i) {
+        const int *vp = map.find(probes[i]);
+        if(vp != NULL) singleSum += *vp;
+    }
+    double single = seconds(start);
+
+    long long batchSum = 0;
+    MyVector<int> keys;
+    MyVector<int *> out;
+    start = chrono::steady_clock::now();
+    for(int base = 0; base < probes.size(); base += chunk) {
+        keys.clear();
+        for(int i = base; i < probes.size() && i < base + chunk; ++i) {
+            keys.add(probes[i]);
+        }
+        map.getMany(keys, out);
+        for(int i = 0; i < out.size(); ++i) {
+            if(out[i] != NULL) batchSum += *out[i];
+        }
+    }
+    double batch = seconds(start);
+
+    if(singleSum != batchSum) cout << "mismatch!" << endl;
+    cout << name << "  find loop " << probes.size() / single / 1e6 << " Mops/s  getMany "
+         << probes.size() / batch / 1e6 << " Mops/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1 << 23;
+    int nProbes = argc > 2 ? atoi(argv[2]) : 4000000;
+    int chunk = argc > 3 ? atoi(argv[3]) : 1024;
+    if(chunk < 1) chunk = 1;
+
+    MyVector<int> probes;
+    unsigned long long state = 88172645463325252ULL;
+    for(int i = 0; i < nProbes; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        probes.add(int(state % (unsigned long long)(2 * n)));
+    }
+
+    probeMap<MySeparateChaining>("map chained", n, probes, chunk);
+    probeMap<MyOpenAddressing>("map open   ", n, probes, chunk);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * File: bloomfilter.cpp
+ * ---------------------
+ * Mostly-negative lookups: containsKey on a large table where only a
+ * fraction of the probe keys are present, with and without the built-in
+ * Bloom filter, for both hash table engines and for a memory-mapped
+ * snapshot (where a miss walks records scattered across the file).
+ * Also compares the query throughput and measured false positive rate
+ * of the classic and the blocked Bloom filter on their own.
+ * Usage: ./bloomfilter [N] [probes] [hitPercent]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "myhashmap.h"
+#include "mybloomfilter.h"
+#include "mymappedhashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Policy>
+void probeMap(const char *name, int n, const MyVector<long long> &probes, bool filtered) {
+    MyHashMap<long long, long long, Policy> map(n);
+    for(int i = 0; i < n; ++i) {
+        map.put((long long)i * 2, i);
+    }
+    if(filtered) map.enableBloomFilter(0.01);
+
+    long long found = 0;
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < probes.size(); ++i) {
+        found += map.containsKey(probes[i]);
+    }
+    double elapsed = seconds(start);
+    cout << name << (filtered ? " + bloom " : "         ") << probes.size() / elapsed / 1e6 << " Mops/s  (found "
+         << found << ", " << map.stats().allocatedBytes / (1 << 20) << " MB)" << endl;
+}
+
+void probeSnapshot(const MyVector<long long> &probes, bool filtered) {
+    MyMappedHashMap<long long, long long> mapped("bloomfilter.snap");
+    if(filtered) mapped.enableBloomFilter(0.01);
+
+    long long found = 0;
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < probes.size(); ++i) {
+        found += mapped.containsKey(probes[i]);
+    }
+    double elapsed = seconds(start);
+    cout << "mapped " << (filtered ? " + bloom " : "         ") << probes.size() / elapsed / 1e6 << " Mops/s  (found "
+         << found << ")" << endl;
+}
+
+template <typename Filter>
+void probeFilter(const char *name, Filter &filter, int n, const MyVector<long long> &probes) {
+    for(int i = 0; i < n; ++i) {
+        filter.add((long long)i * 2);
+    }
+    long long positives = 0, negatives = 0;
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < probes.size(); ++i) {
+        positives += filter.mightContain(probes[i]);
+    }
+    double elapsed = seconds(start);
+    for(int i = 0; i < probes.size(); ++i) {
+        negatives += (probes[i] % 2 != 0 || probes[i] >= 2LL * n);
+    }
+    long long truePositives = probes.size() - negatives;
+    cout << name << probes.size() / elapsed / 1e6 << " Mops/s  false positive rate "
+         << double(positives - truePositives) / negatives << "  " << filter.memoryBytes() / 1024 << " KB" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1 << 22;
+    int nProbes = argc > 2 ? atoi(argv[2]) : 4000000;
+    int hitPercent = argc > 3 ? atoi(argv[3]) : 5;
+
+    MyVector<long long> probes;
+    srand(12345);
+    for(int i = 0; i < nProbes; ++i) {
+        long long r = rand() % n;
+        probes.add(rand() % 100 < hitPercent ? r * 2 : r * 2 + 1);
+    }
+    cout << n << " keys, " << nProbes << " probes, " << hitPercent << "% present" << endl;
+
+    probeMap<MySeparateChaining>("chained", n, probes, false);
+    probeMap<MySeparateChaining>("chained", n, probes, true);
+    probeMap<MyOpenAddressing>("flat   ", n, probes, false);
+    probeMap<MyOpenAddressing>("flat   ", n, probes, true);
+
+    MyHashMap<long long, long long> source(n);
+    for(int i = 0; i < n; ++i) {
+        source.put((long long)i * 2, i);
+    }
+    source.saveSnapshot("bloomfilter.snap");
+    source.clear();
+    probeSnapshot(probes, false);
+    probeSnapshot(probes, true);
+    remove("bloomfilter.snap");
+
+    MyBloomFilter<long long> plain(n, 0.01);
+    MyBlockedBloomFilter<long long> blocked(n, 0.01);
+    probeFilter("MyBloomFilter        ", plain, n, probes);
+    probeFilter("MyBlockedBloomFilter ", blocked, n, probes);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * File: bulkload.cpp
+ * ------------------
+ * Time to load N distinct keys into an empty container: one put at a time
+ * (growing through repeated rehashes), reserve(N) followed by puts, and
+ * putAll/addAll, which size the table once. Usage: ./bulkload [N]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include "myhashmap.h"
+#include "myhashset.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Policy>
+void loadMap(const char *name, const MyVector<pair<int, int>> &pairs) {
+    int n = pairs.size();
+    double grow, reserved, bulk;
+    {
+        auto start = chrono::steady_clock::now();
+        MyHashMap<int, int, Policy> map;
+        for(int i = 0; i < n; ++i) map.put(pairs[i].first, pairs[i].second);
+        grow = seconds(start);
+    }
+    {
+        auto start = chrono::steady_clock::now();
+        MyHashMap<int, int, Policy> map;
+        map.reserve(n);
+        for(int i = 0; i < n; ++i) map.put(pairs[i].first, pairs[i].second);
+        reserved = seconds(start);
+    }
+    {
+        auto start = chrono::steady_clock::now();
+        MyHashMap<int, int, Policy> map;
+        map.putAll(pairs);
+        bulk = seconds(start);
+    }
+    cout << name << "  put " << grow * 1e3 << " ms  reserve+put " << reserved * 1e3
+         << " ms  putAll " << bulk * 1e3 << " ms" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 2000000;
+
+    MyVector<pair<int, int>> pairs;
+    MyVector<string> words;
+    for(int i = 0; i < n; ++i) {
+        pairs.add(make_pair(i * 2654435761u % 2147483647u, i));
+        words.add("https://example.com/item/" + to_string(i));
+    }
+
+    loadMap<MySeparateChaining>("map chained", pairs);
+    loadMap<MyOpenAddressing>("map open   ", pairs);
+
+    double grow, bulk;
+    {
+        auto start = chrono::steady_clock::now();
+        MyHashSet<string> set;
+        for(int i = 0; i < n; ++i) set.add(words[i]);
+        grow = seconds(start);
+    }
+    {
+        auto start = chrono::steady_clock::now();
+        MyHashSet<string> set;
+        set.addAll(words);
+        bulk = seconds(start);
+    }
+    cout << "set string   add " << grow * 1e3 << " ms  addAll " << bulk * 1e3 << " ms" << endl;
+    return 0;
+}
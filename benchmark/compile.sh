@@ -0,0 +1,16 @@
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../concurrentvector/ -o concurrentvector concurrentvector.cpp
+g++ -std=c++11 -O2 -I ../vector/ -I ../pool/ -I ../hashmap/ -o flathashmap flathashmap.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -I ../vector/ -I ../pool/ -I ../hashmap/ -o hashcode hashcode.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -I ../hashmap/ -o stringhash stringhash.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -I ../vector/ -I ../pool/ -I ../hashmap/ -o rehashlatency rehashlatency.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -I ../vector/ -I ../pool/ -I ../hashmap/ -I ../map/ -o nodepool nodepool.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -I ../vector/ -I ../pool/ -I ../hashmap/ -I ../hashset/ -o bulkload bulkload.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -I ../concurrenthashmap/ -o concurrenthashmap concurrenthashmap.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -o parallelbuild parallelbuild.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -I ../vector/ -I ../pool/ -I ../hashmap/ -o batchlookup batchlookup.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -o snapshot snapshot.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -I ../cache/ -o lrucache lrucache.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -I ../cache/ -o ttlcache ttlcache.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -o bloomfilter bloomfilter.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -o multimap multimap.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -O2 -pthread -I ../vector/ -I ../pool/ -I ../hashmap/ -o persistenthashmap persistenthashmap.cpp ../hashmap/myhashcode.cpp
@@ -0,0 +1,72 @@
+/*
+ * File: concurrenthashmap.cpp
+ * ---------------------------
+ * Mixed workload scaling benchmark: every thread performs its share of a
+ * fixed number of operations on random keys, 90% get and 10% put, first
+ * against a MyHashMap guarded by one mutex and then against a
+ * MyConcurrentHashMap. Both maps are filled with every key beforehand.
+ * Usage: ./concurrenthashmap [maxThreads] [totalOps] [nKeys]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "myhashmap.h"
+#include "myconcurrenthashmap.h"
+using namespace std;
+
+/* fn(key, isWrite) is called totalOps / nThreads times by every thread */
+template <typename Fn>
+double runMixed(int nThreads, int totalOps, int nKeys, Fn fn) {
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for(int t = 0; t < nThreads; ++t) {
+        workers.push_back(thread([=]() {
+            unsigned long long state = 0x9e3779b97f4a7c15ULL * (t + 1);
+            for(int i = t; i < totalOps; i += nThreads) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                fn(int((state >> 33) % (unsigned long long)nKeys), (state >> 20) % 10 == 0);
+            }
+        }));
+    }
+    for(int t = 0; t < nThreads; ++t) {
+        workers[t].join();
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : int(thread::hardware_concurrency());
+    int totalOps = argc > 2 ? atoi(argv[2]) : 10000000;
+    int nKeys = argc > 3 ? atoi(argv[3]) : 100000;
+    if(maxThreads < 1) maxThreads = 1;
+    if(nKeys < 1) nKeys = 1;
+
+    cout << "threads  mutex+MyHashMap(Mops/s)  MyConcurrentHashMap(Mops/s)" << endl;
+    for(int n = 1; ; n = (n * 2 < maxThreads) ? n * 2 : maxThreads) {
+        MyHashMap<int, int> locked(nKeys);
+        MyConcurrentHashMap<int, int> concurrent(nKeys);
+        for(int k = 0; k < nKeys; ++k) {
+            locked.put(k, k);
+            concurrent.put(k, k);
+        }
+
+        mutex lock;
+        double lockedTime = runMixed(n, totalOps, nKeys, [&](int key, bool isWrite) {
+            lock_guard<mutex> guard(lock);
+            if(isWrite) locked.put(key, key + 1);
+            else locked.get(key);
+        });
+
+        double concurrentTime = runMixed(n, totalOps, nKeys, [&](int key, bool isWrite) {
+            if(isWrite) concurrent.put(key, key + 1);
+            else concurrent.get(key);
+        });
+
+        cout << n << "  " << totalOps / lockedTime / 1e6 << "  " << totalOps / concurrentTime / 1e6 << endl;
+        if(n == maxThreads) break;
+    }
+    return 0;
+}
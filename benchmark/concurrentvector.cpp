@@ -0,0 +1,58 @@
+/*
+ * File: concurrentvector.cpp
+ * --------------------------
+ * Producer scaling benchmark: every thread appends its share of a fixed
+ * number of elements, first into a MyVector guarded by one mutex and then
+ * into a MyConcurrentVector. Usage: ./concurrentvector [maxThreads] [total]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "myvector.h"
+#include "myconcurrentvector.h"
+using namespace std;
+
+template <typename Fn>
+double runProducers(int nThreads, int total, Fn fn) {
+    vector<thread> producers;
+    auto start = chrono::steady_clock::now();
+    for(int t = 0; t < nThreads; ++t) {
+        producers.push_back(thread([=]() {
+            for(int i = t; i < total; i += nThreads) {
+                fn(i);
+            }
+        }));
+    }
+    for(int t = 0; t < nThreads; ++t) {
+        producers[t].join();
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : int(thread::hardware_concurrency());
+    int total = argc > 2 ? atoi(argv[2]) : 10000000;
+    if(maxThreads < 1) maxThreads = 1;
+
+    cout << "threads  mutex+MyVector(Mops/s)  MyConcurrentVector(Mops/s)" << endl;
+    for(int n = 1; ; n = (n * 2 < maxThreads) ? n * 2 : maxThreads) {
+        MyVector<int> locked;
+        mutex lock;
+        double lockedTime = runProducers(n, total, [&](int i) {
+            lock_guard<mutex> guard(lock);
+            locked.add(i);
+        });
+
+        MyConcurrentVector<int> concurrent;
+        double concurrentTime = runProducers(n, total, [&](int i) {
+            concurrent.add(i);
+        });
+
+        cout << n << "  " << total / lockedTime / 1e6 << "  " << total / concurrentTime / 1e6 << endl;
+        if(n == maxThreads) break;
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * File: flathashmap.cpp
+ * ---------------------
+ * Compares the two MyHashMap policies on integer and string keys:
+ * inserting N keys, looking up every key (hits), looking up N absent
+ * keys (misses) and removing every key. Usage: ./flathashmap [N]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "myhashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Policy, typename KeyType>
+void run(const char *name, const MyVector<KeyType> &present, const MyVector<KeyType> &absent) {
+    int n = present.size();
+    MyHashMap<KeyType, int, Policy> map;
+    long long found = 0;
+
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i) map.put(present[i], i);
+    double insertTime = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i) found += map.containsKey(present[i]);
+    double hitTime = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i) found += map.containsKey(absent[i]);
+    double missTime = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i) map.remove(present[i]);
+    double removeTime = seconds(start);
+
+    cout << name << "  insert " << n / insertTime / 1e6 << "  hit " << n / hitTime / 1e6
+         << "  miss " << n / missTime / 1e6 << "  remove " << n / removeTime / 1e6
+         << "  (Mops/s, found=" << found << ")" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    MyVector<int> intKeys, intMisses;
+    MyVector<string> stringKeys, stringMisses;
+    for(int i = 0; i < n; ++i) {
+        intKeys.add(i * 2);
+        intMisses.add(i * 2 + 1);
+        stringKeys.add("https://example.com/item/" + to_string(i * 2));
+        stringMisses.add("https://example.com/item/" + to_string(i * 2 + 1));
+    }
+
+    run<MySeparateChaining>("int     chained", intKeys, intMisses);
+    run<MyOpenAddressing>("int     open   ", intKeys, intMisses);
+    run<MySeparateChaining>("string  chained", stringKeys, stringMisses);
+    run<MyOpenAddressing>("string  open   ", stringKeys, stringMisses);
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * File: hashcode.cpp
+ * ------------------
+ * Measures hashCode on integer and string keys against the ostringstream
+ * fallback, and the effect on MyHashMap lookups with integer keys: the same
+ * keys are looked up once through the old stream hash and once through MyHash.
+ * Usage: ./hashcode [N]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "myhashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/* The pre-MyHash behaviour: stringify through a stream, then hash the bytes. */
+template <typename T>
+struct StreamHash {
+    int operator()(const T &key) const {
+        ostringstream os;
+        os << key;
+        return myhashCode(os.str());
+    }
+};
+
+/* An int key without a MyHash specialization, so hashCode takes the stream fallback as every key once did. */
+struct StreamKey {
+    int v;
+    bool operator==(const StreamKey &k) const { return v == k.v; }
+    bool operator!=(const StreamKey &k) const { return v != k.v; }
+};
+
+ostream & operator<<(ostream &os, const StreamKey &k) {
+    return os << k.v;
+}
+
+template <typename T, typename Hash>
+double timeHash(const MyVector<T> &keys, long long &sink) {
+    Hash hash;
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < keys.size(); ++i) sink += hash(keys[i]);
+    return keys.size() / seconds(start) / 1e6;
+}
+
+template <typename Key>
+double timeLookups(const MyVector<Key> &keys, long long &sink) {
+    MyHashMap<Key, int> map;
+    for(int i = 0; i < keys.size(); ++i) map.put(keys[i], i);
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < keys.size(); ++i) sink += map.containsKey(keys[i]);
+    return keys.size() / seconds(start) / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 2000000;
+    long long sink = 0;
+
+    MyVector<int> ints;
+    MyVector<StreamKey> streamInts;
+    MyVector<string> strings;
+    for(int i = 0; i < n; ++i) {
+        ints.add(i);
+        streamInts.add(StreamKey{i});
+        strings.add("https://example.com/user/" + to_string(i) + "/profile");
+    }
+
+    cout << "int     stream " << timeHash<int, StreamHash<int> >(ints, sink)
+         << "  MyHash " << timeHash<int, MyHash<int> >(ints, sink) << "  (Mhash/s)" << endl;
+    cout << "string  stream " << timeHash<string, StreamHash<string> >(strings, sink)
+         << "  MyHash " << timeHash<string, MyHash<string> >(strings, sink) << "  (Mhash/s)" << endl;
+
+    cout << "map lookup  stream " << timeLookups(streamInts, sink)
+         << "  MyHash " << timeLookups(ints, sink) << "  (Mops/s)" << endl;
+    cout << "(checksum " << sink << ")" << endl;
+    return 0;
+}
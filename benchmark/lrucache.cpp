@@ -0,0 +1,85 @@
+/*
+ * File: lrucache.cpp
+ * ------------------
+ * A hit/miss workload over an LRU cache: the usual hand-rolled
+ * MyHashMap<K, list iterator> plus std::list (a lookup and a splice per
+ * hit, two allocations and two erasures per miss) against MyLRUCache,
+ * whose list links live in the hash cells.
+ * Usage: ./lrucache [capacity] [operations] [keySpace]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <utility>
+#include "myhashmap.h"
+#include "mylrucache.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/* The two-structure cache this benchmark replaces */
+class HandRolledLRU {
+public:
+    explicit HandRolledLRU(int capacity) : capacity(capacity) {}
+
+    bool get(int key, int &out) {
+        list<pair<int, int>>::iterator *it = index.find(key);
+        if(it == NULL) return false;
+        order.splice(order.begin(), order, *it);
+        out = (*it)->second;
+        return true;
+    }
+
+    void put(int key, int value) {
+        order.push_front(make_pair(key, value));
+        index.put(key, order.begin());
+        if(int(order.size()) > capacity) {
+            index.remove(order.back().first);
+            order.pop_back();
+        }
+    }
+
+private:
+    int capacity;
+    list<pair<int, int>> order;
+    MyHashMap<int, list<pair<int, int>>::iterator> index;
+};
+
+int main(int argc, char *argv[]) {
+    int capacity = argc > 1 ? atoi(argv[1]) : 100000;
+    int nOps = argc > 2 ? atoi(argv[2]) : 5000000;
+    int keySpace = argc > 3 ? atoi(argv[3]) : 4 * capacity;
+
+    MyVector<int> keys;
+    for(int i = 0; i < nOps; ++i) {
+        // Skewed: half of the accesses go to the first eighth of the key space.
+        keys.add(rand() % 2 ? rand() % (keySpace / 8) : rand() % keySpace);
+    }
+
+    long long handSum = 0, cacheSum = 0;
+    HandRolledLRU hand(capacity);
+    auto start = chrono::steady_clock::now();
+    for(int i = 0; i < nOps; ++i) {
+        int value;
+        if(hand.get(keys[i], value)) handSum += value;
+        else hand.put(keys[i], keys[i]);
+    }
+    double handTime = seconds(start);
+
+    MyLRUCache<int, int> cache(capacity);
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < nOps; ++i) {
+        int value;
+        if(cache.tryGet(keys[i], value)) cacheSum += value;
+        else cache.put(keys[i], keys[i]);
+    }
+    double cacheTime = seconds(start);
+
+    if(handSum != cacheSum) cout << "mismatch!" << endl;
+    cout << "MyHashMap + std::list " << nOps / handTime / 1e6 << " Mops/s, MyLRUCache "
+         << nOps / cacheTime / 1e6 << " Mops/s" << endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * File: multimap.cpp
+ * ------------------
+ * A secondary index where most keys have a single value: the old
+ * MyHashMap<int, MyVector<int>> emulation against MyHashMultiMap, timing
+ * the build, lookups through getAll and removeAll, and counting how many
+ * value arrays each one allocates.
+ * Usage: ./multimap [values]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "myhashmap.h"
+#include "myhashmultimap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    int nValues = argc > 1 ? atoi(argv[1]) : 2000000;
+    // About 80% of the keys get one value, the rest get up to 20.
+    MyVector<int> keyOf;
+    for(int key = 0; keyOf.size() < nValues; ++key) {
+        int fanOut = (rand() % 5 == 0) ? 2 + rand() % 19 : 1;
+        for(int j = 0; j < fanOut && keyOf.size() < nValues; ++j) {
+            keyOf.add(key);
+        }
+    }
+    int nKeys = keyOf[nValues - 1] + 1;
+
+    auto start = chrono::steady_clock::now();
+    MyHashMap<int, MyVector<int>> emulated;
+    for(int i = 0; i < nValues; ++i) {
+        emulated[keyOf[i]].add(i);
+    }
+    double emulatedBuild = seconds(start);
+    start = chrono::steady_clock::now();
+    MyHashMultiMap<int, int> native;
+    for(int i = 0; i < nValues; ++i) {
+        native.add(keyOf[i], i);
+    }
+    double nativeBuild = seconds(start);
+
+    long long emulatedSum = 0, nativeSum = 0;
+    start = chrono::steady_clock::now();
+    for(int key = 0; key < nKeys; ++key) {
+        const MyVector<int> *values = emulated.find(key);
+        for(int v : *values) emulatedSum += v;
+    }
+    double emulatedLookup = seconds(start);
+    start = chrono::steady_clock::now();
+    for(int key = 0; key < nKeys; ++key) {
+        for(int v : native.getAll(key)) nativeSum += v;
+    }
+    double nativeLookup = seconds(start);
+
+    long long emulatedArrays = emulated.size(), emulatedBytes = 0, nativeArrays = 0, nativeBytes = 0;
+    for(MyHashMap<int, MyVector<int>>::const_iterator it = emulated.begin(); it != emulated.end(); ++it) {
+        emulatedBytes += it.value().getCapacity() * sizeof(int);
+    }
+    for(int key = 0; key < nKeys; ++key) {
+        int n = native.count(key);
+        if(n > MyHashMultiMap<int, int>::INLINE_VALUES) {
+            nativeArrays++;
+            int capacity = MyHashMultiMap<int, int>::INLINE_VALUES;
+            while(capacity < n) capacity *= 2;
+            nativeBytes += capacity * sizeof(int);
+        }
+    }
+
+    start = chrono::steady_clock::now();
+    for(int key = 0; key < nKeys; key += 2) {
+        emulated.remove(key);
+    }
+    double emulatedRemove = seconds(start);
+    start = chrono::steady_clock::now();
+    for(int key = 0; key < nKeys; key += 2) {
+        native.removeAll(key);
+    }
+    double nativeRemove = seconds(start);
+
+    cout << nValues << " values under " << nKeys << " keys" << endl;
+    cout << "MyHashMap<int, MyVector<int>>: build " << emulatedBuild << " s, getAll " << emulatedLookup
+         << " s, removeAll " << emulatedRemove << " s, " << emulatedArrays << " value arrays (~"
+         << emulatedBytes / 1048576 << " MB)" << endl;
+    cout << "MyHashMultiMap<int, int>:      build " << nativeBuild << " s, getAll " << nativeLookup
+         << " s, removeAll " << nativeRemove << " s, " << nativeArrays << " value arrays (~"
+         << nativeBytes / 1048576 << " MB)" << endl;
+    if(emulatedSum != nativeSum) cout << "checksum mismatch" << endl;
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * File: nodepool.cpp
+ * ------------------
+ * Node churn with and without MyNodePool, followed by the container
+ * workloads that now sit on top of it: MyHashMap and MyMap repeatedly
+ * filled with N keys, half of them removed and re-added, then cleared.
+ * Usage: ./nodepool [N] [ROUNDS]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "myhashmap.h"
+#include "mymap.h"
+#include "mynodepool.h"
+using namespace std;
+
+struct Node {
+    string key;
+    int value;
+    Node *link;
+};
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char *name, long long ops, double time) {
+    cout << name << "  " << ops / time / 1e6 << " Mops/s" << endl;
+}
+
+template <typename Map>
+void churn(const char *name, int n, int rounds) {
+    Map map;
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r) {
+        for(int i = 0; i < n; ++i) map[(i * 7919) % n] = i;
+        for(int i = 0; i < n; i += 2) map.remove(i);
+        for(int i = 0; i < n; i += 2) map[i] = i;
+        map.clear();
+    }
+    report(name, 2LL * n * rounds, seconds(start));
+    MyPoolStats s = map.poolStats();
+    cout << "    pool after clear: chunks " << s.chunks << ", nodes " << s.capacity
+         << ", live " << s.live << ", " << s.bytesReserved / 1024 << " KiB" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 200000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 10;
+    vector<Node *> nodes(n);
+
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r) {
+        for(int i = 0; i < n; ++i) nodes[i] = new Node();
+        for(int i = 0; i < n; ++i) delete nodes[i];
+    }
+    report("new/delete          ", 1LL * n * rounds, seconds(start));
+
+    MyNodePool<Node> pool;
+    start = chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r) {
+        for(int i = 0; i < n; ++i) nodes[i] = pool.create();
+        for(int i = 0; i < n; ++i) nodes[i]->~Node();
+        pool.releaseAll();
+    }
+    report("MyNodePool          ", 1LL * n * rounds, seconds(start));
+
+    churn<MyHashMap<int, int> >("MyHashMap churn     ", n, rounds);
+    churn<MyMap<int, int> >("MyMap churn         ", n, rounds);
+    return 0;
+}
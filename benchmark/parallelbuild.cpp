@@ -0,0 +1,50 @@
+/*
+ * File: parallelbuild.cpp
+ * -----------------------
+ * Time to build a MyHashMap from N pairs with putAll (one thread) and
+ * with buildParallel, doubling the thread count up to maxThreads, for
+ * both hash table engines. Usage: ./parallelbuild [N] [maxThreads]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include "myhashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Policy>
+void buildMap(const char *name, const MyVector<pair<int, int>> &pairs, int maxThreads) {
+    {
+        auto start = chrono::steady_clock::now();
+        MyHashMap<int, int, Policy> map;
+        map.putAll(pairs);
+        cout << name << "  putAll " << seconds(start) * 1e3 << " ms" << endl;
+    }
+    for(int n = 1; ; n = (n * 2 < maxThreads) ? n * 2 : maxThreads) {
+        auto start = chrono::steady_clock::now();
+        MyHashMap<int, int, Policy> map;
+        map.buildParallel(pairs, n);
+        cout << name << "  buildParallel(" << n << ") " << seconds(start) * 1e3 << " ms" << endl;
+        if(n == maxThreads) break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 4000000;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : int(thread::hardware_concurrency());
+    if(maxThreads < 1) maxThreads = 1;
+
+    MyVector<pair<int, int>> pairs;
+    for(int i = 0; i < n; ++i) {
+        pairs.add(make_pair(i * 2654435761u % 2147483647u, i));
+    }
+
+    buildMap<MySeparateChaining>("map chained", pairs, maxThreads);
+    buildMap<MyOpenAddressing>("map open   ", pairs, maxThreads);
+    return 0;
+}
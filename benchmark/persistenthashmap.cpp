@@ -0,0 +1,93 @@
+/*
+ * File: persistenthashmap.cpp
+ * ---------------------------
+ * Per-request isolation of a shared config map: every request copies the
+ * map, overrides a few keys and reads some others. MyHashMap's deep copy
+ * against MyPersistentHashMap's O(1) copy plus path copying, followed by
+ * plain put/get throughput of both.
+ * Usage: ./persistenthashmap [entries] [requests]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "myhashmap.h"
+#include "mypersistenthashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    int nEntries = argc > 1 ? atoi(argv[1]) : 2000;
+    int nRequests = argc > 2 ? atoi(argv[2]) : 20000;
+    const int OVERRIDES = 3, READS = 20;
+    MyVector<string> names;
+    for(int i = 0; i < nEntries; ++i) {
+        names.add("service.option." + to_string(i));
+    }
+    MyHashMap<string, string> config;
+    for(int i = 0; i < nEntries; ++i) {
+        config.put(names[i], "value" + to_string(i));
+    }
+    MyPersistentHashMap<string, string> shared(config);
+
+    long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < nRequests; ++r) {
+        MyHashMap<string, string> local = config;
+        for(int i = 0; i < OVERRIDES; ++i) {
+            local.put(names[(r + i * 7) % nEntries], "override");
+        }
+        for(int i = 0; i < READS; ++i) {
+            checksum += local.find(names[(r * 31 + i) % nEntries])->size();
+        }
+    }
+    double deepCopy = seconds(start);
+    start = chrono::steady_clock::now();
+    for(int r = 0; r < nRequests; ++r) {
+        MyPersistentHashMap<string, string> local = shared;
+        for(int i = 0; i < OVERRIDES; ++i) {
+            local.put(names[(r + i * 7) % nEntries], "override");
+        }
+        for(int i = 0; i < READS; ++i) {
+            checksum -= local.find(names[(r * 31 + i) % nEntries])->size();
+        }
+    }
+    double persistent = seconds(start);
+
+    cout << nRequests << " requests on a " << nEntries << "-entry config, " << OVERRIDES << " overrides and "
+         << READS << " reads each" << endl;
+    cout << "MyHashMap copy:           " << deepCopy << " s (" << deepCopy / nRequests * 1e6 << " us per request)" << endl;
+    cout << "MyPersistentHashMap copy: " << persistent << " s (" << persistent / nRequests * 1e6 << " us per request)" << endl;
+
+    // Plain throughput: unshared maps mutate in place, so the trie is the only difference.
+    int n = 1000000;
+    start = chrono::steady_clock::now();
+    MyHashMap<int, int> hashmap;
+    for(int i = 0; i < n; ++i) {
+        hashmap.put(i, i);
+    }
+    double hashPut = seconds(start);
+    start = chrono::steady_clock::now();
+    MyPersistentHashMap<int, int> trie;
+    for(int i = 0; i < n; ++i) {
+        trie.put(i, i);
+    }
+    double triePut = seconds(start);
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i) {
+        checksum += *hashmap.find(i);
+    }
+    double hashGet = seconds(start);
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < n; ++i) {
+        checksum -= *trie.find(i);
+    }
+    double trieGet = seconds(start);
+    cout << n << " int keys: MyHashMap put " << hashPut << " s, find " << hashGet
+         << " s; MyPersistentHashMap put " << triePut << " s, find " << trieGet << " s" << endl;
+    if(checksum != 0) cout << "checksum mismatch" << endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * File: rehashlatency.cpp
+ * -----------------------
+ * Measures the latency of every single put while a MyHashMap grows from
+ * empty to N entries, once with the default all-at-once rehashing and once
+ * with incremental rehashing. The mean is nearly the same; the interesting
+ * numbers are the tail percentiles and the maximum, which are dominated by
+ * the put that triggers a full rehash. Usage: ./rehashlatency [N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "myhashmap.h"
+using namespace std;
+
+static void report(const char *name, vector<double> &nanos) {
+    double total = 0;
+    for(size_t i = 0; i < nanos.size(); ++i) total += nanos[i];
+    sort(nanos.begin(), nanos.end());
+    size_t n = nanos.size();
+    cout << name << "  mean " << total / n << "  p50 " << nanos[n / 2]
+         << "  p99 " << nanos[n * 99 / 100] << "  p999 " << nanos[n * 999 / 1000]
+         << "  max " << nanos[n - 1] << "  (ns per put)" << endl;
+}
+
+template <typename KeyType>
+void run(const char *name, const MyVector<KeyType> &keys, bool incremental) {
+    MyHashMap<KeyType, int> map;
+    map.setIncrementalRehash(incremental);
+    vector<double> nanos(keys.size());
+    for(int i = 0; i < keys.size(); ++i) {
+        auto start = chrono::steady_clock::now();
+        map.put(keys[i], i);
+        nanos[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    }
+    report(name, nanos);
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    MyVector<int> intKeys;
+    MyVector<string> stringKeys;
+    for(int i = 0; i < n; ++i) {
+        intKeys.add(i);
+        stringKeys.add("https://example.com/item/" + to_string(i));
+    }
+
+    run("int     all-at-once", intKeys, false);
+    run("int     incremental", intKeys, true);
+    run("string  all-at-once", stringKeys, false);
+    run("string  incremental", stringKeys, true);
+    return 0;
+}
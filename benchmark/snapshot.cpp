@@ -0,0 +1,64 @@
+/*
+ * File: snapshot.cpp
+ * ------------------
+ * Startup cost of a large string map: rebuilding it with put from text
+ * against opening a saved snapshot with MyMappedHashMap, followed by the
+ * same random lookups on both.
+ * Usage: ./snapshot [N] [probes] [path]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "myhashmap.h"
+#include "mymappedhashmap.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 2000000;
+    int nProbes = argc > 2 ? atoi(argv[2]) : 1000000;
+    string path = argc > 3 ? argv[3] : "snapshot.snap";
+
+    auto start = chrono::steady_clock::now();
+    MyHashMap<string, string> map(n);
+    for(int i = 0; i < n; ++i) {
+        map.put("user:" + to_string(i), "profile-" + to_string(i * 7));
+    }
+    double build = seconds(start);
+
+    start = chrono::steady_clock::now();
+    map.saveSnapshot(path);
+    double save = seconds(start);
+
+    start = chrono::steady_clock::now();
+    MyMappedHashMap<string, string> mapped(path);
+    double open = seconds(start);
+
+    MyVector<string> probes;
+    for(int i = 0; i < nProbes; ++i) {
+        probes.add("user:" + to_string(rand() % (2 * n)));
+    }
+    size_t heapSum = 0, mappedSum = 0;
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < nProbes; ++i) {
+        heapSum += map.get(probes[i]).size();
+    }
+    double heapLookup = seconds(start);
+    start = chrono::steady_clock::now();
+    for(int i = 0; i < nProbes; ++i) {
+        mappedSum += mapped.get(probes[i]).size();
+    }
+    double mappedLookup = seconds(start);
+
+    if(heapSum != mappedSum) cout << "mismatch!" << endl;
+    cout << "rebuild with put " << build << " s, saveSnapshot " << save << " s, open mapped " << open * 1e3 << " ms" << endl;
+    cout << "get: MyHashMap " << nProbes / heapLookup / 1e6 << " Mops/s, MyMappedHashMap "
+         << nProbes / mappedLookup / 1e6 << " Mops/s" << endl;
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * File: stringhash.cpp
+ * --------------------
+ * Compares the previous byte-at-a-time djb2 string hash with myhashCode
+ * on a synthetic set of URL keys:
+ *   - throughput for several key lengths,
+ *   - collisions of the full hash and of its low 32 bits,
+ *   - how evenly the low bits spread the keys over a power-of-two number
+ *     of buckets (chi-square / degrees of freedom, ideally close to 1).
+ * Usage: ./stringhash [N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "myhashcode.h"
+using namespace std;
+
+static unsigned long long djb2(const string &str) {
+    unsigned hash = 5381;
+    for(size_t i = 0; i < str.length(); ++i) {
+        hash = 33 * hash + str[i];
+    }
+    return hash % (unsigned(-1) >> 1);
+}
+
+static unsigned long long wyhashLike(const string &str) {
+    return myhashCode(str);
+}
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void throughput(const char *name, unsigned long long (*hash)(const string &)) {
+    cout << name;
+    unsigned long long sink = 0;
+    const size_t lengths[] = {8, 32, 128, 1024};
+    for(size_t length : lengths) {
+        string key(length, 'a');
+        long long bytes = 0;
+        auto start = chrono::steady_clock::now();
+        while(bytes < 200000000LL) {
+            key[0]++;
+            sink += hash(key);
+            bytes += length;
+        }
+        cout << "  len " << length << ": " << bytes / seconds(start) / 1e9 << " GB/s";
+    }
+    cout << "  (" << (sink & 1) << ")" << endl;
+}
+
+static void quality(const char *name, unsigned long long (*hash)(const string &), const vector<string> &keys) {
+    vector<unsigned long long> full, low32;
+    const int bucketBits = 16;
+    vector<int> buckets(1 << bucketBits, 0);
+    for(size_t i = 0; i < keys.size(); ++i) {
+        unsigned long long h = hash(keys[i]);
+        full.push_back(h);
+        low32.push_back(h & 0xFFFFFFFFULL);
+        buckets[h & ((1 << bucketBits) - 1)]++;
+    }
+    sort(full.begin(), full.end());
+    sort(low32.begin(), low32.end());
+    long long fullCollisions = full.size() - (unique(full.begin(), full.end()) - full.begin());
+    long long lowCollisions = low32.size() - (unique(low32.begin(), low32.end()) - low32.begin());
+
+    double expected = double(keys.size()) / buckets.size(), chi = 0;
+    int maxLoad = 0;
+    for(size_t i = 0; i < buckets.size(); ++i) {
+        chi += (buckets[i] - expected) * (buckets[i] - expected) / expected;
+        maxLoad = max(maxLoad, buckets[i]);
+    }
+    cout << name << "  64-bit collisions " << fullCollisions << "  32-bit collisions " << lowCollisions
+         << "  chi2/df " << chi / (buckets.size() - 1) << "  max bucket " << maxLoad << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    vector<string> urls;
+    const char *paths[] = {"/user/", "/item/", "/search?q=", "/api/v1/orders/"};
+    for(int i = 0; i < n; ++i) {
+        urls.push_back("https://www.example.com" + string(paths[i % 4]) + to_string(i / 4));
+    }
+
+    throughput("djb2    ", djb2);
+    throughput("myhash  ", wyhashLike);
+    double expected = double(n) * (n - 1) / 2 / 4294967296.0;
+    cout << "URL keys: " << n << ", expected random 32-bit collisions ~" << expected << endl;
+    quality("djb2    ", djb2, urls);
+    quality("myhash  ", wyhashLike, urls);
+    return 0;
+}
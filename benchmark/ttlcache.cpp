@@ -0,0 +1,77 @@
+/*
+ * File: ttlcache.cpp
+ * ------------------
+ * Expiry processing for session data: a MyHashMap of deadlines swept with
+ * a full scan on every event-loop tick against MyTTLCache::tick, under a
+ * simulated clock where a fixed number of sessions start and expire per tick.
+ * Usage: ./ttlcache [sessions] [ticks]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "myhashmap.h"
+#include "myttlcache.h"
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static long long simulatedNow = 0;
+static long long simulatedClock() {
+    return simulatedNow;
+}
+
+int main(int argc, char *argv[]) {
+    int nSessions = argc > 1 ? atoi(argv[1]) : 1000000;
+    int nTicks = argc > 2 ? atoi(argv[2]) : 200;
+    const long long TTL = 30000, TICK = 100;
+    int perTick = int(nSessions * TICK / TTL);
+
+    // Full scan: collect the expired keys with an iterator pass, then remove them.
+    MyHashMap<int, long long> deadlines(nSessions);
+    int next = 0;
+    for(; next < nSessions; ++next) {
+        deadlines.put(next, simulatedNow + rand() % TTL);
+    }
+    long long scanExpired = 0;
+    MyVector<int> dead;
+    auto start = chrono::steady_clock::now();
+    for(int t = 0; t < nTicks; ++t) {
+        simulatedNow += TICK;
+        dead.clear();
+        for(MyHashMap<int, long long>::const_iterator it = deadlines.begin(); it != deadlines.end(); ++it) {
+            if(it.value() <= simulatedNow) dead.add(it.key());
+        }
+        for(int i = 0; i < dead.size(); ++i) {
+            deadlines.remove(dead[i]);
+        }
+        scanExpired += dead.size();
+        for(int i = 0; i < perTick; ++i, ++next) {
+            deadlines.put(next, simulatedNow + TTL);
+        }
+    }
+    double scanTime = seconds(start);
+
+    simulatedNow = 0;
+    srand(1);
+    MyTTLCache<int, int> cache(TTL, 1, simulatedClock);
+    for(next = 0; next < nSessions; ++next) {
+        cache.put(next, next, rand() % TTL);
+    }
+    long long wheelExpired = 0;
+    start = chrono::steady_clock::now();
+    for(int t = 0; t < nTicks; ++t) {
+        simulatedNow += TICK;
+        wheelExpired += cache.tick();
+        for(int i = 0; i < perTick; ++i, ++next) {
+            cache.put(next, next);
+        }
+    }
+    double wheelTime = seconds(start);
+
+    cout << "expired " << scanExpired << " / " << wheelExpired << " sessions" << endl;
+    cout << "mapAll-style scan " << scanTime / nTicks * 1e3 << " ms/tick, MyTTLCache::tick "
+         << wheelTime / nTicks * 1e3 << " ms/tick (including inserts)" << endl;
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mylrucache.h"
+#include "myttlcache.h"
+#include "myvector.h"
+using namespace std;
+
+static long long fakeNow = 1000;
+static long long fakeClock() {
+    return fakeNow;
+}
+
+int main() {
+    // Entry capacity: the least recently used key goes first.
+    MyLRUCache<int, string> cache(3);
+    cache.put(1, "A");
+    cache.put(2, "B");
+    cache.put(3, "C");
+    assert(cache.get(1) == "A");
+    cache.put(4, "D");
+    assert(!cache.containsKey(2) && cache.size() == 3);
+    assert(cache.keys()[0] == 4 && cache.keys()[1] == 1 && cache.keys()[2] == 3);
+    assert(cache.get(2) == "" && cache.peek(2) == nullptr);
+    string value;
+    assert(!cache.tryGet(2, value) && value == "");
+    // peek does not promote, so 3 is still the oldest.
+    assert(*cache.peek(3) == "C");
+    cache.put(5, "E");
+    assert(!cache.containsKey(3) && cache.containsKey(1));
+    *cache.find(1) = "AA";
+    assert(cache.tryGet(1, value) && value == "AA");
+    cout << cache << endl;
+
+    // Byte capacity with an eviction callback.
+    MyLRUCache<string, string> bytes(10);
+    MyVector<string> evicted;
+    bytes.setEvictionCallback([&evicted](const string &key, const string &) { evicted.add(key); });
+    bytes.put("a", "xxxx", 4);
+    bytes.put("b", "xxxx", 4);
+    bytes.put("a", "yy", 2);
+    assert(bytes.usage() == 6 && evicted.isEmpty());
+    bytes.put("c", "xxxxx", 5);
+    assert(evicted.size() == 1 && evicted[0] == "b" && bytes.usage() == 7);
+    bytes.put("huge", "x", 11);
+    assert(evicted.size() == 4 && evicted[3] == "huge" && bytes.isEmpty() && bytes.usage() == 0);
+    assert(!bytes.remove("a"));
+    bytes.put("d", "1", 3);
+    bytes.put("e", "2", 3);
+    assert(bytes.remove("d") && evicted.size() == 4 && bytes.usage() == 3);
+    bytes.setCapacity(2);
+    assert(evicted.size() == 5 && bytes.isEmpty());
+
+    // Growth past the initial buckets keeps every entry reachable, copies keep the order.
+    MyLRUCache<int, int> big(1000);
+    for(int i = 0; i < 5000; ++i) {
+        big.put(i, i * 2);
+    }
+    assert(big.size() == 1000 && big.usage() == 1000);
+    for(int i = 0; i < 5000; ++i) {
+        assert(big.containsKey(i) == (i >= 4000));
+    }
+    big.get(4000);
+    MyLRUCache<int, int> copied = big;
+    copied.put(-1, -1);
+    assert(!copied.containsKey(4001) && copied.containsKey(4000) && big.containsKey(4001));
+    assert(copied.keys()[0] == -1 && copied.keys()[1] == 4000);
+    big = copied;
+    assert(big.size() == 1000 && big.get(-1) == -1);
+    big.clear();
+    assert(big.isEmpty() && big.usage() == 0 && !big.containsKey(4000));
+    big.put(1, 1);
+    assert(big.get(1) == 1);
+
+    // Shrinking the capacity after a burst, then compacting, keeps the order and the entries.
+    MyLRUCache<string, int> bursty(5000);
+    for(int i = 0; i < 5000; ++i) {
+        bursty.put("k" + to_string(i), i);
+    }
+    bursty.get("k10");
+    bursty.setCapacity(3);
+    assert(bursty.size() == 3 && bursty.keys()[0] == "k10" && bursty.keys()[2] == "k4998");
+    bursty.compact();
+    assert(bursty.size() == 3 && bursty.keys()[0] == "k10" && bursty.keys()[1] == "k4999");
+    assert(bursty.get("k4998") == 4998 && bursty.keys()[0] == "k4998" && !bursty.containsKey("k0"));
+    bursty.put("new", -1);
+    assert(bursty.size() == 3 && !bursty.containsKey("k4999") && bursty.peek("new") != NULL);
+    for(int i = 0; i < 3; ++i) {
+        bursty.remove(bursty.keys()[0]);
+    }
+    bursty.compact();
+    assert(bursty.isEmpty() && bursty.keys().isEmpty());
+    bursty.put("again", 1);
+    assert(bursty.get("again") == 1);
+
+    // Sharded cache shared by several threads.
+    MyShardedLRUCache<int, int> shared(4096, 8);
+    vector<thread> workers;
+    for(int t = 0; t < 4; ++t) {
+        workers.push_back(thread([&shared, t]() {
+            for(int i = 0; i < 20000; ++i) {
+                int key = (i * 7 + t) % 3000;
+                int value = 0;
+                if(!shared.tryGet(key, value)) {
+                    shared.put(key, key * 3);
+                }
+                else {
+                    assert(value == key * 3);
+                }
+            }
+        }));
+    }
+    for(size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    assert(shared.size() <= 3000 && shared.get(7) == 21);
+    assert(shared.remove(7) && !shared.containsKey(7) && shared.get(7) == 0);
+    MyShardedLRUCache<int, int> tiny(8, 4);
+    int tinyEvictions = 0;
+    tiny.setEvictionCallback([&tinyEvictions](const int &, const int &) { tinyEvictions++; });
+    for(int i = 0; i < 100; ++i) {
+        tiny.put(i, i);
+    }
+    assert(tiny.size() <= 8 && tiny.usage() == size_t(tiny.size()) && tinyEvictions == 100 - tiny.size());
+    tiny.clear();
+    assert(tiny.size() == 0);
+
+    cout << "Class MyLRUCache unit test succeed." << endl;
+
+    // TTL cache on a fake clock: lazy expiry on get, bulk expiry on tick.
+    MyTTLCache<string, int> sessions(100, 1, fakeClock);
+    MyVector<string> expiredKeys;
+    sessions.setExpirationCallback([&expiredKeys](const string &key, const int &) { expiredKeys.add(key); });
+    sessions.put("a", 1);
+    sessions.put("b", 2, 50);
+    sessions.put("c", 3, 1000000);
+    fakeNow += 49;
+    assert(sessions.get("b") == 2 && sessions.size() == 3);
+    fakeNow += 1;
+    assert(!sessions.containsKey("b") && sessions.size() == 2 && expiredKeys.size() == 1 && expiredKeys[0] == "b");
+    assert(sessions.touch("a") && !sessions.touch("b"));
+    fakeNow += 99;
+    assert(sessions.tick() == 0 && sessions.get("a") == 1);
+    fakeNow += 1;
+    assert(sessions.tick() == 1 && expiredKeys[1] == "a" && sessions.size() == 1);
+    int ttlValue = 0;
+    assert(!sessions.tryGet("a", ttlValue) && sessions.tryGet("c", ttlValue) && ttlValue == 3);
+    sessions.put("c", 4, 10);
+    assert(sessions.remove("c") && sessions.isEmpty() && expiredKeys.size() == 2);
+    fakeNow += 1000000;
+    assert(sessions.tick() == 0);
+
+    // Random deadlines across every wheel level, checked against a brute-force scan.
+    MyTTLCache<int, int> wheel(0, 1, fakeClock);
+    int ttlExpired = 0;
+    wheel.setExpirationCallback([&ttlExpired](const int &, const int &) { ttlExpired++; });
+    MyVector<long long> deadlines;
+    srand(7);
+    for(int i = 0; i < 3000; ++i) {
+        long long ttl = (i % 4 == 0) ? rand() % 70 : (i % 4 == 1) ? rand() % 5000 : (i % 4 == 2) ? rand() % 300000 : 17000000LL + rand() % 1000;
+        wheel.put(i, i, ttl);
+        deadlines.add(fakeNow + ttl);
+    }
+    long long start = fakeNow;
+    int step = 0;
+    while(fakeNow < start + 17002000) {
+        fakeNow += (step++ % 3 == 0) ? 1 : 997 + rand() % 5000;
+        wheel.tick(step % 5 == 0 ? 10 : -1);
+        wheel.tick();
+        int alive = 0;
+        for(int i = 0; i < 3000; ++i) {
+            if(deadlines[i] > fakeNow) alive++;
+        }
+        assert(wheel.size() == alive && ttlExpired == 3000 - alive);
+    }
+    assert(wheel.isEmpty());
+
+    // Bounded work: a burst of simultaneous expiries is spread over several ticks.
+    MyTTLCache<int, int> burst(10, 1, fakeClock);
+    for(int i = 0; i < 100; ++i) {
+        burst.put(i, i);
+    }
+    MyTTLCache<int, int> burstCopy = burst;
+    fakeNow += 10;
+    assert(burst.tick(30) == 30 && burst.size() == 70);
+    assert(burst.tick(30) == 30 && burst.tick(100) == 40 && burst.isEmpty());
+    assert(burstCopy.size() == 100 && burstCopy.keys().isEmpty() && burstCopy.tick() == 100);
+    burstCopy.put(1, 1);
+    assert(burstCopy.get(1) == 1 && burstCopy.toString() == "{1: 1}");
+
+    // Idle gaps are skipped: far-out deadlines in the high levels still expire on the exact tick.
+    MyTTLCache<int, int> idle(0, 1, fakeClock);
+    long long far[] = {63, 64 * 5 + 7, 4096 * 9 + 1, 262144 * 40 + 4095, 16777216LL * 3 + 5};
+    for(int i = 0; i < 5; ++i) {
+        idle.put(i, i, far[i]);
+    }
+    long long idleStart = fakeNow;
+    for(int i = 0; i < 5; ++i) {
+        fakeNow = idleStart + far[i] - 1;
+        assert(idle.tick() == 0 && idle.size() == 5 - i);
+        fakeNow = idleStart + far[i];
+        assert(idle.tick() == 1 && !idle.containsKey(i));
+    }
+    assert(idle.isEmpty());
+
+    // After most sessions expire, compact keeps the survivors in their wheel slots.
+    MyTTLCache<int, int> crowd(5, 1, fakeClock);
+    for(int i = 0; i < 5000; ++i) {
+        crowd.put(i, i, (i % 500 == 0) ? 100 + i : 5);
+    }
+    fakeNow += 5;
+    assert(crowd.tick() == 4990 && crowd.size() == 10);
+    crowd.compact();
+    assert(crowd.size() == 10 && crowd.get(4500) == 4500 && !crowd.containsKey(1));
+    fakeNow += 95;
+    assert(crowd.tick() == 1 && !crowd.containsKey(0) && crowd.containsKey(500));
+    fakeNow += 4500;
+    assert(crowd.tick() == 9 && crowd.isEmpty());
+
+    cout << "Class MyTTLCache unit test succeed." << endl;
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * File: mycachetable.h
+ * --------------------
+ * 该类是MyLRUCache和MyTTLCache共用的散列表：拉链法，篮子数是2的幂。
+ * 它是侵入式的（intrusive）：不分配也不释放结点，只把调用者的Cell串进篮子的链表，
+ * 所以同一个Cell还可以同时挂在缓存自己的链表（LRU链表、时间轮的槽）上。
+ * Cell必须有key、hash（完整的hash Code）和link（同一个篮子中的下一个Cell）三个成员。
+ *
+ * 条目数超过篮子数时加倍；删除之后条目数不足篮子数的1/4时缩小到约两倍条目数，
+ * 两个阈值之间留有距离，所以在边界上交替插入、删除不会反复重建。
+ * 重建时按Cell中保存的hash Code重新链接，不移动Cell，也不重新计算hash Code。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版（从MyLRUCache和MyTTLCache中提取）
+ */
+
+#ifndef _mycachetable_h
+#define _mycachetable_h
+
+#include <cstddef>
+
+template <typename Cell>
+class MyCacheTable {
+public:
+    /*
+     * 方法：MyCacheTable
+     * 使用：MyCacheTable<Cell> table;
+     *      MyCacheTable<Cell> table(expected);
+     * --------------------------------------
+     * 构造一个空的散列表，篮子数为INITIAL_BUCKET_COUNT与不小于expected的2的幂中的较大者。
+     */
+    explicit MyCacheTable(int expected = 0);
+
+    /*
+     * 方法：～MyCacheTable
+     * 使用：隐式调用
+     * -------------
+     * 释放篮子数组。表中的Cell属于调用者，不会被释放。
+     */
+    ~MyCacheTable();
+
+    /*
+     * 方法：find
+     * 使用：Cell *cp = table.find(key, hash);
+     * -------------------------------------
+     * 返回key对应的Cell，不存在时返回NULL。hash是调用者已经算好的hash Code。
+     */
+    template <typename KeyType>
+    Cell * find(const KeyType &key, unsigned long long hash) const;
+
+    /*
+     * 方法：insert
+     * 使用：table.insert(cp);
+     * ---------------------
+     * 按cp->hash把cp插入篮子的链表头部（改写cp->link），条目数超过篮子数时加倍。
+     * 调用者保证表中没有相同的key。
+     */
+    void insert(Cell *cp);
+
+    /*
+     * 方法：unlink
+     * 使用：table.unlink(cp);
+     * ---------------------
+     * 把cp从它所在篮子的链表中摘下，不缩小篮子数组（见shrinkIfSparse）。
+     */
+    void unlink(Cell *cp);
+
+    /*
+     * 方法：shrinkIfSparse
+     * 使用：table.shrinkIfSparse();
+     * ---------------------------
+     * 条目数不足篮子数的1/4时缩小篮子数组。与unlink分开，调用者可以在释放Cell之后、
+     * 或者一连串删除结束之后才调用它。
+     */
+    void shrinkIfSparse();
+
+    /*
+     * 方法：reset
+     * 使用：table.reset();
+     * ------------------
+     * 清空所有篮子并还原为初始大小，用于缓存的clear()。Cell由调用者释放。
+     */
+    void reset();
+
+    /*
+     * 方法：swap
+     * 使用：table.swap(fresh);
+     * ----------------------
+     * 交换两个表的内容，用于compact()：新的Cell先插入一个局部的表，全部成功之后再换进来。
+     */
+    void swap(MyCacheTable<Cell> &other);
+
+    /*
+     * 方法：size, bucketCount, bucket
+     * 使用：for(int i = 0; i < table.bucketCount(); ++i) {
+     *          for(Cell *cp = table.bucket(i); cp != NULL; cp = cp->link) ...
+     *      }
+     * -----------------------------------------------------------------
+     * 返回条目数、篮子数以及第i个篮子的链表头，用于遍历所有Cell。
+     */
+    int size() const;
+    int bucketCount() const;
+    Cell * bucket(int i) const;
+
+private:
+    /* 初始散列表的长度，必须是2的幂 */
+    static const int INITIAL_BUCKET_COUNT = 16;
+
+    Cell **buckets;
+    int nBuckets;           // 2的幂
+    int entries;
+
+    /* 散列表只保存指针，不能被拷贝 */
+    MyCacheTable(const MyCacheTable &);
+    MyCacheTable & operator=(const MyCacheTable &);
+
+    /*
+     * 方法：resize
+     * -----------
+     * 把篮子数量改为n（2的幂），按Cell中保存的hash Code重新链接，不移动Cell。
+     */
+    void resize(int n);
+};
+
+template <typename Cell>
+MyCacheTable<Cell>::MyCacheTable(int expected) {
+    nBuckets = INITIAL_BUCKET_COUNT;
+    while(nBuckets < expected) {
+        nBuckets *= 2;
+    }
+    buckets = new Cell* [nBuckets]();
+    entries = 0;
+}
+
+template <typename Cell>
+MyCacheTable<Cell>::~MyCacheTable() {
+    delete [] buckets;
+}
+
+template <typename Cell>
+template <typename KeyType>
+Cell * MyCacheTable<Cell>::find(const KeyType &key, unsigned long long hash) const {
+    Cell *cp = buckets[hash & (nBuckets - 1)];
+    while(cp != NULL && (cp->hash != hash || cp->key != key)) {
+        cp = cp->link;
+    }
+    return cp;
+}
+
+/*
+ * 实现笔记：insert
+ * --------------
+ * 先链接再扩容：扩容分配失败时cp已经在表中，表仍然是一致的，只是篮子数没有加倍。
+ */
+template <typename Cell>
+void MyCacheTable<Cell>::insert(Cell *cp) {
+    Cell **head = &buckets[cp->hash & (nBuckets - 1)];
+    cp->link = *head;
+    *head = cp;
+    entries++;
+    if(entries > nBuckets) {
+        resize(nBuckets * 2);
+    }
+}
+
+template <typename Cell>
+void MyCacheTable<Cell>::unlink(Cell *cp) {
+    Cell **pp = &buckets[cp->hash & (nBuckets - 1)];
+    while(*pp != cp) {
+        pp = &(*pp)->link;
+    }
+    *pp = cp->link;
+    entries--;
+}
+
+template <typename Cell>
+void MyCacheTable<Cell>::shrinkIfSparse() {
+    if(nBuckets > INITIAL_BUCKET_COUNT && entries < nBuckets / 4) {
+        int n = INITIAL_BUCKET_COUNT;
+        while(n < entries * 2) {
+            n *= 2;
+        }
+        resize(n);
+    }
+}
+
+/*
+ * 实现笔记：reset
+ * -------------
+ * 先清空再缩小：分配新数组失败时表已经是空的，只是还保持原来的大小。
+ */
+template <typename Cell>
+void MyCacheTable<Cell>::reset() {
+    for(int i = 0; i < nBuckets; ++i) {
+        buckets[i] = NULL;
+    }
+    entries = 0;
+    if(nBuckets > INITIAL_BUCKET_COUNT) {
+        Cell **fresh = new Cell* [INITIAL_BUCKET_COUNT]();
+        delete [] buckets;
+        buckets = fresh;
+        nBuckets = INITIAL_BUCKET_COUNT;
+    }
+}
+
+template <typename Cell>
+void MyCacheTable<Cell>::swap(MyCacheTable<Cell> &other) {
+    Cell **b = buckets; buckets = other.buckets; other.buckets = b;
+    int n = nBuckets; nBuckets = other.nBuckets; other.nBuckets = n;
+    int e = entries; entries = other.entries; other.entries = e;
+}
+
+template <typename Cell>
+void MyCacheTable<Cell>::resize(int newNBuckets) {
+    Cell **newBuckets = new Cell* [newNBuckets]();
+    for(int i = 0; i < nBuckets; ++i) {
+        Cell *cp = buckets[i];
+        while(cp != NULL) {
+            Cell *next = cp->link;
+            int bucket = int(cp->hash & (newNBuckets - 1));
+            cp->link = newBuckets[bucket];
+            newBuckets[bucket] = cp;
+            cp = next;
+        }
+    }
+    delete [] buckets;
+    buckets = newBuckets;
+    nBuckets = newNBuckets;
+}
+
+template <typename Cell>
+int MyCacheTable<Cell>::size() const {
+    return entries;
+}
+
+template <typename Cell>
+int MyCacheTable<Cell>::bucketCount() const {
+    return nBuckets;
+}
+
+template <typename Cell>
+Cell * MyCacheTable<Cell>::bucket(int i) const {
+    return buckets[i];
+}
+
+#endif // _mycachetable_h
@@ -0,0 +1,702 @@
+/*
+ * File: mylrucache.h
+ * ------------------
+ * 该类实现了容量有限的LRU（least recently used）缓存：条目超过容量时，淘汰最久没有被访问的条目。
+ * 每个条目有一个"开销"（charge，默认为1），容量限制的是所有条目开销之和，
+ * 所以同一个类既可以限制条目数，也可以（put时传入条目的字节数）限制字节数。
+ *
+ * 与"MyHashMap<K, V>加一个单独的链表"不同，LRU链表的前后指针直接嵌在散列表的Cell中：
+ * 一次查找同时得到条目和它在链表中的位置，get、put、淘汰都只需要一次查找和O(1)的指针修改，
+ * 每个条目也只分配一个Cell（来自缓存自己的MyNodePool）。
+ *
+ * MyShardedLRUCache把key按hash Code分到若干个各自加锁的MyLRUCache中，供多个线程同时使用。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: 删除或淘汰之后条目数不足篮子数的1/4时缩小散列表，clear()还原为初始大小；
+ *                     添加compact()，把Cell搬到紧凑的新结点池并释放旧块。
+ *      3. 2026.10.18: 散列表改用与MyTTLCache共用的MyCacheTable。
+ */
+
+#ifndef _mylrucache_h
+#define _mylrucache_h
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include "mycachetable.h"
+#include "myhashcode.h"
+#include "mynodepool.h"
+#include "myvector.h"
+
+template <typename KeyType, typename ValueType>
+class MyShardedLRUCache;
+
+template <typename KeyType, typename ValueType>
+class MyLRUCache {
+public:
+    /* 条目因为超出容量而被淘汰时调用的函数 */
+    typedef std::function<void (const KeyType &, const ValueType &)> EvictionCallback;
+
+    /*
+     * 方法：MyLRUCache
+     * 使用：MyLRUCache<KeyType, ValueType> cache(capacity);
+     * ---------------------------------------------------
+     * 构造一个空的缓存，所有条目的开销之和不超过capacity。
+     */
+    explicit MyLRUCache(size_t capacity);
+
+    /*
+     * 方法：～MyLRUCache
+     * 使用：隐式调用
+     * -------------
+     * 释放所有条目（不调用淘汰回调）。
+     */
+    ~MyLRUCache();
+
+    /*
+     * 方法：get
+     * 使用：ValueType value = cache.get(key);
+     * -------------------------------------
+     * 返回key对应的value，并把该条目标记为最近使用；key不存在时返回ValueType的默认值。
+     */
+    ValueType get(const KeyType &key);
+
+    /*
+     * 方法：tryGet
+     * 使用：if(cache.tryGet(key, value)) ...
+     * ------------------------------------
+     * key存在时把value复制到out、把条目标记为最近使用并返回true，否则返回false，out不变。
+     */
+    bool tryGet(const KeyType &key, ValueType &out);
+
+    /*
+     * 方法：find
+     * 使用：ValueType *vp = cache.find(key);
+     * ------------------------------------
+     * 返回指向key对应的value的指针（key不存在时为NULL），并把条目标记为最近使用。
+     * 指针在该条目被淘汰或删除之前一直有效。
+     */
+    ValueType * find(const KeyType &key);
+
+    /*
+     * 方法：peek, containsKey
+     * 使用：const ValueType *vp = cache.peek(key);
+     *      if(cache.containsKey(key)) ...
+     * ------------------------------------------
+     * 与find相同，但不改变条目的使用顺序。
+     */
+    const ValueType * peek(const KeyType &key) const;
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * 方法：put
+     * 使用：cache.put(key, value);
+     *      cache.put(key, value, bytes);
+     * ---------------------------------
+     * 插入（或覆盖）key对应的value，开销为charge，并把条目标记为最近使用。
+     * 之后如果开销之和超过容量，从最久没有使用的条目开始淘汰，直到不超过容量为止；
+     * 开销本身就超过容量的条目会被立即淘汰。
+     */
+    void put(const KeyType &key, const ValueType &value, size_t charge = 1);
+
+    /*
+     * 方法：remove
+     * 使用：cache.remove(key);
+     * ----------------------
+     * 删除key对应的条目（不调用淘汰回调）。如果key存在返回true。
+     */
+    bool remove(const KeyType &key);
+
+    /*
+     * 方法：clear
+     * 使用：cache.clear();
+     * ------------------
+     * 删除所有条目（不调用淘汰回调），散列表还原为初始大小。结点池的块保留下来供之后的put复用。
+     */
+    void clear();
+
+    /*
+     * 方法：compact
+     * 使用：cache.compact();
+     * --------------------
+     * 释放突发写入（或调小容量）之后多余的内存：按原来的使用顺序把所有Cell复制到一个新的结点池中
+     * 连续存放，释放旧池的所有块，并把散列表缩小到刚好容纳当前条目。find、peek返回的指针会失效。
+     */
+    void compact();
+
+    /*
+     * 方法：setEvictionCallback
+     * 使用：cache.setEvictionCallback([](const KeyType &k, const ValueType &v) { ... });
+     * -------------------------------------------------------------------------------
+     * 设置条目因为超出容量而被淘汰时调用的函数，它在条目被释放之前调用。
+     * 回调中不能修改这个缓存。回调抛出的异常会传给触发淘汰的put（或setCapacity），
+     * 被淘汰的条目仍然会被删除。
+     */
+    void setEvictionCallback(EvictionCallback callback);
+
+    /*
+     * 方法：setCapacity, capacity, usage
+     * 使用：cache.setCapacity(n);
+     * -------------------------
+     * setCapacity修改容量，必要时立即淘汰条目；capacity返回容量，usage返回当前所有条目的开销之和。
+     */
+    void setCapacity(size_t capacity);
+    size_t capacity() const;
+    size_t usage() const;
+
+    /*
+     * 方法：size, isEmpty
+     * 使用：int n = cache.size();
+     * -------------------------
+     * 返回条目的个数；没有条目时isEmpty返回true。
+     */
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：keys
+     * 使用：MyVector<KeyType> keys = cache.keys();
+     * ------------------------------------------
+     * 按从最近使用到最久没有使用的顺序返回所有的key。
+     */
+    MyVector<KeyType> keys() const;
+
+    /*
+     * 方法：toString
+     * 使用：string str = cache.toString();
+     * ----------------------------------
+     * 按keys()的顺序返回可打印的字符串，如"{k1: v1}{k2: v2}"。
+     */
+    std::string toString() const;
+
+    /*
+     * 拷贝构造函数和赋值操作符
+     * ---------------------
+     * 复制所有条目（保持使用顺序）、容量和淘汰回调。
+     */
+    MyLRUCache(const MyLRUCache<KeyType, ValueType> &src);
+    MyLRUCache<KeyType, ValueType> & operator= (const MyLRUCache<KeyType, ValueType> &src);
+
+private:
+    friend class MyShardedLRUCache<KeyType, ValueType>;
+
+    /*
+     * 散列表中的Cell同时是LRU链表的结点：link串起同一个篮子中的Cell，
+     * prev、next串起LRU链表（head是最近使用的，tail是最久没有使用的）。
+     */
+    struct Cell {
+        KeyType key;
+        ValueType value;
+        unsigned long long hash;
+        size_t charge;
+        Cell *link;
+        Cell *prev;
+        Cell *next;
+    };
+
+    /* 实例变量 */
+    MyCacheTable<Cell> table;
+    Cell *head;             // 最近使用的条目
+    Cell *tail;             // 最久没有使用的条目
+    size_t limit;           // 容量
+    size_t used;            // 所有条目的开销之和
+    EvictionCallback onEvict;
+    MyNodePool<Cell> pool;
+
+    /* 以下方法与同名的公有方法相同，只是使用调用者已经算好的hash Code（供MyShardedLRUCache使用） */
+    void put(const KeyType &key, const ValueType &value, size_t charge, unsigned long long hash);
+    bool remove(const KeyType &key, unsigned long long hash);
+
+    /*
+     * 方法：unlinkList, pushFront, promote
+     * -----------------------------------
+     * 把cp从LRU链表中摘下；把cp插到链表头部；把cp移到链表头部。
+     */
+    void unlinkList(Cell *cp);
+    void pushFront(Cell *cp);
+    void promote(Cell *cp);
+
+    /*
+     * 方法：evictToFit
+     * ---------------
+     * 从链表尾部开始淘汰条目（并调用回调），直到开销之和不超过容量。
+     */
+    void evictToFit();
+
+    void init(size_t capacity);
+    void copyFrom(const MyLRUCache<KeyType, ValueType> &src);
+};
+
+template <typename KeyType, typename ValueType>
+MyLRUCache<KeyType, ValueType>::MyLRUCache(size_t capacity) {
+    init(capacity);
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::init(size_t capacity) {
+    head = tail = NULL;
+    limit = capacity;
+    used = 0;
+}
+
+template <typename KeyType, typename ValueType>
+MyLRUCache<KeyType, ValueType>::~MyLRUCache() {
+    clear();
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyLRUCache<KeyType, ValueType>::get(const KeyType &key) {
+    ValueType *vp = find(key);
+    return (vp == NULL) ? ValueType() : *vp;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyLRUCache<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) {
+    ValueType *vp = find(key);
+    if(vp == NULL) return false;
+    out = *vp;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType * MyLRUCache<KeyType, ValueType>::find(const KeyType &key) {
+    Cell *cp = table.find(key, hashCode(key));
+    if(cp == NULL) return NULL;
+    promote(cp);
+    return &cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType * MyLRUCache<KeyType, ValueType>::peek(const KeyType &key) const {
+    Cell *cp = table.find(key, hashCode(key));
+    return (cp == NULL) ? NULL : &cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyLRUCache<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    return table.find(key, hashCode(key)) != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::put(const KeyType &key, const ValueType &value, size_t charge) {
+    put(key, value, charge, hashCode(key));
+}
+
+/*
+ * 实现笔记：put
+ * -----------
+ * key已经存在时直接覆盖value和开销并移到链表头部，不分配新的Cell；
+ * 否则从结点池分配一个Cell，插入链表头部和散列表。最后再统一淘汰，
+ * 所以刚插入的条目只有在它自己的开销超过容量时才会被淘汰。
+ */
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::put(const KeyType &key, const ValueType &value, size_t charge, unsigned long long hash) {
+    Cell *cp = table.find(key, hash);
+    if(cp != NULL) {
+        cp->value = value;
+        used = used - cp->charge + charge;
+        cp->charge = charge;
+        promote(cp);
+    }
+    else {
+        cp = pool.create(key, value, hash, charge, (Cell *) NULL, (Cell *) NULL, (Cell *) NULL);
+        pushFront(cp);
+        used += charge;
+        table.insert(cp);
+    }
+    evictToFit();
+}
+
+template <typename KeyType, typename ValueType>
+bool MyLRUCache<KeyType, ValueType>::remove(const KeyType &key) {
+    return remove(key, hashCode(key));
+}
+
+template <typename KeyType, typename ValueType>
+bool MyLRUCache<KeyType, ValueType>::remove(const KeyType &key, unsigned long long hash) {
+    Cell *cp = table.find(key, hash);
+    if(cp == NULL) return false;
+    table.unlink(cp);
+    unlinkList(cp);
+    used -= cp->charge;
+    pool.destroy(cp);
+    table.shrinkIfSparse();
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::clear() {
+    Cell *cp = head;
+    while(cp != NULL) {
+        Cell *next = cp->next;
+        pool.destroy(cp);
+        cp = next;
+    }
+    head = tail = NULL;
+    used = 0;
+    table.reset();
+}
+
+/*
+ * 实现笔记：compact
+ * ---------------
+ * 从head到tail依次复制，新的Cell按使用顺序接在新链表的尾部，所以使用顺序不变。
+ * key、value是复制而不是移动的：中途分配失败时只需丢弃已经复制的Cell，缓存保持原样。
+ */
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::compact() {
+    MyCacheTable<Cell> fresh(table.size());
+    MyNodePool<Cell> compacted;
+    Cell *newHead = NULL, *newTail = NULL;
+    try {
+        for(Cell *cp = head; cp != NULL; cp = cp->next) {
+            Cell *np = compacted.create(cp->key, cp->value, cp->hash, cp->charge, (Cell *) NULL, newTail, (Cell *) NULL);
+            fresh.insert(np);
+            if(newTail != NULL) newTail->next = np;
+            else newHead = np;
+            newTail = np;
+        }
+    }
+    catch(...) {
+        while(newHead != NULL) {
+            Cell *next = newHead->next;
+            newHead->~Cell();
+            newHead = next;
+        }
+        throw;
+    }
+    while(head != NULL) {
+        Cell *next = head->next;
+        head->~Cell();
+        head = next;
+    }
+    pool.purge();
+    pool.adopt(compacted);
+    table.swap(fresh);
+    head = newHead;
+    tail = newTail;
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::setEvictionCallback(EvictionCallback callback) {
+    onEvict = callback;
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::setCapacity(size_t capacity) {
+    limit = capacity;
+    evictToFit();
+}
+
+template <typename KeyType, typename ValueType>
+size_t MyLRUCache<KeyType, ValueType>::capacity() const {
+    return limit;
+}
+
+template <typename KeyType, typename ValueType>
+size_t MyLRUCache<KeyType, ValueType>::usage() const {
+    return used;
+}
+
+template <typename KeyType, typename ValueType>
+int MyLRUCache<KeyType, ValueType>::size() const {
+    return table.size();
+}
+
+template <typename KeyType, typename ValueType>
+bool MyLRUCache<KeyType, ValueType>::isEmpty() const {
+    return table.size() == 0;
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyLRUCache<KeyType, ValueType>::keys() const {
+    MyVector<KeyType> keys;
+    for(Cell *cp = head; cp != NULL; cp = cp->next) {
+        keys.add(cp->key);
+    }
+    return keys;
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyLRUCache<KeyType, ValueType>::toString() const {
+    std::ostringstream os;
+    for(Cell *cp = head; cp != NULL; cp = cp->next) {
+        os << "{" << cp->key << ": " << cp->value << "}";
+    }
+    return os.str();
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::unlinkList(Cell *cp) {
+    if(cp->prev != NULL) cp->prev->next = cp->next;
+    else head = cp->next;
+    if(cp->next != NULL) cp->next->prev = cp->prev;
+    else tail = cp->prev;
+    cp->prev = cp->next = NULL;
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::pushFront(Cell *cp) {
+    cp->prev = NULL;
+    cp->next = head;
+    if(head != NULL) head->prev = cp;
+    else tail = cp;
+    head = cp;
+}
+
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::promote(Cell *cp) {
+    if(cp != head) {
+        unlinkList(cp);
+        pushFront(cp);
+    }
+}
+
+/*
+ * 实现笔记：evictToFit
+ * ------------------
+ * 先把条目从篮子和链表中摘下、更新计数，再调用回调，最后释放Cell。
+ * 这样即使回调抛出异常，缓存也处于一致的状态，被淘汰的Cell也不会泄漏。
+ */
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::evictToFit() {
+    while(used > limit && tail != NULL) {
+        Cell *cp = tail;
+        table.unlink(cp);
+        unlinkList(cp);
+        used -= cp->charge;
+        try {
+            if(onEvict) onEvict(cp->key, cp->value);
+        }
+        catch(...) {
+            pool.destroy(cp);
+            throw;
+        }
+        pool.destroy(cp);
+    }
+    table.shrinkIfSparse();
+}
+
+template <typename KeyType, typename ValueType>
+MyLRUCache<KeyType, ValueType>::MyLRUCache(const MyLRUCache<KeyType, ValueType> &src) {
+    init(src.limit);
+    copyFrom(src);
+}
+
+template <typename KeyType, typename ValueType>
+MyLRUCache<KeyType, ValueType> & MyLRUCache<KeyType, ValueType>::operator= (const MyLRUCache<KeyType, ValueType> &src) {
+    if(this != &src) {
+        clear();
+        limit = src.limit;
+        copyFrom(src);
+    }
+    return *this;
+}
+
+/*
+ * 实现笔记：copyFrom
+ * ----------------
+ * 从src的链表尾部（最久没有使用）向头部依次插入，每次插入都放到链表头部，
+ * 所以复制得到的缓存与src的使用顺序相同。src中的条目不超过容量，不会发生淘汰。
+ */
+template <typename KeyType, typename ValueType>
+void MyLRUCache<KeyType, ValueType>::copyFrom(const MyLRUCache<KeyType, ValueType> &src) {
+    onEvict = src.onEvict;
+    for(Cell *cp = src.tail; cp != NULL; cp = cp->prev) {
+        put(cp->key, cp->value, cp->charge, cp->hash);
+    }
+}
+
+/*
+ * 重载运算符<<
+ * -----------
+ * 输出toString()的结果。
+ */
+template <typename KeyType, typename ValueType>
+std::ostream & operator<<(std::ostream &os, const MyLRUCache<KeyType, ValueType> &cache) {
+    return os << cache.toString();
+}
+
+/*
+ * 类：MyShardedLRUCache
+ * --------------------
+ * 供多个线程同时使用的LRU缓存：key按hash Code的高32位分到nShards个分片，
+ * 每个分片是一个由自己的互斥锁保护的MyLRUCache，容量平均分配。
+ * 在LRU缓存中，get也要修改链表，所以读操作同样需要加锁；不同分片的操作互不阻塞，
+ * 分片数远大于线程数时锁竞争很少。淘汰只在各自的分片内按LRU顺序进行，是全局LRU的近似。
+ * hash Code只计算一次，既用来选择分片，也直接交给分片中的散列表。
+ */
+template <typename KeyType, typename ValueType>
+class MyShardedLRUCache {
+public:
+    typedef typename MyLRUCache<KeyType, ValueType>::EvictionCallback EvictionCallback;
+
+    /*
+     * 方法：MyShardedLRUCache
+     * 使用：MyShardedLRUCache<KeyType, ValueType> cache(capacity);
+     *      MyShardedLRUCache<KeyType, ValueType> cache(capacity, nShards);
+     * ---------------------------------------------------------------
+     * 构造一个总容量为capacity的缓存，nShards向上取整为2的幂。
+     */
+    explicit MyShardedLRUCache(size_t capacity, int nShards = 16);
+    ~MyShardedLRUCache();
+
+    /*
+     * 以下方法的含义与MyLRUCache中的同名方法相同，每个方法只锁住key所在的分片。
+     * 因为返回后条目可能立即被其他线程淘汰，这里不提供返回指针的find和peek。
+     */
+    ValueType get(const KeyType &key);
+    bool tryGet(const KeyType &key, ValueType &out);
+    bool containsKey(const KeyType &key) const;
+    void put(const KeyType &key, const ValueType &value, size_t charge = 1);
+    bool remove(const KeyType &key);
+
+    /*
+     * 方法：clear, compact, size, usage
+     * --------------------------------
+     * 依次锁住每个分片；其他线程同时修改缓存时，size和usage的结果只是近似值。
+     * compact依次对每个分片调用MyLRUCache::compact，同一时刻只有一个分片被锁住。
+     */
+    void clear();
+    void compact();
+    int size() const;
+    size_t usage() const;
+
+    /*
+     * 方法：setEvictionCallback
+     * ------------------------
+     * 为所有分片设置淘汰回调。回调在持有分片锁时调用，不能再访问这个缓存。
+     * 应在其他线程开始使用缓存之前调用。
+     */
+    void setEvictionCallback(EvictionCallback callback);
+
+    /* 分片包含互斥锁，禁止复制 */
+    MyShardedLRUCache(const MyShardedLRUCache<KeyType, ValueType> &src) = delete;
+    MyShardedLRUCache<KeyType, ValueType> & operator= (const MyShardedLRUCache<KeyType, ValueType> &src) = delete;
+
+private:
+    /* 填充到独占cache line，避免相邻分片的锁互相干扰（false sharing） */
+    struct Shard {
+        std::mutex lock;
+        MyLRUCache<KeyType, ValueType> cache;
+        char padding[64];
+        Shard() : cache(0) {}
+    };
+
+    Shard *shards;
+    int nShards;            // 2的幂
+
+    Shard & shardOf(unsigned long long hash) const {
+        return shards[(hash >> 32) & (unsigned long long)(nShards - 1)];
+    }
+};
+
+template <typename KeyType, typename ValueType>
+MyShardedLRUCache<KeyType, ValueType>::MyShardedLRUCache(size_t capacity, int nShards) {
+    this->nShards = 1;
+    while(this->nShards < nShards) {
+        this->nShards *= 2;
+    }
+    shards = new Shard[this->nShards];
+    size_t perShard = (capacity + this->nShards - 1) / this->nShards;
+    for(int i = 0; i < this->nShards; ++i) {
+        shards[i].cache.setCapacity(perShard);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+MyShardedLRUCache<KeyType, ValueType>::~MyShardedLRUCache() {
+    delete [] shards;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyShardedLRUCache<KeyType, ValueType>::get(const KeyType &key) {
+    ValueType value = ValueType();
+    tryGet(key, value);
+    return value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyShardedLRUCache<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) {
+    unsigned long long hash = hashCode(key);
+    Shard &shard = shardOf(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    typename MyLRUCache<KeyType, ValueType>::Cell *cp = shard.cache.table.find(key, hash);
+    if(cp == NULL) return false;
+    shard.cache.promote(cp);
+    out = cp->value;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyShardedLRUCache<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    unsigned long long hash = hashCode(key);
+    Shard &shard = shardOf(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.cache.table.find(key, hash) != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+void MyShardedLRUCache<KeyType, ValueType>::put(const KeyType &key, const ValueType &value, size_t charge) {
+    unsigned long long hash = hashCode(key);
+    Shard &shard = shardOf(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.cache.put(key, value, charge, hash);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyShardedLRUCache<KeyType, ValueType>::remove(const KeyType &key) {
+    unsigned long long hash = hashCode(key);
+    Shard &shard = shardOf(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.cache.remove(key, hash);
+}
+
+template <typename KeyType, typename ValueType>
+void MyShardedLRUCache<KeyType, ValueType>::clear() {
+    for(int i = 0; i < nShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].cache.clear();
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyShardedLRUCache<KeyType, ValueType>::compact() {
+    for(int i = 0; i < nShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].cache.compact();
+    }
+}
+
+template <typename KeyType, typename ValueType>
+int MyShardedLRUCache<KeyType, ValueType>::size() const {
+    int total = 0;
+    for(int i = 0; i < nShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        total += shards[i].cache.size();
+    }
+    return total;
+}
+
+template <typename KeyType, typename ValueType>
+size_t MyShardedLRUCache<KeyType, ValueType>::usage() const {
+    size_t total = 0;
+    for(int i = 0; i < nShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        total += shards[i].cache.usage();
+    }
+    return total;
+}
+
+template <typename KeyType, typename ValueType>
+void MyShardedLRUCache<KeyType, ValueType>::setEvictionCallback(EvictionCallback callback) {
+    for(int i = 0; i < nShards; ++i) {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        shards[i].cache.setEvictionCallback(callback);
+    }
+}
+
+#endif // _mylrucache_h
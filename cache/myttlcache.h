@@ -0,0 +1,690 @@
+/*
+ * File: myttlcache.h
+ * ------------------
+ * 该类实现了带有过期时间（TTL，time to live）的缓存：每个条目在put之后的ttl毫秒内有效，
+ * 过期的条目由两种方式删除：
+ *      1. 惰性删除：get、tryGet、containsKey遇到已经过期的条目时立即删除它；
+ *      2. 定期删除：事件循环定期调用tick()，删除所有已经过期的条目，可以限制每次最多删除多少个。
+ *
+ * 过期时间保存在一个分层时间轮（hierarchical timer wheel，与Linux内核的定时器相同）中：
+ * LEVELS层，每层SLOTS个槽，第0层的每个槽对应一个时间刻度（resolution毫秒），
+ * 第k层的每个槽对应SLOTS^k个刻度。条目按剩余时间放入能容纳它的最低一层，
+ * 时间轮转过高层的一个槽时，其中的条目被重新分配（cascade）到低层。
+ * 插入、删除都是O(1)，每个条目最多被重新分配LEVELS - 1次，所以过期处理的均摊代价也是O(1)，
+ * 不再需要用mapAll扫描所有篮子。
+ *
+ * 与MyLRUCache相同，时间轮中的链表指针直接嵌在散列表（MyCacheTable）的Cell中。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: 删除或过期之后条目数不足篮子数的1/4时缩小散列表，clear()还原为初始大小；
+ *                     添加compact()，把Cell搬到紧凑的新结点池并释放旧块。
+ *      3. 2026.10.18: tick用所有层的占用位图跳到下一个非空的槽，空闲之后不再逐圈cascade。
+ *      4. 2026.10.18: 散列表改用与MyLRUCache共用的MyCacheTable。
+ */
+
+#ifndef _myttlcache_h
+#define _myttlcache_h
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string>
+#include "mycachetable.h"
+#include "myhashcode.h"
+#include "mynodepool.h"
+#include "myvector.h"
+
+/*
+ * 函数：myttlSteadyMillis
+ * 使用：long long now = myttlSteadyMillis();
+ * ----------------------------------------
+ * MyTTLCache默认使用的时钟：steady_clock的毫秒数（不受系统时间调整的影响）。
+ */
+inline long long myttlSteadyMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename KeyType, typename ValueType>
+class MyTTLCache {
+public:
+    /* 条目过期被删除时调用的函数 */
+    typedef std::function<void (const KeyType &, const ValueType &)> ExpirationCallback;
+    /* 返回当前时间（毫秒）的时钟 */
+    typedef long long (*Clock)();
+
+    /*
+     * 方法：MyTTLCache
+     * 使用：MyTTLCache<KeyType, ValueType> cache(defaultTtl);
+     *      MyTTLCache<KeyType, ValueType> cache(defaultTtl, resolution, clock);
+     * ----------------------------------------------------------------------
+     * 构造一个空的缓存，put默认的有效期为defaultTtl毫秒。
+     * resolution是时间轮的刻度（毫秒），过期的条目最多在resolution毫秒之后才被tick删除
+     * （惰性删除不受影响），时间轮能直接表示的最长时间为resolution * SLOTS^LEVELS毫秒，
+     * 更远的条目会在到达时重新放入时间轮。clock用来替换默认的时钟（例如在测试中）。
+     */
+    explicit MyTTLCache(long long defaultTtl, long long resolution = 1, Clock clock = myttlSteadyMillis);
+
+    /*
+     * 方法：～MyTTLCache
+     * 使用：隐式调用
+     * -------------
+     * 释放所有条目（不调用过期回调）。
+     */
+    ~MyTTLCache();
+
+    /*
+     * 方法：get, tryGet, containsKey
+     * 使用：ValueType value = cache.get(key);
+     *      if(cache.tryGet(key, value)) ...
+     *      if(cache.containsKey(key)) ...
+     * -------------------------------------
+     * 与MyHashMap相同，只是已经过期的条目被视为不存在，并在这里被删除（调用过期回调）。
+     */
+    ValueType get(const KeyType &key);
+    bool tryGet(const KeyType &key, ValueType &out);
+    bool containsKey(const KeyType &key);
+
+    /*
+     * 方法：put
+     * 使用：cache.put(key, value);
+     *      cache.put(key, value, ttl);
+     * -------------------------------
+     * 插入（或覆盖）key对应的value，有效期为ttl毫秒（默认为构造时的defaultTtl），从现在开始计算。
+     */
+    void put(const KeyType &key, const ValueType &value);
+    void put(const KeyType &key, const ValueType &value, long long ttl);
+
+    /*
+     * 方法：touch
+     * 使用：cache.touch(key);
+     *      cache.touch(key, ttl);
+     * --------------------------
+     * 把未过期的key的有效期重新设为从现在开始的ttl毫秒（例如会话有新的请求时），
+     * 如果key存在（且没有过期）返回true。
+     */
+    bool touch(const KeyType &key);
+    bool touch(const KeyType &key, long long ttl);
+
+    /*
+     * 方法：remove, clear
+     * 使用：cache.remove(key);
+     * ----------------------
+     * 删除key对应的条目或所有条目，不调用过期回调。remove在key存在时返回true。
+     * clear把散列表还原为初始大小，结点池的块保留下来供之后的put复用。
+     */
+    bool remove(const KeyType &key);
+    void clear();
+
+    /*
+     * 方法：compact
+     * 使用：cache.compact();
+     * --------------------
+     * 释放突发写入之后多余的内存（例如大量会话同时过期之后）：把所有Cell复制到一个新的结点池中
+     * 连续存放，每个条目留在时间轮中原来的槽里，释放旧池的所有块，并把散列表缩小到刚好容纳当前条目。
+     * 只处理还在缓存中的条目，已经过期但还没有被tick删除的条目也会被保留。
+     */
+    void compact();
+
+    /*
+     * 方法：tick
+     * 使用：int n = cache.tick();
+     *      int n = cache.tick(maxExpirations);
+     * ---------------------------------------
+     * 把时间轮推进到当前时间，删除所有已经过期的条目（调用过期回调），返回删除的条目数。
+     * maxExpirations >= 0时最多删除这么多个条目就返回，剩下的留给下一次tick，
+     * 这样事件循环中的一次调用不会因为大量条目同时过期而停顿太久。
+     * 空闲的时间段由各层的占用位图直接跳过，所以一次tick的代价只与它删除和重新分配的条目数有关，
+     * 与距离上一次tick的时间无关。
+     */
+    int tick(int maxExpirations = -1);
+
+    /*
+     * 方法：setExpirationCallback
+     * 使用：cache.setExpirationCallback([](const KeyType &k, const ValueType &v) { ... });
+     * ---------------------------------------------------------------------------------
+     * 设置条目因为过期被删除（tick或惰性删除）时调用的函数，它在条目被释放之前调用，
+     * 回调中不能修改这个缓存。回调抛出的异常会传给调用者，过期的条目仍然会被删除。
+     */
+    void setExpirationCallback(ExpirationCallback callback);
+
+    /*
+     * 方法：size, isEmpty
+     * 使用：int n = cache.size();
+     * -------------------------
+     * 返回条目的个数，包括已经过期但还没有被删除的条目。
+     */
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：keys, toString
+     * 使用：MyVector<KeyType> keys = cache.keys();
+     * ------------------------------------------
+     * 按不可预测的顺序返回所有未过期的key，或者"{k1: v1}{k2: v2}"形式的字符串。
+     */
+    MyVector<KeyType> keys() const;
+    std::string toString() const;
+
+    /*
+     * 拷贝构造函数和赋值操作符
+     * ---------------------
+     * 复制所有条目（保持各自的过期时间）、默认有效期、时钟和过期回调。
+     */
+    MyTTLCache(const MyTTLCache<KeyType, ValueType> &src);
+    MyTTLCache<KeyType, ValueType> & operator= (const MyTTLCache<KeyType, ValueType> &src);
+
+private:
+    /*
+     * 散列表中的Cell同时是时间轮中的结点：link串起同一个篮子中的Cell，
+     * prev、next串起时间轮同一个槽中的Cell，slot是它所在的槽（level * SLOTS + 槽下标）。
+     */
+    struct Cell {
+        KeyType key;
+        ValueType value;
+        unsigned long long hash;
+        long long deadline;     // 过期时间（毫秒），now >= deadline时过期
+        Cell *link;
+        Cell *prev;
+        Cell *next;
+        int slot;
+    };
+
+    /* 时间轮的层数和每层的槽数（SLOTS = 2^SLOT_BITS） */
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    /* 散列表 */
+    MyCacheTable<Cell> table;
+    MyNodePool<Cell> pool;
+
+    /* 时间轮 */
+    Cell *wheel[LEVELS * SLOTS];
+    unsigned long long occupied[LEVELS];    // 第k位为1表示该层第k个槽非空
+    long long currentTick;                  // 下一个要处理的刻度
+    bool cascaded;                          // currentTick的cascade是否已经完成
+
+    long long defaultTtl;
+    long long resolution;
+    Clock clock;
+    ExpirationCallback onExpire;
+
+    /*
+     * 方法：findLive
+     * -------------
+     * 查找key，如果它已经过期则删除它（调用回调）并返回NULL。
+     */
+    Cell * findLive(const KeyType &key, long long now);
+
+    /*
+     * 方法：schedule, unschedule
+     * -------------------------
+     * 按cp->deadline把cp放入时间轮中合适的槽；把cp从它所在的槽中摘下。
+     */
+    void schedule(Cell *cp);
+    void unschedule(Cell *cp);
+
+    /*
+     * 方法：cascade
+     * ------------
+     * 时间轮转到第0层的第0个槽时调用：把第level层当前槽中的所有Cell重新放入低层，
+     * 如果该层也转到了第0个槽，则先处理更高的一层。
+     */
+    void cascade(int level);
+
+    /*
+     * 方法：nextEvent
+     * --------------
+     * 返回currentTick之后第一个需要处理的刻度：第0层的一个非空的槽到期，或者高层的一个非空的槽需要cascade。
+     * 所有槽都为空时返回-1。
+     */
+    long long nextEvent() const;
+
+    /*
+     * 方法：expire, erase
+     * ------------------
+     * erase把cp从散列表和时间轮中摘下并释放；expire在释放之前调用过期回调。
+     */
+    void expire(Cell *cp);
+    void erase(Cell *cp);
+
+    void insert(const KeyType &key, const ValueType &value, unsigned long long hash, long long deadline);
+    void init();
+    void copyFrom(const MyTTLCache<KeyType, ValueType> &src);
+    static int lowestBit(unsigned long long bits);
+};
+
+template <typename KeyType, typename ValueType>
+MyTTLCache<KeyType, ValueType>::MyTTLCache(long long defaultTtl, long long resolution, Clock clock) {
+    this->defaultTtl = defaultTtl;
+    this->resolution = (resolution < 1) ? 1 : resolution;
+    this->clock = clock;
+    init();
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::init() {
+    for(int i = 0; i < LEVELS * SLOTS; ++i) {
+        wheel[i] = NULL;
+    }
+    for(int level = 0; level < LEVELS; ++level) {
+        occupied[level] = 0;
+    }
+    currentTick = clock() / resolution;
+    cascaded = false;
+}
+
+template <typename KeyType, typename ValueType>
+MyTTLCache<KeyType, ValueType>::~MyTTLCache() {
+    clear();
+}
+
+template <typename KeyType, typename ValueType>
+typename MyTTLCache<KeyType, ValueType>::Cell * MyTTLCache<KeyType, ValueType>::findLive(const KeyType &key, long long now) {
+    Cell *cp = table.find(key, hashCode(key));
+    if(cp != NULL && now >= cp->deadline) {
+        expire(cp);
+        return NULL;
+    }
+    return cp;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyTTLCache<KeyType, ValueType>::get(const KeyType &key) {
+    Cell *cp = findLive(key, clock());
+    return (cp == NULL) ? ValueType() : cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyTTLCache<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) {
+    Cell *cp = findLive(key, clock());
+    if(cp == NULL) return false;
+    out = cp->value;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyTTLCache<KeyType, ValueType>::containsKey(const KeyType &key) {
+    return findLive(key, clock()) != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::put(const KeyType &key, const ValueType &value) {
+    put(key, value, defaultTtl);
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::put(const KeyType &key, const ValueType &value, long long ttl) {
+    insert(key, value, hashCode(key), clock() + ttl);
+}
+
+/*
+ * 实现笔记：insert
+ * --------------
+ * key已经存在（不论是否过期）时覆盖value，并按新的过期时间换一个槽；否则分配新的Cell。
+ * 新的Cell先放入时间轮再插入散列表：散列表扩容失败时它已经在两边，缓存仍然是一致的。
+ */
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::insert(const KeyType &key, const ValueType &value, unsigned long long hash, long long deadline) {
+    Cell *cp = table.find(key, hash);
+    if(cp != NULL) {
+        cp->value = value;
+        unschedule(cp);
+        cp->deadline = deadline;
+        schedule(cp);
+    }
+    else {
+        cp = pool.create(key, value, hash, deadline, (Cell *) NULL, (Cell *) NULL, (Cell *) NULL, -1);
+        schedule(cp);
+        table.insert(cp);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+bool MyTTLCache<KeyType, ValueType>::touch(const KeyType &key) {
+    return touch(key, defaultTtl);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyTTLCache<KeyType, ValueType>::touch(const KeyType &key, long long ttl) {
+    long long now = clock();
+    Cell *cp = findLive(key, now);
+    if(cp == NULL) return false;
+    unschedule(cp);
+    cp->deadline = now + ttl;
+    schedule(cp);
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyTTLCache<KeyType, ValueType>::remove(const KeyType &key) {
+    Cell *cp = table.find(key, hashCode(key));
+    if(cp == NULL) return false;
+    erase(cp);
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::clear() {
+    for(int i = 0; i < table.bucketCount(); ++i) {
+        Cell *cp = table.bucket(i);
+        while(cp != NULL) {
+            Cell *next = cp->link;
+            pool.destroy(cp);
+            cp = next;
+        }
+    }
+    for(int i = 0; i < LEVELS * SLOTS; ++i) {
+        wheel[i] = NULL;
+    }
+    for(int level = 0; level < LEVELS; ++level) {
+        occupied[level] = 0;
+    }
+    table.reset();
+}
+
+/*
+ * 实现笔记：compact
+ * ---------------
+ * 按时间轮的槽逐个复制：每个槽中的新Cell按原来的顺序接成新的链表，slot不变，
+ * 所以占用位图、currentTick都不需要修改。key、value是复制而不是移动的：
+ * 中途分配失败时只需丢弃已经复制的Cell（它们都在newWheel中），缓存保持原样。
+ */
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::compact() {
+    MyCacheTable<Cell> fresh(table.size());
+    Cell *newWheel[LEVELS * SLOTS] = {};
+    MyNodePool<Cell> compacted;
+    try {
+        for(int slot = 0; slot < LEVELS * SLOTS; ++slot) {
+            Cell *last = NULL;
+            for(Cell *cp = wheel[slot]; cp != NULL; cp = cp->next) {
+                Cell *np = compacted.create(cp->key, cp->value, cp->hash, cp->deadline,
+                                            (Cell *) NULL, last, (Cell *) NULL, slot);
+                fresh.insert(np);
+                if(last != NULL) last->next = np;
+                else newWheel[slot] = np;
+                last = np;
+            }
+        }
+    }
+    catch(...) {
+        for(int slot = 0; slot < LEVELS * SLOTS; ++slot) {
+            for(Cell *np = newWheel[slot]; np != NULL; ) {
+                Cell *next = np->next;
+                np->~Cell();
+                np = next;
+            }
+        }
+        throw;
+    }
+    for(int slot = 0; slot < LEVELS * SLOTS; ++slot) {
+        for(Cell *cp = wheel[slot]; cp != NULL; ) {
+            Cell *next = cp->next;
+            cp->~Cell();
+            cp = next;
+        }
+        wheel[slot] = newWheel[slot];
+    }
+    pool.purge();
+    pool.adopt(compacted);
+    table.swap(fresh);
+}
+
+/*
+ * 实现笔记：schedule
+ * ----------------
+ * 过期刻度expires = ceil(deadline / resolution)，保证tick处理到该刻度时条目确实已经过期。
+ * 按delta = expires - currentTick选择层：delta < SLOTS^(k+1)的条目放入第k层，
+ * 槽下标取expires的第k组SLOT_BITS位。已经过期（delta < 0）的条目放入下一个要处理的槽；
+ * 超出时间轮范围的条目先放在最高层最远的槽，到时由tick检查后重新放入。
+ */
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::schedule(Cell *cp) {
+    long long expires = (cp->deadline >= 0) ? (cp->deadline + resolution - 1) / resolution : cp->deadline / resolution;
+    long long delta = expires - currentTick;
+    int level = 0;
+    if(delta < 0) {
+        expires = currentTick;
+    }
+    else {
+        while(level < LEVELS - 1 && delta >= (1LL << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        if(delta >= (1LL << (SLOT_BITS * LEVELS))) {
+            expires = currentTick + (1LL << (SLOT_BITS * LEVELS)) - 1;
+        }
+    }
+    int index = int((expires >> (SLOT_BITS * level)) & (SLOTS - 1));
+    int slot = level * SLOTS + index;
+
+    cp->slot = slot;
+    cp->prev = NULL;
+    cp->next = wheel[slot];
+    if(wheel[slot] != NULL) wheel[slot]->prev = cp;
+    wheel[slot] = cp;
+    occupied[level] |= 1ULL << index;
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::unschedule(Cell *cp) {
+    if(cp->prev != NULL) cp->prev->next = cp->next;
+    else wheel[cp->slot] = cp->next;
+    if(cp->next != NULL) cp->next->prev = cp->prev;
+    if(wheel[cp->slot] == NULL) {
+        occupied[cp->slot / SLOTS] &= ~(1ULL << (cp->slot % SLOTS));
+    }
+    cp->prev = cp->next = NULL;
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::cascade(int level) {
+    int index = int((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1));
+    if(index == 0 && level < LEVELS - 1) {
+        cascade(level + 1);
+    }
+    int slot = level * SLOTS + index;
+    Cell *cp = wheel[slot];
+    wheel[slot] = NULL;
+    occupied[level] &= ~(1ULL << index);
+    while(cp != NULL) {
+        Cell *next = cp->next;
+        schedule(cp);
+        cp = next;
+    }
+}
+
+/*
+ * 实现笔记：tick
+ * ------------
+ * 逐个处理currentTick .. nowTick：进入刻度时如果第0层转到了第0个槽，先cascade一次，
+ * 然后删除第0层当前槽中的条目。cascaded记录当前刻度的cascade是否已经完成，
+ * 所以因为maxExpirations提前返回后，下一次tick可以从同一个槽继续而不会重复cascade。
+ * 因为最远的条目被截断到时间轮的范围内，删除之前还要检查deadline，没到期的重新放入。
+ * 当前槽处理完之后直接跳到nextEvent给出的刻度：中间跳过的刻度上没有要删除的条目，
+ * 要cascade的槽也都是空的，逐个刻度前进也什么都不会做，所以结果与逐个刻度处理完全相同。
+ */
+template <typename KeyType, typename ValueType>
+int MyTTLCache<KeyType, ValueType>::tick(int maxExpirations) {
+    long long now = clock();
+    long long nowTick = now / resolution;
+    int expired = 0;
+    if(table.size() == 0) {
+        if(currentTick <= nowTick) {
+            currentTick = nowTick + 1;
+            cascaded = false;
+        }
+        return 0;
+    }
+    while(currentTick <= nowTick) {
+        int index = int(currentTick & (SLOTS - 1));
+        if(!cascaded) {
+            if(index == 0) cascade(1);
+            cascaded = true;
+        }
+        while(wheel[index] != NULL) {
+            if(maxExpirations >= 0 && expired >= maxExpirations) return expired;
+            Cell *cp = wheel[index];
+            if(cp->deadline > now) {
+                unschedule(cp);
+                schedule(cp);
+                continue;
+            }
+            expire(cp);
+            expired++;
+        }
+
+        long long next = nextEvent();
+        currentTick = (next >= 0 && next <= nowTick) ? next : nowTick + 1;
+        cascaded = false;
+    }
+    return expired;
+}
+
+/*
+ * 实现笔记：nextEvent
+ * -----------------
+ * 第k层的槽在currentTick是SLOTS^k的倍数时处理（第0层是每个刻度），槽下标依次加一、循环。
+ * 从currentTick之后的第一个边界开始，用占用位图找到循环顺序中第一个非空的槽，
+ * 就得到这一层下一次要处理的刻度；每层O(1)，取各层的最小值。
+ * 高层转回第0个槽时同时处理更高的一层，这个刻度如果更高层的槽非空，已经由更高层给出。
+ */
+template <typename KeyType, typename ValueType>
+long long MyTTLCache<KeyType, ValueType>::nextEvent() const {
+    long long next = -1;
+    for(int level = 0; level < LEVELS; ++level) {
+        if(occupied[level] == 0) continue;
+        int shift = SLOT_BITS * level;
+        long long boundary = ((currentTick >> shift) + 1) << shift;
+        int start = int((boundary >> shift) & (SLOTS - 1));
+        unsigned long long later = occupied[level] & (~0ULL << start);
+        int steps = (later != 0) ? lowestBit(later) - start : SLOTS - start + lowestBit(occupied[level]);
+        long long at = boundary + ((long long) steps << shift);
+        if(next < 0 || at < next) next = at;
+    }
+    return next;
+}
+
+template <typename KeyType, typename ValueType>
+int MyTTLCache<KeyType, ValueType>::lowestBit(unsigned long long bits) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int i = 0;
+    while(!(bits & 1)) {
+        bits >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::expire(Cell *cp) {
+    table.unlink(cp);
+    unschedule(cp);
+    try {
+        if(onExpire) onExpire(cp->key, cp->value);
+    }
+    catch(...) {
+        pool.destroy(cp);
+        throw;
+    }
+    pool.destroy(cp);
+    table.shrinkIfSparse();
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::erase(Cell *cp) {
+    table.unlink(cp);
+    unschedule(cp);
+    pool.destroy(cp);
+    table.shrinkIfSparse();
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::setExpirationCallback(ExpirationCallback callback) {
+    onExpire = callback;
+}
+
+template <typename KeyType, typename ValueType>
+int MyTTLCache<KeyType, ValueType>::size() const {
+    return table.size();
+}
+
+template <typename KeyType, typename ValueType>
+bool MyTTLCache<KeyType, ValueType>::isEmpty() const {
+    return table.size() == 0;
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyTTLCache<KeyType, ValueType>::keys() const {
+    long long now = clock();
+    MyVector<KeyType> keys;
+    for(int i = 0; i < table.bucketCount(); ++i) {
+        for(Cell *cp = table.bucket(i); cp != NULL; cp = cp->link) {
+            if(now < cp->deadline) keys.add(cp->key);
+        }
+    }
+    return keys;
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyTTLCache<KeyType, ValueType>::toString() const {
+    long long now = clock();
+    std::ostringstream os;
+    for(int i = 0; i < table.bucketCount(); ++i) {
+        for(Cell *cp = table.bucket(i); cp != NULL; cp = cp->link) {
+            if(now < cp->deadline) os << "{" << cp->key << ": " << cp->value << "}";
+        }
+    }
+    return os.str();
+}
+
+template <typename KeyType, typename ValueType>
+MyTTLCache<KeyType, ValueType>::MyTTLCache(const MyTTLCache<KeyType, ValueType> &src) {
+    defaultTtl = src.defaultTtl;
+    resolution = src.resolution;
+    clock = src.clock;
+    init();
+    copyFrom(src);
+}
+
+template <typename KeyType, typename ValueType>
+MyTTLCache<KeyType, ValueType> & MyTTLCache<KeyType, ValueType>::operator= (const MyTTLCache<KeyType, ValueType> &src) {
+    if(this != &src) {
+        clear();
+        defaultTtl = src.defaultTtl;
+        resolution = src.resolution;
+        clock = src.clock;
+        currentTick = clock() / resolution;
+        cascaded = false;
+        copyFrom(src);
+    }
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+void MyTTLCache<KeyType, ValueType>::copyFrom(const MyTTLCache<KeyType, ValueType> &src) {
+    onExpire = src.onExpire;
+    for(int i = 0; i < src.table.bucketCount(); ++i) {
+        for(Cell *cp = src.table.bucket(i); cp != NULL; cp = cp->link) {
+            insert(cp->key, cp->value, cp->hash, cp->deadline);
+        }
+    }
+}
+
+/*
+ * 重载运算符<<
+ * -----------
+ * 输出toString()的结果。
+ */
+template <typename KeyType, typename ValueType>
+std::ostream & operator<<(std::ostream &os, const MyTTLCache<KeyType, ValueType> &cache) {
+    return os << cache.toString();
+}
+
+#endif // _myttlcache_h
@@ -0,0 +1 @@
+g++ -std=c++11 -pthread -I ../vector/ -I ../hashmap/ -o main main.cpp ../hashmap/myhashcode.cpp
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include "myconcurrenthashmap.h"
+using namespace std;
+
+// A value whose copy constructor throws once copiesLeft copies have been made.
+struct Brittle {
+    static int copiesLeft;
+    int v;
+    Brittle(int v = 0) : v(v) {}
+    Brittle(const Brittle &b) : v(b.v) {
+        if(copiesLeft == 0) throw runtime_error("copy failed");
+        if(copiesLeft > 0) copiesLeft--;
+    }
+    Brittle & operator=(const Brittle &b) { v = b.v; return *this; }
+};
+int Brittle::copiesLeft = -1;
+ostream & operator<<(ostream &os, const Brittle &b) { return os << b.v; }
+
+int main() {
+    MyConcurrentHashMap<string, int> words;
+    assert(words.isEmpty());
+    words.put("A", 1);
+    words.put("B", 2);
+    assert(words.size() == 2);
+    assert(words.get("B") == 2 && words.get("C") == 0);
+    int out = -1;
+    assert(!words.tryGet("C", out) && out == -1);
+    words.put("B", 3);
+    assert(words.tryGet("B", out) && out == 3 && words.size() == 2);
+    words.remove("A");
+    words.remove("C");
+    assert(!words.containsKey("A") && words.containsKey("B") && words.size() == 1);
+    cout << words << endl;
+    words.clear();
+    assert(words.isEmpty() && !words.containsKey("B"));
+
+    // Stripes grow independently; nothing is lost across many resizes.
+    MyConcurrentHashMap<int, int> numbers(0, 4);
+    for(int i = 0; i < 20000; ++i) {
+        numbers.put(i, -i);
+    }
+    for(int i = 0; i < 20000; i += 2) {
+        numbers.remove(i);
+    }
+    assert(numbers.size() == 10000 && numbers.keys().size() == 10000);
+    for(int i = 0; i < 20000; ++i) {
+        assert(numbers.containsKey(i) == (i % 2 == 1));
+    }
+    assert(numbers.merge(1, 5, [](int old, int v) { return old + v; }) == 4);
+    assert(numbers.computeIfAbsent(1, [](int) { return 100; }) == 4);
+    assert(numbers.computeIfAbsent(0, [](int) { return 100; }) == 100 && numbers.size() == 10001);
+
+    // Stripes shrink back while readers keep finding the surviving keys.
+    std::atomic<bool> shrinking(true);
+    vector<thread> lookers;
+    for(int t = 0; t < 2; ++t) {
+        lookers.push_back(thread([&numbers, &shrinking]() {
+            while(shrinking.load()) {
+                for(int i = 1; i < 100; i += 2) {
+                    assert(numbers.containsKey(i));
+                }
+            }
+        }));
+    }
+    for(int i = 101; i < 20000; i += 2) {
+        numbers.remove(i);
+    }
+    shrinking.store(false);
+    for(thread &t : lookers) {
+        t.join();
+    }
+    assert(numbers.size() == 51 && numbers.get(99) == -99 && numbers.get(0) == 100);
+    numbers.compact();
+    assert(numbers.size() == 51 && numbers.keys().size() == 51 && numbers.get(1) == 4);
+    numbers.clear();
+    numbers.put(7, 7);
+    assert(numbers.size() == 1 && numbers.get(7) == 7);
+
+    // A copy that throws during a resize reaches the caller; the insert itself is kept.
+    MyConcurrentHashMap<int, Brittle> brittle(0, 1);
+    int failedAt = -1;
+    for(int i = 0; i < 1000 && failedAt < 0; ++i) {
+        Brittle::copiesLeft = 1;
+        try {
+            brittle.put(i, Brittle(i));
+        }
+        catch(runtime_error &) {
+            failedAt = i;
+        }
+    }
+    Brittle::copiesLeft = -1;
+    assert(failedAt > 0 && brittle.size() == failedAt + 1);
+    brittle.put(failedAt + 1, Brittle(failedAt + 1));
+    for(int i = 0; i <= failedAt + 1; ++i) {
+        assert(brittle.get(i).v == i);
+    }
+
+    // Concurrent merges on shared keys are never lost.
+    MyConcurrentHashMap<int, int> counts;
+    const int nThreads = 4, perThread = 20000, nKeys = 100;
+    vector<thread> workers;
+    for(int t = 0; t < nThreads; ++t) {
+        workers.push_back(thread([&counts]() {
+            for(int i = 0; i < perThread; ++i) {
+                counts.merge(i % nKeys, 1, [](int old, int v) { return old + v; });
+            }
+        }));
+    }
+    for(int t = 0; t < nThreads; ++t) {
+        workers[t].join();
+    }
+    assert(counts.size() == nKeys);
+    for(int k = 0; k < nKeys; ++k) {
+        assert(counts.get(k) == nThreads * perThread / nKeys);
+    }
+
+    // computeIfAbsent runs its function once per key, whoever wins the race.
+    MyConcurrentHashMap<int, int> cache;
+    atomic<int> calls(0);
+    workers.clear();
+    for(int t = 0; t < nThreads; ++t) {
+        workers.push_back(thread([&cache, &calls]() {
+            for(int i = 0; i < 5000; ++i) {
+                int v = cache.computeIfAbsent(i, [&calls](int k) { calls++; return k * 2; });
+                assert(v == i * 2);
+            }
+        }));
+    }
+    for(int t = 0; t < nThreads; ++t) {
+        workers[t].join();
+    }
+    assert(calls == 5000 && cache.size() == 5000);
+
+    // Readers keep finding old entries while writers update them and force resizes.
+    MyConcurrentHashMap<int, string> shared;
+    for(int i = 0; i < 1000; ++i) {
+        shared.put(i, to_string(i));
+    }
+    atomic<bool> done(false);
+    vector<thread> readers;
+    for(int t = 0; t < 2; ++t) {
+        readers.push_back(thread([&shared, &done]() {
+            while(!done.load()) {
+                for(int i = 0; i < 1000; ++i) {
+                    string s;
+                    assert(shared.tryGet(i, s));
+                    assert(s == to_string(i) || s == to_string(-i));
+                }
+            }
+        }));
+    }
+    workers.clear();
+    for(int t = 0; t < 2; ++t) {
+        workers.push_back(thread([&shared, t]() {
+            for(int i = 0; i < 1000; ++i) {
+                shared.put(i, to_string(-i));
+            }
+            for(int i = 0; i < 20000; ++i) {
+                shared.put(1000 + t * 20000 + i, "new");
+            }
+        }));
+    }
+    for(int t = 0; t < 2; ++t) {
+        workers[t].join();
+    }
+    done = true;
+    for(int t = 0; t < 2; ++t) {
+        readers[t].join();
+    }
+    assert(shared.size() == 41000 && shared.get(5) == "-5" && shared.get(40999) == "new");
+
+    cout << "Class MyConcurrentHashMap unit test succeed." << endl;
+    return 0;
+}
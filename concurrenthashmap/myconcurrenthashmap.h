@@ -0,0 +1,827 @@
+/*
+ * File: myconcurrenthashmap.h
+ * ---------------------------
+ * 该类是可以被多个线程同时读写的散列表。接口与 MyHashMap 相近，但所有方法都可以
+ * 在任意线程中同时调用：
+ *
+ *      写者：散列表被分成若干条带（stripe），每个条带有自己的锁和自己的篮子数组，
+ *           key由hash Code的高位决定属于哪个条带。不同条带上的写操作互不阻塞。
+ *      读者：get、tryGet、containsKey不加任何锁，也不会因为写者而重试。
+ *           结点一旦发布就不再修改（更新value时用一个新结点替换旧结点），
+ *           所以读者看到的总是完整的key-value。
+ *      扩容：只在一个条带内进行，把该条带的结点复制到两倍大的新表中再原子地切换，
+ *           正在读旧表的读者不受影响，所以扩容从不阻塞读者。条带中的条目不足篮子数的1/4时，
+ *           用同样的方法缩小到约两倍条目数。
+ *
+ * 被替换、删除的结点和旧表不能立即释放（读者可能还在访问它们），
+ * 这里使用基于纪元（epoch）的回收：读者在访问期间登记当前纪元，
+ * 退役的结点在所有读者都离开它退役时的纪元之后才被释放。
+ * -------------------------------------------------------------------------------
+ * 思路与JDK 7的ConcurrentHashMap（分段锁、不可变结点）以及Fraser的epoch-based reclamation相同。
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: remove之后条带中的条目不足篮子数的1/4时缩小该条带的表，clear()还原为初始大小，
+ *                     添加compact()。
+ *      3. 2026.10.18: resize只在内存不足时保留旧表并忽略错误，其他异常（例如拷贝构造函数抛出的）传给调用者。
+ */
+
+#ifndef _myconcurrenthashmap_h
+#define _myconcurrenthashmap_h
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include "myhashcode.h"
+#include "myvector.h"
+
+template <typename KeyType, typename ValueType>
+class MyConcurrentHashMap {
+public:
+    /*
+     * Constructor: MyConcurrentHashMap
+     * Usage: MyConcurrentHashMap<KeyType, ValueType> map;
+     *        MyConcurrentHashMap<KeyType, ValueType> map(expectedSize, nStripes);
+     * ---------------------------------------------------------------------------
+     * Initializes an empty map. The second form preallocates enough buckets
+     * for expectedSize entries and splits the map into nStripes independently
+     * locked stripes (rounded up to a power of two). More stripes let more
+     * writers run at the same time.
+     */
+    MyConcurrentHashMap();
+    explicit MyConcurrentHashMap(int expectedSize, int nStripes = DEFAULT_STRIPES);
+
+    /*
+     * Destructor: ~MyConcurrentHashMap
+     * Usage: (usually implicit)
+     * -------------------------
+     * Frees every entry, including the ones still waiting to be reclaimed.
+     * The caller must make sure no other thread is still using the map.
+     */
+    ~MyConcurrentHashMap();
+
+    /*
+     * Method: get
+     * Usage: ValueType value = map.get(key);
+     * --------------------------------------
+     * Returns a copy of the value associated with key, or the default value
+     * of ValueType if there is none. Never takes a lock.
+     */
+    ValueType get(const KeyType &key) const;
+
+    /*
+     * Method: tryGet
+     * Usage: if(map.tryGet(key, value)) . . .
+     * ---------------------------------------
+     * Copies the value associated with key into out and returns true, or
+     * returns false and leaves out unchanged. Never takes a lock.
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+
+    /*
+     * Method: containsKey
+     * Usage: if(map.containsKey(key)) . . .
+     * -------------------------------------
+     * Returns true if there is an entry for key. Never takes a lock.
+     */
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * Method: put
+     * Usage: map.put(key, value);
+     * ---------------------------
+     * Associates key with value, replacing any previous value.
+     */
+    void put(const KeyType &key, const ValueType &value);
+
+    /*
+     * Method: remove
+     * Usage: map.remove(key);
+     * -----------------------
+     * Removes the entry for key, if any.
+     */
+    void remove(const KeyType &key);
+
+    /*
+     * Method: computeIfAbsent
+     * Usage: ValueType value = map.computeIfAbsent(key, [](const KeyType &k) { return ...; });
+     * ----------------------------------------------------------------------------------------
+     * Returns the value associated with key. If there is none, fn(key) is
+     * called and its result is inserted. The check and the insertion are
+     * atomic: when several threads race on the same missing key, fn runs
+     * exactly once and every thread gets the same value. fn runs while the
+     * stripe of key is locked, so it must be short and must not modify this
+     * map.
+     */
+    template <typename Fn>
+    ValueType computeIfAbsent(const KeyType &key, Fn fn);
+
+    /*
+     * Method: merge
+     * Usage: map.merge(key, 1, [](const ValueType &old, const ValueType &v) { return old + v; });
+     * -------------------------------------------------------------------------------------------
+     * Atomically inserts value if key is missing, or replaces the current
+     * value with combine(current, value). Returns the new value. Concurrent
+     * merges on the same key are never lost. combine must not modify this map.
+     */
+    template <typename Fn>
+    ValueType merge(const KeyType &key, const ValueType &value, Fn combine);
+
+    /*
+     * Method: size
+     * Usage: int n = map.size();
+     * --------------------------
+     * Returns the number of entries. While writers are running the result
+     * is only a snapshot.
+     */
+    int size() const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if(map.isEmpty()) . . .
+     * ------------------------------
+     * Returns true if the map contains no entries.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: clear
+     * Usage: map.clear();
+     * -------------------
+     * Removes all entries. Readers that are running at the same time see
+     * either the old or the empty contents of each stripe. Every stripe goes
+     * back to the bucket count it was constructed with.
+     */
+    void clear();
+
+    /*
+     * Method: compact
+     * Usage: map.compact();
+     * ---------------------
+     * Shrinks the table of every stripe to fit its current entries and
+     * frees the retired nodes and tables that no reader can reach any more.
+     * The stripes are compacted one after another, each under its own lock;
+     * readers are never blocked.
+     */
+    void compact();
+
+    /*
+     * Method: keys
+     * Usage: MyVector<KeyType> keys = map.keys();
+     * -------------------------------------------
+     * Returns a copy of the keys, in unpredictable order.
+     */
+    MyVector<KeyType> keys() const;
+
+    /*
+     * Method: mapAll
+     * Usage: map.mapAll(fn);
+     * ----------------------
+     * Calls fn(key, value) for every entry, in unpredictable order, without
+     * taking any lock. Entries added or removed during the call may or may
+     * not be visited; every other entry is visited exactly once.
+     */
+    void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+    /*
+     * Method: toString
+     * Usage: string str = map.toString();
+     * -----------------------------------
+     * Returns a printable string such as "{k1: v1}{k2: v2}".
+     */
+    std::string toString() const;
+
+    /* The map owns its stripes and is not copyable. */
+    MyConcurrentHashMap(const MyConcurrentHashMap<KeyType, ValueType> &src) = delete;
+    MyConcurrentHashMap<KeyType, ValueType> & operator=(const MyConcurrentHashMap<KeyType, ValueType> &src) = delete;
+
+    /*
+     * Notes on the representation
+     * ---------------------------
+     * Stripe s owns its own bucket array (a Table) and is selected by the
+     * high 32 bits of the hash code; the bucket inside the table by the low
+     * bits. A node is never modified after it has been published, except
+     * for its next pointer when the node after it is removed. Writers hold
+     * the stripe lock and publish with release stores; readers follow the
+     * pointers with acquire loads.
+     *
+     * Reclamation: the map keeps a global epoch and MAX_READERS reader
+     * slots. A reader claims a free slot, stores the current epoch there and
+     * clears it when it is done. A writer tags every node (or table) it
+     * unlinks with the epoch at that moment. The epoch only advances when
+     * every busy slot has seen the current epoch, so an object tagged e can
+     * no longer be reached by anyone once the epoch reaches e + 2.
+     */
+private:
+    static const int DEFAULT_STRIPES = 16;
+    static const int MAX_STRIPES = 1 << 16;
+    static const int INITIAL_BUCKET_COUNT = 16;
+    static const int MAX_READERS = 128;
+    static const int RECLAIM_BATCH = 64;
+    static const int CACHE_LINE = 64;
+
+    struct Node {
+        const KeyType key;
+        const ValueType value;
+        const unsigned long long hash;
+        std::atomic<Node *> next;
+
+        Node(const KeyType &key, const ValueType &value, unsigned long long hash, Node *next)
+            : key(key), value(value), hash(hash), next(next) {}
+    };
+
+    struct Table {
+        int nBuckets;                   // always a power of two
+        std::atomic<Node *> *buckets;
+    };
+
+    /* 等待回收的对象：deleter(ptr)在纪元到达epoch + 2之后才会被调用 */
+    struct Retired {
+        void *ptr;
+        void (*deleter)(void *);
+        unsigned long long epoch;
+    };
+
+    struct Stripe {
+        std::mutex lock;
+        std::atomic<Table *> table;
+        std::atomic<int> count;
+        int threshold;                  // 以下成员由lock保护
+        int reclaimAt;
+        MyVector<Retired> retired;
+        char padding[CACHE_LINE];       // 避免相邻条带的锁落在同一个cache line上
+    };
+
+    struct ReaderSlot {
+        std::atomic<unsigned long long> epoch;      // 0表示空闲
+        char padding[CACHE_LINE - sizeof(std::atomic<unsigned long long>)];
+    };
+
+    /*
+     * 类：ReadGuard
+     * 使用：ReadGuard guard(*this);
+     * ---------------------------
+     * 在作用域内占用一个读者槽位，析构时释放。
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const MyConcurrentHashMap &map) : map(map), slot(map.pinReader()) {}
+        ~ReadGuard() { map.unpinReader(slot); }
+    private:
+        const MyConcurrentHashMap &map;
+        int slot;
+    };
+
+    Stripe *stripes;
+    int nStripes;
+    int minBuckets;         // 每个条带的表的初始大小，也是自动缩小的下限
+    mutable std::atomic<unsigned long long> globalEpoch;
+    mutable ReaderSlot readers[MAX_READERS];
+
+    void init(int expectedSize, int stripeCount);
+    Stripe & stripeOf(unsigned long long hash) const;
+    static int bucketOf(unsigned long long hash, const Table *table);
+
+    static Table * newTable(int nBuckets);
+    static void deleteTable(void *table);
+    static void deleteNode(void *node);
+
+    /*
+     * 方法：findLink
+     * 使用：std::atomic<Node *> *link = findLink(table, key, hash);
+     * -----------------------------------------------------------
+     * 写者持有条带的锁时调用：返回指向键为key的结点的那个指针（篮子的头指针或前一个结点的next），
+     * key不存在时返回的指针指向nullptr（链表末尾）。
+     */
+    static std::atomic<Node *> * findLink(Table *table, const KeyType &key, unsigned long long hash);
+
+    /*
+     * 方法：insertOrReplace
+     * 使用：insertOrReplace(stripe, link, key, value, hash);
+     * ----------------------------------------------------
+     * 持有条带的锁时调用：link指向已有结点时用新结点替换它并让旧结点退役，
+     * 否则在篮子头部插入新结点，必要时扩容。
+     */
+    void insertOrReplace(Stripe &stripe, std::atomic<Node *> *link, const KeyType &key,
+                         const ValueType &value, unsigned long long hash);
+    void resize(Stripe &stripe, int nBuckets);
+    static int bucketCountFor(int n);
+
+    /* 纪元回收 */
+    int pinReader() const;
+    void unpinReader(int slot) const;
+    void retire(Stripe &stripe, void *ptr, void (*deleter)(void *));
+    void reclaim(Stripe &stripe);
+    void tryAdvanceEpoch();
+    static unsigned threadHint();
+};
+
+template <typename KeyType, typename ValueType>
+MyConcurrentHashMap<KeyType, ValueType>::MyConcurrentHashMap() {
+    init(0, DEFAULT_STRIPES);
+}
+
+template <typename KeyType, typename ValueType>
+MyConcurrentHashMap<KeyType, ValueType>::MyConcurrentHashMap(int expectedSize, int nStripes) {
+    init(expectedSize, nStripes);
+}
+
+/*
+ * Implementation notes: init
+ * --------------------------
+ * The expected entries are spread evenly over the stripes, and every stripe
+ * gets enough buckets to hold its share with a load factor of at most one.
+ */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::init(int expectedSize, int stripeCount) {
+    nStripes = 1;
+    while(nStripes < stripeCount && nStripes < MAX_STRIPES) {
+        nStripes *= 2;
+    }
+    int perStripe = (expectedSize + nStripes - 1) / nStripes;
+    int nBuckets = bucketCountFor(perStripe);
+    minBuckets = nBuckets;
+
+    stripes = new Stripe[nStripes];
+    for(int i = 0; i < nStripes; ++i) {
+        stripes[i].table.store(newTable(nBuckets), std::memory_order_relaxed);
+        stripes[i].count.store(0, std::memory_order_relaxed);
+        stripes[i].threshold = nBuckets;
+        stripes[i].reclaimAt = RECLAIM_BATCH;
+    }
+    globalEpoch.store(1, std::memory_order_relaxed);
+    for(int i = 0; i < MAX_READERS; ++i) {
+        readers[i].epoch.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+MyConcurrentHashMap<KeyType, ValueType>::~MyConcurrentHashMap() {
+    for(int i = 0; i < nStripes; ++i) {
+        deleteTable(stripes[i].table.load(std::memory_order_acquire));
+        MyVector<Retired> &retired = stripes[i].retired;
+        for(int j = 0; j < retired.size(); ++j) {
+            retired[j].deleter(retired[j].ptr);
+        }
+    }
+    delete [] stripes;
+}
+
+template <typename KeyType, typename ValueType>
+typename MyConcurrentHashMap<KeyType, ValueType>::Stripe & MyConcurrentHashMap<KeyType, ValueType>::stripeOf(unsigned long long hash) const {
+    return stripes[(hash >> 32) & (unsigned long long)(nStripes - 1)];
+}
+
+template <typename KeyType, typename ValueType>
+int MyConcurrentHashMap<KeyType, ValueType>::bucketCountFor(int n) {
+    int nBuckets = INITIAL_BUCKET_COUNT;
+    while(nBuckets < n && nBuckets < (1 << 30)) {
+        nBuckets *= 2;
+    }
+    return nBuckets;
+}
+
+template <typename KeyType, typename ValueType>
+int MyConcurrentHashMap<KeyType, ValueType>::bucketOf(unsigned long long hash, const Table *table) {
+    return int(hash & (unsigned long long)(table->nBuckets - 1));
+}
+
+template <typename KeyType, typename ValueType>
+typename MyConcurrentHashMap<KeyType, ValueType>::Table * MyConcurrentHashMap<KeyType, ValueType>::newTable(int nBuckets) {
+    Table *table = new Table;
+    table->nBuckets = nBuckets;
+    try {
+        table->buckets = new std::atomic<Node *>[nBuckets];
+    }
+    catch(...) {
+        delete table;
+        throw;
+    }
+    for(int i = 0; i < nBuckets; ++i) {
+        table->buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+/* 释放一个表以及仍然挂在它上面的所有结点 */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::deleteTable(void *ptr) {
+    Table *table = static_cast<Table *>(ptr);
+    for(int i = 0; i < table->nBuckets; ++i) {
+        Node *p = table->buckets[i].load(std::memory_order_relaxed);
+        while(p != nullptr) {
+            Node *next = p->next.load(std::memory_order_relaxed);
+            delete p;
+            p = next;
+        }
+    }
+    delete [] table->buckets;
+    delete table;
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::deleteNode(void *ptr) {
+    delete static_cast<Node *>(ptr);
+}
+
+/*
+ * Implementation notes: tryGet
+ * ----------------------------
+ * The reader only performs acquire loads along the chain. It either sees a
+ * replaced node or its replacement, never a half-written one, and the
+ * ReadGuard keeps whatever it sees alive until the value has been copied.
+ */
+template <typename KeyType, typename ValueType>
+bool MyConcurrentHashMap<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) const {
+    unsigned long long hash = hashCode(key);
+    const Stripe &stripe = stripeOf(hash);
+    ReadGuard guard(*this);
+    const Table *table = stripe.table.load(std::memory_order_acquire);
+    Node *p = table->buckets[bucketOf(hash, table)].load(std::memory_order_acquire);
+    while(p != nullptr) {
+        if(p->hash == hash && p->key == key) {
+            out = p->value;
+            return true;
+        }
+        p = p->next.load(std::memory_order_acquire);
+    }
+    return false;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyConcurrentHashMap<KeyType, ValueType>::get(const KeyType &key) const {
+    ValueType value = ValueType();
+    tryGet(key, value);
+    return value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyConcurrentHashMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    unsigned long long hash = hashCode(key);
+    const Stripe &stripe = stripeOf(hash);
+    ReadGuard guard(*this);
+    const Table *table = stripe.table.load(std::memory_order_acquire);
+    Node *p = table->buckets[bucketOf(hash, table)].load(std::memory_order_acquire);
+    while(p != nullptr) {
+        if(p->hash == hash && p->key == key) return true;
+        p = p->next.load(std::memory_order_acquire);
+    }
+    return false;
+}
+
+template <typename KeyType, typename ValueType>
+std::atomic<typename MyConcurrentHashMap<KeyType, ValueType>::Node *> * MyConcurrentHashMap<KeyType, ValueType>::findLink(Table *table, const KeyType &key, unsigned long long hash) {
+    std::atomic<Node *> *link = &table->buckets[bucketOf(hash, table)];
+    Node *p = link->load(std::memory_order_relaxed);
+    while(p != nullptr && (p->hash != hash || p->key != key)) {
+        link = &p->next;
+        p = link->load(std::memory_order_relaxed);
+    }
+    return link;
+}
+
+/*
+ * Implementation notes: insertOrReplace
+ * -------------------------------------
+ * The new node is fully constructed, including its next pointer, before a
+ * single release store makes it reachable. A replaced node stays linked to
+ * its successor, so a reader that is standing on it can still walk on.
+ */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::insertOrReplace(Stripe &stripe, std::atomic<Node *> *link, const KeyType &key,
+                                                             const ValueType &value, unsigned long long hash) {
+    Node *old = link->load(std::memory_order_relaxed);
+    if(old != nullptr) {
+        Node *node = new Node(key, value, hash, old->next.load(std::memory_order_relaxed));
+        link->store(node, std::memory_order_release);
+        retire(stripe, old, deleteNode);
+        return;
+    }
+
+    Table *table = stripe.table.load(std::memory_order_relaxed);
+    std::atomic<Node *> &head = table->buckets[bucketOf(hash, table)];
+    Node *node = new Node(key, value, hash, head.load(std::memory_order_relaxed));
+    head.store(node, std::memory_order_release);
+    int count = stripe.count.load(std::memory_order_relaxed) + 1;
+    stripe.count.store(count, std::memory_order_relaxed);
+    if(count > stripe.threshold) {
+        Table *current = stripe.table.load(std::memory_order_relaxed);
+        if(current->nBuckets < (1 << 30)) resize(stripe, current->nBuckets * 2);
+    }
+}
+
+/*
+ * Implementation notes: resize
+ * ----------------------------
+ * Nodes cannot be relinked into the new table in place, because readers of
+ * the old table would then follow next pointers into the wrong chains. So
+ * the stripe is copied into a table of the new size (twice as large when
+ * it grows, about twice its entries when it shrinks), published with one
+ * release store, and the old table retires together with its nodes.
+ * Readers never wait; writers of this stripe wait for the copy. If memory
+ * runs out while copying, the stripe simply keeps its old table. Any other
+ * exception, such as one from the key or value copy constructor, is passed
+ * on after the partial copy is freed; the stripe keeps its old table then
+ * too, and the insert or remove that triggered the resize has already
+ * taken effect.
+ */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::resize(Stripe &stripe, int nBuckets) {
+    Table *old = stripe.table.load(std::memory_order_relaxed);
+
+    Table *table = nullptr;
+    try {
+        table = newTable(nBuckets);
+        for(int i = 0; i < old->nBuckets; ++i) {
+            for(Node *p = old->buckets[i].load(std::memory_order_relaxed); p != nullptr;
+                p = p->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node *> &head = table->buckets[bucketOf(p->hash, table)];
+                head.store(new Node(p->key, p->value, p->hash, head.load(std::memory_order_relaxed)),
+                           std::memory_order_relaxed);
+            }
+        }
+    }
+    catch(std::bad_alloc &) {
+        if(table != nullptr) deleteTable(table);
+        return;
+    }
+    catch(...) {
+        if(table != nullptr) deleteTable(table);
+        throw;
+    }
+    stripe.table.store(table, std::memory_order_release);
+    stripe.threshold = table->nBuckets;
+    retire(stripe, old, deleteTable);
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::put(const KeyType &key, const ValueType &value) {
+    unsigned long long hash = hashCode(key);
+    Stripe &stripe = stripeOf(hash);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    std::atomic<Node *> *link = findLink(stripe.table.load(std::memory_order_relaxed), key, hash);
+    insertOrReplace(stripe, link, key, value, hash);
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::remove(const KeyType &key) {
+    unsigned long long hash = hashCode(key);
+    Stripe &stripe = stripeOf(hash);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    std::atomic<Node *> *link = findLink(stripe.table.load(std::memory_order_relaxed), key, hash);
+    Node *node = link->load(std::memory_order_relaxed);
+    if(node == nullptr) return;
+    link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+    int count = stripe.count.load(std::memory_order_relaxed) - 1;
+    stripe.count.store(count, std::memory_order_relaxed);
+    retire(stripe, node, deleteNode);
+
+    // 扩容在条目数超过篮子数时发生，这里不足1/4才缩小，缩小后离两个阈值都很远
+    int nBuckets = stripe.table.load(std::memory_order_relaxed)->nBuckets;
+    if(nBuckets > minBuckets && count < nBuckets / 4) {
+        int target = bucketCountFor(count * 2);
+        resize(stripe, target > minBuckets ? target : minBuckets);
+    }
+}
+
+/*
+ * Implementation notes: computeIfAbsent
+ * -------------------------------------
+ * The common case, a key that is already present, is answered by the
+ * lock-free lookup. Only a miss takes the stripe lock, and it looks the key
+ * up again there, because another thread may have inserted it meanwhile.
+ */
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+ValueType MyConcurrentHashMap<KeyType, ValueType>::computeIfAbsent(const KeyType &key, Fn fn) {
+    ValueType value;
+    if(tryGet(key, value)) {
+        return value;
+    }
+
+    unsigned long long hash = hashCode(key);
+    Stripe &stripe = stripeOf(hash);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    std::atomic<Node *> *link = findLink(stripe.table.load(std::memory_order_relaxed), key, hash);
+    Node *node = link->load(std::memory_order_relaxed);
+    if(node != nullptr) {
+        return node->value;
+    }
+    value = fn(key);
+    insertOrReplace(stripe, link, key, value, hash);
+    return value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+ValueType MyConcurrentHashMap<KeyType, ValueType>::merge(const KeyType &key, const ValueType &value, Fn combine) {
+    unsigned long long hash = hashCode(key);
+    Stripe &stripe = stripeOf(hash);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    std::atomic<Node *> *link = findLink(stripe.table.load(std::memory_order_relaxed), key, hash);
+    Node *node = link->load(std::memory_order_relaxed);
+    ValueType merged = (node == nullptr) ? value : combine(node->value, value);
+    insertOrReplace(stripe, link, key, merged, hash);
+    return merged;
+}
+
+template <typename KeyType, typename ValueType>
+int MyConcurrentHashMap<KeyType, ValueType>::size() const {
+    int n = 0;
+    for(int i = 0; i < nStripes; ++i) {
+        n += stripes[i].count.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyConcurrentHashMap<KeyType, ValueType>::isEmpty() const {
+    return size() == 0;
+}
+
+/*
+ * Implementation notes: clear
+ * ---------------------------
+ * Each stripe swaps in an empty table of the initial size and retires the
+ * old one; the stripes are cleared one after another, each under its own lock.
+ */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::clear() {
+    for(int i = 0; i < nStripes; ++i) {
+        Stripe &stripe = stripes[i];
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        Table *old = stripe.table.load(std::memory_order_relaxed);
+        stripe.table.store(newTable(minBuckets), std::memory_order_release);
+        stripe.count.store(0, std::memory_order_relaxed);
+        stripe.threshold = minBuckets;
+        retire(stripe, old, deleteTable);
+    }
+}
+
+/*
+ * Implementation notes: compact
+ * -----------------------------
+ * A stripe whose table is larger than its entries need is copied into a
+ * smaller one, exactly as remove would. Then whatever has piled up on the
+ * retired list is reclaimed; the table that was just retired stays until
+ * the readers that may still see it are done, like every retired object.
+ */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::compact() {
+    for(int i = 0; i < nStripes; ++i) {
+        Stripe &stripe = stripes[i];
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        int target = bucketCountFor(stripe.count.load(std::memory_order_relaxed));
+        if(target < stripe.table.load(std::memory_order_relaxed)->nBuckets) {
+            resize(stripe, target);
+        }
+        reclaim(stripe);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyConcurrentHashMap<KeyType, ValueType>::keys() const {
+    MyVector<KeyType> keys;
+    ReadGuard guard(*this);
+    for(int i = 0; i < nStripes; ++i) {
+        const Table *table = stripes[i].table.load(std::memory_order_acquire);
+        for(int b = 0; b < table->nBuckets; ++b) {
+            for(Node *p = table->buckets[b].load(std::memory_order_acquire); p != nullptr;
+                p = p->next.load(std::memory_order_acquire)) {
+                keys.add(p->key);
+            }
+        }
+    }
+    return keys;
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
+    ReadGuard guard(*this);
+    for(int i = 0; i < nStripes; ++i) {
+        const Table *table = stripes[i].table.load(std::memory_order_acquire);
+        for(int b = 0; b < table->nBuckets; ++b) {
+            for(Node *p = table->buckets[b].load(std::memory_order_acquire); p != nullptr;
+                p = p->next.load(std::memory_order_acquire)) {
+                fn(p->key, p->value);
+            }
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyConcurrentHashMap<KeyType, ValueType>::toString() const {
+    std::ostringstream oss;
+    ReadGuard guard(*this);
+    for(int i = 0; i < nStripes; ++i) {
+        const Table *table = stripes[i].table.load(std::memory_order_acquire);
+        for(int b = 0; b < table->nBuckets; ++b) {
+            for(Node *p = table->buckets[b].load(std::memory_order_acquire); p != nullptr;
+                p = p->next.load(std::memory_order_acquire)) {
+                oss << "{" << p->key << ": " << p->value << "}";
+            }
+        }
+    }
+    return oss.str();
+}
+
+template <typename KeyType, typename ValueType>
+std::ostream & operator<<(std::ostream &os, const MyConcurrentHashMap<KeyType, ValueType> &map) {
+    return os << map.toString();
+}
+
+/*
+ * Implementation notes: threadHint
+ * --------------------------------
+ * Every thread starts its search for a free reader slot at a different
+ * place, so threads normally find their own slot free at the first try and
+ * readers on different cores do not write to the same cache line.
+ */
+template <typename KeyType, typename ValueType>
+unsigned MyConcurrentHashMap<KeyType, ValueType>::threadHint() {
+    static std::atomic<unsigned> nextThread(0);
+    static thread_local unsigned hint = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return hint;
+}
+
+/*
+ * Implementation notes: pinReader, unpinReader
+ * --------------------------------------------
+ * The slot is claimed with a compare-and-swap from 0, so two threads never
+ * share one. After announcing an epoch the reader loads the global epoch
+ * again (all sequentially consistent) and repeats until both agree: from
+ * then on, no writer can advance the epoch twice without seeing the slot.
+ * If all MAX_READERS slots are busy, the reader spins until one is freed.
+ */
+template <typename KeyType, typename ValueType>
+int MyConcurrentHashMap<KeyType, ValueType>::pinReader() const {
+    int slot = int(threadHint() & (MAX_READERS - 1));
+    while(true) {
+        unsigned long long epoch = globalEpoch.load();
+        unsigned long long expected = 0;
+        if(readers[slot].epoch.compare_exchange_strong(expected, epoch)) {
+            unsigned long long now;
+            while((now = globalEpoch.load()) != epoch) {
+                readers[slot].epoch.store(now);
+                epoch = now;
+            }
+            return slot;
+        }
+        slot = (slot + 1) & (MAX_READERS - 1);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::unpinReader(int slot) const {
+    readers[slot].epoch.store(0, std::memory_order_release);
+}
+
+/*
+ * Implementation notes: retire, reclaim
+ * -------------------------------------
+ * The fence orders the unlinking store before the load of the epoch used
+ * as the tag. Retired objects are collected per stripe, under the stripe
+ * lock, and looked at again once RECLAIM_BATCH more have piled up; if a
+ * slow reader keeps some of them alive, the next attempt waits for twice
+ * as many, so a write never rescans the list on every call.
+ */
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::retire(Stripe &stripe, void *ptr, void (*deleter)(void *)) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Retired r = {ptr, deleter, globalEpoch.load()};
+    stripe.retired.add(r);
+    if(stripe.retired.size() >= stripe.reclaimAt) {
+        reclaim(stripe);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::reclaim(Stripe &stripe) {
+    tryAdvanceEpoch();
+    unsigned long long epoch = globalEpoch.load();
+    MyVector<Retired> keep;
+    for(int i = 0; i < stripe.retired.size(); ++i) {
+        Retired &r = stripe.retired[i];
+        if(r.epoch + 2 <= epoch) {
+            r.deleter(r.ptr);
+        }
+        else {
+            keep.add(r);
+        }
+    }
+    stripe.retired = keep;
+    stripe.reclaimAt = (keep.size() * 2 > RECLAIM_BATCH) ? keep.size() * 2 : RECLAIM_BATCH;
+}
+
+template <typename KeyType, typename ValueType>
+void MyConcurrentHashMap<KeyType, ValueType>::tryAdvanceEpoch() {
+    unsigned long long epoch = globalEpoch.load();
+    for(int i = 0; i < MAX_READERS; ++i) {
+        unsigned long long seen = readers[i].epoch.load();
+        if(seen != 0 && seen != epoch) return;
+    }
+    globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+}
+
+#endif // _myconcurrenthashmap_h
@@ -0,0 +1 @@
+g++ -std=c++11 -pthread -o main main.cpp
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+#include "myconcurrentvector.h"
+using namespace std;
+
+int main() {
+    MyConcurrentVector<string> words;
+    assert(words.isEmpty());
+    assert(words.add("A") == 0);
+    assert(words.add("B") == 1);
+    assert(words.size() == 2);
+    assert(words.get(1) == "B");
+    assert(words[0] == "A");
+    assert(!words.isPublished(2));
+    cout << words << endl;
+
+    // The reference stays valid while the vector keeps growing.
+    const string &first = words[0];
+    for(int i = 0; i < 1000; ++i) {
+        words.add("X");
+    }
+    assert(first == "A");
+
+    MyConcurrentVector<int> numbers;
+    const int nThreads = 4, perThread = 50000;
+    vector<thread> producers;
+    for(int t = 0; t < nThreads; ++t) {
+        producers.push_back(thread([&numbers, t]() {
+            for(int i = 0; i < perThread; ++i) {
+                numbers.add(t * perThread + i);
+            }
+        }));
+    }
+    for(int t = 0; t < nThreads; ++t) {
+        producers[t].join();
+    }
+
+    assert(numbers.size() == nThreads * perThread);
+    vector<bool> seen(nThreads * perThread, false);
+    for(int i = 0; i < numbers.size(); ++i) {
+        assert(numbers.isPublished(i));
+        assert(!seen[numbers[i]]);
+        seen[numbers[i]] = true;
+    }
+    cout << "Class MyConcurrentVector unit test succeed." << endl;
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * File: myconcurrentvector.h
+ * --------------------------
+ * 该类是一个只追加（append-only）的并发向量，允许多个生产者线程同时调用 add。
+ * add 通过原子操作预留下标，不需要任何锁；存储空间按段（segment）增长，
+ * 第 k 段的大小是第 0 段的 2^k 倍，已有元素永远不会被移动，所以读者可以在
+ * 写者继续追加的同时读取已经发布（published）的下标。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: add先检查容量再预留下标，向量已满时不再把预留的下标计入size()。
+ */
+
+#ifndef _myconcurrentvector_h
+#define _myconcurrentvector_h
+
+#include <atomic>
+#include <climits>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+template <typename ValueType>
+class MyConcurrentVector {
+public:
+    /*
+     * Constructor: MyConcurrentVector
+     * Usage: MyConcurrentVector<ValueType> vec;
+     * -----------------------------------------
+     * Initializes a new empty vector. No segment is allocated until the
+     * first call to add.
+     */
+    MyConcurrentVector();
+
+    /*
+     * Destructor: ~MyConcurrentVector
+     * Usage: (usually implicit)
+     * -------------------------
+     * Destroys the published elements and frees every segment. The caller
+     * must make sure no other thread is still using the vector.
+     */
+    ~MyConcurrentVector();
+
+    /*
+     * Method: add
+     * Usage: int index = vec.add(value);
+     * ----------------------------------
+     * Appends value and returns the index it was stored at. This method may
+     * be called from any number of threads at the same time. The element
+     * becomes visible to readers once add returns. Throws std::length_error,
+     * without reserving a slot, when the vector is full.
+     */
+    int add(const ValueType &value);
+
+    /*
+     * Method: size
+     * Usage: int n = vec.size();
+     * --------------------------
+     * Returns the number of slots reserved so far. While producers are still
+     * running, some of these slots may not be published yet. If copying a
+     * value or allocating its segment throws inside add, the slot reserved
+     * for it is abandoned: it is still counted here but is never published.
+     */
+    int size() const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if(vec.isEmpty()) . . .
+     * ------------------------------
+     * Returns true if no element has been added.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: isPublished
+     * Usage: if(vec.isPublished(index)) . . .
+     * ---------------------------------------
+     * Returns true if the element at index has been completely written and
+     * may be read.
+     */
+    bool isPublished(int index) const;
+
+    /*
+     * Method: get
+     * Usage: ValueType value = vec.get(index);
+     * ----------------------------------------
+     * Returns the element at the specified index. This method signals an
+     * error if the index has not been published.
+     */
+    ValueType get(int index) const;
+
+    /*
+     * Operator: []
+     * Usage: vec[index]
+     * -----------------
+     * Returns a reference to a published element. Elements never move, so
+     * the reference stays valid for the lifetime of the vector.
+     */
+    const ValueType & operator[](int index) const;
+
+    /*
+     * Method: mapAll
+     * Usage: vec.mapAll(fn);
+     * ----------------------
+     * Calls fn on every published element in order of ascending index.
+     */
+    void mapAll(void (*fn) (const ValueType &)) const;
+
+    /*
+     * Method: toString
+     * Usage: vec.toString();
+     * ----------------------
+     * Returns a printable string representation of the published elements,
+     * such as "{value1, value2, value3}".
+     */
+    std::string toString() const;
+
+    /* The vector owns its segments and is not copyable. */
+    MyConcurrentVector(const MyConcurrentVector<ValueType> &src) = delete;
+    MyConcurrentVector<ValueType> & operator=(const MyConcurrentVector<ValueType> &src) = delete;
+
+    /*
+     * Notes on the representation
+     * ---------------------------
+     * Slot i of the vector lives in segment k = log2(i / FIRST_SEGMENT_SIZE + 1).
+     * Segment k holds FIRST_SEGMENT_SIZE << k slots and is allocated by the first
+     * producer that reserves an index inside it; concurrent allocations race
+     * with compare_exchange and the loser frees its copy. Each slot carries a
+     * ready flag that is set with release semantics after the value has been
+     * constructed, so readers that observe it with acquire semantics see the
+     * complete element.
+     */
+private:
+    static const int FIRST_SEGMENT_BITS = 4;
+    static const int FIRST_SEGMENT_SIZE = 1 << FIRST_SEGMENT_BITS;
+    static const int MAX_SEGMENTS = 32 - FIRST_SEGMENT_BITS;
+
+    struct Slot {
+        typename std::aligned_storage<sizeof(ValueType), alignof(ValueType)>::type storage;
+        std::atomic<bool> ready;
+
+        Slot() : ready(false) {}
+        ValueType * value() { return reinterpret_cast<ValueType *>(&storage); }
+        const ValueType * value() const { return reinterpret_cast<const ValueType *>(&storage); }
+    };
+
+    std::atomic<int> reserved;
+    std::atomic<Slot *> segments[MAX_SEGMENTS];
+
+    static int segmentOf(int index);
+    static int segmentSize(int segment);
+    static int offsetOf(int index, int segment);
+
+    Slot * ensureSegment(int segment);
+    const Slot * findSlot(int index) const;
+};
+
+template <typename ValueType>
+MyConcurrentVector<ValueType>::MyConcurrentVector() : reserved(0) {
+    for(int i = 0; i < MAX_SEGMENTS; ++i) {
+        segments[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename ValueType>
+MyConcurrentVector<ValueType>::~MyConcurrentVector() {
+    for(int k = 0; k < MAX_SEGMENTS; ++k) {
+        Slot *segment = segments[k].load(std::memory_order_acquire);
+        if(segment == nullptr) continue;
+        for(int i = 0; i < segmentSize(k); ++i) {
+            if(segment[i].ready.load(std::memory_order_relaxed)) {
+                segment[i].value()->~ValueType();
+            }
+        }
+        delete [] segment;
+    }
+}
+
+/*
+ * Implementation notes: segmentOf, offsetOf
+ * -----------------------------------------
+ * Adding FIRST_SEGMENT_SIZE to the index turns the segment boundaries into
+ * powers of two, so the segment number is the position of the highest set
+ * bit and the offset is what remains below it.
+ */
+template <typename ValueType>
+int MyConcurrentVector<ValueType>::segmentOf(int index) {
+    unsigned j = unsigned(index) + FIRST_SEGMENT_SIZE;
+    int high = 0;
+#if defined(__GNUC__)
+    high = 31 - __builtin_clz(j);
+#else
+    while(j >>= 1) high++;
+#endif
+    return high - FIRST_SEGMENT_BITS;
+}
+
+template <typename ValueType>
+int MyConcurrentVector<ValueType>::segmentSize(int segment) {
+    return FIRST_SEGMENT_SIZE << segment;
+}
+
+template <typename ValueType>
+int MyConcurrentVector<ValueType>::offsetOf(int index, int segment) {
+    return index + FIRST_SEGMENT_SIZE - segmentSize(segment);
+}
+
+template <typename ValueType>
+typename MyConcurrentVector<ValueType>::Slot * MyConcurrentVector<ValueType>::ensureSegment(int segment) {
+    Slot *current = segments[segment].load(std::memory_order_acquire);
+    if(current != nullptr) return current;
+
+    Slot *fresh = new Slot[segmentSize(segment)];
+    if(segments[segment].compare_exchange_strong(current, fresh, std::memory_order_acq_rel)) {
+        return fresh;
+    }
+    delete [] fresh;            // another producer installed the segment first
+    return current;
+}
+
+template <typename ValueType>
+const typename MyConcurrentVector<ValueType>::Slot * MyConcurrentVector<ValueType>::findSlot(int index) const {
+    if(index < 0 || index >= reserved.load(std::memory_order_acquire)) return nullptr;
+    int k = segmentOf(index);
+    const Slot *segment = segments[k].load(std::memory_order_acquire);
+    if(segment == nullptr) return nullptr;
+    const Slot *slot = &segment[offsetOf(index, k)];
+    return slot->ready.load(std::memory_order_acquire) ? slot : nullptr;
+}
+
+/*
+ * Implementation notes: add
+ * -------------------------
+ * The compare-and-swap loop hands every producer its own index, so producers
+ * never write to the same slot, and it checks the capacity before reserving,
+ * so a full vector never counts a slot that nobody will fill. The value is
+ * constructed in place before the ready flag is published.
+ */
+template <typename ValueType>
+int MyConcurrentVector<ValueType>::add(const ValueType &value) {
+    int index = reserved.load(std::memory_order_relaxed);
+    do {
+        if(index > INT_MAX - FIRST_SEGMENT_SIZE) throw std::length_error("add: the vector is full.");
+    } while(!reserved.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+
+    int k = segmentOf(index);
+    Slot &slot = ensureSegment(k)[offsetOf(index, k)];
+    new (&slot.storage) ValueType(value);
+    slot.ready.store(true, std::memory_order_release);
+    return index;
+}
+
+template <typename ValueType>
+int MyConcurrentVector<ValueType>::size() const {
+    return reserved.load(std::memory_order_acquire);
+}
+
+template <typename ValueType>
+bool MyConcurrentVector<ValueType>::isEmpty() const {
+    return size() == 0;
+}
+
+template <typename ValueType>
+bool MyConcurrentVector<ValueType>::isPublished(int index) const {
+    return findSlot(index) != nullptr;
+}
+
+template <typename ValueType>
+ValueType MyConcurrentVector<ValueType>::get(int index) const {
+    const Slot *slot = findSlot(index);
+    if(slot == nullptr) throw std::out_of_range("get: the index is not published.");
+    return *slot->value();
+}
+
+template <typename ValueType>
+const ValueType & MyConcurrentVector<ValueType>::operator[](int index) const {
+    const Slot *slot = findSlot(index);
+    if(slot == nullptr) throw std::out_of_range("operator []: the index is not published.");
+    return *slot->value();
+}
+
+template <typename ValueType>
+void MyConcurrentVector<ValueType>::mapAll(void (*fn) (const ValueType &)) const {
+    int n = size();
+    for(int i = 0; i < n; ++i) {
+        const Slot *slot = findSlot(i);
+        if(slot != nullptr) {
+            fn(*slot->value());
+        }
+    }
+}
+
+template <typename ValueType>
+std::string MyConcurrentVector<ValueType>::toString() const {
+    std::ostringstream oss;
+    oss << "{";
+    bool first = true;
+    int n = size();
+    for(int i = 0; i < n; ++i) {
+        const Slot *slot = findSlot(i);
+        if(slot == nullptr) continue;
+        if(!first) {
+            oss << ", ";
+        }
+        oss << *slot->value();
+        first = false;
+    }
+    oss << "}";
+    return oss.str();
+}
+
+template <typename ValueType>
+std::ostream & operator<<(std::ostream &os, const MyConcurrentVector<ValueType> &vec) {
+    return os << vec.toString();
+}
+
+#endif // _myconcurrentvector_h
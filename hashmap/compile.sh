@@ -1 +1 @@
-g++ -std=c++11 -I ../vector -o main main.cpp myhashcode.cpp
+g++ -std=c++11 -pthread -I ../vector -I ../pool/ -o main main.cpp myhashcode.cpp
@@ -1,7 +1,67 @@
 #include <iostream>
 #include <cassert>
+// The unit test also checks the counters that only exist when stats are enabled.
+#define MY_HASHMAP_STATS
 #include "myhashmap.h"
+#include "myfrozenhashmap.h"
+#include "mymappedhashmap.h"
+#include "mybloomfilter.h"
+#include "myhashmultimap.h"
+#include "mypersistenthashmap.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
 using namespace std;
+
+struct Point {
+    int x, y;
+    bool operator==(const Point &p) const { return x == p.x && y == p.y; }
+    bool operator!=(const Point &p) const { return !(*this == p); }
+};
+
+ostream & operator<<(ostream &os, const Point &p) {
+    return os << "(" << p.x << ", " << p.y << ")";
+}
+
+template <>
+struct MyHash<Point> {
+    int operator()(const Point &p) const {
+        return myhashCombine(hashCode(p.x), hashCode(p.y));
+    }
+};
+
+// Only 64 distinct hash codes: probe sequences run far and leave their partitions.
+struct Clustered {
+    int v;
+    bool operator==(const Clustered &c) const { return v == c.v; }
+    bool operator!=(const Clustered &c) const { return !(*this == c); }
+};
+
+ostream & operator<<(ostream &os, const Clustered &c) {
+    return os << c.v;
+}
+
+template <>
+struct MyHash<Clustered> {
+    unsigned long long operator()(const Clustered &c) const {
+        return (unsigned long long)(c.v % 64);
+    }
+};
+
+// Copying throws while failCopies is set: used to check that containers stay consistent.
+struct Fragile {
+    int v;
+    static bool failCopies;
+    Fragile(int v) : v(v) {}
+    Fragile(const Fragile &f) : v(f.v) {
+        if(failCopies) throw runtime_error("copy failed");
+    }
+    Fragile & operator=(const Fragile &f) { v = f.v; return *this; }
+    bool operator==(const Fragile &f) const { return v == f.v; }
+};
+bool Fragile::failCopies = false;
+
 int main() {
     MyHashMap<int, string> mhp;
     mhp.put(1, "A");
@@ -52,6 +112,789 @@ int main() {
     mhp[3] = "C";
     cout << mhp << endl;
     cout << mhp3 << endl;
+
+    // MyHash
+    assert(hashCode(42) != hashCode(43));
+    assert(myhashCode(string(100, 'x')) != myhashCode(string(101, 'x')));
+    unsigned long long oldSeed = myhashSeed();
+    unsigned long long before = hashCode(string("https://example.com/"));
+    myhashUseRandomSeed();
+    assert(hashCode(string("https://example.com/")) != before);
+    myhashSetSeed(oldSeed);
+    assert(hashCode(string("https://example.com/")) == before);
+    assert(hashCode(string("abc")) == myhashCode("abc", 3));
+    assert(hashCode(0.0) == hashCode(-0.0));
+    assert(hashCode(make_pair(1, string("a"))) == hashCode(make_pair(1, string("a"))));
+    MyHashMap<Point, string> points;
+    points.put({1, 2}, "A");
+    points[{3, 4}] = "B";
+    assert(points.get({1, 2}) == "A");
+    assert(!points.containsKey({2, 1}));
+
+    // Cells are relinked, not reallocated, when the table grows.
+    MyHashMap<int, int> growing;
+    int &first = growing[-1];
+    first = 7;
+    for(int i = 0; i < 10000; ++i) {
+        growing[i] = i;
+    }
+    assert(first == 7 && growing[-1] == 7);
+    assert(growing.size() == 10001);
+    for(int i = 0; i < 10000; ++i) {
+        assert(growing[i] == i);
+    }
+
+    // Incremental rehashing keeps both tables consistent while it migrates.
+    MyHashMap<int, int> stepwise, reference;
+    stepwise.setIncrementalRehash(true);
+    bool sawRehashing = false;
+    for(int i = 0; i < 5000; ++i) {
+        stepwise.put(i, i * 2);
+        reference.put(i, i * 2);
+        if(stepwise.isRehashing()) {
+            sawRehashing = true;
+            assert(stepwise.containsKey(i) && stepwise.containsKey(i / 4) == reference.containsKey(i / 4));
+            MyHashMap<int, int> snapshot = stepwise;
+            assert(snapshot == stepwise && !snapshot.isRehashing());
+        }
+        if(i % 3 == 0) {
+            stepwise.remove(i / 2);
+            reference.remove(i / 2);
+        }
+    }
+    assert(sawRehashing);
+    assert(stepwise == reference && stepwise.size() == reference.size());
+    stepwise.setIncrementalRehash(false);
+    assert(!stepwise.isRehashing() && stepwise == reference);
+    stepwise.clear();
+    assert(stepwise.size() == 0 && !stepwise.containsKey(1));
+
+    // Long keys that share a prefix are told apart by their cached hash codes.
+    MyHashMap<string, int> urls;
+    MyHashMap<string, int, MyOpenAddressing> flatUrls;
+    string prefix(200, '/');
+    for(int i = 0; i < 2000; ++i) {
+        urls.put(prefix + to_string(i), i);
+        flatUrls.put(prefix + to_string(i), i);
+    }
+    for(int i = 0; i < 2000; ++i) {
+        assert(urls[prefix + to_string(i)] == i && flatUrls[prefix + to_string(i)] == i);
+    }
+    assert(!urls.containsKey(prefix) && !flatUrls.containsKey(prefix));
+
+    // Cells come from the map's pool; clear() keeps the chunks for reuse.
+    MyPoolStats stats = urls.poolStats();
+    assert(stats.live == 2000 && stats.capacity >= 2000);
+    urls.remove(prefix + "7");
+    assert(urls.poolStats().live == 1999 && urls.poolStats().freeList == 1);
+    urls.clear();
+    assert(urls.size() == 0 && urls.poolStats().live == 0);
+    assert(urls.poolStats().chunks == stats.chunks);
+    urls.put(prefix, 1);
+    assert(urls[prefix] == 1 && urls.poolStats().live == 1);
+
+    // A reserved table never has to grow while it is filled.
+    MyHashMap<int, int> sized(3000);
+    sized.setIncrementalRehash(true);
+    for(int i = 0; i < 3000; ++i) {
+        sized[i] = i;
+        assert(!sized.isRehashing());
+    }
+    sized.reserve(10000);
+    assert(!sized.isRehashing() && sized.size() == 3000 && sized[2999] == 2999);
+    MyVector<pair<int, int>> pairs;
+    for(int i = 0; i < 5000; ++i) {
+        pairs.add(make_pair(i, -i));
+    }
+    sized.putAll(pairs);
+    assert(!sized.isRehashing() && sized.size() == 5000 && sized[10] == -10);
+
+    // Lookups with a C string do not build a temporary std::string.
+    MyHashMap<string, int> words;
+    MyHashMap<string, int, MyOpenAddressing> flatWords;
+    words.put("apple", 1);
+    flatWords.put("apple", 1);
+    const char *apple = "apple";
+    assert(words.containsKey(apple) && flatWords.containsKey(apple));
+    assert(!words.containsKey("plum") && !flatWords.containsKey("plum"));
+    assert(words.get("apple") == 1 && flatWords.get("apple") == 1 && words.get("plum") == 0);
+    *words.find("apple") += 1;
+    *flatWords.find(string("apple")) += 2;
+    assert(words["apple"] == 2 && flatWords["apple"] == 3);
+    assert(words.find("plum") == NULL && flatWords.find("plum") == NULL);
+    words.remove("apple");
+    flatWords.remove(apple);
+    assert(words.isEmpty() && flatWords.isEmpty());
+
+    // Single-probe upserts; get on a missing key returns the default value.
+    MyHashMap<string, int> counts;
+    MyHashMap<string, int, MyOpenAddressing> flatCounts;
+    assert(counts.get("none") == 0 && flatCounts.get(string("none")) == 0);
+    int out = -1;
+    assert(!counts.tryGet("none", out) && !flatCounts.tryGet("none", out) && out == -1);
+    assert(counts.tryEmplace("a", 1).second && !counts.tryEmplace("a", 9).second && counts["a"] == 1);
+    assert(flatCounts.tryEmplace("a", 1).second && !flatCounts.tryEmplace("a", 9).second && flatCounts["a"] == 1);
+    assert(!counts.insertOrAssign("a", 2).second && counts["a"] == 2);
+    assert(!flatCounts.insertOrAssign("a", 2).second && flatCounts["a"] == 2);
+    int calls = 0;
+    auto length = [&calls](const string &k) { calls++; return int(k.size()); };
+    counts.computeIfAbsent("bb", length);
+    counts.computeIfAbsent("bb", length);
+    flatCounts.computeIfAbsent("bb", length);
+    flatCounts.computeIfAbsent("bb", length);
+    assert(calls == 2 && counts["bb"] == 2 && flatCounts["bb"] == 2);
+    auto add = [](int old, int v) { return old + v; };
+    for(int i = 0; i < 1000; ++i) {
+        counts.merge(to_string(i % 10), 1, add);
+        flatCounts.merge(to_string(i % 10), 1, add);
+    }
+    assert(counts.tryGet("3", out) && out == 100 && flatCounts.tryGet("3", out) && out == 100);
+    assert(counts.size() == 12 && flatCounts.size() == 12);
+
+    // Batched lookups agree with find and containsKey, also during an incremental rehash.
+    MyHashMap<int, int> batched;
+    MyHashMap<int, int, MyOpenAddressing> flatBatched;
+    batched.setIncrementalRehash(true);
+    for(int i = 0; i < 3000 && !(i > 100 && batched.isRehashing()); ++i) {
+        batched[i * 3] = i;
+        flatBatched[i * 3] = i;
+    }
+    assert(batched.isRehashing());
+    MyVector<int> probes;
+    for(int i = 0; i < 1000; ++i) {
+        probes.add(i);
+    }
+    MyVector<int *> hits;
+    MyVector<const int *> flatHits;
+    MyVector<bool> found, flatFound;
+    batched.getMany(probes, hits);
+    batched.containsMany(probes, found);
+    const MyHashMap<int, int, MyOpenAddressing> &constFlat = flatBatched;
+    constFlat.getMany(probes, flatHits);
+    constFlat.containsMany(probes, flatFound);
+    assert(hits.size() == 1000 && flatHits.size() == 1000 && found.size() == 1000 && found[0] && found[99] && !found[100]);
+    for(int i = 0; i < 1000; ++i) {
+        assert(hits[i] == batched.find(i) && flatHits[i] == constFlat.find(i));
+        assert(found[i] == batched.containsKey(i) && flatFound[i] == constFlat.containsKey(i));
+        if(hits[i] != NULL) assert(*hits[i] == i / 3 && *flatHits[i] == i / 3);
+    }
+    *hits[3] = -1;
+    assert(batched[3] == -1);
+    batched.getMany(MyVector<int>(), hits);
+    assert(hits.isEmpty());
+
+    // Iterators visit every entry once, also while an incremental rehash is in progress.
+    MyHashMap<int, int> walked;
+    walked.setIncrementalRehash(true);
+    long long keySum = 0;
+    for(int i = 0; i < 3000; ++i) {
+        walked[i] = i * 3;
+        keySum += i;
+        if(walked.isRehashing()) break;
+    }
+    assert(walked.isRehashing());
+    long long seenKeys = 0, seenValues = 0;
+    int seen = 0;
+    for(const int &key : walked) {
+        seenKeys += key;
+        seen++;
+    }
+    for(int value : walked.valuesView()) {
+        seenValues += value;
+    }
+    assert(seen == walked.size() && seenKeys == keySum && seenValues == keySum * 3);
+    for(MyHashMap<int, int>::const_iterator it = walked.begin(); it != walked.end(); ++it) {
+        assert(it.value() == it.key() * 3);
+    }
+    MyHashMap<int, int, MyOpenAddressing> flatWalked;
+    for(int key : walked.keysView()) {
+        flatWalked[key] = walked[key];
+    }
+    flatWalked.remove(0);
+    seen = 0;
+    for(auto it = flatWalked.begin(); it != flatWalked.end(); it++) {
+        assert(*it != 0 && it.value() == flatWalked.get(it.key()));
+        seen++;
+    }
+    assert(seen == flatWalked.size() && flatWalked.values().size() == seen);
+    MyHashMap<int, int> none;
+    assert(none.begin() == none.end() && flatWalked.keysView().begin() != flatWalked.keysView().end());
+
+    // A parallel build gives the same map as putAll, duplicates included.
+    MyVector<pair<int, int>> rows;
+    for(int i = 0; i < 60000; ++i) {
+        rows.add(make_pair((i * 7919) % 40000, i));
+    }
+    MyHashMap<int, int> serial, parallel;
+    MyHashMap<int, int, MyOpenAddressing> flatSerial, flatParallel;
+    for(int i = 0; i < 100; ++i) {
+        serial[-i] = i;
+        parallel[-i] = i;
+        flatSerial[-i] = i;
+        flatParallel[-i] = i;
+    }
+    serial.putAll(rows);
+    parallel.buildParallel(rows, 4);
+    flatSerial.putAll(rows);
+    flatParallel.buildParallel(rows, 4);
+    assert(parallel.size() == 40099 && parallel == serial);
+    assert(flatParallel.size() == 40099 && flatParallel == flatSerial);
+    assert(parallel.poolStats().live == 40099);
+    parallel.remove(0);
+    parallel.clear();
+    assert(parallel.isEmpty() && parallel.poolStats().live == 0);
+    MyVector<pair<Clustered, int>> clusteredRows;
+    for(int i = 0; i < 10000; ++i) {
+        clusteredRows.add(make_pair(Clustered{i % 9000}, i));
+    }
+    MyHashMap<Clustered, int, MyOpenAddressing> clustered;
+    clustered.buildParallel(clusteredRows, 3);
+    assert(clustered.size() == 9000 && clustered.get(Clustered{5}) == 9005 && clustered.get(Clustered{8999}) == 8999);
+    MyHashMap<int, int> few;
+    few.buildParallel(MyVector<pair<int, int>>(10, make_pair(1, 1)), 8);
+    assert(few.size() == 1 && few[1] == 1);
+
+    // A frozen map answers exactly like the map it was built from.
+    MyHashMap<string, int> reference_data;
+    for(int i = 0; i < 20000; ++i) {
+        reference_data.put("key" + to_string(i), i);
+    }
+    MyFrozenHashMap<string, int> frozen(reference_data);
+    assert(frozen.size() == 20000 && !frozen.isEmpty());
+    for(int i = 0; i < 20000; ++i) {
+        assert(frozen.get("key" + to_string(i)) == i);
+    }
+    assert(!frozen.containsKey("key20000") && frozen.get("nope") == 0 && frozen.find("nope") == NULL);
+    const char *key7 = "key7";
+    assert(frozen.containsKey(key7) && *frozen.find(key7) == 7 && frozen.tryGet("key8", out) && out == 8);
+    assert(frozen.bytesUsed() < 20000 * (sizeof(string) + sizeof(int) + 8));
+    MyFrozenHashMap<string, int> frozenCopy = frozen;
+    assert(frozenCopy.get("key123") == 123 && frozenCopy.keys().size() == 20000);
+    MyVector<pair<int, string>> frozenPairs;
+    for(int i = 0; i < 1000; ++i) {
+        frozenPairs.add(make_pair(i % 700, to_string(i)));
+    }
+    MyFrozenHashMap<int, string> small(frozenPairs);
+    assert(small.size() == 700 && small.get(5) == "705" && small.get(699) == "699" && small.get(700) == "");
+    MyHashMap<Clustered, int, MyOpenAddressing> collide;
+    collide.put(Clustered{1}, 1);
+    collide.put(Clustered{65}, 2);
+    bool threw = false;
+    try {
+        MyFrozenHashMap<Clustered, int> bad(collide);
+    }
+    catch(const invalid_argument &) {
+        threw = true;
+    }
+    assert(threw);
+    MyFrozenHashMap<int, int> emptyFrozen{MyVector<pair<int, int>>()};
+    frozenCopy = MyFrozenHashMap<string, int>();
+    assert(emptyFrozen.isEmpty() && !emptyFrozen.containsKey(0) && frozenCopy.toString() == "");
+
+    // MyOpenAddressing
+    MyHashMap<int, string, MyOpenAddressing> flat;
+    flat.put(1, "A");
+    flat.put(2, "B");
+    assert(flat.get(2) == "B");
+    flat[2] = "C";
+    assert(flat[2] == "C");
+    assert(flat.containsKey(1) && !flat.containsKey(3));
+    assert(flat.get(3) == "");
+    MyHashMap<int, string, MyOpenAddressing> flat2 = flat;
+    assert(flat2 == flat);
+    flat2.remove(1);
+    assert(flat2 != flat && flat2.size() == 1);
+    cout << flat << endl;
+
+    MyHashMap<int, int> chained;
+    MyHashMap<int, int, MyOpenAddressing> open;
+    for(int i = 0; i < 20000; ++i) {
+        int key = (i * 7919) % 5003;
+        if(i % 3 == 0) {
+            chained.remove(key);
+            open.remove(key);
+        }
+        else {
+            chained.put(key, i);
+            open[key] = i;
+        }
+    }
+    assert(chained.size() == open.size());
+    MyVector<int> openKeys = open.keys();
+    for(int i = 0; i < openKeys.size(); ++i) {
+        assert(chained.containsKey(openKeys[i]));
+        assert(chained[openKeys[i]] == open.get(openKeys[i]));
+    }
+    open.clear();
+    assert(open.isEmpty() && !open.containsKey(0));
+    MyHashMap<int, int, MyOpenAddressing> openSized(100);
+    openSized.putAll(pairs);
+    openSized.reserve(20000);
+    assert(openSized.size() == 5000 && openSized[4999] == -4999);
+
+    // Snapshots are served straight from the mapping; both engines write the same format.
+    MyHashMap<string, string> named;
+    for(int i = 0; i < 3000; ++i) {
+        named.put("key" + to_string(i), string(i % 37, 'a' + i % 26));
+    }
+    named.saveSnapshot("snapshot_test.snap");
+    {
+        MyMappedHashMap<string, string> mapped("snapshot_test.snap");
+        assert(mapped.size() == 3000 && !mapped.isEmpty());
+        for(int i = 0; i < 3000; ++i) {
+            assert(mapped.get("key" + to_string(i)) == named.get("key" + to_string(i)));
+        }
+        string value = "unchanged";
+        assert(!mapped.containsKey("key3000") && !mapped.tryGet("missing", value) && value == "unchanged");
+        assert(mapped.tryGet("key40", value) && value == string(3, 'a' + 14));
+        bool typeChecked = false;
+        try {
+            MyMappedHashMap<int, int> wrongTypes("snapshot_test.snap");
+        }
+        catch(const invalid_argument &) {
+            typeChecked = true;
+        }
+        assert(typeChecked);
+    }
+    MyHashMap<int, Point, MyOpenAddressing> pointValues;
+    for(int i = 0; i < 1000; ++i) {
+        pointValues.put(i * 3, Point{i, -i});
+    }
+    pointValues.saveSnapshot("snapshot_test.snap");
+    {
+        MyMappedHashMap<int, Point> mapped("snapshot_test.snap");
+        assert(mapped.size() == 1000);
+        for(int i = 0; i < 3000; ++i) {
+            assert(mapped.containsKey(i) == (i % 3 == 0));
+        }
+        assert(mapped.get(2997) == (Point{999, -999}) && mapped.get(1) == (Point{0, 0}));
+        // 大小相同、种类不同的key类型也会被发现
+        bool kindChecked = false;
+        try {
+            MyMappedHashMap<float, Point> wrongKind("snapshot_test.snap");
+        }
+        catch(const invalid_argument &) {
+            kindChecked = true;
+        }
+        assert(kindChecked);
+    }
+    MyHashMap<int, int>().saveSnapshot("snapshot_test.snap");
+    {
+        MyMappedHashMap<int, int> mapped("snapshot_test.snap");
+        assert(mapped.isEmpty() && !mapped.containsKey(0) && mapped.toString() == "");
+    }
+    remove("snapshot_test.snap");
+    bool missingFile = false;
+    try {
+        MyMappedHashMap<int, int> mapped("snapshot_test.snap");
+    }
+    catch(const runtime_error &) {
+        missingFile = true;
+    }
+    assert(missingFile);
+
+    // Stats: occupancy histogram and probe lengths from the table, counters from the lookups.
+    MyHashMap<int, int> measured;
+    MyHashMap<int, int, MyOpenAddressing> measuredFlat;
+    for(int i = 0; i < 1000; ++i) {
+        measured.put(i, i);
+        measuredFlat.put(i, i);
+    }
+    MyHashMapStats chainStats = measured.stats();
+    MyHashMapStats flatStats = measuredFlat.stats();
+    int histogramEntries = 0, histogramBuckets = 0;
+    for(int k = 0; k < chainStats.occupancy.size(); ++k) {
+        histogramEntries += k * chainStats.occupancy[k];
+        histogramBuckets += chainStats.occupancy[k];
+    }
+    assert(histogramEntries == 1000 && histogramBuckets == chainStats.buckets);
+    assert(chainStats.maxProbeLength >= 1 && chainStats.averageProbeLength >= 1.0);
+    assert(chainStats.averageProbeLength <= chainStats.maxProbeLength);
+    assert(chainStats.rehashes > 0 && chainStats.countersEnabled && chainStats.bytesPerEntry > 0);
+    histogramEntries = 0;
+    for(int k = 0; k < flatStats.occupancy.size(); ++k) {
+        histogramEntries += k * flatStats.occupancy[k];
+    }
+    assert(histogramEntries == 1000 && flatStats.occupancy.size() == 17 && flatStats.rehashes > 0);
+    assert(flatStats.loadFactor <= 0.875 && flatStats.averageProbeLength >= 1.0);
+    long long lookupsBefore = measured.stats().lookups;
+    measured.containsKey(5);
+    measured.get(-1);
+    assert(measured.stats().lookups == lookupsBefore + 2 && measured.stats().probes >= chainStats.probes + 1);
+    MyHashMap<Clustered, int> crowded;
+    for(int i = 0; i < 640; ++i) {
+        crowded.put(Clustered{i}, i);
+    }
+    // 64 distinct hash codes: every chain holds 10 cells.
+    MyHashMapStats crowdedStats = crowded.stats();
+    assert(crowdedStats.maxProbeLength == 10 && crowdedStats.averageProbeLength == 5.5);
+    assert(crowdedStats.occupancy[10] == 64);
+    cout << crowdedStats << endl;
+
+    // Shrinking: after a burst the tables follow the live entries back down.
+    MyHashMap<string, int> bursty;
+    MyHashMap<string, int, MyOpenAddressing> burstyFlat;
+    for(int i = 0; i < 20000; ++i) {
+        bursty.put("burst" + to_string(i), i);
+        burstyFlat.put("burst" + to_string(i), i);
+    }
+    int peakBuckets = bursty.stats().buckets, peakSlots = burstyFlat.stats().buckets;
+    for(int i = 100; i < 20000; ++i) {
+        bursty.remove("burst" + to_string(i));
+        burstyFlat.remove("burst" + to_string(i));
+    }
+    // 开放寻址的stats().buckets是16个槽一组的组数
+    assert(bursty.stats().buckets <= 512 && burstyFlat.stats().buckets <= 512 / 16);
+    assert(bursty.stats().buckets < peakBuckets && burstyFlat.stats().buckets < peakSlots);
+    for(int i = 0; i < 100; ++i) {
+        assert(bursty.get("burst" + to_string(i)) == i && burstyFlat.get("burst" + to_string(i)) == i);
+    }
+    // 在缩容之后的边界上交替put、remove不会rehashing
+    long long settledRehashes = bursty.stats().rehashes, settledFlat = burstyFlat.stats().rehashes;
+    for(int i = 0; i < 1000; ++i) {
+        bursty.put("again", i);
+        bursty.remove("again");
+        burstyFlat.put("again", i);
+        burstyFlat.remove("again");
+    }
+    assert(bursty.stats().rehashes == settledRehashes && burstyFlat.stats().rehashes == settledFlat);
+    // compact把Cell搬到紧凑的结点池并释放旧块
+    assert(bursty.poolStats().capacity >= 20000);
+    bursty.compact();
+    burstyFlat.compact();
+    assert(bursty.poolStats().live == 100 && bursty.poolStats().capacity < 200);
+    assert(bursty.stats().buckets == 128 && burstyFlat.stats().buckets == 128 / 16);
+    for(int i = 0; i < 100; ++i) {
+        assert(bursty.get("burst" + to_string(i)) == i && burstyFlat.get("burst" + to_string(i)) == i);
+    }
+    bursty.put("after", 1);
+    assert(bursty.size() == 101 && bursty["after"] == 1);
+    // 增量rehashing时缩容也是渐进的
+    MyHashMap<int, int> gradual;
+    gradual.setIncrementalRehash(true);
+    for(int i = 0; i < 5000; ++i) {
+        gradual.put(i, i);
+    }
+    for(int i = 0; i < 4990; ++i) {
+        gradual.remove(i);
+    }
+    for(int i = 4990; i < 5000; ++i) {
+        assert(gradual.get(i) == i);
+    }
+    assert(gradual.size() == 10 && gradual.stats().buckets <= 64);
+    // clear把表还原为初始大小，但不小于构造时预留的大小
+    bursty.clear();
+    burstyFlat.clear();
+    assert(bursty.stats().buckets == 16 && burstyFlat.stats().buckets == 1);
+    MyHashMap<int, int> presized(4000);
+    MyHashMap<int, int, MyOpenAddressing> presizedFlat(4000);
+    int reservedBuckets = presized.stats().buckets, reservedSlots = presizedFlat.stats().buckets;
+    for(int i = 0; i < 4000; ++i) {
+        presized.put(i, i);
+        presizedFlat.put(i, i);
+    }
+    for(int i = 0; i < 4000; ++i) {
+        presized.remove(i);
+        presizedFlat.remove(i);
+    }
+    assert(presized.stats().buckets == reservedBuckets && presizedFlat.stats().buckets == reservedSlots);
+    presized.clear();
+    assert(presized.stats().buckets == reservedBuckets);
+
+    // Bloom filters never forget an added key; the false positive rate stays near the target.
+    MyBloomFilter<string> plain(10000, 0.01);
+    MyBlockedBloomFilter<string> blocked(10000, 0.01);
+    for(int i = 0; i < 10000; ++i) {
+        plain.add("in" + to_string(i));
+        blocked.add("in" + to_string(i));
+    }
+    int plainHits = 0, blockedHits = 0;
+    for(int i = 0; i < 100000; ++i) {
+        assert(i >= 10000 || (plain.mightContain("in" + to_string(i)) && blocked.mightContain("in" + to_string(i))));
+        plainHits += plain.mightContain("out" + to_string(i));
+        blockedHits += blocked.mightContain("out" + to_string(i));
+    }
+    assert(plainHits < 2000 && blockedHits < 2000);
+    assert(plain.hashCount() == 7 && plain.falsePositiveRate(10000) <= 0.011);
+    assert(blocked.falsePositiveRate(10000) <= 0.01 && blocked.memoryBytes() == blocked.blockCount() * 32);
+    assert(blocked.mightContain("in7") && !MyBlockedBloomFilter<int>(100).mightContain(1));
+    MyBlockedBloomFilter<string> blockedCopy = blocked;
+    blocked.clear();
+    assert(!blocked.mightContain("in0") && blockedCopy.mightContain("in0"));
+    // 内存上限：filter不超过maxBytes，误判率随之升高
+    MyBlockedBloomFilter<int> capped(1000000, 0.001, 4096);
+    MyBloomFilter<int> cappedPlain(1000000, 0.001, 4096);
+    assert(capped.memoryBytes() <= 4096 && cappedPlain.memoryBytes() <= 4096);
+    assert(capped.falsePositiveRate(1000000) > 0.5 && cappedPlain.falsePositiveRate(1000000) > 0.5);
+    capped.reset(10);
+    assert(capped.blockCount() == 1);
+    bool rateChecked = false;
+    try {
+        MyBloomFilter<int> wrongRate(10, 1.5);
+    }
+    catch(const invalid_argument &) {
+        rateChecked = true;
+    }
+    assert(rateChecked);
+
+    // The built-in filter rejects missing keys before the table is probed, through every resize.
+    MyHashMap<string, int> filtered;
+    MyHashMap<string, int, MyOpenAddressing> filteredFlat;
+    filtered.enableBloomFilter(0.01);
+    filteredFlat.enableBloomFilter(0.01);
+    assert(filtered.hasBloomFilter() && !bursty.hasBloomFilter());
+    for(int i = 0; i < 20000; ++i) {
+        filtered.put("key" + to_string(i), i);
+        filteredFlat["key" + to_string(i)] = i;
+    }
+    long long probesBefore = filtered.stats().probes, flatProbesBefore = filteredFlat.stats().probes;
+    for(int i = 0; i < 20000; ++i) {
+        assert(!filtered.containsKey("miss" + to_string(i)) && filteredFlat.find("miss" + to_string(i)) == NULL);
+    }
+    // 没有filter时每次查找至少检查一组，这里只有误判的key才会探测
+    assert(filteredFlat.stats().probes - flatProbesBefore < 1000);
+    assert(filtered.stats().probes - probesBefore < 1000);
+    for(int i = 0; i < 20000; i += 2) {
+        filtered.remove("key" + to_string(i));
+        filteredFlat.remove("key" + to_string(i));
+    }
+    for(int i = 0; i < 19000; ++i) {
+        filtered.remove("key" + to_string(i));
+        filteredFlat.remove("key" + to_string(i));
+    }
+    for(int i = 0; i < 20000; ++i) {
+        assert(filtered.containsKey("key" + to_string(i)) == (i >= 19000 && i % 2 == 1));
+        assert(filteredFlat.get("key" + to_string(i)) == ((i >= 19000 && i % 2 == 1) ? i : 0));
+    }
+    filtered.compact();
+    filteredFlat.compact();
+    MyHashMap<string, int> filteredCopy = filtered;
+    MyHashMap<string, int, MyOpenAddressing> filteredFlatCopy;
+    filteredFlatCopy = filteredFlat;
+    assert(filteredCopy.hasBloomFilter() && filteredCopy.size() == 500 && filteredCopy.get("key19999") == 19999);
+    assert(filteredFlatCopy.hasBloomFilter() && filteredFlatCopy.containsKey("key19001") && !filteredFlatCopy.containsKey("key19000"));
+    MyVector<string> batch;
+    for(int i = 18990; i < 19010; ++i) {
+        batch.add("key" + to_string(i));
+    }
+    MyVector<bool> batchFound;
+    filtered.containsMany(batch, batchFound);
+    for(int j = 0; j < batch.size(); ++j) {
+        assert(batchFound[j] == (18990 + j >= 19000 && j % 2 == 1));
+    }
+    filteredFlat.containsMany(batch, batchFound);
+    for(int j = 0; j < batch.size(); ++j) {
+        assert(batchFound[j] == (18990 + j >= 19000 && j % 2 == 1));
+    }
+    filtered.clear();
+    filteredFlat.clear();
+    assert(!filtered.containsKey("key19999") && !filteredFlat.containsKey("key19999"));
+    // buildParallel和渐进式rehashing之后filter仍然包含所有key
+    MyVector<pair<int, int>> bulkPairs;
+    for(int i = 0; i < 50000; ++i) {
+        bulkPairs.add(make_pair(i * 7, i));
+    }
+    MyHashMap<int, int> filteredBulk;
+    MyHashMap<int, int, MyOpenAddressing> filteredBulkFlat;
+    filteredBulk.enableBloomFilter(0.02, 1 << 16);
+    filteredBulkFlat.enableBloomFilter(0.02);
+    filteredBulk.buildParallel(bulkPairs, 4);
+    filteredBulkFlat.buildParallel(bulkPairs, 4);
+    MyHashMap<int, int> filteredGradual;
+    filteredGradual.setIncrementalRehash(true);
+    filteredGradual.enableBloomFilter();
+    for(int i = 0; i < 50000; ++i) {
+        filteredGradual.put(i * 7, i);
+        assert(filteredGradual.containsKey(i * 7) && !filteredGradual.containsKey(i * 7 + 1));
+    }
+    for(int i = 0; i < 350000; ++i) {
+        bool present = (i % 7 == 0);
+        assert(filteredBulk.containsKey(i) == present && filteredBulkFlat.containsKey(i) == present);
+        assert(filteredGradual.containsKey(i) == present);
+    }
+    assert(filteredBulk.stats().allocatedBytes > bursty.stats().allocatedBytes);
+    filteredBulk.disableBloomFilter();
+    assert(!filteredBulk.hasBloomFilter() && filteredBulk.get(349993) == 49999);
+    // 快照也可以在打开之后加上filter
+    named.saveSnapshot("snapshot_test.snap");
+    {
+        MyMappedHashMap<string, string> mapped("snapshot_test.snap");
+        mapped.enableBloomFilter(0.01);
+        assert(mapped.hasBloomFilter());
+        for(int i = 0; i < 6000; ++i) {
+            assert(mapped.containsKey("key" + to_string(i)) == (i < 3000));
+        }
+        assert(mapped.get("key41") == named.get("key41"));
+    }
+    remove("snapshot_test.snap");
+
+    // 一对多：大多数key只有一两个value，不为它们分配数组
+    MyHashMultiMap<string, int> byTag;
+    MyHashMultiMap<int, string, MyOpenAddressing> byOwner(16);
+    assert(byTag.isEmpty() && byTag.getAll("none").isEmpty() && byTag.count("none") == 0);
+    for(int i = 0; i < 3000; ++i) {
+        byTag.add("tag" + to_string(i % 1000), i);
+        byOwner.add(i % 500, to_string(i));
+    }
+    byTag.add("hot", 1);
+    byTag.add("hot", 2);
+    byTag.add("hot", 1);
+    assert(byTag.size() == 3003 && byTag.keyCount() == 1001 && byOwner.keyCount() == 500);
+    MySpan<int> tagged = byTag.getAll("tag7");
+    assert(tagged.size() == 3 && tagged[0] == 7 && tagged[1] == 1007 && tagged[2] == 2007);
+    assert(byOwner.count(499) == 6 && byOwner.getAll(499)[5] == "2999");
+    assert(byTag.remove("hot", 1) && !byTag.remove("hot", 3) && !byTag.remove("cold", 1));
+    assert(byTag.count("hot") == 2 && byTag.getAll("hot")[0] == 2 && byTag.getAll("hot")[1] == 1);
+    assert(byTag.remove("hot", 2) && byTag.remove("hot", 1) && !byTag.containsKey("hot"));
+    assert(byTag.removeAll("tag7") == 3 && byTag.removeAll("tag7") == 0 && byTag.size() == 2997);
+    for(int k = 0; k < 490; ++k) {
+        assert(byOwner.removeAll(k) == 6);
+    }
+    byOwner.compact();
+    assert(byOwner.size() == 60 && byOwner.keys().size() == 10 && byOwner.getAll(495)[1] == "995");
+    int listed = 0;
+    for(const string &tag : byTag.keys()) {
+        for(int v : byTag.getAll(tag)) {
+            assert("tag" + to_string(v % 1000) == tag);
+            listed++;
+        }
+    }
+    assert(listed == byTag.size());
+    // value复制失败时不会留下没有value的key
+    MyHashMultiMap<int, Fragile> fragile;
+    fragile.add(1, Fragile(10));
+    Fragile::failCopies = true;
+    for(int key = 1; key <= 2; ++key) {
+        bool thrown = false;
+        try {
+            fragile.add(key, Fragile(20));
+        }
+        catch(const runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    Fragile::failCopies = false;
+    assert(!fragile.containsKey(2) && fragile.keyCount() == 1 && fragile.count(1) == 1 && fragile.size() == 1);
+    MyHashMultiMap<int, int> tiny;
+    tiny.add(1, 10);
+    tiny.add(1, 11);
+    assert(tiny.toString() == "{1: {10, 11}}");
+    byTag.clear();
+    assert(byTag.isEmpty() && byTag.keyCount() == 0);
+
+    // 持久化map：复制是O(1)的快照，修改只复制被修改的路径
+    MyPersistentHashMap<string, string> config;
+    assert(config.isEmpty() && config.get("none") == "" && config.begin() == config.end());
+    for(int i = 0; i < 5000; ++i) {
+        config.put("key" + to_string(i), "v" + to_string(i));
+    }
+    config.put("key7", "seven");
+    assert(config.size() == 5000 && config.get("key7") == "seven" && config.get("key4999") == "v4999");
+    MyPersistentHashMap<string, string> request = config;
+    assert(request == config && request.find("key1") == config.find("key1"));
+    request.put("key1", "changed");
+    request.put("extra", "x");
+    request.remove("key2");
+    assert(config.get("key1") == "v1" && !config.containsKey("extra") && config.containsKey("key2"));
+    assert(request.get("key1") == "changed" && request.size() == 5000 && !request.containsKey("key2"));
+    // 没有被修改的条目仍然由两个版本共享
+    assert(request.find("key3000") == config.find("key3000") && request != config);
+    MyPersistentHashMap<string, string> rollback = request;
+    request.put("key1", "again");
+    request = rollback;
+    assert(request.get("key1") == "changed" && request == rollback);
+    MyPersistentHashMap<string, string> next = config.with("key1", "w").without("key8");
+    assert(next.get("key1") == "w" && !next.containsKey("key8") && config.get("key1") == "v1" && config.containsKey("key8"));
+    string value;
+    assert(next.tryGet("key9", value) && value == "v9" && !next.tryGet("key8", value) && value == "v9");
+
+    // 与MyHashMap对照的随机操作，同时保留一系列旧版本，最后检查每个版本都没有被改变
+    MyPersistentHashMap<int, int> versioned;
+    MyHashMap<int, int> model;
+    MyVector<MyPersistentHashMap<int, int>> history;
+    MyVector<MyHashMap<int, int>> expected;
+    srand(42);
+    for(int i = 0; i < 60000; ++i) {
+        int key = rand() % 4000;
+        if(rand() % 3 == 0) {
+            versioned.remove(key);
+            model.remove(key);
+        } else {
+            versioned.put(key, i);
+            model.put(key, i);
+        }
+        if(i % 5000 == 0) {
+            history.add(versioned);
+            expected.add(model);
+        }
+    }
+    MyPersistentHashMap<int, int> converted(model);
+    assert(versioned.size() == model.size() && converted == versioned);
+    for(int v = 0; v < history.size(); ++v) {
+        assert(history[v].size() == expected[v].size());
+        for(MyHashMap<int, int>::const_iterator it = expected[v].begin(); it != expected[v].end(); ++it) {
+            assert(history[v].get(it.key()) == it.value());
+        }
+        int visited = 0;
+        for(int key : history[v]) {
+            assert(expected[v].containsKey(key));
+            visited++;
+        }
+        assert(visited == expected[v].size());
+    }
+    for(int key = 0; key < 4000; ++key) {
+        versioned.remove(key);
+    }
+    assert(versioned.isEmpty() && versioned.begin() == versioned.end() && history[3].size() == expected[3].size());
+
+    // hash Code完全相同的key放在冲突结点中
+    MyPersistentHashMap<Clustered, int> clashing;
+    for(int i = 0; i < 1000; ++i) {
+        clashing.put(Clustered{i}, i);
+    }
+    MyPersistentHashMap<Clustered, int> clashingBefore = clashing;
+    for(int i = 0; i < 1000; i += 2) {
+        clashing.remove(Clustered{i});
+    }
+    clashing.put(Clustered{1}, -1);
+    assert(clashing.size() == 500 && clashing.get(Clustered{1}) == -1 && !clashing.containsKey(Clustered{2}));
+    assert(clashingBefore.size() == 1000 && clashingBefore.get(Clustered{1}) == 1 && clashingBefore.get(Clustered{998}) == 998);
+    assert(clashing.keys().size() == 500 && clashingBefore.values().size() == 1000);
+    for(int i = 1; i < 1000; i += 2) {
+        clashing.remove(Clustered{i});
+    }
+    assert(clashing.isEmpty() && clashingBefore.containsKey(Clustered{999}));
+
+    // 共享结点的不同副本可以在不同的线程中同时修改
+    MyVector<MyPersistentHashMap<int, int>> forks(4, versioned);
+    MyPersistentHashMap<int, int> base;
+    for(int i = 0; i < 20000; ++i) {
+        base.put(i, i);
+    }
+    for(int t = 0; t < 4; ++t) {
+        forks[t] = base;
+    }
+    vector<thread> editors;
+    for(int t = 0; t < 4; ++t) {
+        editors.push_back(thread([&forks, t]() {
+            for(int i = 0; i < 20000; ++i) {
+                if(i % 4 == t) forks[t].remove(i);
+                else forks[t].put(i, i + t);
+            }
+        }));
+    }
+    for(thread &th : editors) {
+        th.join();
+    }
+    for(int t = 0; t < 4; ++t) {
+        assert(forks[t].size() == 15000 && forks[t].get(t + 4) == 0 && forks[t].get(t + 5) == t + 5 + t);
+    }
+    assert(base.size() == 20000 && base.get(12345) == 12345);
+    MyPersistentHashMap<int, string> single;
+    single.put(1, "A");
+    assert(single.toString() == "{1: A}");
+
     cout << "Class MyHashMap unit test succeed." << endl;
 
     return 0;
@@ -0,0 +1,605 @@
+/*
+ * File: mybloomfilter.h
+ * ---------------------
+ * Bloom filter：用很少的内存记录一个集合，回答"某个元素是否可能在集合中"。
+ * 回答"不在"时一定正确；回答"可能在"时有一定的概率是误判（false positive），
+ * 误判率由每个元素占用的位数决定。不支持删除元素。
+ *
+ * 这里有两种实现，都使用myhashcode.h中的hashCode，所以与MyHashMap中保存的hash Code一致：
+ *      MyBloomFilter：经典的Bloom filter，m个位、k个hash函数（由一个hash Code经double hashing得到），
+ *                     k个位分散在整个位数组中，每次查询最多访问k个cache line。
+ *      MyBlockedBloomFilter：分块（split block）Bloom filter，位数组分成32字节的块，
+ *                     每个元素只在一个块中设置8个位（块中的每个32位字各1位），
+ *                     所以每次查询只访问一个cache line；8个字的计算互不依赖，
+ *                     支持AVX2时用一组SIMD指令完成，否则由编译器自动向量化。
+ *                     同样的误判率需要比经典实现多10%～20%的内存。
+ * MyHashMap、MyHashSet和MyMappedHashMap的enableBloomFilter使用MyBlockedBloomFilter。
+ * -------------------------------------------------------------------------------
+ * 参考：https://github.com/apache/parquet-format/blob/master/BloomFilter.md
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ */
+
+#ifndef _mybloomfilter_h
+#define _mybloomfilter_h
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include "myhashcode.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * 函数：mybloomCheckRate
+ * 使用：mybloomCheckRate(expectedItems, falsePositiveRate);
+ * -------------------------------------------------------
+ * 两种filter的构造函数共用的参数检查：expectedItems不能为负，
+ * falsePositiveRate必须在(0, 1)之间，否则抛出std::invalid_argument。
+ */
+inline void mybloomCheckRate(int expectedItems, double falsePositiveRate) {
+    if(expectedItems < 0) {
+        throw std::invalid_argument("Bloom filter: expectedItems must not be negative");
+    }
+    if(!(falsePositiveRate > 0 && falsePositiveRate < 1)) {
+        throw std::invalid_argument("Bloom filter: falsePositiveRate must be in (0, 1)");
+    }
+}
+
+template <typename T>
+class MyBloomFilter {
+public:
+    /*
+     * 方法：MyBloomFilter
+     * 使用：MyBloomFilter<T> filter(expectedItems);
+     *      MyBloomFilter<T> filter(expectedItems, 0.001);
+     *      MyBloomFilter<T> filter(expectedItems, 0.001, 1 << 20);
+     * -----------------------------------------------------------
+     * 构造一个空的filter，大小使加入expectedItems个不同的元素之后误判率约为falsePositiveRate（默认1%）：
+     * m = -n ln(p) / (ln 2)^2个位，k = (m / n) ln 2个hash函数。
+     * maxBytes不为0时位数组最多占用maxBytes字节，超出时按maxBytes分配并重新选择k，
+     * 误判率会高于falsePositiveRate（见falsePositiveRate(n)）。
+     * 参数不合法时抛出std::invalid_argument。
+     */
+    explicit MyBloomFilter(int expectedItems, double falsePositiveRate = 0.01, size_t maxBytes = 0);
+
+    /*
+     * 方法：～MyBloomFilter
+     * 使用：隐式调用
+     * -------------
+     * 释放位数组。
+     */
+    ~MyBloomFilter();
+
+    /*
+     * 方法：add, mightContain
+     * 使用：filter.add(value);
+     *      if(filter.mightContain(value)) ...
+     * ---------------------------------------
+     * add把value加入集合。mightContain返回false时value一定没有被加入过；
+     * 返回true时value可能被加入过，也可能是误判。
+     * 满足MyTransparentLookup的LookupType（例如std::string的C字符串）可以直接查询。
+     */
+    void add(const T &value);
+    bool mightContain(const T &value) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<T, LookupType>::value>::type>
+    bool mightContain(const LookupType &value) const;
+
+    /*
+     * 方法：addHash, mightContainHash
+     * 使用：filter.addHash(hashCode(value));
+     * ------------------------------------
+     * 与add、mightContain相同，但直接使用已经算好的hash Code（例如散列表中保存的），不再计算一次。
+     */
+    void addHash(unsigned long long hash);
+    bool mightContainHash(unsigned long long hash) const;
+
+    /*
+     * 方法：clear
+     * 使用：filter.clear();
+     * --------------------
+     * 清除所有位，大小不变。
+     */
+    void clear();
+
+    /*
+     * 方法：bitCount, hashCount, memoryBytes
+     * 使用：size_t m = filter.bitCount();
+     * ---------------------------------
+     * 返回位数m、hash函数的个数k以及位数组占用的字节数。
+     */
+    size_t bitCount() const;
+    int hashCount() const;
+    size_t memoryBytes() const;
+
+    /*
+     * 方法：falsePositiveRate
+     * 使用：double p = filter.falsePositiveRate(n);
+     * -------------------------------------------
+     * 加入n个不同的元素之后，查询一个没有加入过的元素时误判的概率：(1 - e^(-kn/m))^k。
+     */
+    double falsePositiveRate(int n) const;
+
+    /*
+     * 拷贝构造函数和赋值操作符
+     * 使用：MyBloomFilter<T> f2 = f1;
+     * ------------------------------
+     * 复制位数组，两个filter之后互相独立。
+     */
+    MyBloomFilter(const MyBloomFilter<T> &src);
+    MyBloomFilter<T> & operator= (const MyBloomFilter<T> &src);
+
+private:
+    /* k的上限：更多的hash函数只会让查询更慢，误判率几乎不再下降 */
+    static const int MAX_HASHES = 16;
+
+    unsigned long long *bits;   // 位数组，nWords个64位字
+    size_t nBits;
+    size_t nWords;
+    int nHashes;
+};
+
+/*
+ * 实现笔记：MyBloomFilter
+ * ---------------------
+ * double hashing（Kirsch-Mitzenmacher）：第i个位置是(h1 + i * h2) mod m，h1是hash Code，
+ * h2是对它再混合一次得到的奇数，k个hash函数只需要计算一次hashCode(value)。
+ */
+template <typename T>
+MyBloomFilter<T>::MyBloomFilter(int expectedItems, double falsePositiveRate, size_t maxBytes) {
+    mybloomCheckRate(expectedItems, falsePositiveRate);
+    double n = expectedItems > 0 ? expectedItems : 1;
+    double ln2 = std::log(2.0);
+    double m = std::ceil(-n * std::log(falsePositiveRate) / (ln2 * ln2));
+    if(m < 64) m = 64;
+    if(maxBytes > 0 && m > double(maxBytes) * 8) m = double(maxBytes) * 8;
+    nWords = (size_t(m) + 63) / 64;
+    if(nWords == 0) nWords = 1;
+    nBits = nWords * 64;
+    nHashes = int(std::round(double(nBits) / n * ln2));
+    if(nHashes < 1) nHashes = 1;
+    if(nHashes > MAX_HASHES) nHashes = MAX_HASHES;
+    bits = new unsigned long long[nWords];
+    clear();
+}
+
+template <typename T>
+MyBloomFilter<T>::~MyBloomFilter() {
+    delete [] bits;
+}
+
+template <typename T>
+void MyBloomFilter<T>::add(const T &value) {
+    addHash(hashCode(value));
+}
+
+template <typename T>
+bool MyBloomFilter<T>::mightContain(const T &value) const {
+    return mightContainHash(hashCode(value));
+}
+
+template <typename T>
+template <typename LookupType, typename>
+bool MyBloomFilter<T>::mightContain(const LookupType &value) const {
+    return mightContainHash(MyTransparentLookup<T, LookupType>::hash(value));
+}
+
+template <typename T>
+void MyBloomFilter<T>::addHash(unsigned long long hash) {
+    unsigned long long step = myhashMix(hash) | 1;
+    for(int i = 0; i < nHashes; ++i, hash += step) {
+        size_t bit = size_t(hash % nBits);
+        bits[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+template <typename T>
+bool MyBloomFilter<T>::mightContainHash(unsigned long long hash) const {
+    unsigned long long step = myhashMix(hash) | 1;
+    for(int i = 0; i < nHashes; ++i, hash += step) {
+        size_t bit = size_t(hash % nBits);
+        if((bits[bit / 64] & (1ULL << (bit % 64))) == 0) return false;
+    }
+    return true;
+}
+
+template <typename T>
+void MyBloomFilter<T>::clear() {
+    std::memset(bits, 0, nWords * sizeof(unsigned long long));
+}
+
+template <typename T>
+size_t MyBloomFilter<T>::bitCount() const {
+    return nBits;
+}
+
+template <typename T>
+int MyBloomFilter<T>::hashCount() const {
+    return nHashes;
+}
+
+template <typename T>
+size_t MyBloomFilter<T>::memoryBytes() const {
+    return nWords * sizeof(unsigned long long);
+}
+
+template <typename T>
+double MyBloomFilter<T>::falsePositiveRate(int n) const {
+    return std::pow(1 - std::exp(-double(nHashes) * n / double(nBits)), nHashes);
+}
+
+template <typename T>
+MyBloomFilter<T>::MyBloomFilter(const MyBloomFilter<T> &src)
+    : bits(new unsigned long long[src.nWords]), nBits(src.nBits), nWords(src.nWords), nHashes(src.nHashes) {
+    std::memcpy(bits, src.bits, nWords * sizeof(unsigned long long));
+}
+
+template <typename T>
+MyBloomFilter<T> & MyBloomFilter<T>::operator= (const MyBloomFilter<T> &src) {
+    if(this != &src) {
+        unsigned long long *copy = new unsigned long long[src.nWords];
+        std::memcpy(copy, src.bits, src.nWords * sizeof(unsigned long long));
+        delete [] bits;
+        bits = copy;
+        nBits = src.nBits;
+        nWords = src.nWords;
+        nHashes = src.nHashes;
+    }
+    return *this;
+}
+
+template <typename T>
+class MyBlockedBloomFilter {
+public:
+    /*
+     * 方法：MyBlockedBloomFilter
+     * 使用：MyBlockedBloomFilter<T> filter(expectedItems);
+     *      MyBlockedBloomFilter<T> filter(expectedItems, 0.001, 1 << 20);
+     * -----------------------------------------------------------------
+     * 参数的含义与MyBloomFilter相同。块数是使预计的误判率不超过falsePositiveRate的最小值
+     * （考虑了元素在块之间分布不均匀的影响，见falsePositiveRate(n)）；
+     * maxBytes不为0时块数不超过maxBytes / 32（至少1块），此时误判率会高于falsePositiveRate。
+     * 参数不合法时抛出std::invalid_argument。
+     */
+    explicit MyBlockedBloomFilter(int expectedItems, double falsePositiveRate = 0.01, size_t maxBytes = 0);
+
+    /*
+     * 方法：～MyBlockedBloomFilter
+     * 使用：隐式调用
+     * -------------
+     * 释放块数组。
+     */
+    ~MyBlockedBloomFilter();
+
+    /*
+     * 方法：add, mightContain, addHash, mightContainHash
+     * 使用：filter.add(value);
+     *      if(filter.mightContainHash(hash)) ...
+     * ------------------------------------------
+     * 与MyBloomFilter中的同名方法相同。
+     */
+    void add(const T &value);
+    bool mightContain(const T &value) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<T, LookupType>::value>::type>
+    bool mightContain(const LookupType &value) const;
+    void addHash(unsigned long long hash);
+    bool mightContainHash(unsigned long long hash) const;
+
+    /*
+     * 方法：prefetch
+     * 使用：filter.prefetch(hash);
+     * --------------------------
+     * 提示CPU提前读入hash Code为hash的元素所在的块，批量查询时用来重叠cache miss。
+     */
+    void prefetch(unsigned long long hash) const;
+
+    /*
+     * 方法：clear, reset
+     * 使用：filter.clear();
+     *      filter.reset(expectedItems);
+     * -------------------------------
+     * clear清除所有位，大小不变。reset按构造时的误判率和内存上限，
+     * 把filter重新调整为适合expectedItems个元素的大小，并清除所有位。
+     */
+    void clear();
+    void reset(int expectedItems);
+
+    /*
+     * 方法：blockCount, memoryBytes
+     * 使用：size_t bytes = filter.memoryBytes();
+     * ----------------------------------------
+     * 返回块数以及块数组占用的字节数（每块32字节）。
+     */
+    size_t blockCount() const;
+    size_t memoryBytes() const;
+
+    /*
+     * 方法：falsePositiveRate
+     * 使用：double p = filter.falsePositiveRate(n);
+     * -------------------------------------------
+     * 加入n个不同的元素之后，查询一个没有加入过的元素时误判的概率。
+     */
+    double falsePositiveRate(int n) const;
+
+    /*
+     * 拷贝构造函数和赋值操作符
+     * 使用：MyBlockedBloomFilter<T> f2 = f1;
+     * -------------------------------------
+     * 复制块数组，两个filter之后互相独立。
+     */
+    MyBlockedBloomFilter(const MyBlockedBloomFilter<T> &src);
+    MyBlockedBloomFilter<T> & operator= (const MyBlockedBloomFilter<T> &src);
+
+private:
+    /* 每块8个32位的字，一共256位；块按32字节对齐，不会跨越cache line */
+    static const int BLOCK_WORDS = 8;
+    struct Block {
+        unsigned int words[BLOCK_WORDS];
+    };
+    /* 块数的上限，保证blockOf中的乘法不会溢出 */
+    static const size_t MAX_BLOCKS = size_t(1) << 31;
+
+    char *raw;                  // 分配的原始内存，blocks是其中按32字节对齐的部分
+    Block *blocks;
+    size_t nBlocks;
+    double targetRate;
+    size_t maxBytes;
+
+    /*
+     * 方法：allocate
+     * 使用：allocate(n);
+     * -----------------
+     * 分配n个清零的块（不释放原来的块数组）。
+     */
+    void allocate(size_t n);
+
+    /*
+     * 方法：blockOf, maskOf
+     * 使用：const Block &block = blocks[blockOf(hash)];
+     * ------------------------------------------------
+     * blockOf用hash Code的高32位选择块（乘法代替取模）；maskOf用低32位和8个奇数常数相乘，
+     * 取每个乘积的高5位作为第i个字中要设置的位。
+     */
+    size_t blockOf(unsigned long long hash) const;
+    static void maskOf(unsigned long long hash, unsigned int mask[BLOCK_WORDS]);
+
+    /*
+     * 方法：blocksFor, rateFor
+     * 使用：size_t n = blocksFor(expectedItems, rate, maxBytes);
+     * --------------------------------------------------------
+     * rateFor返回平均每块有load个元素时的误判率；blocksFor找出使rateFor不超过rate的最小块数。
+     */
+    static size_t blocksFor(int expectedItems, double rate, size_t maxBytes);
+    static double rateFor(double load);
+};
+
+/*
+ * 实现笔记：maskOf中的常数
+ * ---------------------
+ * 与Parquet的split block Bloom filter相同的8个奇数。
+ */
+static const unsigned int MYBLOOM_SALT[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+template <typename T>
+MyBlockedBloomFilter<T>::MyBlockedBloomFilter(int expectedItems, double falsePositiveRate, size_t maxBytes)
+    : raw(NULL), blocks(NULL), nBlocks(0), targetRate(falsePositiveRate), maxBytes(maxBytes) {
+    mybloomCheckRate(expectedItems, falsePositiveRate);
+    allocate(blocksFor(expectedItems, falsePositiveRate, maxBytes));
+}
+
+template <typename T>
+MyBlockedBloomFilter<T>::~MyBlockedBloomFilter() {
+    delete [] raw;
+}
+
+template <typename T>
+void MyBlockedBloomFilter<T>::allocate(size_t n) {
+    raw = new char[n * sizeof(Block) + sizeof(Block) - 1];
+    size_t misalignment = reinterpret_cast<size_t>(raw) % sizeof(Block);
+    blocks = reinterpret_cast<Block *>(raw + (misalignment == 0 ? 0 : sizeof(Block) - misalignment));
+    nBlocks = n;
+    clear();
+}
+
+template <typename T>
+void MyBlockedBloomFilter<T>::add(const T &value) {
+    addHash(hashCode(value));
+}
+
+template <typename T>
+bool MyBlockedBloomFilter<T>::mightContain(const T &value) const {
+    return mightContainHash(hashCode(value));
+}
+
+template <typename T>
+template <typename LookupType, typename>
+bool MyBlockedBloomFilter<T>::mightContain(const LookupType &value) const {
+    return mightContainHash(MyTransparentLookup<T, LookupType>::hash(value));
+}
+
+template <typename T>
+size_t MyBlockedBloomFilter<T>::blockOf(unsigned long long hash) const {
+    return size_t(((hash >> 32) * nBlocks) >> 32);
+}
+
+template <typename T>
+void MyBlockedBloomFilter<T>::maskOf(unsigned long long hash, unsigned int mask[BLOCK_WORDS]) {
+    unsigned int x = static_cast<unsigned int>(hash);
+    for(int i = 0; i < BLOCK_WORDS; ++i) {
+        mask[i] = 1U << ((x * MYBLOOM_SALT[i]) >> 27);
+    }
+}
+
+/*
+ * 实现笔记：addHash, mightContainHash
+ * --------------------------------
+ * 支持AVX2时，8个字正好是一个256位的寄存器：一次乘法、一次移位算出8个位的位置，
+ * _mm256_sllv_epi32生成掩码，_mm256_testc_si256检查块中是否包含掩码的所有位。
+ * 否则逐字计算，查询时把8个字的结果合并后只判断一次，循环中没有分支。
+ */
+template <typename T>
+void MyBlockedBloomFilter<T>::addHash(unsigned long long hash) {
+    Block &block = blocks[blockOf(hash)];
+#if defined(__AVX2__)
+    __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(MYBLOOM_SALT));
+    __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(int(hash)), salt), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    __m256i *p = reinterpret_cast<__m256i *>(block.words);
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), mask));
+#else
+    unsigned int mask[BLOCK_WORDS];
+    maskOf(hash, mask);
+    for(int i = 0; i < BLOCK_WORDS; ++i) {
+        block.words[i] |= mask[i];
+    }
+#endif
+}
+
+template <typename T>
+bool MyBlockedBloomFilter<T>::mightContainHash(unsigned long long hash) const {
+    const Block &block = blocks[blockOf(hash)];
+#if defined(__AVX2__)
+    __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(MYBLOOM_SALT));
+    __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(int(hash)), salt), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i *>(block.words)), mask) != 0;
+#else
+    unsigned int mask[BLOCK_WORDS];
+    maskOf(hash, mask);
+    unsigned int missing = 0;
+    for(int i = 0; i < BLOCK_WORDS; ++i) {
+        missing |= mask[i] & ~block.words[i];
+    }
+    return missing == 0;
+#endif
+}
+
+template <typename T>
+void MyBlockedBloomFilter<T>::prefetch(unsigned long long hash) const {
+#if defined(__GNUC__)
+    __builtin_prefetch(&blocks[blockOf(hash)]);
+#else
+    (void)hash;
+#endif
+}
+
+template <typename T>
+void MyBlockedBloomFilter<T>::clear() {
+    std::memset(static_cast<void *>(blocks), 0, nBlocks * sizeof(Block));
+}
+
+/*
+ * 实现笔记：reset
+ * -------------
+ * 块数不变时只清零，不重新分配。
+ */
+template <typename T>
+void MyBlockedBloomFilter<T>::reset(int expectedItems) {
+    size_t n = blocksFor(expectedItems, targetRate, maxBytes);
+    if(n == nBlocks) {
+        clear();
+        return;
+    }
+    char *old = raw;
+    allocate(n);
+    delete [] old;
+}
+
+template <typename T>
+size_t MyBlockedBloomFilter<T>::blockCount() const {
+    return nBlocks;
+}
+
+template <typename T>
+size_t MyBlockedBloomFilter<T>::memoryBytes() const {
+    return nBlocks * sizeof(Block);
+}
+
+template <typename T>
+double MyBlockedBloomFilter<T>::falsePositiveRate(int n) const {
+    return rateFor(double(n) / double(nBlocks));
+}
+
+/*
+ * 实现笔记：rateFor
+ * ---------------
+ * 一个块中有l个元素时，某个字中的一个位仍为0的概率是(31/32)^l，
+ * 查询误判要求8个字中对应的位都是1：(1 - (31/32)^l)^8。
+ * 元素落在哪个块是随机的，l服从均值为load的Poisson分布，按分布加权求和；
+ * 只累加均值附近（±12个标准差）的项，其余项的贡献可以忽略。
+ */
+template <typename T>
+double MyBlockedBloomFilter<T>::rateFor(double load) {
+    if(load <= 0) return 0;
+    double spread = 12 * std::sqrt(load) + 12;
+    int low = load > spread ? int(load - spread) : 0;
+    int high = int(load + spread);
+    double rate = 0;
+    for(int l = low; l <= high; ++l) {
+        double poisson = std::exp(l * std::log(load) - load - std::lgamma(l + 1.0));
+        rate += poisson * std::pow(1 - std::pow(31.0 / 32.0, l), BLOCK_WORDS);
+    }
+    return rate < 1 ? rate : 1;
+}
+
+/*
+ * 实现笔记：blocksFor
+ * -----------------
+ * 误判率随块数增加而单调下降：先倍增找到一个足够的块数，再在最后一次倍增的区间里二分。
+ */
+template <typename T>
+size_t MyBlockedBloomFilter<T>::blocksFor(int expectedItems, double rate, size_t maxBytes) {
+    size_t limit = MAX_BLOCKS;
+    if(maxBytes > 0) {
+        limit = maxBytes / sizeof(Block);
+        if(limit < 1) limit = 1;
+        if(limit > MAX_BLOCKS) limit = MAX_BLOCKS;
+    }
+    if(expectedItems <= 0) return 1;
+
+    size_t high = 1;
+    while(high < limit && rateFor(double(expectedItems) / double(high)) > rate) {
+        high *= 2;
+    }
+    if(high >= limit) {
+        if(rateFor(double(expectedItems) / double(limit)) > rate) return limit;
+        high = limit;
+    }
+    size_t low = high / 2;      // low个块不够（low为0时表示还没有检查过）
+    while(high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if(rateFor(double(expectedItems) / double(mid)) > rate) low = mid;
+        else high = mid;
+    }
+    return high;
+}
+
+template <typename T>
+MyBlockedBloomFilter<T>::MyBlockedBloomFilter(const MyBlockedBloomFilter<T> &src)
+    : raw(NULL), blocks(NULL), nBlocks(0), targetRate(src.targetRate), maxBytes(src.maxBytes) {
+    allocate(src.nBlocks);
+    std::memcpy(static_cast<void *>(blocks), src.blocks, nBlocks * sizeof(Block));
+}
+
+template <typename T>
+MyBlockedBloomFilter<T> & MyBlockedBloomFilter<T>::operator= (const MyBlockedBloomFilter<T> &src) {
+    if(this != &src) {
+        char *old = raw;
+        allocate(src.nBlocks);
+        delete [] old;
+        std::memcpy(static_cast<void *>(blocks), src.blocks, nBlocks * sizeof(Block));
+        targetRate = src.targetRate;
+        maxBytes = src.maxBytes;
+    }
+    return *this;
+}
+
+#endif // _mybloomfilter_h
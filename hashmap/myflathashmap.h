@@ -0,0 +1,1195 @@
+/*
+ * File: myflathashmap.h
+ * ---------------------
+ * MyHashMap 的开放寻址实现，通过 MyHashMap<KeyType, ValueType, MyOpenAddressing> 选择。
+ * 它的接口与拉链法实现（myhashmap.h）完全相同，只是底层表示不同：
+ *
+ * key-value 对直接存放在一个连续的槽（slot）数组中，没有每个条目单独分配的 Cell，
+ * 也没有 link 指针。每个槽对应一个控制字节（control byte）：
+ *      EMPTY   (0x80)：槽从未被使用
+ *      DELETED (0xFE)：槽中的条目已被删除（墓碑）
+ *      0..127        ：槽已被占用，值为该 key 的hash Code的低 7 位（H2）
+ *
+ * 查找时，hash Code的其余位（H1）决定从哪一组（16 个槽）开始探测，
+ * 一次比较整组 16 个控制字节（支持SSE2时使用一条SIMD指令），只有 H2 相同的槽
+ * 才需要真正比较 key。遇到含有 EMPTY 的组即可确定 key 不存在。
+ * 负载系数的上限为 7/8。
+ * -----------------------------------------
+ * 参考：https://abseil.io/about/design/swisstables
+ * 更新：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: 槽中保存完整的hash Code：H2相同的槽先比较hash Code再比较key，
+ *                     扩容时直接使用保存的hash Code，不再重新计算。
+ *      3. 2026.10.18: 添加reserve、指定预期大小的构造函数以及批量插入的putAll。
+ *      4. 2026.10.18: 添加find，get、containsKey、remove、find支持异构查找（见MyTransparentLookup）。
+ *      5. 2026.10.18: 添加tryGet、tryEmplace、insertOrAssign、computeIfAbsent、merge。
+ *      6. 2026.10.18: 添加迭代器（沿控制字节跳过空槽）以及keysView()、valuesView()。
+ *      7. 2026.10.18: 添加多线程批量构建buildParallel：每个线程只在自己分区的组内探测和插入，
+ *                     探测序列离开分区的少数条目最后再逐个插入。
+ *      8. 2026.10.18: 添加批量查找getMany、containsMany，一批key先预取控制字节和候选槽再比较。
+ *      9. 2026.10.18: 添加saveSnapshot（见mysnapshot.h）。
+ *     10. 2026.10.18: 添加stats()，定义MY_HASHMAP_STATS时统计查找和重建槽数组的计数（见MyHashMapStats）。
+ *     11. 2026.10.18: remove之后条目数不足负载上限的1/4时缩小槽数组，clear()还原为初始容量，添加compact()。
+ *     12. 2026.10.18: 添加可选的Bloom filter（enableBloomFilter），findSlot先查询filter。
+ *     13. 2026.10.18: allocate分配成功之后才修改成员，resize、clear分配失败时保持原来的表。
+ */
+
+#ifndef _myflathashmap_h
+#define _myflathashmap_h
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "myhashmap.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+template <typename KeyType, typename ValueType>
+class MyHashMap<KeyType, ValueType, MyOpenAddressing> {
+public:
+    /*
+     * 以下方法的含义与拉链法实现中的同名方法完全相同，
+     * 详细说明见 myhashmap.h。
+     */
+    MyHashMap();
+    explicit MyHashMap(int expectedSize);
+    ~MyHashMap();
+
+    ValueType get(const KeyType &key) const;
+    bool isEmpty() const;
+    MyVector<KeyType> keys() const;
+    void put(const KeyType &key, const ValueType &value);
+    void putAll(const MyVector<std::pair<KeyType, ValueType>> &pairs);
+    void buildParallel(const MyVector<std::pair<KeyType, ValueType>> &pairs, int nThreads);
+    void reserve(int n);
+    void remove(const KeyType &key);
+    int size() const;
+    void clear();
+    void compact();
+    bool containsKey(const KeyType &key) const;
+    ValueType * find(const KeyType &key);
+    const ValueType * find(const KeyType &key) const;
+    void getMany(const MyVector<KeyType> &keys, MyVector<ValueType *> &out);
+    void getMany(const MyVector<KeyType> &keys, MyVector<const ValueType *> &out) const;
+    void containsMany(const MyVector<KeyType> &keys, MyVector<bool> &found) const;
+    void saveSnapshot(const std::string &path) const;
+    MyHashMapStats stats() const;
+    void enableBloomFilter(double falsePositiveRate = 0.01, size_t maxBytes = 0);
+    void disableBloomFilter();
+    bool hasBloomFilter() const;
+
+    /*
+     * 注意：与拉链法不同，这里的条目在扩容时会被移动，所以find、tryEmplace、
+     * insertOrAssign、computeIfAbsent、merge返回的指针和引用只在下一次插入、删除之前有效
+     * （remove可能缩小槽数组）。
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+    template <typename... Args>
+    std::pair<ValueType *, bool> tryEmplace(const KeyType &key, Args&&... args);
+    std::pair<ValueType *, bool> insertOrAssign(const KeyType &key, const ValueType &value);
+    template <typename Fn>
+    ValueType & computeIfAbsent(const KeyType &key, Fn fn);
+    template <typename Fn>
+    ValueType & merge(const KeyType &key, const ValueType &value, Fn combine);
+
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    ValueType get(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    bool containsKey(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    void remove(const LookupType &key);
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    ValueType * find(const LookupType &key);
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    const ValueType * find(const LookupType &key) const;
+
+    bool equals(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src) const;
+    std::string toString() const;
+    MyVector<ValueType> values() const;
+
+    MyHashMap(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src);
+    MyHashMap<KeyType, ValueType, MyOpenAddressing> &operator= (const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src);
+
+    ValueType & operator[] (const KeyType &key);
+    const ValueType operator[] (const KeyType &key) const;
+
+    /*
+     * 重载运算符==
+     * ------------
+     * 开放寻址中条目的位置与插入历史有关，所以这里逐个查找key，
+     * 而不是像拉链法那样逐个篮子比较。
+     */
+    bool operator == (const MyHashMap<KeyType, ValueType, MyOpenAddressing> &hmp2) const;
+    bool operator != (const MyHashMap<KeyType, ValueType, MyOpenAddressing> &hmp2) const;
+
+    void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+private:
+    struct Slot;
+
+    struct KeyOf {
+        typedef KeyType type;
+        static const KeyType & get(const Slot &slot) { return slot.key; }
+    };
+    struct ValueOf {
+        typedef ValueType type;
+        static const ValueType & get(const Slot &slot) { return slot.value; }
+    };
+
+public:
+    /*
+     * 迭代器
+     * ------
+     * 用法与拉链法实现相同。迭代器只保存一个槽下标，前进时沿控制字节跳过空槽和墓碑。
+     * 插入可能移动所有条目，所以修改map之后已有的迭代器失效。
+     */
+    template <typename Proj>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename Proj::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type * pointer;
+        typedef const value_type & reference;
+
+        Iterator() : map(NULL), index(0) {}
+
+        reference operator*() const { return Proj::get(map->slots[index]); }
+        pointer operator->() const { return &Proj::get(map->slots[index]); }
+        const KeyType & key() const { return map->slots[index].key; }
+        const ValueType & value() const { return map->slots[index].value; }
+
+        Iterator & operator++() {
+            index++;
+            settle();
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iterator &rhs) const { return index == rhs.index; }
+        bool operator!=(const Iterator &rhs) const { return index != rhs.index; }
+
+    private:
+        friend class MyHashMap;
+
+        Iterator(const MyHashMap *map, int index) : map(map), index(index) {
+            settle();
+        }
+
+        /* 停在第一个已占用的槽上，没有时停在capacity（即end()） */
+        void settle() {
+            while(index < map->capacity && map->ctrl[index] < 0) {
+                index++;
+            }
+        }
+
+        const MyHashMap *map;
+        int index;
+    };
+
+    template <typename It>
+    class View {
+    public:
+        View(It first, It last) : first(first), last(last) {}
+        It begin() const { return first; }
+        It end() const { return last; }
+    private:
+        It first, last;
+    };
+
+    typedef Iterator<KeyOf> const_iterator;
+    typedef const_iterator iterator;
+    typedef Iterator<ValueOf> value_iterator;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    View<const_iterator> keysView() const;
+    View<value_iterator> valuesView() const;
+
+private:
+    /* 槽中存放的条目 */
+    struct Slot {
+        KeyType key;
+        ValueType value;
+        size_t hash;            // hashOf(key)，扩容时直接使用
+    };
+
+    /* 控制字节 */
+    static const signed char EMPTY = -128;
+    static const signed char DELETED = -2;
+    /* 每组的槽数，即一次探测比较的控制字节数 */
+    static const int GROUP_WIDTH = 16;
+    /* 初始槽数，必须是GROUP_WIDTH的倍数且为2的幂 */
+    static const int INITIAL_CAPACITY = 16;
+    /* buildParallel：每个线程至少分到的条目数，以及每个线程平均分到的分区数 */
+    static const int PARALLEL_MIN_PER_THREAD = 4096;
+    static const int PARTITIONS_PER_THREAD = 8;
+    /* getMany、containsMany每批预取的key数 */
+    static const int LOOKUP_BATCH = 32;
+
+    /* 实例变量 */
+    signed char *ctrl;      // capacity个控制字节
+    Slot *slots;            // capacity个槽，只有控制字节为0..127的槽中有已构造的条目
+    int capacity;
+    int entries;
+    int growthLeft;         // 在必须扩容之前还能占用多少个EMPTY槽（维持负载系数不超过7/8）
+    int minCapacity;        // 自动缩容和clear()的下限：INITIAL_CAPACITY或构造时预留的槽数
+    MyBlockedBloomFilter<KeyType> *bloom;  // enableBloomFilter之后记录所有key的hash Code，否则为NULL
+
+#ifdef MY_HASHMAP_STATS
+    mutable MyHashMapCounters counters;
+#endif
+
+    /*
+     * 方法：matchByte, matchEmpty, matchEmptyOrDeleted
+     * 使用：unsigned mask = matchByte(ctrl + g * GROUP_WIDTH, h2);
+     * -----------------------------------------------------------
+     * 比较一组16个控制字节，返回一个16位的掩码，第i位为1表示该组第i个槽满足条件。
+     */
+    static unsigned matchByte(const signed char *group, signed char value);
+    static unsigned matchEmpty(const signed char *group);
+    static unsigned matchEmptyOrDeleted(const signed char *group);
+    static int lowestBit(unsigned mask);
+
+    static size_t hashOf(const KeyType &key);
+    template <typename LookupType>
+    static size_t hashOf(const LookupType &key);
+    static int maxLoad(int capacity);
+    /* 能容纳n个条目而不超过负载上限的最小槽数（2的幂，至少为INITIAL_CAPACITY） */
+    static int capacityFor(int n);
+
+    /*
+     * 方法：findSlot
+     * 使用：int i = findSlot(key, hash);
+     * ---------------------------------
+     * 返回键为key的条目所在的槽下标，如果不存在则返回-1。
+     * key可以是KeyType，也可以是异构查找的LookupType。
+     */
+    template <typename LookupType>
+    int findSlot(const LookupType &key, size_t hash) const;
+
+    /*
+     * 方法：lookupMany
+     * 使用：lookupMany(keys, [&](int i, int slot) { ... });
+     * ---------------------------------------------------
+     * getMany和containsMany共用的分批预取查找：按顺序对每个keys[i]调用fn(i, slot)，
+     * slot是findSlot(keys[i])的结果。
+     */
+    template <typename Fn>
+    void lookupMany(const MyVector<KeyType> &keys, Fn fn) const;
+
+    /*
+     * 方法：eraseSlot
+     * 使用：eraseSlot(i);
+     * ------------------
+     * 销毁第i个槽中的条目并更新控制字节。
+     */
+    void eraseSlot(int i);
+
+    /*
+     * 方法：shrinkIfSparse
+     * 使用：shrinkIfSparse();
+     * ----------------------
+     * remove之后调用：条目数不足负载上限的1/4时缩小槽数组。
+     */
+    void shrinkIfSparse();
+
+    /*
+     * 方法：prepareInsert
+     * 使用：int i = prepareInsert(hash);
+     * ---------------------------------
+     * 为一个不在表中的key找到可以写入的槽（必要时先扩容），
+     * 写好控制字节并更新entries，返回槽下标。调用者负责在槽中构造条目。
+     */
+    int prepareInsert(size_t hash);
+
+    /*
+     * 方法：findOrInsert
+     * 使用：std::pair<int, bool> r = findOrInsert(key, args...);
+     * ---------------------------------------------------------
+     * 计算一次hash Code并查找key，不存在时用args构造value并插入。
+     * 返回key所在的槽下标以及是否插入了新条目。
+     */
+    template <typename... Args>
+    std::pair<int, bool> findOrInsert(const KeyType &key, Args&&... args);
+
+    void allocate(int newCapacity);
+    void destroySlots();
+    void resize(int newCapacity);
+    void deepCopy(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src);
+};
+
+/*
+ * 实现笔记：控制字节的匹配
+ * ---------------------
+ * 支持SSE2时，_mm_cmpeq_epi8一次比较16个字节，_mm_movemask_epi8取出每个字节的最高位。
+ * EMPTY和DELETED的最高位都是1，而已占用槽的控制字节在0..127之间，
+ * 所以直接取最高位就得到了"EMPTY或DELETED"的掩码。
+ * 不支持SSE2时逐字节比较，结果相同。
+ */
+template <typename KeyType, typename ValueType>
+unsigned MyHashMap<KeyType, ValueType, MyOpenAddressing>::matchByte(const signed char *group, signed char value) {
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(value))));
+#else
+    unsigned mask = 0;
+    for(int i = 0; i < GROUP_WIDTH; ++i) {
+        if(group[i] == value) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+template <typename KeyType, typename ValueType>
+unsigned MyHashMap<KeyType, ValueType, MyOpenAddressing>::matchEmpty(const signed char *group) {
+    return matchByte(group, EMPTY);
+}
+
+template <typename KeyType, typename ValueType>
+unsigned MyHashMap<KeyType, ValueType, MyOpenAddressing>::matchEmptyOrDeleted(const signed char *group) {
+#if defined(__SSE2__)
+    return unsigned(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group))));
+#else
+    unsigned mask = 0;
+    for(int i = 0; i < GROUP_WIDTH; ++i) {
+        if(group[i] < 0) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+template <typename KeyType, typename ValueType>
+int MyHashMap<KeyType, ValueType, MyOpenAddressing>::lowestBit(unsigned mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int n = 0;
+    while(!(mask & 1)) {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+template <typename KeyType, typename ValueType>
+size_t MyHashMap<KeyType, ValueType, MyOpenAddressing>::hashOf(const KeyType &key) {
+    return size_t(hashCode(key));
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType>
+size_t MyHashMap<KeyType, ValueType, MyOpenAddressing>::hashOf(const LookupType &key) {
+    return size_t(MyTransparentLookup<KeyType, LookupType>::hash(key));
+}
+
+template <typename KeyType, typename ValueType>
+int MyHashMap<KeyType, ValueType, MyOpenAddressing>::maxLoad(int capacity) {
+    return capacity - capacity / 8;
+}
+
+template <typename KeyType, typename ValueType>
+int MyHashMap<KeyType, ValueType, MyOpenAddressing>::capacityFor(int n) {
+    int capacity = INITIAL_CAPACITY;
+    while(maxLoad(capacity) < n && capacity < (1 << 30)) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+template <typename KeyType, typename ValueType>
+MyHashMap<KeyType, ValueType, MyOpenAddressing>::MyHashMap() {
+    bloom = NULL;
+    allocate(INITIAL_CAPACITY);
+    minCapacity = capacity;
+}
+
+template <typename KeyType, typename ValueType>
+MyHashMap<KeyType, ValueType, MyOpenAddressing>::MyHashMap(int expectedSize) {
+    bloom = NULL;
+    allocate(capacityFor(expectedSize));
+    minCapacity = capacity;
+}
+
+template <typename KeyType, typename ValueType>
+MyHashMap<KeyType, ValueType, MyOpenAddressing>::~MyHashMap() {
+    destroySlots();
+    ::operator delete(slots);
+    delete [] ctrl;
+    delete bloom;
+}
+
+/*
+ * 实现笔记：allocate, destroySlots
+ * ------------------------------
+ * 槽数组只分配原始内存，条目在插入时用placement new构造，
+ * 因此销毁时只对已占用的槽调用析构函数。
+ * 有Bloom filter时allocate把它清空并调整为适合新容量的大小，之后由prepareInsert重新加入条目。
+ * 两个数组先分配到局部变量中，全部成功之后才修改成员：分配失败时ctrl、slots、capacity
+ * 都还是原来的，调用者（resize、clear）持有的旧表仍然有效。filter的reset失败时也不改变filter。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::allocate(int newCapacity) {
+    signed char *newCtrl = new signed char[newCapacity];
+    Slot *newSlots = NULL;
+    try {
+        newSlots = static_cast<Slot *>(::operator new(sizeof(Slot) * newCapacity));
+        if(bloom != NULL) bloom->reset(maxLoad(newCapacity));
+    }
+    catch(...) {
+        ::operator delete(newSlots);
+        delete [] newCtrl;
+        throw;
+    }
+    std::memset(newCtrl, EMPTY, newCapacity);
+    ctrl = newCtrl;
+    slots = newSlots;
+    capacity = newCapacity;
+    entries = 0;
+    growthLeft = maxLoad(capacity);
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::destroySlots() {
+    for(int i = 0; i < capacity; ++i) {
+        if(ctrl[i] >= 0) {
+            slots[i].~Slot();
+        }
+    }
+}
+
+/*
+ * 实现笔记：findSlot
+ * ----------------
+ * 探测序列以组为单位：从第 H1 % nGroups 组开始，第i步前进i组（三角数序列），
+ * 当组数是2的幂时该序列会访问到每一组。
+ * H2只有7位，大约每128个槽就有一个误匹配，所以先比较槽中保存的完整hash Code，
+ * 只有真正可能相等时才比较（可能很长的）key。
+ * 有Bloom filter时先查询它，被排除的key不读取任何控制字节（探测长度记为0）；
+ * 插入之前的查找同样适用，因为每个条目在prepareInsert中都加入了filter。
+ */
+template <typename KeyType, typename ValueType>
+template <typename LookupType>
+int MyHashMap<KeyType, ValueType, MyOpenAddressing>::findSlot(const LookupType &key, size_t hash) const {
+    if(bloom != NULL && !bloom->mightContainHash(hash)) {
+#ifdef MY_HASHMAP_STATS
+        counters.recordLookup(0);
+#endif
+        return -1;
+    }
+    size_t groupMask = size_t(capacity / GROUP_WIDTH) - 1;
+    size_t g = (hash >> 7) & groupMask;
+    signed char h2 = static_cast<signed char>(hash & 0x7F);
+
+    for(size_t step = 1; ; ++step) {
+        const signed char *group = ctrl + g * GROUP_WIDTH;
+        unsigned mask = matchByte(group, h2);
+        while(mask) {
+            int i = int(g * GROUP_WIDTH) + lowestBit(mask);
+            if(slots[i].hash == hash && slots[i].key == key) {
+#ifdef MY_HASHMAP_STATS
+                counters.recordLookup((long long)step);
+#endif
+                return i;
+            }
+            mask &= mask - 1;
+        }
+        if(matchEmpty(group)) {
+#ifdef MY_HASHMAP_STATS
+            counters.recordLookup((long long)step);
+#endif
+            return -1;
+        }
+        g = (g + step) & groupMask;
+    }
+}
+
+/*
+ * 实现笔记：prepareInsert
+ * ---------------------
+ * 沿探测序列找到第一个EMPTY或DELETED的槽。复用DELETED槽不消耗growthLeft；
+ * 如果要占用EMPTY槽但growthLeft已用完，则先扩容：当墓碑占多数时保持容量
+ * 原地重建，否则容量加倍。
+ */
+template <typename KeyType, typename ValueType>
+int MyHashMap<KeyType, ValueType, MyOpenAddressing>::prepareInsert(size_t hash) {
+    while(true) {
+        size_t groupMask = size_t(capacity / GROUP_WIDTH) - 1;
+        size_t g = (hash >> 7) & groupMask;
+        size_t step = 1;
+        unsigned mask = matchEmptyOrDeleted(ctrl + g * GROUP_WIDTH);
+        while(!mask) {
+            g = (g + step++) & groupMask;
+            mask = matchEmptyOrDeleted(ctrl + g * GROUP_WIDTH);
+        }
+        int i = int(g * GROUP_WIDTH) + lowestBit(mask);
+
+        if(ctrl[i] == EMPTY && growthLeft == 0) {
+            resize(entries * 2 >= maxLoad(capacity) ? capacity * 2 : capacity);
+            continue;
+        }
+        if(ctrl[i] == EMPTY) growthLeft--;
+        ctrl[i] = static_cast<signed char>(hash & 0x7F);
+        entries++;
+        if(bloom != NULL) bloom->addHash(hash);
+        return i;
+    }
+}
+
+/*
+ * 实现笔记：resize
+ * --------------
+ * 分配新的控制字节和槽数组，把旧表中的条目逐个移动过去。
+ * 新表中没有墓碑。allocate失败时不修改任何成员，map仍然是原来的旧表。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::resize(int newCapacity) {
+    signed char *oldCtrl = ctrl;
+    Slot *oldSlots = slots;
+    int oldCapacity = capacity;
+#ifdef MY_HASHMAP_STATS
+    counters.rehashes++;
+    MyHashMapCounters::RehashTimer timer(counters.rehashNanos);
+#endif
+
+    allocate(newCapacity);
+    for(int i = 0; i < oldCapacity; ++i) {
+        if(oldCtrl[i] >= 0) {
+            int j = prepareInsert(oldSlots[i].hash);
+            new (&slots[j]) Slot(std::move(oldSlots[i]));
+            oldSlots[i].~Slot();
+        }
+    }
+    ::operator delete(oldSlots);
+    delete [] oldCtrl;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyHashMap<KeyType, ValueType, MyOpenAddressing>::get(const KeyType &key) const {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? ValueType() : slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::isEmpty() const {
+    return entries == 0;
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyHashMap<KeyType, ValueType, MyOpenAddressing>::keys() const {
+    MyVector<KeyType> keys;
+    for(const KeyType &key : *this) {
+        keys.add(key);
+    }
+    return keys;
+}
+
+/*
+ * 实现笔记：begin, end
+ * ------------------
+ * end()的下标是capacity，比较迭代器时只比较下标，所以end()不需要扫描控制字节。
+ */
+template <typename KeyType, typename ValueType>
+typename MyHashMap<KeyType, ValueType, MyOpenAddressing>::const_iterator MyHashMap<KeyType, ValueType, MyOpenAddressing>::begin() const {
+    return const_iterator(this, 0);
+}
+
+template <typename KeyType, typename ValueType>
+typename MyHashMap<KeyType, ValueType, MyOpenAddressing>::const_iterator MyHashMap<KeyType, ValueType, MyOpenAddressing>::end() const {
+    return const_iterator(this, capacity);
+}
+
+template <typename KeyType, typename ValueType>
+typename MyHashMap<KeyType, ValueType, MyOpenAddressing>::template View<typename MyHashMap<KeyType, ValueType, MyOpenAddressing>::const_iterator>
+MyHashMap<KeyType, ValueType, MyOpenAddressing>::keysView() const {
+    return View<const_iterator>(begin(), end());
+}
+
+template <typename KeyType, typename ValueType>
+typename MyHashMap<KeyType, ValueType, MyOpenAddressing>::template View<typename MyHashMap<KeyType, ValueType, MyOpenAddressing>::value_iterator>
+MyHashMap<KeyType, ValueType, MyOpenAddressing>::valuesView() const {
+    return View<value_iterator>(value_iterator(this, 0), value_iterator(this, capacity));
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::put(const KeyType &key, const ValueType &value) {
+    insertOrAssign(key, value);
+}
+
+/*
+ * 实现笔记：findOrInsert
+ * --------------------
+ * 条目先在栈上构造好，再占用槽并移动进去：如果构造key或value时抛出异常，
+ * 表中不会留下一个控制字节表示已占用、却没有条目的槽。
+ */
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+std::pair<int, bool> MyHashMap<KeyType, ValueType, MyOpenAddressing>::findOrInsert(const KeyType &key, Args&&... args) {
+    size_t hash = hashOf(key);
+    int i = findSlot(key, hash);
+    if(i >= 0) {
+        return std::make_pair(i, false);
+    }
+    Slot slot{key, ValueType(std::forward<Args>(args)...), hash};
+    i = prepareInsert(hash);
+    new (&slots[i]) Slot(std::move(slot));
+    return std::make_pair(i, true);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::tryGet(const KeyType &key, ValueType &out) const {
+    int i = findSlot(key, hashOf(key));
+    if(i < 0) return false;
+    out = slots[i].value;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+std::pair<ValueType *, bool> MyHashMap<KeyType, ValueType, MyOpenAddressing>::tryEmplace(const KeyType &key, Args&&... args) {
+    std::pair<int, bool> r = findOrInsert(key, std::forward<Args>(args)...);
+    return std::make_pair(&slots[r.first].value, r.second);
+}
+
+template <typename KeyType, typename ValueType>
+std::pair<ValueType *, bool> MyHashMap<KeyType, ValueType, MyOpenAddressing>::insertOrAssign(const KeyType &key, const ValueType &value) {
+    std::pair<int, bool> r = findOrInsert(key, value);
+    if(!r.second) {
+        slots[r.first].value = value;
+    }
+    return std::make_pair(&slots[r.first].value, r.second);
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+ValueType & MyHashMap<KeyType, ValueType, MyOpenAddressing>::computeIfAbsent(const KeyType &key, Fn fn) {
+    size_t hash = hashOf(key);
+    int i = findSlot(key, hash);
+    if(i < 0) {
+        Slot slot{key, fn(key), hash};
+        i = prepareInsert(hash);
+        new (&slots[i]) Slot(std::move(slot));
+    }
+    return slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+ValueType & MyHashMap<KeyType, ValueType, MyOpenAddressing>::merge(const KeyType &key, const ValueType &value, Fn combine) {
+    std::pair<int, bool> r = findOrInsert(key, value);
+    if(!r.second) {
+        slots[r.first].value = combine(slots[r.first].value, value);
+    }
+    return slots[r.first].value;
+}
+
+/*
+ * 实现笔记：reserve, putAll
+ * -----------------------
+ * reserve最多移动一次所有条目（同时清除墓碑）：容量不够，或者墓碑占用了
+ * 剩余的空间时才重建；putAll先reserve，之后的插入不会再扩容。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::reserve(int n) {
+    int target = capacityFor(n);
+    if(target > capacity || growthLeft < n - entries) {
+        resize(target > capacity ? target : capacity);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::putAll(const MyVector<std::pair<KeyType, ValueType>> &pairs) {
+    reserve(entries + pairs.size());
+    for(int i = 0; i < pairs.size(); ++i) {
+        put(pairs[i].first, pairs[i].second);
+    }
+}
+
+/*
+ * 实现笔记：lookupMany
+ * ------------------
+ * 每批分三轮：第一轮计算hash Code并预取起始组的控制字节；第二轮在控制字节中匹配H2，
+ * 预取第一个候选槽；第三轮用findSlot完成查找。多数key在起始组中就能确定结果，
+ * 所以前两轮预取的正是findSlot要读的cache line。
+ * 有Bloom filter时第一轮改为预取filter中的块，第二轮先查询filter，被排除的key不再预取。
+ */
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::lookupMany(const MyVector<KeyType> &keys, Fn fn) const {
+    size_t hashes[LOOKUP_BATCH];
+    size_t groupMask = size_t(capacity / GROUP_WIDTH) - 1;
+    for(int base = 0; base < keys.size(); base += LOOKUP_BATCH) {
+        int n = (keys.size() - base < LOOKUP_BATCH) ? keys.size() - base : LOOKUP_BATCH;
+        for(int j = 0; j < n; ++j) {
+            hashes[j] = hashOf(keys[base + j]);
+            if(bloom != NULL) bloom->prefetch(hashes[j]);
+            else myhashPrefetch(ctrl + ((hashes[j] >> 7) & groupMask) * GROUP_WIDTH);
+        }
+        for(int j = 0; j < n; ++j) {
+            if(bloom != NULL && !bloom->mightContainHash(hashes[j])) continue;
+            size_t g = (hashes[j] >> 7) & groupMask;
+            unsigned mask = matchByte(ctrl + g * GROUP_WIDTH, static_cast<signed char>(hashes[j] & 0x7F));
+            if(mask) myhashPrefetch(&slots[g * GROUP_WIDTH + lowestBit(mask)]);
+        }
+        for(int j = 0; j < n; ++j) {
+            fn(base + j, findSlot(keys[base + j], hashes[j]));
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::getMany(const MyVector<KeyType> &keys, MyVector<ValueType *> &out) {
+    out.clear();
+    lookupMany(keys, [this, &out](int, int i) {
+        out.add(i < 0 ? NULL : &slots[i].value);
+    });
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::getMany(const MyVector<KeyType> &keys, MyVector<const ValueType *> &out) const {
+    out.clear();
+    lookupMany(keys, [this, &out](int, int i) {
+        out.add(i < 0 ? NULL : &slots[i].value);
+    });
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::containsMany(const MyVector<KeyType> &keys, MyVector<bool> &found) const {
+    found.clear();
+    lookupMany(keys, [&found](int, int i) {
+        found.add(i >= 0);
+    });
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::saveSnapshot(const std::string &path) const {
+    mysnapshotSave<KeyType, ValueType>(*this, path);
+}
+
+/*
+ * 实现笔记：stats
+ * -------------
+ * 条目的探测长度是从它的起始组沿三角数序列走到它所在的组需要检查的组数，
+ * 所以沿同样的序列重走一遍即可算出；多数条目就在起始组中，长度为1。
+ */
+template <typename KeyType, typename ValueType>
+MyHashMapStats MyHashMap<KeyType, ValueType, MyOpenAddressing>::stats() const {
+    MyHashMapStats s = MyHashMapStats();
+    int nGroups = capacity / GROUP_WIDTH;
+    size_t groupMask = size_t(nGroups) - 1;
+    s.entries = entries;
+    s.buckets = nGroups;
+    s.loadFactor = double(entries) / capacity;
+    for(int k = 0; k <= GROUP_WIDTH; ++k) {
+        s.occupancy.add(0);
+    }
+    long long totalProbes = 0;
+    for(int g = 0; g < nGroups; ++g) {
+        int used = 0;
+        for(int i = g * GROUP_WIDTH; i < (g + 1) * GROUP_WIDTH; ++i) {
+            if(ctrl[i] < 0) continue;
+            used++;
+            size_t probe = (slots[i].hash >> 7) & groupMask;
+            int length = 1;
+            for(size_t step = 1; probe != size_t(g); ++step) {
+                probe = (probe + step) & groupMask;
+                length++;
+            }
+            totalProbes += length;
+            if(length > s.maxProbeLength) s.maxProbeLength = length;
+        }
+        s.occupancy[used]++;
+    }
+    s.allocatedBytes = size_t(capacity) * (sizeof(Slot) + 1);
+    if(bloom != NULL) s.allocatedBytes += bloom->memoryBytes();
+    if(entries > 0) {
+        s.averageProbeLength = double(totalProbes) / entries;
+        s.bytesPerEntry = double(s.allocatedBytes) / entries;
+    }
+#ifdef MY_HASHMAP_STATS
+    counters.fill(s);
+#endif
+    return s;
+}
+
+/*
+ * 实现笔记：buildParallel
+ * ---------------------
+ * reserve之后growthLeft足够容纳所有新条目，表不会再扩容。分区编号取自起始组下标的最高几位，
+ * 每个分区对应一段连续的组。线程沿正常的探测序列查找、插入，但只读写自己分区内的组：
+ * 只要探测在分区内结束，结果就与串行插入相同。探测序列要离开分区时（组已满，负载系数不超过7/8时很少见），
+ * 该条目记下来，所有线程结束后再按原来的顺序逐个插入。相同的key总在同一个分区、由同一个线程处理，
+ * 它后出现的条目也一定同样被推迟，所以仍然是后出现的为准。
+ * 条目先构造好再写控制字节，构造时抛出异常不会留下半个条目。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::buildParallel(const MyVector<std::pair<KeyType, ValueType>> &pairs, int nThreads) {
+    if(nThreads > pairs.size() / PARALLEL_MIN_PER_THREAD) nThreads = pairs.size() / PARALLEL_MIN_PER_THREAD;
+    if(nThreads <= 1) {
+        putAll(pairs);
+        return;
+    }
+    reserve(entries + pairs.size());
+
+    int groupBits = 0, partBits = 0;
+    while((GROUP_WIDTH << groupBits) < capacity) groupBits++;
+    while((1 << partBits) < nThreads * PARTITIONS_PER_THREAD && partBits < groupBits) partBits++;
+    int nParts = 1 << partBits;
+
+    MyVector<unsigned long long> hashes(pairs.size());
+    MyVector<int> order(pairs.size());
+    MyVector<int> start(nParts + 1);
+    std::exception_ptr error = myhashPartition(pairs, 7 + groupBits - partBits, nParts, nThreads, hashes, order, start);
+    if(error) std::rethrow_exception(error);
+
+    size_t groupMask = size_t(capacity / GROUP_WIDTH) - 1;
+    MyVector<MyVector<int>> deferred(nThreads);
+    MyVector<int> added(nThreads, 0), emptiesUsed(nThreads, 0);
+    std::atomic<int> nextPart(0);
+    error = myhashParallelFor(nThreads, [&](int t) {
+        int inserted = 0, used = 0;
+        try {
+            for(int p = nextPart.fetch_add(1); p < nParts; p = nextPart.fetch_add(1)) {
+                size_t lo = size_t(p) << (groupBits - partBits), hi = lo + (size_t(1) << (groupBits - partBits));
+                for(int j = start[p]; j < start[p + 1]; ++j) {
+                    int i = order[j];
+                    size_t hash = size_t(hashes[i]);
+                    signed char h2 = static_cast<signed char>(hash & 0x7F);
+                    int found = -1, slot = -1;
+                    bool outside = false;
+
+                    size_t g = (hash >> 7) & groupMask;
+                    for(size_t step = 1; found < 0; ++step) {
+                        if(g < lo || g >= hi) { outside = true; break; }
+                        const signed char *group = ctrl + g * GROUP_WIDTH;
+                        for(unsigned mask = matchByte(group, h2); mask; mask &= mask - 1) {
+                            int k = int(g * GROUP_WIDTH) + lowestBit(mask);
+                            if(slots[k].hash == hash && slots[k].key == pairs[i].first) { found = k; break; }
+                        }
+                        if(found < 0 && matchEmpty(group)) break;
+                        g = (g + step) & groupMask;
+                    }
+                    if(found >= 0) {
+                        slots[found].value = pairs[i].second;
+                        continue;
+                    }
+
+                    g = (hash >> 7) & groupMask;
+                    for(size_t step = 1; !outside; ++step) {
+                        if(g < lo || g >= hi) { outside = true; break; }
+                        unsigned mask = matchEmptyOrDeleted(ctrl + g * GROUP_WIDTH);
+                        if(mask) { slot = int(g * GROUP_WIDTH) + lowestBit(mask); break; }
+                        g = (g + step) & groupMask;
+                    }
+                    if(outside) {
+                        deferred[t].add(i);
+                        continue;
+                    }
+                    new (&slots[slot]) Slot{pairs[i].first, pairs[i].second, hash};
+                    if(ctrl[slot] == EMPTY) used++;
+                    ctrl[slot] = h2;
+                    inserted++;
+                }
+            }
+        }
+        catch(...) {
+            added[t] = inserted;
+            emptiesUsed[t] = used;
+            throw;
+        }
+        added[t] = inserted;
+        emptiesUsed[t] = used;
+    });
+
+    for(int t = 0; t < nThreads; ++t) {
+        entries += added[t];
+        growthLeft -= emptiesUsed[t];
+    }
+    if(bloom != NULL) {
+        for(int i = 0; i < hashes.size(); ++i) {
+            bloom->addHash(hashes[i]);
+        }
+    }
+    if(error) std::rethrow_exception(error);
+
+    for(int t = 0; t < nThreads; ++t) {
+        for(int k = 0; k < deferred[t].size(); ++k) {
+            const std::pair<KeyType, ValueType> &pair = pairs[deferred[t][k]];
+            size_t hash = size_t(hashes[deferred[t][k]]);
+            int i = findSlot(pair.first, hash);
+            if(i >= 0) {
+                slots[i].value = pair.second;
+                continue;
+            }
+            Slot slot{pair.first, pair.second, hash};
+            i = prepareInsert(hash);
+            new (&slots[i]) Slot(std::move(slot));
+        }
+    }
+}
+
+/*
+ * 实现笔记：remove
+ * --------------
+ * 如果被删除的槽所在的组中还有EMPTY槽，说明没有任何探测序列越过这一组，
+ * 可以直接把它标记为EMPTY；否则必须留下墓碑DELETED，以免后面的查找提前停止。
+ * 与拉链法相同，条目数不足负载上限的1/4时缩小到约两倍条目数对应的容量，
+ * 缩小后的负载系数离扩容和下一次缩容都很远；resize同时清除了所有墓碑。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::remove(const KeyType &key) {
+    int i = findSlot(key, hashOf(key));
+    if(i >= 0) {
+        eraseSlot(i);
+        shrinkIfSparse();
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::remove(const LookupType &key) {
+    int i = findSlot(key, hashOf(key));
+    if(i >= 0) {
+        eraseSlot(i);
+        shrinkIfSparse();
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::shrinkIfSparse() {
+    if(capacity > minCapacity && entries < maxLoad(capacity) / 4) {
+        int target = capacityFor(entries * 2);
+        resize(target > minCapacity ? target : minCapacity);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::eraseSlot(int i) {
+    slots[i].~Slot();
+    if(matchEmpty(ctrl + (i / GROUP_WIDTH) * GROUP_WIDTH)) {
+        ctrl[i] = EMPTY;
+        growthLeft++;
+    }
+    else {
+        ctrl[i] = DELETED;
+    }
+    entries--;
+}
+
+template <typename KeyType, typename ValueType>
+int MyHashMap<KeyType, ValueType, MyOpenAddressing>::size() const {
+    return entries;
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::clear() {
+    destroySlots();
+    std::memset(ctrl, EMPTY, capacity);
+    entries = 0;
+    growthLeft = maxLoad(capacity);
+    if(bloom != NULL) bloom->clear();
+    if(capacity > minCapacity) {
+        signed char *oldCtrl = ctrl;
+        Slot *oldSlots = slots;
+        allocate(minCapacity);
+        ::operator delete(oldSlots);
+        delete [] oldCtrl;
+    }
+}
+
+/*
+ * 实现笔记：compact
+ * ---------------
+ * 条目直接存放在槽数组中，没有单独的结点，所以只需把槽数组重建为刚好容纳entries个条目的大小
+ * （同时清除墓碑）。下限不是minCapacity：compact是显式的请求。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::compact() {
+    resize(capacityFor(entries));
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::containsKey(const KeyType &key) const {
+    return findSlot(key, hashOf(key)) >= 0;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType * MyHashMap<KeyType, ValueType, MyOpenAddressing>::find(const KeyType &key) {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? NULL : &slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType * MyHashMap<KeyType, ValueType, MyOpenAddressing>::find(const KeyType &key) const {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? NULL : &slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+ValueType MyHashMap<KeyType, ValueType, MyOpenAddressing>::get(const LookupType &key) const {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? ValueType() : slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::containsKey(const LookupType &key) const {
+    return findSlot(key, hashOf(key)) >= 0;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+ValueType * MyHashMap<KeyType, ValueType, MyOpenAddressing>::find(const LookupType &key) {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? NULL : &slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+const ValueType * MyHashMap<KeyType, ValueType, MyOpenAddressing>::find(const LookupType &key) const {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? NULL : &slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::equals(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &other) const {
+    if(size() != other.size()) {
+        return false;
+    }
+    for(int i = 0; i < capacity; ++i) {
+        if(ctrl[i] < 0) continue;
+        int j = other.findSlot(slots[i].key, slots[i].hash);
+        if(j < 0 || slots[i].value != other.slots[j].value) return false;
+    }
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyHashMap<KeyType, ValueType, MyOpenAddressing>::toString() const {
+    std::ostringstream oss;
+    for(int i = 0; i < capacity; ++i) {
+        if(ctrl[i] >= 0) {
+            oss << "{" << slots[i].key << ": " << slots[i].value << "}";
+        }
+    }
+    return oss.str();
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<ValueType> MyHashMap<KeyType, ValueType, MyOpenAddressing>::values() const {
+    MyVector<ValueType> values;
+    for(const ValueType &value : valuesView()) {
+        values.add(value);
+    }
+    return values;
+}
+
+template <typename KeyType, typename ValueType>
+MyHashMap<KeyType, ValueType, MyOpenAddressing>::MyHashMap(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src) {
+    deepCopy(src);
+}
+
+template <typename KeyType, typename ValueType>
+MyHashMap<KeyType, ValueType, MyOpenAddressing> & MyHashMap<KeyType, ValueType, MyOpenAddressing>::operator =(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src) {
+    if(this != &src) {
+        destroySlots();
+        ::operator delete(slots);
+        delete [] ctrl;
+        delete bloom;
+        deepCopy(src);
+    }
+    return *this;
+}
+
+/*
+ * 实现笔记：deepCopy
+ * ----------------
+ * 容量相同的两个表可以直接复制控制字节，并在相同的位置上拷贝构造条目，
+ * 不需要重新计算hash Code。Bloom filter也直接复制。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::deepCopy(const MyHashMap<KeyType, ValueType, MyOpenAddressing> &src) {
+    bloom = NULL;
+    allocate(src.capacity);
+    std::memcpy(ctrl, src.ctrl, capacity);
+    for(int i = 0; i < capacity; ++i) {
+        if(ctrl[i] >= 0) {
+            new (&slots[i]) Slot(src.slots[i]);
+        }
+    }
+    entries = src.entries;
+    growthLeft = src.growthLeft;
+    minCapacity = src.minCapacity;
+    bloom = (src.bloom == NULL) ? NULL : new MyBlockedBloomFilter<KeyType>(*src.bloom);
+}
+
+/*
+ * 实现笔记：enableBloomFilter
+ * -------------------------
+ * filter的大小按负载上限maxLoad(capacity)确定，与拉链法中的growthLimit相对应；
+ * 槽数组重建（扩容、缩容、compact、clear）时allocate会重新调整它。
+ */
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::enableBloomFilter(double falsePositiveRate, size_t maxBytes) {
+    MyBlockedBloomFilter<KeyType> *filter = new MyBlockedBloomFilter<KeyType>(maxLoad(capacity), falsePositiveRate, maxBytes);
+    delete bloom;
+    bloom = filter;
+    for(int i = 0; i < capacity; ++i) {
+        if(ctrl[i] >= 0) filter->addHash(slots[i].hash);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::disableBloomFilter() {
+    delete bloom;
+    bloom = NULL;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::hasBloomFilter() const {
+    return bloom != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType & MyHashMap<KeyType, ValueType, MyOpenAddressing>::operator[] (const KeyType &key) {
+    int i = findOrInsert(key).first;     // 可能扩容，之后再读slots
+    return slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType MyHashMap<KeyType, ValueType, MyOpenAddressing>::operator[] (const KeyType &key) const {
+    int i = findSlot(key, hashOf(key));
+    return (i < 0) ? ValueType() : slots[i].value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::operator == (const MyHashMap<KeyType, ValueType, MyOpenAddressing> &hmp2) const {
+    return this->equals(hmp2);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyHashMap<KeyType, ValueType, MyOpenAddressing>::operator != (const MyHashMap<KeyType, ValueType, MyOpenAddressing> &hmp2) const {
+    return !(*this == hmp2);
+}
+
+template <typename KeyType, typename ValueType>
+void MyHashMap<KeyType, ValueType, MyOpenAddressing>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
+    for(int i = 0; i < capacity; ++i) {
+        if(ctrl[i] >= 0) {
+            fn(slots[i].key, slots[i].value);
+        }
+    }
+}
+
+#endif // _myflathashmap_h
@@ -0,0 +1,637 @@
+/*
+ * File: myfrozenhashmap.h
+ * -----------------------
+ * 该类是只读的散列表：由一个MyHashMap（或一组key-value对）一次性构建，之后只能查找。
+ * 它使用最小完美散列（minimal perfect hashing，PTHash风格）：n个key被一一映射到
+ * 0..n-1，所以条目直接存放在一个长度恰好为n的连续数组中，没有空槽、没有Cell、没有link指针，
+ * 每次查找只计算一次hash Code、访问一次条目数组。
+ *
+ * 构建方法：
+ *      1. 每个key按hash Code分到一个桶（平均每个桶BUCKET_LOAD个key）；
+ *      2. 从最大的桶开始，为每个桶寻找一个"导航值"（pilot）p，使桶中每个key的位置
+ *         position(hash, p)互不相同，也不与之前的桶冲突；
+ *      3. 位置的取值范围比n略大（负载系数约0.95），这样最后几个桶也能很快找到pilot；
+ *         落在n之后的位置再通过一个很小的重映射表（remap）指向0..n-1中剩下的空位；
+ *      4. 某个桶试过MAX_PILOT个pilot仍然找不到时，换一个种子（seed）重新分桶、从头寻找。
+ * 查找时只需读取桶的pilot，算出位置，比较该位置上的key。
+ * 额外空间约为每个key 1字节（pilot）加上0.05个int（remap）。
+ * -------------------------------------------------------------------------------
+ * 参考：https://arxiv.org/abs/2104.10402 (PTHash)
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: pilot的搜索有上限，达到上限时换一个种子重新构建，不会无限循环。
+ */
+
+#ifndef _myfrozenhashmap_h
+#define _myfrozenhashmap_h
+
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "myhashmap.h"
+#include "myvector.h"
+
+template <typename KeyType, typename ValueType>
+class MyFrozenHashMap {
+public:
+    /*
+     * 方法：MyFrozenHashMap
+     * 使用：MyFrozenHashMap<KeyType, ValueType> frozen;
+     *      MyFrozenHashMap<KeyType, ValueType> frozen(map);
+     *      MyFrozenHashMap<KeyType, ValueType> frozen(pairs);
+     * ------------------------------------------------------
+     * 第一种形式构造一个空的map；第二种复制map（拉链法或开放寻址）中的所有条目；
+     * 第三种使用pairs中的key-value对（相同的key以后出现的为准）。
+     * 两个不同的key的hash Code完全相同时无法构建完美散列，抛出std::invalid_argument，
+     * 这通常说明KeyType的MyHash特化质量太差。换了MAX_ATTEMPTS个种子仍然找不到pilot时
+     * （正常的hash Code几乎不可能发生）抛出std::runtime_error。
+     */
+    MyFrozenHashMap();
+    template <typename Policy>
+    explicit MyFrozenHashMap(const MyHashMap<KeyType, ValueType, Policy> &map);
+    explicit MyFrozenHashMap(const MyVector<std::pair<KeyType, ValueType>> &pairs);
+
+    /*
+     * 方法：～MyFrozenHashMap
+     * 使用：隐式调用
+     * -------------
+     * 释放所有条目。
+     */
+    ~MyFrozenHashMap();
+
+    /*
+     * 方法：get
+     * 使用：ValueType value = frozen.get(key);
+     * --------------------------------------
+     * 返回key对应的value，如果key不存在则返回ValueType的默认值。
+     */
+    ValueType get(const KeyType &key) const;
+
+    /*
+     * 方法：tryGet
+     * 使用：if(frozen.tryGet(key, value)) ...
+     * -------------------------------------
+     * key存在时把value复制到out并返回true，否则返回false，out保持不变。
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+
+    /*
+     * 方法：containsKey
+     * 使用：if(frozen.containsKey(key)) ...
+     * -----------------------------------
+     * 如果有key的条目，则返回true。
+     */
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * 方法：find
+     * 使用：const ValueType *vp = frozen.find(key);
+     * -------------------------------------------
+     * 返回指向key对应的value的指针，如果key不存在则返回NULL。
+     * 指针在frozen被销毁或赋值之前一直有效。
+     */
+    const ValueType * find(const KeyType &key) const;
+
+    /*
+     * 异构查找
+     * 使用：frozen.get("apple");
+     * ------------------------
+     * 与MyHashMap相同，满足MyTransparentLookup的LookupType可以直接查找，不构造临时的KeyType。
+     */
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    ValueType get(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    bool containsKey(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    const ValueType * find(const LookupType &key) const;
+
+    /*
+     * 方法：size, isEmpty
+     * 使用：int n = frozen.size();
+     * --------------------------
+     * 返回条目的个数；没有条目时isEmpty返回true。
+     */
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：keys, values
+     * 使用：MyVector<KeyType> keys = frozen.keys();
+     * -------------------------------------------
+     * 按条目数组中的顺序（不可预测）返回所有key或value的副本。
+     */
+    MyVector<KeyType> keys() const;
+    MyVector<ValueType> values() const;
+
+    /*
+     * 方法：mapAll
+     * 使用：frozen.mapAll(fn);
+     * ----------------------
+     * 按条目数组中的顺序对每个条目调用fn(key, value)。
+     */
+    void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+    /*
+     * 方法：toString
+     * 使用：string str = frozen.toString();
+     * -----------------------------------
+     * 格式与MyHashMap相同，例如"{k1: v1}{k2: v2}"。
+     */
+    std::string toString() const;
+
+    /*
+     * 方法：bytesUsed
+     * 使用：size_t bytes = frozen.bytesUsed();
+     * --------------------------------------
+     * 返回条目数组、pilot和remap占用的字节数（不含key、value自己在堆上分配的内存）。
+     */
+    size_t bytesUsed() const;
+
+    /*
+     * 拷贝构造函数与赋值运算符
+     * ----------------------
+     * 深拷贝：直接复制条目数组、pilot和remap，不需要重新构建。
+     */
+    MyFrozenHashMap(const MyFrozenHashMap<KeyType, ValueType> &src);
+    MyFrozenHashMap<KeyType, ValueType> & operator=(const MyFrozenHashMap<KeyType, ValueType> &src);
+
+private:
+    struct Entry {
+        KeyType key;
+        ValueType value;
+    };
+
+    /* 平均每个桶的key数，越大pilot越少，但构建越慢 */
+    static const int BUCKET_LOAD = 4;
+    /* 位置的取值范围 = n + n / SLACK_DIVISOR + 1，即负载系数约为0.95 */
+    static const int SLACK_DIVISOR = 20;
+    /* 每个桶最多尝试的pilot个数，以及最多尝试的种子个数 */
+    static const unsigned MAX_PILOT = 1U << 16;
+    static const int MAX_ATTEMPTS = 8;
+
+    /* 实例变量 */
+    Entry *entries;         // n个条目，下标即完美散列的结果
+    int n;
+    unsigned *pilots;       // 每个桶的pilot
+    int nBuckets;
+    int *remap;             // 位置n..range-1对应的条目下标
+    int range;              // 位置的取值范围
+    unsigned long long seed;    // 与hash Code混合之后再分桶、计算位置
+
+    /*
+     * 方法：bucketOf, positionOf
+     * 使用：int b = bucketOf(hash);
+     *      int pos = positionOf(hash, pilots[b]);
+     * ------------------------------------------
+     * 先与seed一起混合hash Code，所以质量较差的MyHash（例如只返回int）也能均匀地分到桶和位置上。
+     * positionOf返回0..range-1之间的位置，还没有经过remap。
+     */
+    int bucketOf(unsigned long long hash) const;
+    int positionOf(unsigned long long hash, unsigned pilot) const;
+
+    /*
+     * 方法：slotOf
+     * 使用：int i = slotOf(hash);
+     * -------------------------
+     * 返回hash Code为hash的key所在的条目下标（经过remap），没有条目时返回-1。
+     * 调用者还需要比较该条目的key。
+     */
+    int slotOf(unsigned long long hash) const;
+
+    template <typename LookupType>
+    const Entry * findEntry(const LookupType &key, unsigned long long hash) const;
+
+    /*
+     * 方法：build
+     * 使用：build(keys, values, count);
+     * -------------------------------
+     * 用count个互不相同的key（以及对应的value）构建完美散列并复制条目。
+     */
+    void build(const KeyType * const *keys, const ValueType * const *values, int count);
+
+    /*
+     * 方法：searchPilots
+     * 使用：if(searchPilots(hashes, position, taken)) ...
+     * -------------------------------------------------
+     * 用当前的seed分桶，为每个桶寻找pilot，写入pilots，并把每个key的位置写入position、
+     * 被占用的位置在taken中标记为true。某个桶试过MAX_PILOT个pilot仍然找不到时返回false。
+     */
+    bool searchPilots(const MyVector<unsigned long long> &hashes, MyVector<int> &position, MyVector<bool> &taken);
+    void clearAll();
+    void deepCopy(const MyFrozenHashMap<KeyType, ValueType> &src);
+};
+
+template <typename KeyType, typename ValueType>
+MyFrozenHashMap<KeyType, ValueType>::MyFrozenHashMap() {
+    entries = nullptr;
+    pilots = nullptr;
+    remap = nullptr;
+    n = nBuckets = range = 0;
+    seed = 0;
+}
+
+/*
+ * 实现笔记：构造函数
+ * ----------------
+ * 先收集指向map中每个key和value的指针，build只在最后复制条目。
+ * 从pairs构造时先用一个临时的MyHashMap去掉重复的key。
+ */
+template <typename KeyType, typename ValueType>
+template <typename Policy>
+MyFrozenHashMap<KeyType, ValueType>::MyFrozenHashMap(const MyHashMap<KeyType, ValueType, Policy> &map) {
+    entries = nullptr;
+    pilots = nullptr;
+    remap = nullptr;
+    n = nBuckets = range = 0;
+    seed = 0;
+
+    MyVector<const KeyType *> keys;
+    MyVector<const ValueType *> values;
+    for(typename MyHashMap<KeyType, ValueType, Policy>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        keys.add(&it.key());
+        values.add(&it.value());
+    }
+    if(keys.size() > 0) {
+        build(&keys[0], &values[0], keys.size());
+    }
+}
+
+template <typename KeyType, typename ValueType>
+MyFrozenHashMap<KeyType, ValueType>::MyFrozenHashMap(const MyVector<std::pair<KeyType, ValueType>> &pairs) {
+    entries = nullptr;
+    pilots = nullptr;
+    remap = nullptr;
+    n = nBuckets = range = 0;
+    seed = 0;
+
+    MyHashMap<KeyType, ValueType, MyOpenAddressing> unique(pairs.size());
+    unique.putAll(pairs);
+    MyFrozenHashMap<KeyType, ValueType> built(unique);
+    std::swap(entries, built.entries);
+    std::swap(n, built.n);
+    std::swap(pilots, built.pilots);
+    std::swap(nBuckets, built.nBuckets);
+    std::swap(remap, built.remap);
+    std::swap(range, built.range);
+    std::swap(seed, built.seed);
+}
+
+template <typename KeyType, typename ValueType>
+MyFrozenHashMap<KeyType, ValueType>::~MyFrozenHashMap() {
+    clearAll();
+}
+
+template <typename KeyType, typename ValueType>
+void MyFrozenHashMap<KeyType, ValueType>::clearAll() {
+    for(int i = 0; i < n; ++i) {
+        entries[i].~Entry();
+    }
+    ::operator delete(entries);
+    delete [] pilots;
+    delete [] remap;
+    entries = nullptr;
+    pilots = nullptr;
+    remap = nullptr;
+    n = nBuckets = range = 0;
+    seed = 0;
+}
+
+/*
+ * 实现笔记：bucketOf
+ * ----------------
+ * 与PTHash相同，桶的大小是有意不均匀的：约60%的key落在前30%的桶中。
+ * 这些大桶最先处理，那时表还很空；最后处理的桶大多只有一两个key，
+ * 即使表已经很满也能较快找到pilot。
+ */
+template <typename KeyType, typename ValueType>
+int MyFrozenHashMap<KeyType, ValueType>::bucketOf(unsigned long long hash) const {
+    unsigned long long x = myhashMix(hash ^ seed);
+    unsigned long long dense = (unsigned long long)nBuckets * 3 / 10 + 1;
+    if(dense >= (unsigned long long)nBuckets) return int(x % (unsigned long long)nBuckets);
+    if(x < 0x9999999999999999ULL) return int((x >> 1) % dense);
+    return int(dense + (x >> 1) % ((unsigned long long)nBuckets - dense));
+}
+
+template <typename KeyType, typename ValueType>
+int MyFrozenHashMap<KeyType, ValueType>::positionOf(unsigned long long hash, unsigned pilot) const {
+    return int(myhashMix(hash ^ seed ^ ((pilot + 1ULL) * 0x9e3779b97f4a7c15ULL)) % (unsigned long long)range);
+}
+
+template <typename KeyType, typename ValueType>
+int MyFrozenHashMap<KeyType, ValueType>::slotOf(unsigned long long hash) const {
+    if(n == 0) return -1;
+    int pos = positionOf(hash, pilots[bucketOf(hash)]);
+    return (pos < n) ? pos : remap[pos - n];
+}
+
+/*
+ * 实现笔记：build
+ * -------------
+ * 1. 计算每个key的hash Code；
+ * 2. 用searchPilots分桶并寻找所有的pilot。与PTHash相同，某个桶找不到pilot时不无限地试下去，
+ *    而是换一个种子从头开始：新的种子改变了每个key的桶和位置，原来困难的桶不会再一起出现；
+ * 3. 把n..range-1中被占用的位置依次对应到0..n-1中剩下的空位；
+ * 4. 最后才把条目复制到最终位置，复制时抛出异常的话销毁已经复制的条目。
+ */
+template <typename KeyType, typename ValueType>
+void MyFrozenHashMap<KeyType, ValueType>::build(const KeyType * const *keys, const ValueType * const *values, int count) {
+    n = count;
+    range = n + n / SLACK_DIVISOR + 1;
+    nBuckets = (n + BUCKET_LOAD - 1) / BUCKET_LOAD;
+
+    MyVector<unsigned long long> hashes(n);
+    for(int i = 0; i < n; ++i) {
+        hashes[i] = hashCode(*keys[i]);
+    }
+
+    MyVector<bool> taken(range, false);
+    MyVector<int> position(n);
+    int constructed = 0;
+    try {
+        pilots = new unsigned[nBuckets];
+        for(int attempt = 1; !searchPilots(hashes, position, taken); ++attempt) {
+            if(attempt == MAX_ATTEMPTS) {
+                throw std::runtime_error("MyFrozenHashMap: can not find a perfect hash function for these keys");
+            }
+            seed = myhashMix(seed + 0x9e3779b97f4a7c15ULL);
+        }
+
+        remap = new int[range - n];
+        int hole = 0;
+        for(int pos = n; pos < range; ++pos) {
+            if(taken[pos]) {
+                while(taken[hole]) hole++;
+                remap[pos - n] = hole++;
+            }
+            else {
+                remap[pos - n] = -1;
+            }
+        }
+        for(int i = 0; i < n; ++i) {
+            if(position[i] >= n) position[i] = remap[position[i] - n];
+        }
+
+        entries = static_cast<Entry *>(::operator new(sizeof(Entry) * n));
+        for(; constructed < n; ++constructed) {
+            new (&entries[position[constructed]]) Entry{*keys[constructed], *values[constructed]};
+        }
+    }
+    catch(...) {
+        for(int i = 0; i < constructed; ++i) {
+            entries[position[i]].~Entry();
+        }
+        n = 0;
+        clearAll();
+        throw;
+    }
+}
+
+/*
+ * 实现笔记：searchPilots
+ * --------------------
+ * 1. 用计数排序按桶分组；
+ * 2. 同一个桶中两个key的hash Code相同时，换什么种子都找不到pilot，先检查并抛出std::invalid_argument；
+ * 3. 桶按大小从大到小处理（同样用计数排序），大桶在表还很空时就能找到pilot；
+ *    对每个桶从p = 0开始尝试，直到桶中所有key的位置都还没被占用且互不相同。
+ *    负载系数约0.95时，最后的单key桶平均约20次就能找到pilot，MAX_PILOT次都失败几乎不可能，
+ *    这时清空taken并返回false，由build换一个种子。
+ */
+template <typename KeyType, typename ValueType>
+bool MyFrozenHashMap<KeyType, ValueType>::searchPilots(const MyVector<unsigned long long> &hashes, MyVector<int> &position, MyVector<bool> &taken) {
+    MyVector<int> bucketStart(nBuckets + 1, 0);
+    for(int i = 0; i < n; ++i) {
+        bucketStart[bucketOf(hashes[i]) + 1]++;
+    }
+    int maxSize = 0;
+    for(int b = 0; b < nBuckets; ++b) {
+        if(bucketStart[b + 1] > maxSize) maxSize = bucketStart[b + 1];
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    MyVector<int> members(n);
+    MyVector<int> next = bucketStart;
+    for(int i = 0; i < n; ++i) {
+        members[next[bucketOf(hashes[i])]++] = i;
+    }
+
+    MyVector<int> bySize(nBuckets);
+    MyVector<int> sizeStart(maxSize + 2, 0);
+    for(int b = 0; b < nBuckets; ++b) {
+        sizeStart[maxSize - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+    }
+    for(int s = 0; s <= maxSize; ++s) {
+        sizeStart[s + 1] += sizeStart[s];
+    }
+    for(int b = 0; b < nBuckets; ++b) {
+        bySize[sizeStart[maxSize - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+    }
+
+    for(int b = 0; b < nBuckets; ++b) {
+        for(int x = bucketStart[b]; x < bucketStart[b + 1]; ++x) {
+            for(int y = bucketStart[b]; y < x; ++y) {
+                if(hashes[members[x]] == hashes[members[y]]) {
+                    throw std::invalid_argument("MyFrozenHashMap: two different keys have the same hash code");
+                }
+            }
+        }
+    }
+
+    MyVector<int> tried(maxSize);
+    for(int k = 0; k < nBuckets; ++k) {
+        int b = bySize[k];
+        int first = bucketStart[b], size = bucketStart[b + 1] - first;
+        unsigned pilot = 0;
+        for(; pilot < MAX_PILOT; ++pilot) {
+            bool ok = true;
+            for(int x = 0; x < size && ok; ++x) {
+                int pos = positionOf(hashes[members[first + x]], pilot);
+                if(taken[pos]) ok = false;
+                for(int y = 0; y < x && ok; ++y) {
+                    if(tried[y] == pos) ok = false;
+                }
+                tried[x] = pos;
+            }
+            if(ok) break;
+        }
+        if(pilot == MAX_PILOT) {
+            for(int pos = 0; pos < range; ++pos) {
+                taken[pos] = false;
+            }
+            return false;
+        }
+        for(int x = 0; x < size; ++x) {
+            taken[tried[x]] = true;
+            position[members[first + x]] = tried[x];
+        }
+        pilots[b] = pilot;
+    }
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType>
+const typename MyFrozenHashMap<KeyType, ValueType>::Entry * MyFrozenHashMap<KeyType, ValueType>::findEntry(const LookupType &key, unsigned long long hash) const {
+    int i = slotOf(hash);
+    if(i < 0 || entries[i].key != key) return nullptr;
+    return &entries[i];
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyFrozenHashMap<KeyType, ValueType>::get(const KeyType &key) const {
+    const Entry *e = findEntry(key, hashCode(key));
+    return (e == nullptr) ? ValueType() : e->value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyFrozenHashMap<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) const {
+    const Entry *e = findEntry(key, hashCode(key));
+    if(e == nullptr) return false;
+    out = e->value;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyFrozenHashMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    return findEntry(key, hashCode(key)) != nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType * MyFrozenHashMap<KeyType, ValueType>::find(const KeyType &key) const {
+    const Entry *e = findEntry(key, hashCode(key));
+    return (e == nullptr) ? NULL : &e->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+ValueType MyFrozenHashMap<KeyType, ValueType>::get(const LookupType &key) const {
+    const Entry *e = findEntry(key, MyTransparentLookup<KeyType, LookupType>::hash(key));
+    return (e == nullptr) ? ValueType() : e->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+bool MyFrozenHashMap<KeyType, ValueType>::containsKey(const LookupType &key) const {
+    return findEntry(key, MyTransparentLookup<KeyType, LookupType>::hash(key)) != nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+const ValueType * MyFrozenHashMap<KeyType, ValueType>::find(const LookupType &key) const {
+    const Entry *e = findEntry(key, MyTransparentLookup<KeyType, LookupType>::hash(key));
+    return (e == nullptr) ? NULL : &e->value;
+}
+
+template <typename KeyType, typename ValueType>
+int MyFrozenHashMap<KeyType, ValueType>::size() const {
+    return n;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyFrozenHashMap<KeyType, ValueType>::isEmpty() const {
+    return n == 0;
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyFrozenHashMap<KeyType, ValueType>::keys() const {
+    MyVector<KeyType> keys;
+    for(int i = 0; i < n; ++i) {
+        keys.add(entries[i].key);
+    }
+    return keys;
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<ValueType> MyFrozenHashMap<KeyType, ValueType>::values() const {
+    MyVector<ValueType> values;
+    for(int i = 0; i < n; ++i) {
+        values.add(entries[i].value);
+    }
+    return values;
+}
+
+template <typename KeyType, typename ValueType>
+void MyFrozenHashMap<KeyType, ValueType>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
+    for(int i = 0; i < n; ++i) {
+        fn(entries[i].key, entries[i].value);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyFrozenHashMap<KeyType, ValueType>::toString() const {
+    std::ostringstream oss;
+    for(int i = 0; i < n; ++i) {
+        oss << "{" << entries[i].key << ": " << entries[i].value << "}";
+    }
+    return oss.str();
+}
+
+template <typename KeyType, typename ValueType>
+std::ostream & operator<<(std::ostream &os, const MyFrozenHashMap<KeyType, ValueType> &frozen) {
+    return os << frozen.toString();
+}
+
+template <typename KeyType, typename ValueType>
+size_t MyFrozenHashMap<KeyType, ValueType>::bytesUsed() const {
+    return sizeof(Entry) * size_t(n) + sizeof(unsigned) * size_t(nBuckets) + sizeof(int) * size_t(range - n);
+}
+
+template <typename KeyType, typename ValueType>
+MyFrozenHashMap<KeyType, ValueType>::MyFrozenHashMap(const MyFrozenHashMap<KeyType, ValueType> &src) {
+    entries = nullptr;
+    pilots = nullptr;
+    remap = nullptr;
+    n = nBuckets = range = 0;
+    seed = 0;
+    deepCopy(src);
+}
+
+template <typename KeyType, typename ValueType>
+MyFrozenHashMap<KeyType, ValueType> & MyFrozenHashMap<KeyType, ValueType>::operator=(const MyFrozenHashMap<KeyType, ValueType> &src) {
+    if(this != &src) {
+        MyFrozenHashMap<KeyType, ValueType> copy(src);
+        std::swap(entries, copy.entries);
+        std::swap(n, copy.n);
+        std::swap(pilots, copy.pilots);
+        std::swap(nBuckets, copy.nBuckets);
+        std::swap(remap, copy.remap);
+        std::swap(range, copy.range);
+        std::swap(seed, copy.seed);
+    }
+    return *this;
+}
+
+/*
+ * 实现笔记：deepCopy
+ * ----------------
+ * pilot和remap只依赖于hash Code，直接复制即可；条目逐个复制构造。
+ * 三个数组的分配和条目的复制都在同一个try块中：任何一步抛出异常时，
+ * clearAll释放已经分配的数组、销毁已经复制的条目（还没有分配的指针仍为nullptr），*this保持为空。
+ */
+template <typename KeyType, typename ValueType>
+void MyFrozenHashMap<KeyType, ValueType>::deepCopy(const MyFrozenHashMap<KeyType, ValueType> &src) {
+    if(src.n == 0) return;
+    seed = src.seed;
+    try {
+        pilots = new unsigned[src.nBuckets];
+        nBuckets = src.nBuckets;
+        for(int b = 0; b < nBuckets; ++b) {
+            pilots[b] = src.pilots[b];
+        }
+        remap = new int[src.range - src.n];
+        range = src.range;
+        for(int i = 0; i < range - src.n; ++i) {
+            remap[i] = src.remap[i];
+        }
+        entries = static_cast<Entry *>(::operator new(sizeof(Entry) * src.n));
+        for(; n < src.n; ++n) {
+            new (&entries[n]) Entry(src.entries[n]);
+        }
+    }
+    catch(...) {
+        clearAll();
+        throw;
+    }
+}
+
+#endif // _myfrozenhashmap_h
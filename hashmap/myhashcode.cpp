@@ -1,32 +1,151 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <cstring>
+#include <chrono>
+#include <random>
 #include "myhashcode.h"
 /*
  * Implementation notes: myhashCode
  * ------------------------------
- * This function takes a string key and uses it to derive a hash code,
- * which is a nonnegative integer related to the key by a deterministic
- * function that distributes keys well across the space of integers.
- * The general method is called linear congruence, which is also used
- * in random-number generators. The specific algorithm used here is
- * called djb2 after the initials of its inventor, Daniel J. Bernstein.
+ * This function takes a string key and uses it to derive a 64-bit hash
+ * code, which is related to the key by a deterministic function that
+ * distributes keys well across the space of integers.
+ *
+ * The algorithm follows wyhash by Wang Yi. The key is consumed eight bytes
+ * at a time; every pair of words is combined with a 64x64->128 bit multiply
+ * whose high and low halves are folded together ("mum"), which mixes all
+ * input bits into the result at the cost of one multiplication per sixteen
+ * bytes. Keys of at most sixteen bytes are read with a few overlapping
+ * loads and need no loop at all.
+ *
+ * The seed takes part in every round, so with a random seed an attacker
+ * cannot precompute a set of keys that collide.
+ * Reference: https://github.com/wangyi-fudan/wyhash
  */
 
-// Starting point for first cycle
-const int HASH_SEED = 5381;
-// Multiplier for each cycle
-const int HASH_MULTIPLIER = 33;
-// All 1 bits except the sign
-const int HASH_MASK = unsigned(-1) >> 1;
-
-int myhashCode(const std::string &str) {
-    unsigned hash = HASH_SEED;
-    int n = str.length();
-    for(int i = 0; i < n; ++i) {
-        hash = HASH_MULTIPLIER * hash + str[i];
+// Starting point for the seed, the value djb2 used to start from
+unsigned long long myhashCurrentSeed = 5381;
+
+namespace {
+
+// Odd constants with balanced bits used to whiten the input
+const unsigned long long SECRET0 = 0xa0761d6478bd642fULL;
+const unsigned long long SECRET1 = 0xe7037ed1a0b428dbULL;
+const unsigned long long SECRET2 = 0x8ebc6af09c88c6e3ULL;
+const unsigned long long SECRET3 = 0x589965cc75374cc3ULL;
+
+/* Multiplies a and b and returns the 128-bit product in a (low) and b (high). */
+inline void mum(unsigned long long &a, unsigned long long &b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = a;
+    r *= b;
+    a = (unsigned long long)r;
+    b = (unsigned long long)(r >> 64);
+#else
+    unsigned long long ha = a >> 32, hb = b >> 32, la = (unsigned)a, lb = (unsigned)b;
+    unsigned long long rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    unsigned long long t = rl + (rm0 << 32), c = t < rl;
+    unsigned long long lo = t + (rm1 << 32);
+    c += lo < t;
+    unsigned long long hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    a = lo;
+    b = hi;
+#endif
+}
+
+inline unsigned long long mix(unsigned long long a, unsigned long long b) {
+    mum(a, b);
+    return a ^ b;
+}
+
+inline unsigned long long read8(const unsigned char *p) {
+    unsigned long long v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline unsigned long long read4(const unsigned char *p) {
+    unsigned v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline unsigned long long read3(const unsigned char *p, size_t k) {
+    return ((unsigned long long)p[0] << 16) | ((unsigned long long)p[k >> 1] << 8) | p[k - 1];
+}
+
+}
+
+unsigned long long myhashCode(const std::string &str) {
+    return myhashCode(str.data(), str.length(), myhashCurrentSeed);
+}
+
+unsigned long long myhashCode(const char *data, size_t length) {
+    return myhashCode(data, length, myhashCurrentSeed);
+}
+
+unsigned long long myhashCode(const char *data, size_t length, unsigned long long seed) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    unsigned long long a, b;
+
+    seed ^= mix(seed ^ SECRET0, SECRET1);
+    if(length <= 16) {
+        if(length >= 4) {
+            size_t shift = (length >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + shift);
+            b = (read4(p + length - 4) << 32) | read4(p + length - 4 - shift);
+        }
+        else if(length > 0) {
+            a = read3(p, length);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
     }
+    else {
+        size_t i = length;
+        if(i > 48) {
+            unsigned long long see1 = seed, see2 = seed;
+            do {
+                seed = mix(read8(p) ^ SECRET1, read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ SECRET2, read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ SECRET3, read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16) {
+            seed = mix(read8(p) ^ SECRET1, read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= SECRET1;
+    b ^= seed;
+    mum(a, b);
+    return mix(a ^ SECRET0 ^ length, b ^ SECRET1);
+}
 
-    return int(hash % HASH_MASK);
+void myhashSetSeed(unsigned long long seed) {
+    myhashCurrentSeed = seed;
 }
 
+/*
+ * Implementation notes: myhashUseRandomSeed
+ * -----------------------------------------
+ * std::random_device is mixed with the clock, because on some platforms
+ * random_device is deterministic.
+ */
+unsigned long long myhashUseRandomSeed() {
+    std::random_device device;
+    unsigned long long seed = ((unsigned long long)device() << 32) ^ device();
+    seed ^= (unsigned long long)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    myhashSetSeed(myhashMix(seed));
+    return myhashCurrentSeed;
+}
@@ -4,30 +4,213 @@
  * The stanford implementation of the HashMap class uses
  * the hash funcion for string, which was developed by
  * Daniel J.Bernstein.
+ *
+ * 更新：
+ *      1. 2026.10.18: 添加MyHash<T>，按类型选择hash函数：整数类型使用64位混合函数，
+ *                     std::string直接对字节计算，其余类型才退回到ostringstream。
+ *      2. 2026.10.18: 字符串hash由djb2改为按字（8字节）处理的64位wyhash风格算法，
+ *                     返回完整的64位hash Code，并支持设置或随机生成进程级的种子。
+ *      3. 2026.10.18: 添加MyTransparentLookup，允许不构造key直接用兼容的类型（如C字符串）查找。
  */
 
 #ifndef _myhashcode_h
 #define _myhashcode_h
 
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+/*
+ * 函数：myhashCode
+ * 使用：unsigned long long code = myhashCode(str);
+ *      unsigned long long code = myhashCode(data, length);
+ *      unsigned long long code = myhashCode(data, length, seed);
+ * -----------------------------------------------------------
+ * 对字符串（或[data, data + length)中的字节）计算64位hash Code。
+ * 前两种形式使用当前进程的种子（见myhashSeed），第三种使用指定的种子。
+ * 相同内容的std::string与字节序列得到相同的结果。
+ */
+unsigned long long myhashCode(const std::string &str);
+unsigned long long myhashCode(const char *data, size_t length);
+unsigned long long myhashCode(const char *data, size_t length, unsigned long long seed);
+
+/*
+ * 函数：myhashSeed, myhashSetSeed, myhashUseRandomSeed
+ * 使用：myhashUseRandomSeed();
+ * ---------------------------
+ * 所有hash Code都依赖一个进程级的种子，默认是固定值，所以同一个key在每次运行中
+ * 得到相同的hash Code。如果key可能来自不可信的输入（例如请求中的URL），
+ * 可以在程序开始时调用myhashUseRandomSeed，使用随机种子来抵御hash flooding攻击。
+ *
+ * 注意：种子改变后，已经存放在散列表中的key的hash Code会失效，
+ * 所以必须在创建任何散列表之前设置种子。
+ */
+extern unsigned long long myhashCurrentSeed;
+
+inline unsigned long long myhashSeed() {
+    return myhashCurrentSeed;
+}
+
+void myhashSetSeed(unsigned long long seed);
+unsigned long long myhashUseRandomSeed();
+
+/*
+ * 函数：myhashMix
+ * 使用：unsigned long long h = myhashMix(x);
+ * -----------------------------------------
+ * 64位整数的混合函数（splitmix64的finalizer），输入的每一位都会影响输出的每一位，
+ * 所以连续的整数也会被均匀地打散。
+ */
+inline unsigned long long myhashMix(unsigned long long x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/*
+ * 函数：myhashCombine
+ * 使用：h = myhashCombine(h, hashCode(member));
+ * -------------------------------------------
+ * 把一个成员的hash Code合并到已有的hash Code中，用于为自定义的复合类型编写MyHash。
+ */
+inline unsigned long long myhashCombine(unsigned long long seed, unsigned long long code) {
+    return myhashMix(seed ^ (code + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
 
-int myhashCode(const std::string &str);
+/*
+ * 类：MyHash<T>
+ * 使用：unsigned long long code = MyHash<KeyType>()(key);
+ * ----------------------------------------------------
+ * 计算key的64位hash Code。默认的实现把key用插入操作符（<<）写入
+ * ostringstream，再对得到的字符串计算hash Code，所以KeyType需要支持<<。
+ * 下面为常用类型提供了不经过字符串的特化版本：
+ *      整数、枚举：myhashMix（与种子混合）
+ *      浮点数：对其二进制表示调用myhashMix（+0.0与-0.0的hash Code相同）
+ *      指针：对地址调用myhashMix
+ *      std::string：直接对字节计算
+ *      std::pair：合并两个成员的hash Code
+ *
+ * 对于自己定义的类型，可以特化MyHash来避免字符串化，例如：
+ *      template <>
+ *      struct MyHash<Point> {
+ *          unsigned long long operator()(const Point &p) const {
+ *              return myhashCombine(hashCode(p.x), hashCode(p.y));
+ *          }
+ *      };
+ * 特化必须与该类型的 == / != 保持一致：相等的key必须有相同的hash Code。
+ */
+template <typename T, typename Enable = void>
+struct MyHash {
+    unsigned long long operator()(const T &key) const {
+        std::ostringstream os;
+        os << key;
+        return myhashCode(os.str());
+    }
+};
+
+template <typename T>
+struct MyHash<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type> {
+    unsigned long long operator()(const T &key) const {
+        return myhashMix((unsigned long long)key ^ myhashSeed());
+    }
+};
+
+template <typename T>
+struct MyHash<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    unsigned long long operator()(const T &key) const {
+        double value = (key == 0) ? 0.0 : double(key);
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return myhashMix(bits ^ myhashSeed());
+    }
+};
+
+template <typename T>
+struct MyHash<T *> {
+    unsigned long long operator()(T *key) const {
+        return myhashMix((unsigned long long)(size_t)key ^ myhashSeed());
+    }
+};
+
+template <>
+struct MyHash<std::string> {
+    unsigned long long operator()(const std::string &key) const {
+        return myhashCode(key.data(), key.size());
+    }
+};
+
+template <typename T1, typename T2>
+struct MyHash<std::pair<T1, T2> > {
+    unsigned long long operator()(const std::pair<T1, T2> &key) const {
+        return myhashCombine(MyHash<T1>()(key.first), MyHash<T2>()(key.second));
+    }
+};
+
+/*
+ * 类：MyTransparentLookup<KeyType, LookupType>
+ * 使用：unsigned long long code = MyTransparentLookup<std::string, const char *>::hash(str);
+ * ---------------------------------------------------------------------------------------
+ * 标记可以直接用LookupType查找KeyType的组合（heterogeneous lookup），这样查找时不必先构造
+ * 一个临时的KeyType。value为true时必须满足：
+ *      1. hash(lookup)与hashCode(KeyType(lookup))相同；
+ *      2. KeyType与LookupType之间可以用 == / != 比较，结果与先转换再比较相同。
+ * MyHashMap和MyHashSet对满足条件的LookupType提供get、containsKey、remove、find等模板重载。
+ *
+ * 这里为std::string提供了C字符串（const char *、字符数组）和C++17的std::string_view。
+ * 对于其他类型，可以特化该模板：
+ *      template <>
+ *      struct MyTransparentLookup<Point, PointRef> {
+ *          static const bool value = true;
+ *          static unsigned long long hash(const PointRef &p) { ... }
+ *      };
+ */
+template <typename KeyType, typename LookupType, typename Enable = void>
+struct MyTransparentLookup {
+    static const bool value = false;
+};
+
+template <typename LookupType>
+struct MyTransparentLookup<std::string, LookupType,
+                           typename std::enable_if<std::is_convertible<LookupType, const char *>::value>::type> {
+    static const bool value = true;
+    static unsigned long long hash(const char *key) {
+        return myhashCode(key, std::strlen(key));
+    }
+};
+
+#if __cplusplus >= 201703L
+template <>
+struct MyTransparentLookup<std::string, std::string_view> {
+    static const bool value = true;
+    static unsigned long long hash(std::string_view key) {
+        return myhashCode(key.data(), key.size());
+    }
+};
+#endif
 
 /*
  * 方法：hashCode
- * 使用：int bucket = hashCode(key);
+ * 使用：unsigned long long code = hashCode(key);
  * --------------------------------
- * 计算key的hash Code，这里key支持多个类型
- * 但是需要保证KeyType支持插入操作符（<<）
- * 对于自己定义的类型，特别注意
+ * 计算key的hash Code，这里key支持多个类型，
+ * 具体使用的hash函数由MyHash<T>决定。
+ * 对于自己定义的类型，需要支持插入操作符（<<），或者特化MyHash<T>。
  */
 template <typename T>
-int hashCode(const T &rat);
+unsigned long long hashCode(const T &rat);
 
 template <typename T>
-int hashCode(const T &rat) {
-    std::ostringstream os;
-    os << rat;
-    return myhashCode(os.str());
+unsigned long long hashCode(const T &rat) {
+    return MyHash<T>()(rat);
 }
 #endif
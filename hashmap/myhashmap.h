@@ -1,9 +1,20 @@
 #ifndef _myhashmap_h
 #define _myhashmap_h
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <iterator>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "mybloomfilter.h"
 #include "myhashcode.h"
+#include "mynodepool.h"
+#include "mysnapshot.h"
 #include "myvector.h"
 #include <iostream>
 /*
@@ -18,8 +29,240 @@
  *      1. 2024.4.8：重写并添加中文注释
  *      2. 2024.4.14：添加"myvector.h" 以实现keys(), values()
  *      3. 2024.4.24: 添加mapAll支持callback函数
+ *      4. 2026.10.18: 添加模板参数Policy，用于选择散列表的底层实现（见下方的MySeparateChaining/MyOpenAddressing）
+ *      5. 2026.10.18: 篮子数量改为2的幂，用位与（&）代替取模选择篮子；rehashing改为原地重新链接Cell，
+ *                     不再重新分配Cell，也不再重新计算hash Code。
+ *      6. 2026.10.18: 添加渐进式rehashing模式（setIncrementalRehash），把迁移的代价分摊到之后的操作中。
+ *      7. 2026.10.18: 查找时先比较Cell中保存的hash Code，只有hash Code相同才比较key。
+ *      8. 2026.10.18: Cell改为从每个map自己的结点池（MyNodePool）中分配，clear()整体归还，
+ *                     添加poolStats()查看结点池的占用情况。
+ *      9. 2026.10.18: 添加reserve、指定预期大小的构造函数以及批量插入的putAll。
+ *     10. 2026.10.18: 添加find，get、containsKey、remove、find支持异构查找（见MyTransparentLookup）。
+ *     11. 2026.10.18: 添加tryGet、tryEmplace、insertOrAssign、computeIfAbsent、merge，每个只计算一次hash Code、
+ *                     查找一次；get在key不存在时返回ValueType的默认值（原来返回""，只适用于字符串）。
+ *     12. 2026.10.18: 添加迭代器（支持基于范围的for循环）以及借用map的keysView()、valuesView()；
+ *                     keys()、values()沿迭代器直接生成结果，删除sequentialTraversal。
+ *     13. 2026.10.18: 添加多线程批量构建buildParallel：按hash Code对输入做radix partition，
+ *                     每个线程只写属于自己分区的篮子，Cell从线程自己的结点池分配，最后并入map的结点池。
+ *     14. 2026.10.18: 添加批量查找getMany、containsMany，一批key先预取篮子和Cell再比较，重叠cache miss。
+ *     15. 2026.10.18: 添加saveSnapshot，写出可以由MyMappedHashMap直接mmap使用的快照（见mysnapshot.h）。
+ *     16. 2026.10.18: 添加stats()：篮子占用直方图、探测长度、占用的字节数；定义MY_HASHMAP_STATS时
+ *                     还统计查找次数、比较过的Cell数以及rehashing的次数和耗时（见MyHashMapStats）。
+ *     17. 2026.10.18: remove之后条目数不足rehashing阈值的1/4时把篮子缩小到约两倍条目数（滞后缩容），
+ *                     clear()把篮子还原为初始数量；添加compact()，把Cell搬到紧凑的新结点池并释放旧块。
+ *     18. 2026.10.18: 添加可选的Bloom filter（enableBloomFilter），查找不存在的key时不必读取篮子和链表。
+ *     19. 2026.10.18: myhashParallelFor创建线程失败时先等待已经启动的线程，再把异常返回给调用者。
+ */
+
+/*
+ * 散列表策略（Policy）
+ * 使用：MyHashMap<int, std::string> map;                       // 默认：拉链法
+ *      MyHashMap<int, std::string, MyOpenAddressing> flatMap;  // 开放寻址（SwissTable风格）
+ * ------------------------------------------------------------------------------------
+ * MySeparateChaining 是默认的拉链法实现；MyOpenAddressing 选择 myflathashmap.h 中的开放寻址实现，
+ * 它把key-value存放在连续的槽数组中，并用控制字节（control bytes）一次探测16个槽。
+ * 两种实现提供相同的接口。
+ */
+struct MySeparateChaining {};
+struct MyOpenAddressing {};
+
+/*
+ * 结构体：MyHashMapStats
+ * 使用：MyHashMapStats s = map.stats();
+ *      std::cout << s << std::endl;
+ * -----------------------------------
+ * stats()返回的散列表状况，用来诊断hash Code分布不好的key类型。
+ * 前面几项由stats()遍历散列表当场算出，总是可用；后面的计数只在编译时定义了MY_HASHMAP_STATS
+ * （例如g++ -DMY_HASHMAP_STATS）时才会在每次查找和rehashing中收集，否则相关代码完全不存在，
+ * 计数都是0。计数属于每个map自己，拷贝得到的map从0开始。
+ *
+ * "篮子"在拉链法中是一个链表，在开放寻址中是一组GROUP_WIDTH个槽；
+ * "探测长度"在拉链法中是找到一个条目需要比较的Cell数，在开放寻址中是需要检查的组数。
+ */
+struct MyHashMapStats {
+    int entries;
+    int buckets;                // 篮子数（渐进式rehashing期间包括旧表）
+    double loadFactor;          // entries / 槽数（拉链法为entries / 篮子数）
+    MyVector<int> occupancy;    // occupancy[k]：恰好有k个条目的篮子数
+    int maxProbeLength;         // 表中条目的最大探测长度
+    double averageProbeLength;  // 查找一个存在的key的平均探测长度
+    size_t allocatedBytes;      // 篮子数组（槽数组）、结点池以及Bloom filter占用的字节数
+    double bytesPerEntry;       // allocatedBytes / entries，没有条目时为0
+
+    bool countersEnabled;       // 是否定义了MY_HASHMAP_STATS
+    long long lookups;          // 查找次数（包括插入、删除之前的查找）
+    long long probes;           // 所有查找的探测长度之和，probes / lookups是实际的平均探测长度
+    long long rehashes;         // rehashing（开放寻址中为重建槽数组）的次数
+    double rehashSeconds;       // rehashing花费的总时间
+};
+
+inline std::ostream & operator<<(std::ostream &os, const MyHashMapStats &s) {
+    os << "entries: " << s.entries << ", buckets: " << s.buckets << ", load factor: " << s.loadFactor
+       << ", probe length: max " << s.maxProbeLength << " avg " << s.averageProbeLength
+       << ", bytes: " << s.allocatedBytes << " (" << s.bytesPerEntry << " per entry), occupancy:";
+    for(int k = 0; k < s.occupancy.size(); ++k) {
+        os << " " << k << ":" << s.occupancy[k];
+    }
+    if(s.countersEnabled) {
+        os << ", lookups: " << s.lookups << ", probes: " << s.probes
+           << ", rehashes: " << s.rehashes << " (" << s.rehashSeconds << " s)";
+    }
+    return os;
+}
+
+#ifdef MY_HASHMAP_STATS
+/*
+ * 结构体：MyHashMapCounters
+ * ------------------------
+ * MY_HASHMAP_STATS打开时每个map中的计数。const的查找也会更新lookups和probes，
+ * 而且多个线程可能同时查找同一个map，所以它们是relaxed的原子变量；
+ * rehashing只发生在写操作中，使用普通变量。
+ */
+struct MyHashMapCounters {
+    std::atomic<long long> lookups;
+    std::atomic<long long> probes;
+    long long rehashes;
+    long long rehashNanos;
+
+    MyHashMapCounters() : lookups(0), probes(0), rehashes(0), rehashNanos(0) {}
+
+    void recordLookup(long long length) {
+        lookups.fetch_add(1, std::memory_order_relaxed);
+        probes.fetch_add(length, std::memory_order_relaxed);
+    }
+
+    /* 在作用域结束时把经过的时间加到rehashNanos上 */
+    struct RehashTimer {
+        long long &nanos;
+        std::chrono::steady_clock::time_point start;
+        explicit RehashTimer(long long &nanos) : nanos(nanos), start(std::chrono::steady_clock::now()) {}
+        ~RehashTimer() {
+            nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    void fill(MyHashMapStats &s) const {
+        s.countersEnabled = true;
+        s.lookups = lookups.load(std::memory_order_relaxed);
+        s.probes = probes.load(std::memory_order_relaxed);
+        s.rehashes = rehashes;
+        s.rehashSeconds = rehashNanos / 1e9;
+    }
+};
+#endif
+
+/*
+ * 函数：myhashPrefetch
+ * 使用：myhashPrefetch(&buckets[i]);
+ * ---------------------------------
+ * 提示CPU把p所在的cache line提前读入cache，不会等待，也不会因为无效地址出错。
+ * 编译器不支持__builtin_prefetch时什么都不做。
+ */
+inline void myhashPrefetch(const void *p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+/*
+ * 函数：myhashParallelFor
+ * 使用：std::exception_ptr error = myhashParallelFor(nThreads, [&](int t) { ... });
+ * -------------------------------------------------------------------------------
+ * 启动nThreads个线程，第t个线程执行fn(t)，等待全部结束。
+ * 某个线程中抛出的异常不会终止程序，而是被捕获下来：返回第一个异常（没有异常时返回空的exception_ptr），
+ * 由调用者在整理好自己的状态之后重新抛出。
+ * 创建线程失败（std::system_error）时不再启动后面的线程，等待已经启动的线程结束之后，
+ * 同样把这个异常返回给调用者；没有启动的t不会执行fn(t)。
+ */
+template <typename Fn>
+std::exception_ptr myhashParallelFor(int nThreads, Fn fn) {
+    std::exception_ptr *errors = new std::exception_ptr[nThreads];
+    std::thread *workers;
+    try {
+        workers = new std::thread[nThreads];
+    }
+    catch(...) {
+        delete [] errors;
+        throw;
+    }
+    std::exception_ptr error;
+    int started = 0;
+    try {
+        for(; started < nThreads; ++started) {
+            int t = started;
+            workers[t] = std::thread([&fn, errors, t]() {
+                try {
+                    fn(t);
+                }
+                catch(...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+    }
+    catch(...) {
+        error = std::current_exception();
+    }
+    for(int t = 0; t < started; ++t) {
+        workers[t].join();
+        if(!error && errors[t]) error = errors[t];
+    }
+    delete [] workers;
+    delete [] errors;
+    return error;
+}
+
+/*
+ * 函数：myhashPartition
+ * 使用：myhashPartition(pairs, shift, nParts, nThreads, hashes, order, start);
+ * --------------------------------------------------------------------------
+ * buildParallel使用的radix partition，由nThreads个线程完成：
+ *      hashes[i]    = hashCode(pairs[i].first)；
+ *      分区编号      = (hashes[i] >> shift) & (nParts - 1)，nParts必须是2的幂；
+ *      第p个分区中的下标依次是order[start[p]] .. order[start[p + 1] - 1]。
+ * 同一分区内保持输入顺序，所以相同的key仍然是后出现的为准。
+ * hashes、order的长度必须是pairs.size()，start的长度必须是nParts + 1。
+ * 先统计每个线程在每个分区中的条目数，前缀和之后每个线程把自己的下标写到互不重叠的位置。
  */
 template <typename KeyType, typename ValueType>
+std::exception_ptr myhashPartition(const MyVector<std::pair<KeyType, ValueType>> &pairs, int shift, int nParts, int nThreads,
+                                   MyVector<unsigned long long> &hashes, MyVector<int> &order, MyVector<int> &start) {
+    int n = pairs.size();
+    unsigned long long partMask = (unsigned long long)(nParts - 1);
+    MyVector<int> offsets(nThreads * nParts, 0);
+
+    std::exception_ptr error = myhashParallelFor(nThreads, [&](int t) {
+        int *count = &offsets[t * nParts];
+        for(int i = int((long long)n * t / nThreads); i < int((long long)n * (t + 1) / nThreads); ++i) {
+            unsigned long long hash = hashCode(pairs[i].first);
+            hashes[i] = hash;
+            count[(hash >> shift) & partMask]++;
+        }
+    });
+    if(error) return error;
+
+    int sum = 0;
+    for(int p = 0; p < nParts; ++p) {
+        start[p] = sum;
+        for(int t = 0; t < nThreads; ++t) {
+            int count = offsets[t * nParts + p];
+            offsets[t * nParts + p] = sum;
+            sum += count;
+        }
+    }
+    start[nParts] = sum;
+
+    return myhashParallelFor(nThreads, [&](int t) {
+        int *next = &offsets[t * nParts];
+        for(int i = int((long long)n * t / nThreads); i < int((long long)n * (t + 1) / nThreads); ++i) {
+            order[next[(hashes[i] >> shift) & partMask]++] = i;
+        }
+    });
+}
+
+template <typename KeyType, typename ValueType, typename Policy = MySeparateChaining>
 class MyHashMap {
 public:
     /*
@@ -30,6 +273,14 @@ public:
      */
     MyHashMap();
 
+    /*
+     * 方法：MyHashMap
+     * 使用: MyHashMap<KeyType, ValueType> mhp(expectedSize);
+     * ----------------------------------------------------
+     * 构造一个空的map，并预先分配足够的篮子，使插入expectedSize个条目之前都不需要rehashing。
+     */
+    explicit MyHashMap(int expectedSize);
+
     /*
      * 方法：～MyHashMap
      * 使用：隐式调用
@@ -42,10 +293,19 @@ public:
      * 方法：get
      * 使用: ValueType key = map.get(key);
      * ----------------------------------
-     * 返回此hashmap中与 key 相关的value。
+     * 返回此hashmap中与 key 相关的value。如果key不存在，返回ValueType的默认值。
      */
     ValueType get(const KeyType &key) const;
 
+    /*
+     * 方法：tryGet
+     * 使用：if(map.tryGet(key, value)) ...
+     * -----------------------------------
+     * 如果key存在，把对应的value复制到out中并返回true；否则返回false，out不变。
+     * 可以区分"key不存在"与"value恰好是默认值"。
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+
     /*
      * 方法：isEmpty
      * 使用：if (map.isEmpty()) ...
@@ -74,11 +334,48 @@ public:
      */
     void put(const KeyType &key, const ValueType &value);
 
+    /*
+     * 方法：putAll
+     * 使用：map.putAll(pairs);
+     * -----------------------
+     * 依次put pairs中的每个key-value对（相同的key以后出现的为准）。
+     * 插入之前先用reserve一次性把表扩大到能容纳size() + pairs.size()个条目，
+     * 所以插入过程中不会发生rehashing。
+     */
+    void putAll(const MyVector<std::pair<KeyType, ValueType>> &pairs);
+
+    /*
+     * 方法：buildParallel
+     * 使用：map.buildParallel(pairs, nThreads);
+     * ---------------------------------------
+     * 与putAll的结果相同（相同的key以后出现的为准），但由nThreads个线程完成：
+     * 先按hash Code把pairs划分成若干分区，每个分区对应一段连续的篮子，
+     * 再由各个线程把分区中的条目插入自己的篮子，线程之间不需要加锁。
+     * 输入太少（每个线程不到PARALLEL_MIN_PER_THREAD个条目）或nThreads <= 1时直接调用putAll。
+     * 额外使用约12 * pairs.size()字节的临时空间。构造key、value时抛出异常的话，
+     * 已经插入的条目保留在map中，然后重新抛出该异常。
+     */
+    void buildParallel(const MyVector<std::pair<KeyType, ValueType>> &pairs, int nThreads);
+
+    /*
+     * 方法：reserve
+     * 使用：map.reserve(n);
+     * --------------------
+     * 把篮子的数量扩大到插入n个条目之前都不需要rehashing，只重新链接一次已有的Cell。
+     * 如果当前的篮子已经足够，则什么都不做（不会缩小散列表）。
+     * 之后的remove仍然可以缩小散列表；需要一直保留篮子时使用指定预期大小的构造函数。
+     * 正在进行的渐进式rehashing会在这里一并完成。
+     */
+    void reserve(int n);
+
     /*
      * 方法：remove
      * 使用：hashmap.remove(key);
      * -------------------------
      * 删除hashmap中键为key对应的key-value对
+     * 删除后条目数不足rehashing阈值的1/4时，把篮子缩小到约两倍条目数（但不少于构造时预留的数量），
+     * 缩小后负载系数在1/4到1/2之间，离下一次扩容或缩容都还很远，所以在边界上交替put、remove
+     * 不会反复rehashing。缩容只重新链接Cell，find返回的指针仍然有效，但迭代器会失效。
      */
 
     void remove(const KeyType &key);
@@ -95,10 +392,21 @@ public:
      * 方法：clear
      * 使用：map.clear();
      * -----------------
-     * 清空map上的所有key-value对。
+     * 清空map上的所有key-value对，篮子还原为初始数量（或构造时预留的数量）。
+     * 结点池的块保留下来供之后的插入复用，需要把它们还给系统时再调用compact()。
      */
     void clear();
 
+    /*
+     * 方法：compact
+     * 使用：map.compact();
+     * -------------------
+     * 释放突发写入之后多余的内存：把所有Cell搬到一个新的结点池中连续存放，释放旧的块
+     * （包括空闲链表中的结点），并把篮子缩小到刚好容纳当前条目的数量。
+     * 需要O(条目数)的时间；之后find返回的指针、value的引用和迭代器都会失效。
+     */
+    void compact();
+
     /*
      * 方法：containsKey
      * 使用：if (map.containsKey(key)) ...
@@ -107,13 +415,93 @@ public:
      */
     bool containsKey(const KeyType &key) const;
 
+    /*
+     * 方法：find
+     * 使用：ValueType *vp = map.find(key);
+     * ----------------------------------
+     * 返回指向key对应的value的指针，如果key不存在则返回NULL。
+     * 只计算一次hash Code、查找一次，可以代替"先containsKey再get"。
+     * 指针在key被删除或map被clear之前一直有效（rehashing不会移动Cell）。
+     */
+    ValueType * find(const KeyType &key);
+    const ValueType * find(const KeyType &key) const;
+
+    /*
+     * 批量查找
+     * 使用：map.getMany(keys, out);
+     *      map.containsMany(keys, found);
+     * ---------------------------------
+     * out[i]是指向keys[i]对应的value的指针（key不存在时为NULL），found[i]表示keys[i]是否存在，
+     * out和found原有的内容被清除。结果与逐个调用find、containsKey相同，但每LOOKUP_BATCH个key一批：
+     * 先计算这一批的hash Code并预取它们的篮子，再预取每个链表的第一个Cell，最后才沿链表比较key。
+     * 这样一批key的cache miss同时进行，而不是一个接一个地等待，表远大于cache时效果最明显。
+     */
+    void getMany(const MyVector<KeyType> &keys, MyVector<ValueType *> &out);
+    void getMany(const MyVector<KeyType> &keys, MyVector<const ValueType *> &out) const;
+    void containsMany(const MyVector<KeyType> &keys, MyVector<bool> &found) const;
+
+    /*
+     * 方法：saveSnapshot
+     * 使用：map.saveSnapshot(path);
+     * ----------------------------
+     * 把map写成快照文件path（格式见mysnapshot.h）。快照中只有相对偏移量，
+     * 之后可以用MyMappedHashMap<KeyType, ValueType>(path)把它mmap进来直接查找，不需要重新put。
+     * KeyType、ValueType必须是可平凡复制的类型或std::string。
+     * 打开或写入文件失败时抛出std::runtime_error。
+     */
+    void saveSnapshot(const std::string &path) const;
+
+    /*
+     * 单次查找的插入/更新（upsert）
+     * 使用：std::pair<ValueType *, bool> r = map.tryEmplace(key, args...);
+     *      map.insertOrAssign(key, value);
+     *      ValueType &v = map.computeIfAbsent(key, [](const KeyType &k) { return ...; });
+     *      map.merge(key, 1, [](const ValueType &old, const ValueType &v) { return old + v; });
+     * -------------------------------------------------------------------------------------
+     * 下面的方法都只计算一次hash Code、沿链表查找一次，代替"先containsKey再get/put"：
+     *      tryEmplace：key不存在时插入用args构造的value，存在时什么都不做（不构造value）；
+     *                  返回指向value的指针以及是否插入了新条目。
+     *      insertOrAssign：key不存在时插入value，存在时用value覆盖；返回值同tryEmplace。
+     *      computeIfAbsent：key不存在时插入fn(key)，fn只在这时被调用；返回value的引用。
+     *      merge：key不存在时插入value，否则把value改为combine(旧value, value)；返回value的引用。
+     * 返回的指针和引用在key被删除或map被clear之前一直有效。fn和combine中不能修改这个map。
+     */
+    template <typename... Args>
+    std::pair<ValueType *, bool> tryEmplace(const KeyType &key, Args&&... args);
+    std::pair<ValueType *, bool> insertOrAssign(const KeyType &key, const ValueType &value);
+    template <typename Fn>
+    ValueType & computeIfAbsent(const KeyType &key, Fn fn);
+    template <typename Fn>
+    ValueType & merge(const KeyType &key, const ValueType &value, Fn combine);
+
+    /*
+     * 异构查找（heterogeneous lookup）
+     * 使用：MyHashMap<std::string, int> map;
+     *      if(map.containsKey("key")) ...          // 不构造临时的std::string
+     *      int *vp = map.find(std::string_view(buffer, n));
+     * -----------------------------------------------------
+     * 当MyTransparentLookup<KeyType, LookupType>::value为true时（见myhashcode.h），
+     * get、containsKey、remove和find可以直接接受LookupType类型的参数，
+     * 查找过程中不会构造KeyType。只有插入（put、operator[]）才需要真正的KeyType。
+     */
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    ValueType get(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    bool containsKey(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    void remove(const LookupType &key);
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    ValueType * find(const LookupType &key);
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<KeyType, LookupType>::value>::type>
+    const ValueType * find(const LookupType &key) const;
+
     /*
      * 方法：equals
      * 使用：if (map1.equals(map2)) ...
      * -------------------------------
      * 判断两个map是否含有相同的key-value对
      */
-    bool equals(const MyHashMap<KeyType, ValueType> &src) const;
+    bool equals(const MyHashMap<KeyType, ValueType, Policy> &src) const;
 
     /*
      * 方法：toString
@@ -134,6 +522,116 @@ public:
      */
     MyVector<ValueType> values() const;
 
+private:
+    struct Cell;
+
+    /* 迭代器从Cell中取出的成员 */
+    struct KeyOf {
+        typedef KeyType type;
+        static const KeyType & get(const Cell *cp) { return cp->key; }
+    };
+    struct ValueOf {
+        typedef ValueType type;
+        static const ValueType & get(const Cell *cp) { return cp->value; }
+    };
+
+public:
+    /*
+     * 迭代器
+     * 使用：for(const KeyType &key : map) ...
+     *      for(MyHashMap<KeyType, ValueType>::const_iterator it = map.begin(); it != map.end(); ++it) {
+     *          cout << it.key() << ": " << it.value() << endl;
+     *      }
+     * ----------------------------------------------------------------------------------------
+     * 与stanford HashMap相同，基于范围的for循环以不可预测的顺序遍历map中的key。
+     * 迭代器直接沿篮子数组和链表前进（渐进式rehashing期间先遍历旧表中还没有迁移的篮子，
+     * 再遍历新表），不复制任何条目，只占用O(1)的额外内存。key()和value()同时给出当前条目的key和value。
+     * 修改map（put、remove、operator[]、clear等）之后，已有的迭代器失效。
+     */
+    template <typename Proj>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename Proj::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type * pointer;
+        typedef const value_type & reference;
+
+        Iterator() : map(NULL), table(2), index(0), cp(NULL) {}
+
+        reference operator*() const { return Proj::get(cp); }
+        pointer operator->() const { return &Proj::get(cp); }
+        const KeyType & key() const { return cp->key; }
+        const ValueType & value() const { return cp->value; }
+
+        Iterator & operator++() {
+            cp = cp->link;
+            if(cp == NULL) {
+                index++;
+                settle();
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iterator &rhs) const { return cp == rhs.cp; }
+        bool operator!=(const Iterator &rhs) const { return cp != rhs.cp; }
+
+    private:
+        friend class MyHashMap;
+
+        explicit Iterator(const MyHashMap *map) : map(map), table(0), index(map->rehashIndex), cp(NULL) {
+            settle();
+        }
+
+        /* 从第table个表的第index个篮子开始，停在第一个非空的篮子上；没有时cp为NULL（即end()） */
+        void settle() {
+            for(; table < 2; ++table, index = 0) {
+                Cell * const *heads = (table == 0) ? map->oldBuckets : map->buckets;
+                int n = (table == 0) ? map->oldNBuckets : map->nBuckets;
+                for(; index < n; ++index) {
+                    if(heads[index] != NULL) {
+                        cp = heads[index];
+                        return;
+                    }
+                }
+            }
+        }
+
+        const MyHashMap *map;
+        int table;          // 0：旧表，1：新表，2：遍历结束
+        int index;          // 当前篮子的下标
+        const Cell *cp;     // 当前Cell，遍历结束时为NULL
+    };
+
+    /*
+     * 视图：keysView, valuesView
+     * 使用：for(const ValueType &value : map.valuesView()) ...
+     * -----------------------------------------------------
+     * 返回借用这个map的视图，只保存一对迭代器，不像keys()/values()那样复制所有条目。
+     * 视图在map被修改之前有效。
+     */
+    template <typename It>
+    class View {
+    public:
+        View(It first, It last) : first(first), last(last) {}
+        It begin() const { return first; }
+        It end() const { return last; }
+    private:
+        It first, last;
+    };
+
+    typedef Iterator<KeyOf> const_iterator;
+    typedef const_iterator iterator;
+    typedef Iterator<ValueOf> value_iterator;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    View<const_iterator> keysView() const;
+    View<value_iterator> valuesView() const;
 
     /*
      * 拷贝构造函数和赋值操作符进行deepCopy
@@ -141,8 +639,8 @@ public:
      *      map3 = map1;                                         // 此处map3使用赋值语句
      * ---------------------------------
      */
-    MyHashMap(const MyHashMap<KeyType, ValueType> &src);
-    MyHashMap<KeyType, ValueType> &operator= (const MyHashMap<KeyType, ValueType> &src);
+    MyHashMap(const MyHashMap<KeyType, ValueType, Policy> &src);
+    MyHashMap<KeyType, ValueType, Policy> &operator= (const MyHashMap<KeyType, ValueType, Policy> &src);
 
     /*
      * 重载运算符[]
@@ -172,8 +670,8 @@ public:
      * ----------------------------------------
      * 因为equals目的与其相同，所以看作该重载是equals的wrapper函数。
      */
-    bool operator == (const MyHashMap<KeyType, ValueType> &hmp2) const;
-    bool operator != (const MyHashMap<KeyType, ValueType> &hmp2) const;
+    bool operator == (const MyHashMap<KeyType, ValueType, Policy> &hmp2) const;
+    bool operator != (const MyHashMap<KeyType, ValueType, Policy> &hmp2) const;
 
     /* 类的私有部分*/
     /*
@@ -191,6 +689,75 @@ public:
      * The entries are processed in unpredictable order.
      */
     void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+    /*
+     * 方法：setIncrementalRehash
+     * 使用：map.setIncrementalRehash(true);
+     * ------------------------------------
+     * 打开（或关闭）渐进式rehashing。默认关闭：负载系数超过阈值时，一次put就把所有Cell
+     * 迁移到新的篮子数组中，条目很多时这一次put会停顿很久。
+     *
+     * 打开后（类似Redis的dict），扩容时只分配新的篮子数组，新旧两个表同时存在，
+     * 之后的每次put、remove、operator[]只迁移REHASH_STEP_BUCKETS个非空篮子，
+     * 把迁移的代价分摊到后续的写操作中。迁移期间的查找根据key所在的旧篮子是否已经迁移，
+     * 只查找两个表中的一个。get、containsKey等const方法不会迁移篮子，所以它们仍然没有副作用。
+     *
+     * 关闭时如果迁移还没有完成，则立即完成迁移。
+     */
+    void setIncrementalRehash(bool enabled);
+
+    /*
+     * 方法：isRehashing
+     * 使用：if(map.isRehashing()) ...
+     * ------------------------------
+     * 如果渐进式rehashing正在进行（新旧两个表同时存在），返回true。
+     */
+    bool isRehashing() const;
+
+    /*
+     * 方法：poolStats
+     * 使用：MyPoolStats s = map.poolStats();
+     * -------------------------------------
+     * 返回存放Cell的结点池的占用情况：块数、结点总数、正在使用和空闲的结点数以及占用的字节数。
+     * clear()之后块仍然保留（live为0），供之后的插入复用。
+     */
+    MyPoolStats poolStats() const;
+
+    /*
+     * 方法：stats
+     * 使用：MyHashMapStats s = map.stats();
+     * ------------------------------------
+     * 遍历散列表，返回篮子占用直方图、探测长度、占用的字节数等信息；
+     * 定义了MY_HASHMAP_STATS时还包括查找和rehashing的计数（见MyHashMapStats）。
+     * 需要O(篮子数 + 条目数)的时间。
+     */
+    MyHashMapStats stats() const;
+
+    /*
+     * 方法：enableBloomFilter, disableBloomFilter, hasBloomFilter
+     * 使用：map.enableBloomFilter(0.01);
+     *      map.enableBloomFilter(0.01, 1 << 20);
+     * ----------------------------------------
+     * 为map附加一个记录所有key的hash Code的分块Bloom filter（MyBlockedBloomFilter，见mybloomfilter.h）。
+     * 之后get、tryGet、containsKey、find、const的operator[]以及getMany、containsMany先查询filter，
+     * filter确定key不存在时直接返回，不读取篮子和链表。filter的每次查询只读一个cache line，
+     * 整个filter也比篮子数组和Cell小得多，容易留在cache中，所以适合大部分查找都不存在的场景。
+     * 开放寻址中查找一个不存在的key通常只读一组控制字节，filter反而多一次访存，
+     * 所以它主要用于一次探测代价较高的情况：拉链法的链表、映射到磁盘文件的MyMappedHashMap（见benchmark/bloomfilter.cpp）。
+     *
+     * falsePositiveRate是不存在的key仍然通过filter（还要查找散列表）的比例，默认1%；
+     * maxBytes不为0时filter最多占用maxBytes字节，此时误判率可能高于falsePositiveRate。
+     * filter按rehashing阈值（下一次扩容之前最多的条目数）确定大小，在rehashing、compact和clear时重建，
+     * 所以误判率一直不超过设定值。Bloom filter不支持删除：remove之后被删除的key仍留在filter中，
+     * 直到下一次重建，只会让误判略多一些，查找结果总是正确的。
+     * 重建只遍历Cell中保存的hash Code，不重新计算；渐进式rehashing打开时，重建仍然在开始迁移时一次完成。
+     * 再次调用enableBloomFilter按新的参数重建filter；拷贝map时filter也被拷贝。
+     * 参数不合法时抛出std::invalid_argument，map不变。
+     */
+    void enableBloomFilter(double falsePositiveRate = 0.01, size_t maxBytes = 0);
+    void disableBloomFilter();
+    bool hasBloomFilter() const;
+
 private:
 
     /* 散列表中类型的定义（拉链法） */
@@ -198,31 +765,172 @@ private:
     struct Cell {
         KeyType key;
         ValueType value;
+        unsigned long long hash;    // hashCode(key)，rehashing时直接使用
         Cell *link;
     };
 
     /* 负载系数声明 */
     static const double REHASH_THRESHOLD;
-    /* 初始散列表的长度 */
-    static const int INITIAL_BUCKET_COUNT = 10;
+    /* 初始散列表的长度，必须是2的幂 */
+    static const int INITIAL_BUCKET_COUNT = 16;
+    /* 渐进式rehashing时每次操作迁移的非空篮子数 */
+    static const int REHASH_STEP_BUCKETS = 4;
+    /* buildParallel：每个线程至少分到的条目数，以及每个线程平均分到的分区数（用于负载均衡） */
+    static const int PARALLEL_MIN_PER_THREAD = 4096;
+    static const int PARTITIONS_PER_THREAD = 8;
+    /* getMany、containsMany每批预取的key数 */
+    static const int LOOKUP_BATCH = 32;
 
     /* 实例变量 */
     Cell **buckets;         // Dynamic array of pointers to cells
-    int nBuckets;           // The number of buckets in the array
+    int nBuckets;           // The number of buckets in the array, always a power of two
     int entries;
+    int growthLimit;        // entries超过该值时rehashing，等于nBuckets * REHASH_THRESHOLD
+    int minBuckets;         // 自动缩容和clear()的下限：INITIAL_BUCKET_COUNT或构造时预留的篮子数
+
+    /* 渐进式rehashing的状态 */
+    Cell **oldBuckets;      // 正在迁移的旧表，没有迁移时为NULL
+    int oldNBuckets;
+    int rehashIndex;        // 旧表中下标小于rehashIndex的篮子已经迁移完毕
+    bool incremental;       // 是否使用渐进式rehashing
+
+    MyNodePool<Cell> pool;  // 所有Cell都从这里分配
+
+    MyBlockedBloomFilter<KeyType> *bloom;  // enableBloomFilter之后记录所有key的hash Code，否则为NULL
+
+#ifdef MY_HASHMAP_STATS
+    mutable MyHashMapCounters counters;
+#endif
+
+    /*
+     * 方法：bucketOf
+     * 使用：int bucket = bucketOf(hashCode(key));
+     * ------------------------------------------
+     * 因为nBuckets是2的幂，hash Code对nBuckets取模等价于保留其低位，
+     * 用一次位与代替整数除法。
+     */
+    int bucketOf(unsigned long long hash) const;
+
+    /*
+     * 方法：chainOf
+     * 使用：Cell *&head = chainOf(hashCode(key));
+     * ------------------------------------------
+     * 返回hash Code为hash的key所在链表的头指针（的引用）。
+     * 渐进式rehashing期间，如果key在旧表中的篮子还没有迁移，则返回旧表中的篮子，
+     * 否则返回新表中的篮子，所以查找和插入总是使用同一个链表。
+     */
+    Cell *& chainOf(unsigned long long hash) const;
+
+    /*
+     * 方法：insertCell
+     * 使用：Cell *cp = insertCell(head, key, hash, args...);
+     * -----------------------------------------------------
+     * 用头插法在head指向的链表中插入一个键为key的新Cell并返回它，
+     * 其value由args构造（没有args时为值类型的默认值）。调用者需要在之后调用growIfNeeded。
+     */
+    template <typename... Args>
+    Cell * insertCell(Cell *&head, const KeyType &key, unsigned long long hash, Args&&... args);
+
+    /*
+     * 方法：findOrInsert
+     * 使用：std::pair<Cell *, bool> r = findOrInsert(key, args...);
+     * ------------------------------------------------------------
+     * 写操作的公共部分：迁移一步渐进式rehashing，计算一次hash Code并查找key，
+     * 不存在时用args构造value并插入。返回key所在的Cell以及是否插入了新的Cell。
+     */
+    template <typename... Args>
+    std::pair<Cell *, bool> findOrInsert(const KeyType &key, Args&&... args);
+
+    /*
+     * 方法：growIfNeeded
+     * 使用：growIfNeeded();
+     * --------------------
+     * 插入新Cell之后调用：负载系数超过阈值时rehashing。
+     */
+    void growIfNeeded();
+
+    /*
+     * 方法：hashOf
+     * 使用：unsigned long long hash = hashOf(key);
+     * -------------------------------------------
+     * 计算key的hash Code。key是异构查找的LookupType时使用MyTransparentLookup::hash，
+     * 保证与对应的KeyType得到相同的结果。
+     */
+    static unsigned long long hashOf(const KeyType &key);
+    template <typename LookupType>
+    static unsigned long long hashOf(const LookupType &key);
 
     /* 方法：findCell
-     * 使用：Cell *cp = findCell(bucket, key);
-     * --------------------------------------
-     * 在散列表中第bucket个篮子里搜索键为key的结构体Cell，
+     * 使用：Cell *cp = findCell(head, key, hash);
+     * ------------------------------------------
+     * 在head指向的链表里搜索键为key（hash Code为hash）的结构体Cell，
      * 如果存在键为key的Cell，则返回该Cell的地址，
-     * 反之返回NULL。
+     * 反之返回NULL。先比较保存的hash Code，只有相同时才比较key，
+     * 所以对于较长的字符串key，链表中的其他Cell几乎不会触发完整的key比较。
+     * key可以是KeyType，也可以是异构查找的LookupType。
+     */
+    template <typename LookupType>
+    Cell * findCell(Cell *head, const LookupType &key, unsigned long long hash) const;
+
+    /*
+     * 方法：lookupCell
+     * 使用：Cell *cp = lookupCell(key, hash);
+     * --------------------------------------
+     * 只读查找的公共部分：Bloom filter确定key不存在时直接返回NULL，
+     * 否则在key所在的链表中调用findCell。
+     */
+    template <typename LookupType>
+    Cell * lookupCell(const LookupType &key, unsigned long long hash) const;
+
+    /*
+     * 方法：rebuildBloom
+     * 使用：rebuildBloom();
+     * --------------------
+     * 有Bloom filter时把它调整为适合growthLimit个条目的大小，再加入所有Cell的hash Code。
+     */
+    void rebuildBloom();
+
+    /*
+     * 方法：lookupMany
+     * 使用：lookupMany(keys, [&](int i, Cell *cp) { ... });
+     * ---------------------------------------------------
+     * getMany和containsMany共用的分批预取查找：按顺序对每个keys[i]调用fn(i, cp)，
+     * cp是键为keys[i]的Cell，不存在时为NULL。
+     */
+    template <typename Fn>
+    void lookupMany(const MyVector<KeyType> &keys, Fn fn) const;
+
+    /*
+     * 方法：removeKey
+     * 使用：removeKey(key);
+     * --------------------
+     * remove的实现，key可以是KeyType或异构查找的LookupType。
+     */
+    template <typename LookupType>
+    void removeKey(const LookupType &key);
+
+    /*
+     * 方法：forEachCell
+     * 使用：forEachCell([](Cell *cp) { ... });
+     * ---------------------------------------
+     * 依次对旧表（如果正在迁移）和新表中的每个Cell调用fn。
+     * 调用fn之前已经读出了下一个Cell，所以fn可以释放当前Cell。
+     */
+    template <typename Fn>
+    void forEachCell(Fn fn) const;
+
+    /*
+     * 方法：destroyCells
+     * 使用：destroyCells(); pool.releaseAll();
+     * ---------------------------------------
+     * 对所有Cell调用析构函数（key和value都不需要析构时什么也不做），
+     * 之后由结点池整体回收它们占用的内存，不需要逐个归还。
      */
-    Cell * findCell(int bucket, const KeyType &key) const;
+    void destroyCells();
 
     /*
      * 方法：rehashing
-     * 使用：if(size()*1.0/nBuckets > REHASH_THRESHOLD) {
+     * 使用：if(entries > growthLimit) {
      *          rehashing();
      *      }
      * ---------------------------------------------------
@@ -231,6 +939,46 @@ private:
      */
     void rehashing();
 
+    /*
+     * 方法：shrinkIfSparse
+     * 使用：shrinkIfSparse();
+     * ----------------------
+     * 删除Cell之后调用：条目数不足growthLimit的1/4时缩小篮子数组。
+     */
+    void shrinkIfSparse();
+
+    /*
+     * 方法：resetBuckets
+     * 使用：resetBuckets(n);
+     * ---------------------
+     * 丢弃旧表和当前的篮子数组（不处理其中的Cell），换成n个空篮子。
+     */
+    void resetBuckets(int n);
+
+    /*
+     * 方法：rehashTo, bucketCountFor
+     * 使用：rehashTo(bucketCountFor(n), true);
+     * ---------------------------------------
+     * rehashTo把篮子数量改为newNBuckets并开始迁移，allAtOnce为true时立即完成迁移。
+     * bucketCountFor返回能容纳n个条目而不超过负载系数的最小篮子数（2的幂，至少为INITIAL_BUCKET_COUNT）。
+     */
+    void rehashTo(int newNBuckets, bool allAtOnce);
+    static int bucketCountFor(int n);
+
+    /*
+     * 方法：migrateBucket, rehashStep, finishRehash, migrateAll
+     * 使用：rehashStep();
+     * ------------------
+     * migrateBucket把旧表中的一个篮子整体迁移到新表；rehashStep迁移最多REHASH_STEP_BUCKETS个
+     * 非空篮子（最多跳过10倍数量的空篮子），由每次写操作调用；finishRehash迁移剩余的所有篮子。
+     * migrateAll是finishRehash中不计时的部分，供已经在计时的rehashTo直接调用。
+     * 所有篮子迁移完毕后释放旧表。
+     */
+    void migrateBucket(int oldBucket);
+    void rehashStep();
+    void finishRehash();
+    void migrateAll();
+
     /*
      * 方法：deepCopy
      * 使用：deepCopy(src);
@@ -239,32 +987,46 @@ private:
      * 因为每个hashmap维护一个动态内存分配的散列表，所以需要进行深拷贝使得每个
      * hashmap之间管理的散列表独立。
      */
-    void deepCopy(const MyHashMap<KeyType, ValueType> &src);
-
-    /*
-     * 方法：sequentialTraversal
-     * 使用：sequentialTraversal(traversalResult);
-     * --------------------------
-     * 像keys()和values()需要得到hashTable中所有的keys和values
-     * 所以这里通过下标 顺序遍历 buckets这个指针数组。将{key: value}
-     * 放入traversalResult中
-     */
-    void sequentialTraversal(MyVector<std::pair<KeyType, ValueType>> &vec) const;
+    void deepCopy(const MyHashMap<KeyType, ValueType, Policy> &src);
 };
 
 
 /* 负载系数初始化 */
-template <typename KeyType, typename ValueType>
-const double MyHashMap<KeyType, ValueType>::REHASH_THRESHOLD = 1.0;
+template <typename KeyType, typename ValueType, typename Policy>
+const double MyHashMap<KeyType, ValueType, Policy>::REHASH_THRESHOLD = 1.0;
 
-template <typename KeyType, typename ValueType>
-MyHashMap<KeyType, ValueType>::MyHashMap() {
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMap<KeyType, ValueType, Policy>::MyHashMap() {
     entries = 0;
     nBuckets = INITIAL_BUCKET_COUNT;
+    minBuckets = nBuckets;
+    growthLimit = int(nBuckets * REHASH_THRESHOLD);
+    buckets = new Cell* [nBuckets];
+    for(int i = 0; i < nBuckets; ++i) {
+        buckets[i] = NULL;
+    }
+    oldBuckets = NULL;
+    oldNBuckets = 0;
+    rehashIndex = 0;
+    incremental = false;
+    bloom = NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMap<KeyType, ValueType, Policy>::MyHashMap(int expectedSize) {
+    entries = 0;
+    nBuckets = bucketCountFor(expectedSize);
+    minBuckets = nBuckets;
+    growthLimit = int(nBuckets * REHASH_THRESHOLD);
     buckets = new Cell* [nBuckets];
     for(int i = 0; i < nBuckets; ++i) {
         buckets[i] = NULL;
     }
+    oldBuckets = NULL;
+    oldNBuckets = 0;
+    rehashIndex = 0;
+    incremental = false;
+    bloom = NULL;
 }
 
 /*
@@ -275,53 +1037,59 @@ MyHashMap<KeyType, ValueType>::MyHashMap() {
  * 这个方法的调用暗示着该对象不再使用，所以像私有变量
  * entries、nBuckets无需维护。
  */
-template <typename KeyType, typename ValueType>
-MyHashMap<KeyType, ValueType>::~MyHashMap() {
-    for(int i = 0; i < nBuckets; ++i) {
-        Cell *p = buckets[i];
-        Cell *q = NULL;
-
-        while(p) {
-            q = p->link;
-            delete p;
-            p = q;
-        }
-    }
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMap<KeyType, ValueType, Policy>::~MyHashMap() {
+    destroyCells();
+    delete [] buckets;
+    delete [] oldBuckets;
+    delete bloom;
 }
 
-template <typename KeyType, typename ValueType>
-ValueType MyHashMap<KeyType, ValueType>::get(const KeyType &key) const {
-    int bucket = hashCode(key) % nBuckets;
-    Cell *cp = findCell(bucket, key);
-    return (cp == NULL) ? "" : cp->value;
+template <typename KeyType, typename ValueType, typename Policy>
+ValueType MyHashMap<KeyType, ValueType, Policy>::get(const KeyType &key) const {
+    Cell *cp = lookupCell(key, hashCode(key));
+    return (cp == NULL) ? ValueType() : cp->value;
 }
 
-template <typename KeyType, typename ValueType>
-bool MyHashMap<KeyType, ValueType>::isEmpty() const {
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::isEmpty() const {
     return entries == 0;
 }
 
-template <typename KeyType, typename ValueType>
-MyVector<KeyType> MyHashMap<KeyType, ValueType>::keys() const {
-    MyVector<std::pair<KeyType, ValueType>> keysAndValues;
-    sequentialTraversal(keysAndValues);
-
+/*
+ * 实现笔记：keys, values
+ * --------------------
+ * 直接沿迭代器把key（或value）放入结果中，不再先复制出所有的key-value对。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+MyVector<KeyType> MyHashMap<KeyType, ValueType, Policy>::keys() const {
     MyVector<KeyType> keys;
-    for(int i = 0; i < keysAndValues.size(); ++i) {
-        keys.add(keysAndValues[i].first);
+    for(const KeyType &key : *this) {
+        keys.add(key);
     }
     return keys;
 }
 
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::sequentialTraversal(MyVector<std::pair<KeyType, ValueType>> &vec) const {
-    for(int i = 0; i < nBuckets; ++i) {
-        Cell *cp = buckets[i];
-        while(cp) {
-            vec.add({cp->key, cp->value});
-            cp = cp->link;
-        }
-    }
+template <typename KeyType, typename ValueType, typename Policy>
+typename MyHashMap<KeyType, ValueType, Policy>::const_iterator MyHashMap<KeyType, ValueType, Policy>::begin() const {
+    return const_iterator(this);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+typename MyHashMap<KeyType, ValueType, Policy>::const_iterator MyHashMap<KeyType, ValueType, Policy>::end() const {
+    return const_iterator();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+typename MyHashMap<KeyType, ValueType, Policy>::template View<typename MyHashMap<KeyType, ValueType, Policy>::const_iterator>
+MyHashMap<KeyType, ValueType, Policy>::keysView() const {
+    return View<const_iterator>(begin(), end());
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+typename MyHashMap<KeyType, ValueType, Policy>::template View<typename MyHashMap<KeyType, ValueType, Policy>::value_iterator>
+MyHashMap<KeyType, ValueType, Policy>::valuesView() const {
+    return View<value_iterator>(value_iterator(this), value_iterator());
 }
 
 /*
@@ -332,26 +1100,148 @@ void MyHashMap<KeyType, ValueType>::sequentialTraversal(MyVector<std::pair<KeyTy
  * 将key-value插入到hash Table中。注意维护key-value数量的变量entries需要+1
  *
  * 注意，如果添加key-value后，负载系数超过阈值，则需要重新hashing。
+ * 渐进式rehashing期间，先迁移一小批篮子。
  */
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::put(const KeyType &key, const ValueType &value) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell *cp = findCell(bucket, key);
-    if(cp == NULL) {
-        cp = new Cell;
-        cp->key = key;
-        cp->link = buckets[bucket];
-        buckets[bucket] = cp;
-        entries ++;
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::put(const KeyType &key, const ValueType &value) {
+    insertOrAssign(key, value);
+}
+
+/*
+ * 实现笔记：insertCell
+ * ------------------
+ * 所有插入操作共用的头插法。Cell直接在结点池中用key、value、hash和link构造，
+ * 不需要先默认构造value再赋值。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename... Args>
+typename MyHashMap<KeyType, ValueType, Policy>::Cell * MyHashMap<KeyType, ValueType, Policy>::insertCell(Cell *&head, const KeyType &key, unsigned long long hash, Args&&... args) {
+    Cell *cp = pool.create(key, ValueType(std::forward<Args>(args)...), hash, head);
+    head = cp;
+    entries ++;
+    if(bloom != NULL) bloom->addHash(hash);
+    return cp;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename... Args>
+std::pair<typename MyHashMap<KeyType, ValueType, Policy>::Cell *, bool> MyHashMap<KeyType, ValueType, Policy>::findOrInsert(const KeyType &key, Args&&... args) {
+    rehashStep();
+
+    unsigned long long hash = hashCode(key);
+    Cell *&head = chainOf(hash);
+    Cell *cp = findCell(head, key, hash);
+    if(cp != NULL) {
+        return std::make_pair(cp, false);
     }
-    cp->value = value;
+    cp = insertCell(head, key, hash, std::forward<Args>(args)...);
+    growIfNeeded();
+    return std::make_pair(cp, true);
+}
 
-    if(size()*1.0/nBuckets > REHASH_THRESHOLD) {
-        // std::cout << "rehashing: " << size() << std::endl;
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::growIfNeeded() {
+    if(entries > growthLimit) {
         rehashing();
     }
 }
 
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::tryGet(const KeyType &key, ValueType &out) const {
+    const ValueType *vp = find(key);
+    if(vp == NULL) return false;
+    out = *vp;
+    return true;
+}
+
+/*
+ * 实现笔记：tryEmplace, insertOrAssign, computeIfAbsent, merge
+ * ----------------------------------------------------------
+ * 都建立在一次findOrInsert（或同样的一次查找）之上。rehashing只重新链接Cell，
+ * 所以插入后即使发生了rehashing，cp仍然指向同一个Cell。
+ * computeIfAbsent和merge在插入之前先算出value，这样fn抛出异常时map不会改变。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename... Args>
+std::pair<ValueType *, bool> MyHashMap<KeyType, ValueType, Policy>::tryEmplace(const KeyType &key, Args&&... args) {
+    std::pair<Cell *, bool> r = findOrInsert(key, std::forward<Args>(args)...);
+    return std::make_pair(&r.first->value, r.second);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+std::pair<ValueType *, bool> MyHashMap<KeyType, ValueType, Policy>::insertOrAssign(const KeyType &key, const ValueType &value) {
+    std::pair<Cell *, bool> r = findOrInsert(key, value);
+    if(!r.second) {
+        r.first->value = value;
+    }
+    return std::make_pair(&r.first->value, r.second);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename Fn>
+ValueType & MyHashMap<KeyType, ValueType, Policy>::computeIfAbsent(const KeyType &key, Fn fn) {
+    rehashStep();
+
+    unsigned long long hash = hashCode(key);
+    Cell *&head = chainOf(hash);
+    Cell *cp = findCell(head, key, hash);
+    if(cp == NULL) {
+        cp = insertCell(head, key, hash, fn(key));
+        growIfNeeded();
+    }
+    return cp->value;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename Fn>
+ValueType & MyHashMap<KeyType, ValueType, Policy>::merge(const KeyType &key, const ValueType &value, Fn combine) {
+    std::pair<Cell *, bool> r = findOrInsert(key, value);
+    if(!r.second) {
+        r.first->value = combine(r.first->value, value);
+    }
+    return r.first->value;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMap<KeyType, ValueType, Policy>::bucketOf(unsigned long long hash) const {
+    return int(hash & (unsigned long long)(nBuckets - 1));
+}
+
+/*
+ * 实现笔记：chainOf
+ * ---------------
+ * 旧表中下标小于rehashIndex的篮子已经整体迁移到新表，
+ * 所以只要看key在旧表中的篮子下标就能确定它在哪个表中。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+typename MyHashMap<KeyType, ValueType, Policy>::Cell *& MyHashMap<KeyType, ValueType, Policy>::chainOf(unsigned long long hash) const {
+    if(oldBuckets != NULL) {
+        int oldBucket = int(hash & (unsigned long long)(oldNBuckets - 1));
+        if(oldBucket >= rehashIndex) {
+            return oldBuckets[oldBucket];
+        }
+    }
+    return buckets[bucketOf(hash)];
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename Fn>
+void MyHashMap<KeyType, ValueType, Policy>::forEachCell(Fn fn) const {
+    Cell **tables[2] = {oldBuckets, buckets};
+    int sizes[2] = {oldNBuckets, nBuckets};
+    for(int t = 0; t < 2; ++t) {
+        if(tables[t] == NULL) continue;
+        for(int i = 0; i < sizes[t]; ++i) {
+            Cell *cp = tables[t][i];
+            while(cp) {
+                Cell *next = cp->link;
+                fn(cp);
+                cp = next;
+            }
+        }
+    }
+}
+
 /*
  * 实现笔记：remove
  * --------------
@@ -361,29 +1251,45 @@ void MyHashMap<KeyType, ValueType>::put(const KeyType &key, const ValueType &val
  * 反之查找cp的前一个结点地址r，将r下一个结点指向cp的下一个结点
  * 删除结点cp，同时更新私有变量entries
  */
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::remove(const KeyType &key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell *cp = findCell(bucket, key);
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::remove(const KeyType &key) {
+    removeKey(key);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType, typename>
+void MyHashMap<KeyType, ValueType, Policy>::remove(const LookupType &key) {
+    removeKey(key);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType>
+void MyHashMap<KeyType, ValueType, Policy>::removeKey(const LookupType &key) {
+    rehashStep();
+
+    unsigned long long hash = hashOf(key);
+    Cell *&head = chainOf(hash);
+    Cell *cp = findCell(head, key, hash);
     if(cp != NULL) {
-        Cell *r = buckets[bucket];
+        Cell *r = head;
         if(r == cp) {
-            buckets[bucket] = buckets[bucket]->link;
+            head = head->link;
         }
         else {
-            while(r->link->key != cp->key) {
+            while(r->link != cp) {
                 r = r->link;
             }
             r->link = cp->link;
         }
-        delete cp;
+        pool.destroy(cp);
         entries--;
+        shrinkIfSparse();
     }
 }
 
 
-template <typename KeyType, typename ValueType>
-int MyHashMap<KeyType, ValueType>::size() const {
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMap<KeyType, ValueType, Policy>::size() const {
     return entries;
 }
 
@@ -393,47 +1299,161 @@ int MyHashMap<KeyType, ValueType>::size() const {
  * 将hash Table中所有的key-value对删除
  * 注意需要将指针数组中每个元素指向NULL。
  * 同时更新相应的私有变量entries，因为clear操作
- * 后可能重新使用该对象。
+ * 后可能重新使用该对象。如果正在渐进式rehashing，旧表直接释放。
+ * Cell不需要逐个释放：析构之后由结点池整体回收，块留给之后的插入使用。
+ * 篮子数组比minBuckets大时换成minBuckets个篮子，否则只把指针置为NULL。
  */
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::clear() {
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::clear() {
+    destroyCells();
+    pool.releaseAll();
+    resetBuckets(nBuckets > minBuckets ? minBuckets : nBuckets);
+    entries = 0;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::resetBuckets(int n) {
+    delete [] oldBuckets;
+    oldBuckets = NULL;
+    oldNBuckets = 0;
+    rehashIndex = 0;
+    if(n != nBuckets) {
+        Cell **fresh = new Cell* [n];
+        delete [] buckets;
+        buckets = fresh;
+        nBuckets = n;
+        growthLimit = int(nBuckets * REHASH_THRESHOLD);
+    }
     for(int i = 0; i < nBuckets; ++i) {
-        Cell *cp = buckets[i];
-        Cell *q = NULL;
-        while(cp) {
-            q = cp->link;
-            delete cp;
-            entries --;
-            cp = q;
-        }
         buckets[i] = NULL; // miss will lead error.
     }
+    rebuildBloom();
 }
 
-template <typename KeyType, typename ValueType>
-bool MyHashMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
-    int bucket = hashCode(key) % nBuckets;
-    Cell *cp = findCell(bucket, key);
-    return cp != NULL;
+/*
+ * 实现笔记：compact
+ * ---------------
+ * 新的Cell从一个临时的结点池中按顺序分配，所以它们连续地排列在几个块中；之后析构旧的Cell，
+ * purge释放旧池的所有块，再用adopt接管临时池的块。key、value是复制而不是移动的：
+ * 复制到一半分配失败时，只需丢弃临时池，map保持原样。
+ * 新表只有entries个条目需要的篮子，下限不是minBuckets：compact是显式的请求。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::compact() {
+    finishRehash();
+    int n = bucketCountFor(entries);
+    Cell **fresh = new Cell* [n];
+    for(int i = 0; i < n; ++i) {
+        fresh[i] = NULL;
+    }
+    MyNodePool<Cell> compacted;
+    try {
+        forEachCell([&](Cell *cp) {
+            int bucket = int(cp->hash & (unsigned long long)(n - 1));
+            fresh[bucket] = compacted.create(cp->key, cp->value, cp->hash, fresh[bucket]);
+        });
+    }
+    catch(...) {
+        for(int i = 0; i < n; ++i) {
+            for(Cell *cp = fresh[i]; cp != NULL; ) {
+                Cell *next = cp->link;
+                cp->~Cell();
+                cp = next;
+            }
+        }
+        delete [] fresh;
+        throw;
+    }
+    destroyCells();
+    pool.purge();
+    pool.adopt(compacted);
+    delete [] buckets;
+    buckets = fresh;
+    nBuckets = n;
+    growthLimit = int(nBuckets * REHASH_THRESHOLD);
+    rebuildBloom();
 }
 
-template <typename KeyType, typename ValueType>
-bool MyHashMap<KeyType, ValueType>::equals(const MyHashMap<KeyType, ValueType> &other) const {
-    if(size() != other.size() || nBuckets != other.nBuckets) {
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::containsKey(const KeyType &key) const {
+    return lookupCell(key, hashCode(key)) != NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+ValueType * MyHashMap<KeyType, ValueType, Policy>::find(const KeyType &key) {
+    Cell *cp = lookupCell(key, hashOf(key));
+    return (cp == NULL) ? NULL : &cp->value;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+const ValueType * MyHashMap<KeyType, ValueType, Policy>::find(const KeyType &key) const {
+    Cell *cp = lookupCell(key, hashOf(key));
+    return (cp == NULL) ? NULL : &cp->value;
+}
+
+/*
+ * 实现笔记：异构查找
+ * ---------------
+ * 与对应的非模板版本相同，只是用hashOf计算LookupType的hash Code，
+ * findCell中直接用LookupType与Cell中的key比较。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType, typename>
+ValueType MyHashMap<KeyType, ValueType, Policy>::get(const LookupType &key) const {
+    const ValueType *vp = find(key);
+    return (vp == NULL) ? ValueType() : *vp;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType, typename>
+bool MyHashMap<KeyType, ValueType, Policy>::containsKey(const LookupType &key) const {
+    return find(key) != NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType, typename>
+ValueType * MyHashMap<KeyType, ValueType, Policy>::find(const LookupType &key) {
+    Cell *cp = lookupCell(key, hashOf(key));
+    return (cp == NULL) ? NULL : &cp->value;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType, typename>
+const ValueType * MyHashMap<KeyType, ValueType, Policy>::find(const LookupType &key) const {
+    Cell *cp = lookupCell(key, hashOf(key));
+    return (cp == NULL) ? NULL : &cp->value;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+unsigned long long MyHashMap<KeyType, ValueType, Policy>::hashOf(const KeyType &key) {
+    return hashCode(key);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType>
+unsigned long long MyHashMap<KeyType, ValueType, Policy>::hashOf(const LookupType &key) {
+    return MyTransparentLookup<KeyType, LookupType>::hash(key);
+}
+
+/*
+ * 实现笔记：equals
+ * --------------
+ * 同一个篮子中Cell的顺序与插入和rehashing的历史有关，
+ * 所以这里在other中逐个查找本map的key，而不是逐个篮子比较链表。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::equals(const MyHashMap<KeyType, ValueType, Policy> &other) const {
+    if(size() != other.size()) {
         return false;
     }
 
-    Cell *pThis, *pOther;
-    for(int i = 0; i < nBuckets; ++i) {
-        pThis = buckets[i], pOther = other.buckets[i];
-        while(pThis || pOther) {
-            if(!pThis || !pOther) return false;
-            if(pThis->key != pOther->key || pThis->value != pOther->value) return false;
-            pThis = pThis->link;
-            pOther = pOther->link;
-        }
-    }
-    return true;
+    bool same = true;
+    forEachCell([&](Cell *pThis) {
+        if(!same) return;
+        Cell *pOther = other.findCell(other.chainOf(pThis->hash), pThis->key, pThis->hash);
+        if(pOther == NULL || pThis->value != pOther->value) same = false;
+    });
+    return same;
 }
 
 
@@ -443,29 +1463,21 @@ bool MyHashMap<KeyType, ValueType>::equals(const MyHashMap<KeyType, ValueType> &
  * ostringstream的官方文档：https://en.cppreference.com/w/cpp/io/basic_ostringstream
  * 注意：这个实现要求KeyType和ValueType支持插入操作符(<<)。
  */
-template <typename KeyType, typename ValueType>
-std::string MyHashMap<KeyType, ValueType>::toString() const{
+template <typename KeyType, typename ValueType, typename Policy>
+std::string MyHashMap<KeyType, ValueType, Policy>::toString() const{
     std::ostringstream oss;
 
-    Cell *cp = NULL;
-    for(int i = 0; i < nBuckets; ++i) {
-        cp = buckets[i];
-        while(cp) {
-            oss << "{" << cp->key << ": " << cp->value << "}";
-            cp = cp->link;
-        }
-    }
+    forEachCell([&oss](Cell *cp) {
+        oss << "{" << cp->key << ": " << cp->value << "}";
+    });
     return oss.str();
 }
 
-template <typename KeyType, typename ValueType>
-MyVector<ValueType> MyHashMap<KeyType, ValueType>::values() const {
-    MyVector<std::pair<KeyType, ValueType>> keysAndValues;
-    sequentialTraversal(keysAndValues);
-
+template <typename KeyType, typename ValueType, typename Policy>
+MyVector<ValueType> MyHashMap<KeyType, ValueType, Policy>::values() const {
     MyVector<ValueType> values;
-    for(int i = 0; i < keysAndValues.size(); ++i) {
-        values.add(keysAndValues[i].second);
+    for(const ValueType &value : valuesView()) {
+        values.add(value);
     }
     return values;
 }
@@ -475,69 +1487,468 @@ MyVector<ValueType> MyHashMap<KeyType, ValueType>::values() const {
  * -------------------
  * 利用MyHashMap中的方法toString()使得插入操作符支持类MyHashMap
  */
-template <typename KeyType, typename ValueType>
-std::ostream & operator<< (std::ostream &os, const MyHashMap<KeyType, ValueType> & hashmap) {
+template <typename KeyType, typename ValueType, typename Policy>
+std::ostream & operator<< (std::ostream &os, const MyHashMap<KeyType, ValueType, Policy> & hashmap) {
     return os << hashmap.toString();
 }
 
-template <typename KeyType, typename ValueType>
-typename MyHashMap<KeyType, ValueType>::Cell * MyHashMap<KeyType, ValueType>::findCell(int bucket, const KeyType &key) const {
-    Cell *p = buckets[bucket];
-    while(p && p->key != key) {
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType>
+typename MyHashMap<KeyType, ValueType, Policy>::Cell * MyHashMap<KeyType, ValueType, Policy>::findCell(Cell *head, const LookupType &key, unsigned long long hash) const {
+    Cell *p = head;
+#ifdef MY_HASHMAP_STATS
+    long long visited = 0;
+    while(p && (++visited, p->hash != hash || p->key != key)) {
         p = p->link;
     }
+    counters.recordLookup(visited);
+#else
+    while(p && (p->hash != hash || p->key != key)) {
+        p = p->link;
+    }
+#endif
 
     return p;
 }
 
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename LookupType>
+typename MyHashMap<KeyType, ValueType, Policy>::Cell * MyHashMap<KeyType, ValueType, Policy>::lookupCell(const LookupType &key, unsigned long long hash) const {
+    if(bloom != NULL && !bloom->mightContainHash(hash)) {
+#ifdef MY_HASHMAP_STATS
+        counters.recordLookup(0);
+#endif
+        return NULL;
+    }
+    return findCell(chainOf(hash), key, hash);
+}
+
+/*
+ * 实现笔记：lookupMany
+ * ------------------
+ * 每批分三轮：第一轮计算hash Code并预取篮子（chainOf只计算地址，不读取篮子）；
+ * 第二轮读取篮子（此时多半已在cache中）并预取链表的第一个Cell；第三轮才比较key。
+ * 每一轮中的访存互不依赖，CPU可以同时等待一批cache miss。
+ * 有Bloom filter时在最前面多一轮：先预取每个key在filter中的块，被filter排除的key
+ * 不再预取篮子，也不查找链表（heads[j]为NULL）。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+template <typename Fn>
+void MyHashMap<KeyType, ValueType, Policy>::lookupMany(const MyVector<KeyType> &keys, Fn fn) const {
+    unsigned long long hashes[LOOKUP_BATCH];
+    Cell **heads[LOOKUP_BATCH];
+    for(int base = 0; base < keys.size(); base += LOOKUP_BATCH) {
+        int n = (keys.size() - base < LOOKUP_BATCH) ? keys.size() - base : LOOKUP_BATCH;
+        for(int j = 0; j < n; ++j) {
+            hashes[j] = hashCode(keys[base + j]);
+            if(bloom != NULL) bloom->prefetch(hashes[j]);
+        }
+        for(int j = 0; j < n; ++j) {
+            if(bloom != NULL && !bloom->mightContainHash(hashes[j])) {
+                heads[j] = NULL;
+                continue;
+            }
+            heads[j] = &chainOf(hashes[j]);
+            myhashPrefetch(heads[j]);
+        }
+        for(int j = 0; j < n; ++j) {
+            if(heads[j] != NULL && *heads[j] != NULL) myhashPrefetch(*heads[j]);
+        }
+        for(int j = 0; j < n; ++j) {
+            fn(base + j, heads[j] == NULL ? NULL : findCell(*heads[j], keys[base + j], hashes[j]));
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::getMany(const MyVector<KeyType> &keys, MyVector<ValueType *> &out) {
+    out.clear();
+    lookupMany(keys, [&out](int, Cell *cp) {
+        out.add(cp == NULL ? NULL : &cp->value);
+    });
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::getMany(const MyVector<KeyType> &keys, MyVector<const ValueType *> &out) const {
+    out.clear();
+    lookupMany(keys, [&out](int, Cell *cp) {
+        out.add(cp == NULL ? NULL : &cp->value);
+    });
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::containsMany(const MyVector<KeyType> &keys, MyVector<bool> &found) const {
+    found.clear();
+    lookupMany(keys, [&found](int, Cell *cp) {
+        found.add(cp != NULL);
+    });
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::saveSnapshot(const std::string &path) const {
+    mysnapshotSave<KeyType, ValueType>(*this, path);
+}
+
 /*
  * 实现笔记：rehashing
  * -----------------
  * 将hash Table中指针数组的长度增加一倍
- * 并将原来的key-value对重新hash，因为
- * 数组长度变化导致之前的key对应的hash Code
- * 变化，如果不重新hash的话，则之前的key-value
+ * 并将原来的key-value对重新分配到新的篮子中，因为
+ * 数组长度变化导致之前的key对应的篮子
+ * 变化，如果不重新分配的话，则之前的key-value
  * 无法查找到。
  *
- * 注意：需要将原来的heap内存释放掉。
+ * 每个Cell中保存了它的hash Code，所以这里不需要重新计算hashCode(key)，
+ * 也不需要分配新的Cell：只需把原来的Cell从旧链表中摘下，用头插法
+ * 链接到新篮子的链表中。Cell的地址不变，所以operator[]返回的引用在
+ * rehashing后仍然有效。
+ *
+ * 注意：需要将原来的指针数组释放掉。
+ *
+ * 这里只分配新表并把当前表记为旧表。非渐进模式下立即迁移全部篮子；
+ * 渐进模式下由之后的写操作通过rehashStep逐步迁移。
+ * 如果上一次迁移还没有完成，先把它完成，保证同时最多只有两个表。
  */
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::rehashing() {
-    int oldNBuckets = nBuckets;
-    Cell **oldBuckets = buckets;
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::rehashing() {
+    rehashTo(nBuckets * 2, !incremental);
+}
 
-    entries = 0;
-    nBuckets *= 2;
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::rehashTo(int newNBuckets, bool allAtOnce) {
+    if(oldBuckets != NULL) {
+        finishRehash();
+    }
+#ifdef MY_HASHMAP_STATS
+    counters.rehashes++;
+    MyHashMapCounters::RehashTimer timer(counters.rehashNanos);
+#endif
+
+    oldNBuckets = nBuckets;
+    oldBuckets = buckets;
+    rehashIndex = 0;
+
+    nBuckets = newNBuckets;
+    growthLimit = int(nBuckets * REHASH_THRESHOLD);
     buckets = new Cell* [nBuckets];
 
     for(int i = 0; i < nBuckets; ++i) {
         buckets[i] = NULL;
     }
 
-    for(int i = 0; i < oldNBuckets; ++i) {
-        Cell *p = oldBuckets[i];
-        Cell *r = nullptr;
-        while(p) {
-            r = p->link;
-            this->put(p->key, p->value);
-            delete p;
-            p = r;
+    if(allAtOnce) {
+        migrateAll();
+    }
+    rebuildBloom();
+}
+
+/*
+ * 实现笔记：shrinkIfSparse
+ * ----------------------
+ * 扩容发生在负载系数超过1时，这里在负载系数低于1/4时才缩容，并且缩到负载系数为1/4到1/2之间，
+ * 两个阈值之间留有足够的距离（hysteresis）。渐进模式下缩容也是渐进的，与扩容相同。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::shrinkIfSparse() {
+    if(nBuckets > minBuckets && entries < growthLimit / 4) {
+        int target = bucketCountFor(entries * 2);
+        rehashTo(target > minBuckets ? target : minBuckets, !incremental);
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMap<KeyType, ValueType, Policy>::bucketCountFor(int n) {
+    int count = INITIAL_BUCKET_COUNT;
+    while(int(count * REHASH_THRESHOLD) < n && count < (1 << 30)) {
+        count *= 2;
+    }
+    return count;
+}
+
+/*
+ * 实现笔记：reserve, putAll
+ * -----------------------
+ * reserve最多重新链接一次所有Cell，代替逐步插入时的多次rehashing；
+ * putAll先reserve，之后的每次put都不会再触发rehashing。
+ * 如果pairs中有重复的key（或与已有的key重复），预留的篮子会多一些，但不影响正确性。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::reserve(int n) {
+    int target = bucketCountFor(n);
+    if(target > nBuckets) {
+        rehashTo(target, true);
+    }
+    else {
+        finishRehash();
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::putAll(const MyVector<std::pair<KeyType, ValueType>> &pairs) {
+    reserve(entries + pairs.size());
+    for(int i = 0; i < pairs.size(); ++i) {
+        put(pairs[i].first, pairs[i].second);
+    }
+}
+
+/*
+ * 实现笔记：buildParallel
+ * ---------------------
+ * 先reserve，之后的插入不会rehashing，篮子数组也不会再变。分区编号取自篮子下标的最高几位，
+ * 所以每个分区对应一段连续且互不重叠的篮子，处理不同分区的线程从不写同一个篮子。
+ * 分区数是线程数的若干倍，线程用一个原子计数器领取下一个分区，
+ * 这样某个分区特别大时其余线程也不会空等。
+ * 结点池不能被多个线程共用：每个线程使用自己的MyNodePool，结束后由map的结点池adopt，
+ * Cell的地址不变，链表也不需要修改。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::buildParallel(const MyVector<std::pair<KeyType, ValueType>> &pairs, int nThreads) {
+    if(nThreads > pairs.size() / PARALLEL_MIN_PER_THREAD) nThreads = pairs.size() / PARALLEL_MIN_PER_THREAD;
+    if(nThreads <= 1) {
+        putAll(pairs);
+        return;
+    }
+    reserve(entries + pairs.size());
+
+    int bucketBits = 0, partBits = 0;
+    while((1 << bucketBits) < nBuckets) bucketBits++;
+    while((1 << partBits) < nThreads * PARTITIONS_PER_THREAD && partBits < bucketBits) partBits++;
+    int nParts = 1 << partBits;
+
+    MyVector<unsigned long long> hashes(pairs.size());
+    MyVector<int> order(pairs.size());
+    MyVector<int> start(nParts + 1);
+    std::exception_ptr error = myhashPartition(pairs, bucketBits - partBits, nParts, nThreads, hashes, order, start);
+    if(error) std::rethrow_exception(error);
+
+    MyNodePool<Cell> *pools = new MyNodePool<Cell>[nThreads];
+    MyVector<int> added(nThreads, 0);
+    std::atomic<int> nextPart(0);
+    error = myhashParallelFor(nThreads, [&](int t) {
+        int inserted = 0;
+        try {
+            for(int p = nextPart.fetch_add(1); p < nParts; p = nextPart.fetch_add(1)) {
+                for(int j = start[p]; j < start[p + 1]; ++j) {
+                    int i = order[j];
+                    unsigned long long hash = hashes[i];
+                    Cell *&head = buckets[bucketOf(hash)];
+                    Cell *cp = findCell(head, pairs[i].first, hash);
+                    if(cp != NULL) {
+                        cp->value = pairs[i].second;
+                    }
+                    else {
+                        head = pools[t].create(pairs[i].first, pairs[i].second, hash, head);
+                        inserted++;
+                    }
+                }
+            }
+        }
+        catch(...) {
+            added[t] = inserted;
+            throw;
+        }
+        added[t] = inserted;
+    });
+
+    for(int t = 0; t < nThreads; ++t) {
+        pool.adopt(pools[t]);
+        entries += added[t];
+    }
+    delete [] pools;
+    if(bloom != NULL) {
+        for(int i = 0; i < hashes.size(); ++i) {
+            bloom->addHash(hashes[i]);
         }
     }
+    if(error) std::rethrow_exception(error);
 }
 
-template <typename KeyType, typename ValueType>
-MyHashMap<KeyType, ValueType>::MyHashMap(const MyHashMap<KeyType, ValueType> &src) {
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::migrateBucket(int oldBucket) {
+    Cell *p = oldBuckets[oldBucket];
+    Cell *r = nullptr;
+    while(p) {
+        r = p->link;
+        int bucket = bucketOf(p->hash);
+        p->link = buckets[bucket];
+        buckets[bucket] = p;
+        p = r;
+    }
+    oldBuckets[oldBucket] = NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::rehashStep() {
+    if(oldBuckets == NULL) return;
+#ifdef MY_HASHMAP_STATS
+    MyHashMapCounters::RehashTimer timer(counters.rehashNanos);
+#endif
+
+    int moved = 0;
+    int emptyVisits = REHASH_STEP_BUCKETS * 10;
+    while(rehashIndex < oldNBuckets && moved < REHASH_STEP_BUCKETS) {
+        if(oldBuckets[rehashIndex] != NULL) {
+            migrateBucket(rehashIndex);
+            moved++;
+        }
+        else if(--emptyVisits == 0) {
+            rehashIndex++;
+            break;
+        }
+        rehashIndex++;
+    }
+
+    if(rehashIndex == oldNBuckets) {
+        delete [] oldBuckets;
+        oldBuckets = NULL;
+        oldNBuckets = 0;
+        rehashIndex = 0;
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::finishRehash() {
+    if(oldBuckets == NULL) return;
+#ifdef MY_HASHMAP_STATS
+    MyHashMapCounters::RehashTimer timer(counters.rehashNanos);
+#endif
+    migrateAll();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::migrateAll() {
+    for(; rehashIndex < oldNBuckets; ++rehashIndex) {
+        migrateBucket(rehashIndex);
+    }
+    delete [] oldBuckets;
+    oldBuckets = NULL;
+    oldNBuckets = 0;
+    rehashIndex = 0;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::setIncrementalRehash(bool enabled) {
+    incremental = enabled;
+    if(!enabled) {
+        finishRehash();
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::isRehashing() const {
+    return oldBuckets != NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+MyPoolStats MyHashMap<KeyType, ValueType, Policy>::poolStats() const {
+    return pool.stats();
+}
+
+/*
+ * 实现笔记：stats
+ * -------------
+ * 链表中第j个Cell需要比较j次才能找到，所以长度为L的链表贡献L(L + 1) / 2次比较，
+ * 平均探测长度是所有链表的贡献之和除以条目数。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMapStats MyHashMap<KeyType, ValueType, Policy>::stats() const {
+    MyHashMapStats s = MyHashMapStats();
+    s.entries = entries;
+    s.buckets = nBuckets + oldNBuckets;
+    s.loadFactor = double(entries) / nBuckets;
+    long long comparisons = 0;
+    Cell **tables[] = {oldBuckets, buckets};
+    int first[] = {rehashIndex, 0};
+    int sizes[] = {oldNBuckets, nBuckets};
+    for(int t = 0; t < 2; ++t) {
+        for(int i = first[t]; i < sizes[t]; ++i) {
+            int length = 0;
+            for(Cell *cp = tables[t][i]; cp != NULL; cp = cp->link) {
+                length++;
+            }
+            while(s.occupancy.size() <= length) {
+                s.occupancy.add(0);
+            }
+            s.occupancy[length]++;
+            if(length > s.maxProbeLength) s.maxProbeLength = length;
+            comparisons += (long long)length * (length + 1) / 2;
+        }
+    }
+    // 旧表中已经迁移的篮子都是空的
+    if(oldBuckets != NULL && rehashIndex > 0) {
+        if(s.occupancy.isEmpty()) s.occupancy.add(0);
+        s.occupancy[0] += rehashIndex;
+    }
+    s.allocatedBytes = size_t(nBuckets + oldNBuckets) * sizeof(Cell *) + pool.stats().bytesReserved;
+    if(bloom != NULL) s.allocatedBytes += bloom->memoryBytes();
+    if(entries > 0) {
+        s.averageProbeLength = double(comparisons) / entries;
+        s.bytesPerEntry = double(s.allocatedBytes) / entries;
+    }
+#ifdef MY_HASHMAP_STATS
+    counters.fill(s);
+#endif
+    return s;
+}
+
+/*
+ * 实现笔记：enableBloomFilter
+ * -------------------------
+ * 先构造好新的filter再替换旧的：构造函数检查参数时抛出异常，map保持原样。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::enableBloomFilter(double falsePositiveRate, size_t maxBytes) {
+    MyBlockedBloomFilter<KeyType> *filter = new MyBlockedBloomFilter<KeyType>(growthLimit, falsePositiveRate, maxBytes);
+    delete bloom;
+    bloom = filter;
+    forEachCell([filter](Cell *cp) {
+        filter->addHash(cp->hash);
+    });
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::disableBloomFilter() {
+    delete bloom;
+    bloom = NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::hasBloomFilter() const {
+    return bloom != NULL;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::rebuildBloom() {
+    if(bloom == NULL) return;
+    bloom->reset(growthLimit);
+    MyBlockedBloomFilter<KeyType> *filter = bloom;
+    forEachCell([filter](Cell *cp) {
+        filter->addHash(cp->hash);
+    });
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::destroyCells() {
+    if(!std::is_trivially_destructible<Cell>::value) {
+        forEachCell([](Cell *cp) {
+            cp->~Cell();
+        });
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMap<KeyType, ValueType, Policy>::MyHashMap(const MyHashMap<KeyType, ValueType, Policy> &src) {
     deepCopy(src);
 }
 
-template <typename KeyType, typename ValueType>
-MyHashMap<KeyType, ValueType>& MyHashMap<KeyType, ValueType>::operator =(const MyHashMap<KeyType, ValueType> &src) {
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMap<KeyType, ValueType, Policy>& MyHashMap<KeyType, ValueType, Policy>::operator =(const MyHashMap<KeyType, ValueType, Policy> &src) {
     if(this != &src) {
         // free old heap storage
         clear();
         delete [] buckets;
         nBuckets = 0;
+        delete bloom;
 
         // deepCopying
         deepCopy(src);
@@ -545,36 +1956,32 @@ MyHashMap<KeyType, ValueType>& MyHashMap<KeyType, ValueType>::operator =(const M
     return *this;
 }
 
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::deepCopy(const MyHashMap<KeyType, ValueType> &src) {
+/*
+ * 实现笔记：deepCopy
+ * ----------------
+ * 拷贝得到的map只有一个表：即使src正在渐进式rehashing，
+ * 它的所有Cell（包括旧表中的）都按保存的hash Code直接放入新表对应的篮子。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::deepCopy(const MyHashMap<KeyType, ValueType, Policy> &src) {
     nBuckets = src.nBuckets;
     entries = src.entries;
+    growthLimit = src.growthLimit;
+    minBuckets = src.minBuckets;
+    oldBuckets = NULL;
+    oldNBuckets = 0;
+    rehashIndex = 0;
+    incremental = src.incremental;
     buckets = new Cell* [nBuckets];
     for(int i = 0; i < nBuckets; ++i) {
         buckets[i] = NULL;
     }
 
-    for(int i = 0; i < nBuckets; ++i) {
-        Cell *p = src.buckets[i];
-        Cell *q = buckets[i];
-        while(p) {
-            Cell *tmp = new Cell;
-            tmp->key = p->key;
-            tmp->value = p->value;
-            tmp->link = NULL;
-
-            if(buckets[i] == NULL) {
-                buckets[i] = tmp;
-            }
-            else {
-                q->link = tmp;
-            }
-
-            q = tmp;
-            p = p->link;
-        }
-    }
-
+    src.forEachCell([this](Cell *p) {
+        int bucket = bucketOf(p->hash);
+        buckets[bucket] = pool.create(p->key, p->value, p->hash, buckets[bucket]);
+    });
+    bloom = (src.bloom == NULL) ? NULL : new MyBlockedBloomFilter<KeyType>(*src.bloom);
 }
 
 /*
@@ -584,21 +1991,9 @@ void MyHashMap<KeyType, ValueType>::deepCopy(const MyHashMap<KeyType, ValueType>
  * 注意：如果key不存在，则该操作会自动创建该key，其value为
  * 默认值。
  */
-template <typename KeyType, typename ValueType>
-ValueType & MyHashMap<KeyType, ValueType>::operator[] (const KeyType &key) {
-
-    int bucket = hashCode(key) % nBuckets;
-
-    Cell *cp = findCell(bucket, key);
-    if(cp == NULL) {
-        cp = new Cell;
-        cp->key = key;
-        cp->value = ValueType ();
-        cp->link = buckets[bucket];
-        buckets[bucket] = cp;
-        entries ++;
-    }
-    return cp->value;
+template <typename KeyType, typename ValueType, typename Policy>
+ValueType & MyHashMap<KeyType, ValueType, Policy>::operator[] (const KeyType &key) {
+    return findOrInsert(key).first->value;
 }
 
 /*
@@ -607,12 +2002,10 @@ ValueType & MyHashMap<KeyType, ValueType>::operator[] (const KeyType &key) {
  * 根据方法的constness实现此操作符可以将hashmap抽象成key-value的关联数组，
  * 注意：如果key不存在，则什么都不发生
  */
-template <typename KeyType, typename ValueType>
-const ValueType MyHashMap<KeyType, ValueType>::operator[] (const KeyType &key) const{
+template <typename KeyType, typename ValueType, typename Policy>
+const ValueType MyHashMap<KeyType, ValueType, Policy>::operator[] (const KeyType &key) const{
 
-    int bucket = hashCode(key) % nBuckets;
-
-    Cell *cp = findCell(bucket, key);
+    Cell *cp = lookupCell(key, hashCode(key));
     if(cp == NULL) {
         // throw std::out_of_range("Key does not exist.");
         return ValueType();
@@ -622,25 +2015,23 @@ const ValueType MyHashMap<KeyType, ValueType>::operator[] (const KeyType &key) c
     }
 }
 
-template <typename KeyType, typename ValueType>
-bool MyHashMap<KeyType, ValueType>::operator == (const MyHashMap<KeyType, ValueType> &hmp2) const {
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::operator == (const MyHashMap<KeyType, ValueType, Policy> &hmp2) const {
     return this->equals(hmp2);
 }
 
-template <typename KeyType, typename ValueType>
-bool MyHashMap<KeyType, ValueType>::operator != (const MyHashMap<KeyType, ValueType> &hmp2) const {
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMap<KeyType, ValueType, Policy>::operator != (const MyHashMap<KeyType, ValueType, Policy> &hmp2) const {
     return !(*this == hmp2);
 }
 
-template <typename KeyType, typename ValueType>
-void MyHashMap<KeyType, ValueType>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
-    for(int bucket = 0; bucket < nBuckets; ++bucket) {
-        Cell *temp = buckets[bucket];
-        while(temp != nullptr) {
-            fn(temp->key, temp->value);
-            temp = temp->link;
-        }
-    }
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMap<KeyType, ValueType, Policy>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
+    forEachCell([fn](Cell *temp) {
+        fn(temp->key, temp->value);
+    });
 }
 
+#include "myflathashmap.h"
+
 #endif // _myhashmap_h
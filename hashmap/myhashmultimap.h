@@ -0,0 +1,272 @@
+/*
+ * File: myhashmultimap.h
+ * ----------------------
+ * 该类实现了一个key对应多个value的散列表（multimap），用于二级索引等一对多的关联。
+ * 原来的做法是MyHashMap<KeyType, MyVector<ValueType>>，每个key都要分配一个MyVector，
+ * 而MyVector即使只有一个元素也要分配INITIAL_CAPACITY（10）个元素的数组。
+ * 这里每个key的value列表是一个MySmallVector：前INLINE_VALUES个value直接存放在
+ * 散列表的条目中，不分配任何内存；更多的value才搬到一个按两倍扩容的连续数组中。
+ * 同一个key的value保持添加的顺序，并且总是连续存放，getAll直接返回借用它们的MySpan。
+ *
+ * 与MyHashMap相同，模板参数Policy选择底层的散列表（拉链法或开放寻址）。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ */
+
+#ifndef _myhashmultimap_h
+#define _myhashmultimap_h
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include "myhashmap.h"
+#include "myflathashmap.h"
+#include "mysmallvector.h"
+#include "myvector.h"
+
+template <typename KeyType, typename ValueType, typename Policy = MySeparateChaining>
+class MyHashMultiMap {
+public:
+    /* 每个key内联存放的value个数，超过时才为这个key分配数组 */
+    static const int INLINE_VALUES = 2;
+    typedef MySmallVector<ValueType, INLINE_VALUES> ValueList;
+
+    /*
+     * 方法：MyHashMultiMap
+     * 使用：MyHashMultiMap<KeyType, ValueType> multimap;
+     *      MyHashMultiMap<KeyType, ValueType> multimap(expectedKeys);
+     * -----------------------------------------------------------
+     * 构造一个空的multimap；第二种形式预先为expectedKeys个不同的key分配散列表。
+     */
+    MyHashMultiMap();
+    explicit MyHashMultiMap(int expectedKeys);
+
+    /*
+     * 方法：add
+     * 使用：multimap.add(key, value);
+     * -----------------------------
+     * 把value添加到key的value列表的末尾。同一个key可以添加相同的value多次。
+     */
+    void add(const KeyType &key, const ValueType &value);
+
+    /*
+     * 方法：getAll
+     * 使用：for(const ValueType &value : multimap.getAll(key)) ...
+     * ---------------------------------------------------------
+     * 按添加的顺序返回key的所有value，key不存在时返回空的MySpan。
+     * 返回的MySpan借用multimap中的value，不复制任何元素，在multimap被修改之前有效。
+     */
+    MySpan<ValueType> getAll(const KeyType &key) const;
+
+    /*
+     * 方法：count
+     * 使用：int n = multimap.count(key);
+     * --------------------------------
+     * 返回key的value个数，key不存在时返回0。
+     */
+    int count(const KeyType &key) const;
+
+    /*
+     * 方法：containsKey
+     * 使用：if(multimap.containsKey(key)) ...
+     * -------------------------------------
+     * 如果key至少有一个value，则返回true。
+     */
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * 方法：removeAll
+     * 使用：int n = multimap.removeAll(key);
+     * ------------------------------------
+     * 删除key的所有value，返回删除的个数。
+     */
+    int removeAll(const KeyType &key);
+
+    /*
+     * 方法：remove
+     * 使用：if(multimap.remove(key, value)) ...
+     * ---------------------------------------
+     * 删除key的value列表中第一个等于value的元素，其余value保持原来的顺序；
+     * 删除了元素时返回true。key的最后一个value被删除后，key也不再存在。
+     */
+    bool remove(const KeyType &key, const ValueType &value);
+
+    /*
+     * 方法：size, keyCount, isEmpty
+     * 使用：int n = multimap.size();
+     * ----------------------------
+     * size返回所有key的value个数之和，keyCount返回不同的key的个数。
+     */
+    int size() const;
+    int keyCount() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：clear
+     * 使用：multimap.clear();
+     * ---------------------
+     * 删除所有的key和value。
+     */
+    void clear();
+
+    /*
+     * 方法：compact
+     * 使用：multimap.compact();
+     * -----------------------
+     * 见MyHashMap::compact，大量removeAll之后释放多余的内存。
+     */
+    void compact();
+
+    /*
+     * 方法：keys
+     * 使用：MyVector<KeyType> keys = multimap.keys();
+     * ---------------------------------------------
+     * 以不可预测的顺序返回所有不同的key。
+     */
+    MyVector<KeyType> keys() const;
+
+    /*
+     * 方法：mapAll
+     * 使用：multimap.mapAll(fn);
+     * ------------------------
+     * 对每个key调用一次fn(key, values)，values是这个key的所有value。
+     */
+    void mapAll(void (*fn) (const KeyType &, MySpan<ValueType>)) const;
+
+    /*
+     * 方法：toString
+     * 使用：string str = multimap.toString();
+     * -------------------------------------
+     * 与MyHashMap的格式相同，value列表写成MyVector的格式，例如"{k1: {v1, v2}}{k2: {v3}}"。
+     */
+    std::string toString() const;
+
+private:
+    MyHashMap<KeyType, ValueList, Policy> map;
+    int nValues;            // 所有value列表的长度之和
+};
+
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMultiMap<KeyType, ValueType, Policy>::MyHashMultiMap() : nValues(0) {
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+MyHashMultiMap<KeyType, ValueType, Policy>::MyHashMultiMap(int expectedKeys) : map(expectedKeys), nValues(0) {
+}
+
+/*
+ * 实现笔记：add
+ * ------------
+ * tryEmplace只计算一次hash Code、查找一次：key不存在时就地构造一个空的ValueList。
+ * 添加value抛出异常时，刚插入的key被删除，不会留下没有value的key。
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMultiMap<KeyType, ValueType, Policy>::add(const KeyType &key, const ValueType &value) {
+    std::pair<ValueList *, bool> slot = map.tryEmplace(key);
+    try {
+        slot.first->add(value);
+    }
+    catch(...) {
+        if(slot.second) map.remove(key);
+        throw;
+    }
+    nValues++;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+MySpan<ValueType> MyHashMultiMap<KeyType, ValueType, Policy>::getAll(const KeyType &key) const {
+    const ValueList *list = map.find(key);
+    return (list == NULL) ? MySpan<ValueType>() : list->view();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMultiMap<KeyType, ValueType, Policy>::count(const KeyType &key) const {
+    const ValueList *list = map.find(key);
+    return (list == NULL) ? 0 : list->size();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMultiMap<KeyType, ValueType, Policy>::containsKey(const KeyType &key) const {
+    return map.containsKey(key);
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMultiMap<KeyType, ValueType, Policy>::removeAll(const KeyType &key) {
+    const ValueList *list = map.find(key);
+    if(list == NULL) return 0;
+    int n = list->size();
+    map.remove(key);
+    nValues -= n;
+    return n;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMultiMap<KeyType, ValueType, Policy>::remove(const KeyType &key, const ValueType &value) {
+    ValueList *list = map.find(key);
+    if(list == NULL) return false;
+    for(int i = 0; i < list->size(); ++i) {
+        if((*list)[i] == value) {
+            list->remove(i);
+            nValues--;
+            if(list->isEmpty()) map.remove(key);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMultiMap<KeyType, ValueType, Policy>::size() const {
+    return nValues;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+int MyHashMultiMap<KeyType, ValueType, Policy>::keyCount() const {
+    return map.size();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+bool MyHashMultiMap<KeyType, ValueType, Policy>::isEmpty() const {
+    return nValues == 0;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMultiMap<KeyType, ValueType, Policy>::clear() {
+    map.clear();
+    nValues = 0;
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMultiMap<KeyType, ValueType, Policy>::compact() {
+    map.compact();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+MyVector<KeyType> MyHashMultiMap<KeyType, ValueType, Policy>::keys() const {
+    return map.keys();
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+void MyHashMultiMap<KeyType, ValueType, Policy>::mapAll(void (*fn) (const KeyType &, MySpan<ValueType>)) const {
+    for(typename MyHashMap<KeyType, ValueList, Policy>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        fn(it.key(), it.value().view());
+    }
+}
+
+template <typename KeyType, typename ValueType, typename Policy>
+std::string MyHashMultiMap<KeyType, ValueType, Policy>::toString() const {
+    return map.toString();
+}
+
+/*
+ * 实现笔记：operator<<
+ * -------------------
+ * 利用toString()使得插入操作符支持类MyHashMultiMap
+ */
+template <typename KeyType, typename ValueType, typename Policy>
+std::ostream & operator<< (std::ostream &os, const MyHashMultiMap<KeyType, ValueType, Policy> &multimap) {
+    return os << multimap.toString();
+}
+
+#endif // _myhashmultimap_h
@@ -0,0 +1,299 @@
+/*
+ * File: mymappedhashmap.h
+ * -----------------------
+ * 该类是只读的散列表，直接使用MyHashMap::saveSnapshot写出的快照文件：
+ * 构造时只mmap整个文件并检查文件头，不读取、不反序列化任何条目，
+ * 查找时直接在映射的内存（也就是操作系统的page cache）中探测slot数组、比较记录中的key。
+ * 所以无论快照有多大，打开都几乎是瞬间完成的，只有被查找到的页才会真正从磁盘读入；
+ * 同一个快照被多个进程打开时，它们共享同一份page cache。
+ *
+ * 快照格式见mysnapshot.h。KeyType、ValueType必须与保存时相同（可平凡复制的类型或std::string）。
+ * 快照文件被认为是可信的：这里只检查文件头，不检查每个slot和记录。
+ * 只支持POSIX系统（mmap）。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: 添加enableBloomFilter，不存在的key不必访问映射的内存。
+ */
+
+#ifndef _mymappedhashmap_h
+#define _mymappedhashmap_h
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mybloomfilter.h"
+#include "mysnapshot.h"
+
+template <typename KeyType, typename ValueType>
+class MyMappedHashMap {
+public:
+    /*
+     * 方法：MyMappedHashMap
+     * 使用：MyMappedHashMap<KeyType, ValueType> mapped(path);
+     * -----------------------------------------------------
+     * 以只读方式mmap快照文件path。文件无法打开或映射时抛出std::runtime_error；
+     * 文件不是快照、版本或字节序不同、KeyType/ValueType与保存时不一致时抛出std::invalid_argument。
+     */
+    explicit MyMappedHashMap(const std::string &path);
+
+    /*
+     * 方法：～MyMappedHashMap
+     * 使用：隐式调用
+     * -------------
+     * 解除映射。
+     */
+    ~MyMappedHashMap();
+
+    /*
+     * 方法：get
+     * 使用：ValueType value = mapped.get(key);
+     * --------------------------------------
+     * 返回key对应的value，如果key不存在则返回ValueType的默认值。
+     */
+    ValueType get(const KeyType &key) const;
+
+    /*
+     * 方法：tryGet
+     * 使用：if(mapped.tryGet(key, value)) ...
+     * -------------------------------------
+     * key存在时把value复制到out并返回true，否则返回false，out保持不变。
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+
+    /*
+     * 方法：containsKey
+     * 使用：if(mapped.containsKey(key)) ...
+     * -----------------------------------
+     * 如果有key的条目，则返回true。不会复制value。
+     */
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * 方法：size, isEmpty
+     * 使用：int n = mapped.size();
+     * --------------------------
+     * 返回条目的个数；没有条目时isEmpty返回true。
+     */
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：mapAll
+     * 使用：mapped.mapAll(fn);
+     * ----------------------
+     * 按slot数组中的顺序对每个条目调用fn(key, value)。会读入整个快照。
+     */
+    void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+    /*
+     * 方法：toString
+     * 使用：string str = mapped.toString();
+     * -----------------------------------
+     * 格式与MyHashMap相同，例如"{k1: v1}{k2: v2}"。
+     */
+    std::string toString() const;
+
+    /*
+     * 方法：enableBloomFilter, disableBloomFilter, hasBloomFilter
+     * 使用：mapped.enableBloomFilter(0.01);
+     * -----------------------------------
+     * 在内存中为快照里的所有key建立一个分块Bloom filter（见mybloomfilter.h），之后get、tryGet、containsKey
+     * 先查询它：被filter排除的key不访问映射的内存，也就不会为了一个不存在的key从磁盘读入slot数组和记录的页。
+     * 建立时读取每条记录中保存的hash Code（会把整个快照读入一次），打开快照之后调用一次即可。
+     * falsePositiveRate、maxBytes的含义与MyHashMap::enableBloomFilter相同。
+     */
+    void enableBloomFilter(double falsePositiveRate = 0.01, size_t maxBytes = 0);
+    void disableBloomFilter();
+    bool hasBloomFilter() const;
+
+    /* 映射只属于一个对象，禁止复制 */
+    MyMappedHashMap(const MyMappedHashMap<KeyType, ValueType> &src) = delete;
+    MyMappedHashMap<KeyType, ValueType> & operator= (const MyMappedHashMap<KeyType, ValueType> &src) = delete;
+
+private:
+    const char *base;                       // 映射的起始地址
+    size_t length;                          // 映射的长度
+    const MySnapshotHeader *header;
+    const unsigned long long *slots;        // header->capacity个记录偏移量，0表示空槽
+    unsigned long long mask;                // header->capacity - 1
+    MyBlockedBloomFilter<KeyType> *bloom;   // 快照中所有key的hash Code（mysnapshotHash），没有时为NULL
+
+    /* 返回key的记录，不存在时返回NULL */
+    const MySnapshotRecord * findRecord(const KeyType &key) const;
+
+    /* 记录中key、value字节的起始地址 */
+    static const char * keyBytes(const MySnapshotRecord *record) {
+        return reinterpret_cast<const char *>(record + 1);
+    }
+    static const char * valueBytes(const MySnapshotRecord *record) {
+        return keyBytes(record) + record->keyLength;
+    }
+};
+
+template <typename KeyType, typename ValueType>
+MyMappedHashMap<KeyType, ValueType>::MyMappedHashMap(const std::string &path) {
+    bloom = NULL;
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw std::runtime_error("MyMappedHashMap: can not open " + path);
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("MyMappedHashMap: can not stat " + path);
+    }
+    length = size_t(st.st_size);
+    if(length < sizeof(MySnapshotHeader)) {
+        close(fd);
+        throw std::invalid_argument("MyMappedHashMap: " + path + " is not a snapshot");
+    }
+    void *p = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                              // 映射建立之后不再需要文件描述符
+    if(p == MAP_FAILED) {
+        throw std::runtime_error("MyMappedHashMap: can not map " + path);
+    }
+    base = static_cast<const char *>(p);
+    header = reinterpret_cast<const MySnapshotHeader *>(base);
+
+    const char *error = NULL;
+    if(std::memcmp(header->magic, MY_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        error = " is not a snapshot";
+    } else if(header->version != MY_SNAPSHOT_VERSION || header->byteOrder != 0x01020304) {
+        error = " has an unsupported version or byte order";
+    } else if(header->keyTag != MySnapshotCodec<KeyType>::TAG || header->valueTag != MySnapshotCodec<ValueType>::TAG) {
+        error = " was saved with different key or value types";
+    } else if(header->fileSize != length || header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0
+              || header->slotsOffset + header->capacity * sizeof(unsigned long long) > length) {
+        error = " is truncated or corrupt";
+    }
+    if(error != NULL) {
+        munmap(p, length);
+        throw std::invalid_argument("MyMappedHashMap: " + path + error);
+    }
+    slots = reinterpret_cast<const unsigned long long *>(base + header->slotsOffset);
+    mask = header->capacity - 1;
+    // 查找在文件中随机跳转，预读相邻的页没有用处
+    madvise(p, length, MADV_RANDOM);
+}
+
+template <typename KeyType, typename ValueType>
+MyMappedHashMap<KeyType, ValueType>::~MyMappedHashMap() {
+    munmap(const_cast<char *>(base), length);
+    delete bloom;
+}
+
+/*
+ * 实现笔记：findRecord
+ * -------------------
+ * 与mysnapshotSave相同的线性探测：从hash & mask开始，直到遇到空槽。
+ * 先比较记录中保存的hash Code和key长度，只有都相同才逐字节比较key。
+ * 有Bloom filter时先查询它，被排除的key不读取映射的内存。
+ */
+template <typename KeyType, typename ValueType>
+const MySnapshotRecord * MyMappedHashMap<KeyType, ValueType>::findRecord(const KeyType &key) const {
+    const char *bytes = MySnapshotCodec<KeyType>::data(key);
+    size_t keyLength = MySnapshotCodec<KeyType>::size(key);
+    unsigned long long hash = mysnapshotHash(bytes, keyLength);
+    if(bloom != NULL && !bloom->mightContainHash(hash)) {
+        return NULL;
+    }
+    for(unsigned long long i = hash & mask; slots[i] != 0; i = (i + 1) & mask) {
+        const MySnapshotRecord *record = reinterpret_cast<const MySnapshotRecord *>(base + slots[i]);
+        if(record->hash == hash && record->keyLength == keyLength
+           && std::memcmp(keyBytes(record), bytes, keyLength) == 0) {
+            return record;
+        }
+    }
+    return NULL;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyMappedHashMap<KeyType, ValueType>::get(const KeyType &key) const {
+    const MySnapshotRecord *record = findRecord(key);
+    return record == NULL ? ValueType() : MySnapshotCodec<ValueType>::decode(valueBytes(record), record->valueLength);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMappedHashMap<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) const {
+    const MySnapshotRecord *record = findRecord(key);
+    if(record == NULL) return false;
+    out = MySnapshotCodec<ValueType>::decode(valueBytes(record), record->valueLength);
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMappedHashMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    return findRecord(key) != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+int MyMappedHashMap<KeyType, ValueType>::size() const {
+    return int(header->count);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMappedHashMap<KeyType, ValueType>::isEmpty() const {
+    return header->count == 0;
+}
+
+template <typename KeyType, typename ValueType>
+void MyMappedHashMap<KeyType, ValueType>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
+    for(unsigned long long i = 0; i <= mask; ++i) {
+        if(slots[i] == 0) continue;
+        const MySnapshotRecord *record = reinterpret_cast<const MySnapshotRecord *>(base + slots[i]);
+        fn(MySnapshotCodec<KeyType>::decode(keyBytes(record), record->keyLength),
+           MySnapshotCodec<ValueType>::decode(valueBytes(record), record->valueLength));
+    }
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyMappedHashMap<KeyType, ValueType>::toString() const {
+    std::ostringstream os;
+    for(unsigned long long i = 0; i <= mask; ++i) {
+        if(slots[i] == 0) continue;
+        const MySnapshotRecord *record = reinterpret_cast<const MySnapshotRecord *>(base + slots[i]);
+        os << "{" << MySnapshotCodec<KeyType>::decode(keyBytes(record), record->keyLength) << ": "
+           << MySnapshotCodec<ValueType>::decode(valueBytes(record), record->valueLength) << "}";
+    }
+    return os.str();
+}
+
+template <typename KeyType, typename ValueType>
+void MyMappedHashMap<KeyType, ValueType>::enableBloomFilter(double falsePositiveRate, size_t maxBytes) {
+    MyBlockedBloomFilter<KeyType> *filter = new MyBlockedBloomFilter<KeyType>(int(header->count), falsePositiveRate, maxBytes);
+    for(unsigned long long i = 0; i <= mask; ++i) {
+        if(slots[i] == 0) continue;
+        filter->addHash(reinterpret_cast<const MySnapshotRecord *>(base + slots[i])->hash);
+    }
+    delete bloom;
+    bloom = filter;
+}
+
+template <typename KeyType, typename ValueType>
+void MyMappedHashMap<KeyType, ValueType>::disableBloomFilter() {
+    delete bloom;
+    bloom = NULL;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMappedHashMap<KeyType, ValueType>::hasBloomFilter() const {
+    return bloom != NULL;
+}
+
+/*
+ * 重载运算符<<
+ * -----------
+ * 输出toString()的结果。
+ */
+template <typename KeyType, typename ValueType>
+std::ostream & operator<<(std::ostream &os, const MyMappedHashMap<KeyType, ValueType> &map) {
+    return os << map.toString();
+}
+
+#endif // _mymappedhashmap_h
@@ -0,0 +1,891 @@
+/*
+ * File: mypersistenthashmap.h
+ * ---------------------------
+ * 该类是持久化（persistent）的散列表：底层是hash array mapped trie（HAMT），
+ * 复制一个map只需O(1)——两个副本共享同一棵树，之后各自的修改互不影响。
+ *
+ * 树的每一层用hash Code中的5位选择32个分支之一。结点用两个32位的位图（CHAMP风格）
+ * 记录哪些分支直接存放条目（dataMap）、哪些分支指向下一层的结点（nodeMap），
+ * 条目和子结点按分支的顺序紧凑地存放在结点之后，下标由popcount算出，没有空槽。
+ * 64位hash Code用完之后（13层之后）hash Code完全相同的key放在一个线性的冲突结点中。
+ *
+ * 修改时只复制从根到被修改条目的路径（path copying，O(log32 N)个结点），
+ * 其余的子树由新旧两个版本共享。结点带有原子的引用计数：
+ *      1. 复制map只增加根结点的引用计数；
+ *      2. 沿路径的结点只被这一个map引用（引用计数为1）时直接原地修改，
+ *         所以没有被复制过的map与普通的散列表一样不会复制路径；
+ *      3. 最后一个引用消失时释放结点。
+ * 因此可以把一个MyPersistentHashMap当作快照保存下来，之后用赋值回滚到那个版本。
+ *
+ * 同一个MyPersistentHashMap对象不能被多个线程同时修改；
+ * 但不同的副本（即使共享结点）可以在不同的线程中同时读取和修改。
+ * -------------------------------------------------------------------------------
+ * 参考：https://lampwww.epfl.ch/papers/idealhashtrees.pdf (Ideal Hash Trees)
+ *      https://michael.steindorfer.name/publications/oopsla15.pdf (CHAMP)
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ */
+
+#ifndef _mypersistenthashmap_h
+#define _mypersistenthashmap_h
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "myhashcode.h"
+#include "myhashmap.h"
+#include "myflathashmap.h"
+#include "myvector.h"
+
+template <typename KeyType, typename ValueType>
+class MyPersistentHashMap {
+public:
+    /*
+     * 方法：MyPersistentHashMap
+     * 使用：MyPersistentHashMap<KeyType, ValueType> pmap;
+     *      MyPersistentHashMap<KeyType, ValueType> pmap(map);
+     * ---------------------------------------------------
+     * 第一种形式构造一个空的map，不分配任何内存；第二种复制MyHashMap（拉链法或开放寻址）中的所有条目。
+     */
+    MyPersistentHashMap();
+    template <typename Policy>
+    explicit MyPersistentHashMap(const MyHashMap<KeyType, ValueType, Policy> &map);
+
+    /*
+     * 方法：～MyPersistentHashMap
+     * 使用：隐式调用
+     * -------------
+     * 释放对根结点的引用，不再被任何版本引用的结点随之释放。
+     */
+    ~MyPersistentHashMap();
+
+    /*
+     * 拷贝构造函数和赋值操作符
+     * 使用：MyPersistentHashMap<KeyType, ValueType> snapshot = pmap;   // O(1)的快照
+     *      pmap = snapshot;                                          // 回滚到快照
+     * ------------------------------------------------------------------------
+     * 只复制根结点的指针并增加它的引用计数，时间为O(1)，与条目数无关。
+     * 之后修改任何一方都只复制被修改的路径，另一方看不到这些修改。
+     */
+    MyPersistentHashMap(const MyPersistentHashMap<KeyType, ValueType> &src);
+    MyPersistentHashMap<KeyType, ValueType> & operator= (const MyPersistentHashMap<KeyType, ValueType> &src);
+
+    /*
+     * 方法：get
+     * 使用：ValueType value = pmap.get(key);
+     * ------------------------------------
+     * 返回key对应的value，如果key不存在则返回ValueType的默认值。
+     */
+    ValueType get(const KeyType &key) const;
+
+    /*
+     * 方法：tryGet
+     * 使用：if(pmap.tryGet(key, value)) ...
+     * -----------------------------------
+     * key存在时把value复制到out并返回true，否则返回false，out保持不变。
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+
+    /*
+     * 方法：containsKey
+     * 使用：if(pmap.containsKey(key)) ...
+     * ---------------------------------
+     * 如果有key的条目，则返回true。
+     */
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * 方法：find
+     * 使用：const ValueType *vp = pmap.find(key);
+     * -----------------------------------------
+     * 返回指向key对应的value的指针，如果key不存在则返回NULL。
+     * value可能被其他版本共享，所以只能读取；指针在pmap被修改、赋值或销毁之前有效。
+     */
+    const ValueType * find(const KeyType &key) const;
+
+    /*
+     * 方法：put
+     * 使用：pmap.put(key, value);
+     * -------------------------
+     * 将key与value关联，key已存在时替换原来的value。
+     * 路径上的结点被其他版本共享时复制它们（O(log32 N)），否则原地修改。
+     */
+    void put(const KeyType &key, const ValueType &value);
+
+    /*
+     * 方法：remove
+     * 使用：pmap.remove(key);
+     * ---------------------
+     * 删除key的条目（如果存在）。与put相同，只复制被共享的路径。
+     */
+    void remove(const KeyType &key);
+
+    /*
+     * 方法：with, without
+     * 使用：MyPersistentHashMap<KeyType, ValueType> next = pmap.with(key, value);
+     * -----------------------------------------------------------------------
+     * 返回添加（或替换）了key的新版本 / 删除了key的新版本，pmap本身不变。
+     * 新旧两个版本共享除被修改的路径以外的所有结点。
+     */
+    MyPersistentHashMap<KeyType, ValueType> with(const KeyType &key, const ValueType &value) const;
+    MyPersistentHashMap<KeyType, ValueType> without(const KeyType &key) const;
+
+    /*
+     * 方法：size, isEmpty
+     * 使用：int n = pmap.size();
+     * ------------------------
+     * 返回条目的个数；没有条目时isEmpty返回true。
+     */
+    int size() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：clear
+     * 使用：pmap.clear();
+     * -----------------
+     * 删除所有条目。只释放这个版本的引用，其他版本不受影响。
+     */
+    void clear();
+
+    /*
+     * 方法：keys, values
+     * 使用：MyVector<KeyType> keys = pmap.keys();
+     * -----------------------------------------
+     * 按树中的顺序（由hash Code决定，不可预测）返回所有key或value的副本。
+     */
+    MyVector<KeyType> keys() const;
+    MyVector<ValueType> values() const;
+
+    /*
+     * 方法：mapAll
+     * 使用：pmap.mapAll(fn);
+     * --------------------
+     * 按树中的顺序对每个条目调用fn(key, value)。
+     */
+    void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+    /*
+     * 方法：equals
+     * 使用：if(pmap.equals(pmap2)) ...
+     * ------------------------------
+     * 两个map包含相同的key-value对时返回true。共享同一个根结点的版本直接判为相等。
+     * 这个实现要求ValueType支持 != 运算符。
+     */
+    bool equals(const MyPersistentHashMap<KeyType, ValueType> &src) const;
+    bool operator == (const MyPersistentHashMap<KeyType, ValueType> &src) const;
+    bool operator != (const MyPersistentHashMap<KeyType, ValueType> &src) const;
+
+    /*
+     * 方法：toString
+     * 使用：string str = pmap.toString();
+     * ---------------------------------
+     * 格式与MyHashMap相同，例如"{k1: v1}{k2: v2}"。
+     */
+    std::string toString() const;
+
+private:
+    /* 每一层使用的hash Code位数，以及hash Code的总位数 */
+    static const int BITS_PER_LEVEL = 5;
+    static const int HASH_BITS = 64;
+    /* 13层位图结点加上一层冲突结点 */
+    static const int MAX_DEPTH = (HASH_BITS + BITS_PER_LEVEL - 1) / BITS_PER_LEVEL + 1;
+
+    struct Entry {
+        unsigned long long hash;
+        KeyType key;
+        ValueType value;
+
+        Entry(unsigned long long hash, const KeyType &key, const ValueType &value) : hash(hash), key(key), value(value) {}
+    };
+
+    /*
+     * 结点
+     * ----
+     * 结点头之后紧接着nEntries个Entry和nChildren个子结点指针，三者在一次分配中得到。
+     * shift >= HASH_BITS的结点是冲突结点：dataMap、nodeMap都为0，条目按添加顺序存放。
+     */
+    struct Node {
+        std::atomic<int> refs;
+        unsigned dataMap;       // 第i位为1：分支i直接存放一个条目
+        unsigned nodeMap;       // 第i位为1：分支i指向一个子结点
+        int nEntries;
+        int nChildren;
+        Entry *entries;
+        Node **children;
+    };
+
+    Node *root;         // 空map为NULL
+    int count;
+
+public:
+    /*
+     * 迭代器
+     * 使用：for(const KeyType &key : pmap) ...
+     *      for(MyPersistentHashMap<KeyType, ValueType>::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+     *          cout << it.key() << ": " << it.value() << endl;
+     *      }
+     * ---------------------------------------------------------------------------------------------
+     * 按树中的顺序遍历所有key，key()和value()给出当前条目的key和value。
+     * 迭代器只保存从根到当前结点的路径（最多MAX_DEPTH层），不复制任何条目。
+     * 修改pmap之后，已有的迭代器失效；迭代器遍历的是创建它时的版本，其他副本的修改不影响它。
+     */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef KeyType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const KeyType * pointer;
+        typedef const KeyType & reference;
+
+        const_iterator() : depth(-1) {}
+
+        reference operator*() const { return current()->key; }
+        pointer operator->() const { return &current()->key; }
+        const KeyType & key() const { return current()->key; }
+        const ValueType & value() const { return current()->value; }
+
+        const_iterator & operator++() {
+            index[depth]++;
+            settle();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator &rhs) const { return current() == rhs.current(); }
+        bool operator!=(const const_iterator &rhs) const { return current() != rhs.current(); }
+
+    private:
+        friend class MyPersistentHashMap;
+
+        explicit const_iterator(const Node *root) : depth(-1) {
+            if(root != NULL) {
+                depth = 0;
+                path[0] = root;
+                index[0] = 0;
+                settle();
+            }
+        }
+
+        const Entry * current() const {
+            return (depth < 0) ? NULL : &path[depth]->entries[index[depth]];
+        }
+
+        /*
+         * 每个结点先访问它的条目，再依次进入子结点；子结点访问完之后回到父结点。
+         * 停在下一个条目上，没有时depth为-1（即end()）。
+         */
+        void settle() {
+            while(depth >= 0) {
+                const Node *node = path[depth];
+                int i = index[depth];
+                if(i < node->nEntries) return;
+                if(i < node->nEntries + node->nChildren) {
+                    index[depth]++;
+                    path[depth + 1] = node->children[i - node->nEntries];
+                    index[depth + 1] = 0;
+                    depth++;
+                } else {
+                    depth--;
+                }
+            }
+        }
+
+        const Node *path[MAX_DEPTH];
+        int index[MAX_DEPTH];       // 在path[d]中的位置：先是条目，之后是子结点
+        int depth;                  // 当前结点的层数，遍历结束时为-1
+    };
+    typedef const_iterator iterator;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    /* 返回hash Code在shift这一层选择的分支对应的位 */
+    static unsigned bitOf(unsigned long long hash, int shift);
+    /* 返回bitmap中低于bit的1的个数，也就是bit对应的条目/子结点的下标 */
+    static int indexOf(unsigned bitmap, unsigned bit);
+    static int bitCount(unsigned bitmap);
+
+    /*
+     * 方法：allocate, freeNode, release
+     * ---------------------------------
+     * allocate分配一个可以容纳nEntries个条目、nChildren个子结点的结点（条目尚未构造），引用计数为1。
+     * freeNode析构条目并释放内存，但不处理子结点（它们已经被转移到新结点或者已经释放）。
+     * release减少引用计数，降为0时释放子结点的引用和结点本身。
+     */
+    static Node * allocate(int nEntries, int nChildren);
+    static void freeNode(Node *node);
+    static void release(Node *node);
+    static void retain(Node *node);
+
+    /*
+     * 方法：remake
+     * 使用：Node *n = remake(old, owned, dataMap, nodeMap, bit, entry, child);
+     * -----------------------------------------------------------------------
+     * 按新的位图dataMap、nodeMap构造一个新结点：分支bit上的条目为entry（不为NULL时，从中移动），
+     * 分支bit上的子结点为child（不为NULL时，转移child的引用），其余的条目和子结点取自old。
+     * owned为true时old只被这个map引用：条目从old中移动，子结点直接转移，最后释放old；
+     * 否则复制条目、增加子结点的引用计数，old保持不变。
+     */
+    static Node * remake(Node *old, bool owned, unsigned dataMap, unsigned nodeMap, unsigned bit, Entry *entry, Node *child);
+
+    /*
+     * 方法：remakeCollision
+     * --------------------
+     * 冲突结点版本的remake：保留old中除第skip个以外的条目，entry不为NULL时把它添加到末尾。
+     */
+    static Node * remakeCollision(Node *old, bool owned, int skip, Entry *entry);
+
+    /* 构造包含a、b两个条目（从中移动）的子树，a、b在shift之前的各层选择相同的分支 */
+    static Node * mergeEntries(int shift, Entry &a, Entry &b);
+
+    /*
+     * 方法：assoc, dissoc
+     * ------------------
+     * 在以node为根、位于shift这一层的子树中添加（替换）entry / 删除key，返回修改后的子树的根。
+     * 返回的结点与node不同时：owned为true则node已被释放，否则node保持不变（旧版本仍在使用它）。
+     * dissoc返回NULL表示子树为空。
+     */
+    static Node * assoc(Node *node, bool owned, int shift, Entry &entry, bool &added);
+    static Node * dissoc(Node *node, bool owned, int shift, unsigned long long hash, const KeyType &key, bool &removed);
+
+    /* 沿hash Code查找key的条目，不存在时返回NULL */
+    const Entry * findEntry(const KeyType &key) const;
+};
+
+template <typename KeyType, typename ValueType>
+MyPersistentHashMap<KeyType, ValueType>::MyPersistentHashMap() : root(NULL), count(0) {
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Policy>
+MyPersistentHashMap<KeyType, ValueType>::MyPersistentHashMap(const MyHashMap<KeyType, ValueType, Policy> &map) : root(NULL), count(0) {
+    for(typename MyHashMap<KeyType, ValueType, Policy>::const_iterator it = map.begin(); it != map.end(); ++it) {
+        put(it.key(), it.value());
+    }
+}
+
+template <typename KeyType, typename ValueType>
+MyPersistentHashMap<KeyType, ValueType>::~MyPersistentHashMap() {
+    if(root != NULL) release(root);
+}
+
+template <typename KeyType, typename ValueType>
+MyPersistentHashMap<KeyType, ValueType>::MyPersistentHashMap(const MyPersistentHashMap<KeyType, ValueType> &src) : root(src.root), count(src.count) {
+    if(root != NULL) retain(root);
+}
+
+/*
+ * 实现笔记：operator=
+ * ------------------
+ * 先增加src根结点的引用计数再释放自己的，所以自我赋值和共享同一个根结点的赋值都是安全的。
+ */
+template <typename KeyType, typename ValueType>
+MyPersistentHashMap<KeyType, ValueType> & MyPersistentHashMap<KeyType, ValueType>::operator= (const MyPersistentHashMap<KeyType, ValueType> &src) {
+    if(src.root != NULL) retain(src.root);
+    if(root != NULL) release(root);
+    root = src.root;
+    count = src.count;
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+unsigned MyPersistentHashMap<KeyType, ValueType>::bitOf(unsigned long long hash, int shift) {
+    return 1u << ((hash >> shift) & 31);
+}
+
+template <typename KeyType, typename ValueType>
+int MyPersistentHashMap<KeyType, ValueType>::bitCount(unsigned bitmap) {
+#if defined(__GNUC__)
+    return __builtin_popcount(bitmap);
+#else
+    int n = 0;
+    for(; bitmap != 0; bitmap &= bitmap - 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+template <typename KeyType, typename ValueType>
+int MyPersistentHashMap<KeyType, ValueType>::indexOf(unsigned bitmap, unsigned bit) {
+    return bitCount(bitmap & (bit - 1));
+}
+
+/*
+ * 实现笔记：allocate
+ * -----------------
+ * 结点头、条目数组、子结点指针数组依次放在一块内存中，各自按对齐要求向上取整。
+ */
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::Node * MyPersistentHashMap<KeyType, ValueType>::allocate(int nEntries, int nChildren) {
+    size_t entryOffset = (sizeof(Node) + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+    size_t childOffset = entryOffset + nEntries * sizeof(Entry);
+    childOffset = (childOffset + alignof(Node *) - 1) / alignof(Node *) * alignof(Node *);
+    char *raw = static_cast<char *>(::operator new(childOffset + nChildren * sizeof(Node *)));
+    Node *node = new (raw) Node;
+    node->refs.store(1, std::memory_order_relaxed);
+    node->dataMap = 0;
+    node->nodeMap = 0;
+    node->nEntries = nEntries;
+    node->nChildren = nChildren;
+    node->entries = reinterpret_cast<Entry *>(raw + entryOffset);
+    node->children = reinterpret_cast<Node **>(raw + childOffset);
+    return node;
+}
+
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::freeNode(Node *node) {
+    for(int i = 0; i < node->nEntries; ++i) {
+        node->entries[i].~Entry();
+    }
+    node->~Node();
+    ::operator delete(static_cast<void *>(node));
+}
+
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::retain(Node *node) {
+    node->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+ * 实现笔记：release
+ * ----------------
+ * 与std::shared_ptr相同：减少引用计数使用acq_rel，保证释放结点的线程看到其他线程之前对它的所有写入。
+ * 树的深度不超过MAX_DEPTH，所以递归是安全的。
+ */
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::release(Node *node) {
+    if(node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    for(int i = 0; i < node->nChildren; ++i) {
+        release(node->children[i]);
+    }
+    freeNode(node);
+}
+
+/*
+ * 实现笔记：remake
+ * ---------------
+ * 先构造分支bit上的新条目：之后的条目只有在移动不会抛出异常时才从old中移动，
+ * 所以构造过程中抛出异常时old仍然完整，新结点中已经构造的条目被析构、内存被释放。
+ */
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::Node *
+MyPersistentHashMap<KeyType, ValueType>::remake(Node *old, bool owned, unsigned dataMap, unsigned nodeMap, unsigned bit, Entry *entry, Node *child) {
+    Node *node = allocate(bitCount(dataMap), bitCount(nodeMap));
+    node->dataMap = dataMap;
+    node->nodeMap = nodeMap;
+    int at = (entry != NULL) ? indexOf(dataMap, bit) : -1;
+    int i = 0;
+    bool atBuilt = false;
+    try {
+        if(at >= 0) {
+            new (&node->entries[at]) Entry(std::move(*entry));
+            atBuilt = true;
+        }
+        for(unsigned rest = dataMap; rest != 0; rest &= rest - 1, ++i) {
+            if(i == at) continue;
+            Entry &src = old->entries[indexOf(old->dataMap, rest & (0u - rest))];
+            if(owned) {
+                new (&node->entries[i]) Entry(std::move_if_noexcept(src));
+            } else {
+                new (&node->entries[i]) Entry(src);
+            }
+        }
+    }
+    catch(...) {
+        for(int j = 0; j < i; ++j) {
+            if(j != at) node->entries[j].~Entry();
+        }
+        if(atBuilt) node->entries[at].~Entry();
+        node->nEntries = 0;
+        freeNode(node);
+        throw;
+    }
+    int j = 0;
+    for(unsigned rest = nodeMap; rest != 0; rest &= rest - 1, ++j) {
+        unsigned b = rest & (0u - rest);
+        if(b == bit && child != NULL) {
+            node->children[j] = child;
+        } else {
+            node->children[j] = old->children[indexOf(old->nodeMap, b)];
+            if(!owned) retain(node->children[j]);
+        }
+    }
+    if(owned) freeNode(old);
+    return node;
+}
+
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::Node *
+MyPersistentHashMap<KeyType, ValueType>::remakeCollision(Node *old, bool owned, int skip, Entry *entry) {
+    int n = old->nEntries - (skip >= 0 ? 1 : 0) + (entry != NULL ? 1 : 0);
+    Node *node = allocate(n, 0);
+    int built = 0;
+    try {
+        for(int i = 0; i < old->nEntries; ++i) {
+            if(i == skip) continue;
+            if(owned) {
+                new (&node->entries[built]) Entry(std::move_if_noexcept(old->entries[i]));
+            } else {
+                new (&node->entries[built]) Entry(old->entries[i]);
+            }
+            built++;
+        }
+        if(entry != NULL) {
+            new (&node->entries[built]) Entry(std::move(*entry));
+            built++;
+        }
+    }
+    catch(...) {
+        node->nEntries = built;
+        freeNode(node);
+        throw;
+    }
+    if(owned) freeNode(old);
+    return node;
+}
+
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::Node *
+MyPersistentHashMap<KeyType, ValueType>::mergeEntries(int shift, Entry &a, Entry &b) {
+    if(shift >= HASH_BITS) {
+        Node *node = allocate(2, 0);
+        new (&node->entries[0]) Entry(std::move(a));
+        new (&node->entries[1]) Entry(std::move(b));
+        return node;
+    }
+    unsigned bitA = bitOf(a.hash, shift), bitB = bitOf(b.hash, shift);
+    if(bitA == bitB) {
+        Node *child = mergeEntries(shift + BITS_PER_LEVEL, a, b);
+        Node *node = allocate(0, 1);
+        node->nodeMap = bitA;
+        node->children[0] = child;
+        return node;
+    }
+    Node *node = allocate(2, 0);
+    node->dataMap = bitA | bitB;
+    new (&node->entries[bitA < bitB ? 0 : 1]) Entry(std::move(a));
+    new (&node->entries[bitA < bitB ? 1 : 0]) Entry(std::move(b));
+    return node;
+}
+
+/*
+ * 实现笔记：assoc
+ * --------------
+ * 分支bit上有三种情况：
+ *      1. 是条目：key相同则替换value（owned时原地替换），否则把两个条目下沉到一个新的子结点；
+ *      2. 是子结点：递归，子结点只有在父结点被这个map独占、且自己的引用计数也为1时才算独占；
+ *         父结点独占时直接把新的子结点写入原来的位置，不复制父结点；
+ *      3. 是空的：把条目插入到这一层。
+ */
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::Node *
+MyPersistentHashMap<KeyType, ValueType>::assoc(Node *node, bool owned, int shift, Entry &entry, bool &added) {
+    if(shift >= HASH_BITS) {
+        for(int i = 0; i < node->nEntries; ++i) {
+            if(node->entries[i].key == entry.key) {
+                if(owned) {
+                    node->entries[i].value = std::move(entry.value);
+                    return node;
+                }
+                return remakeCollision(node, false, i, &entry);
+            }
+        }
+        added = true;
+        return remakeCollision(node, owned, -1, &entry);
+    }
+    unsigned bit = bitOf(entry.hash, shift);
+    if(node->dataMap & bit) {
+        Entry &existing = node->entries[indexOf(node->dataMap, bit)];
+        if(existing.hash == entry.hash && existing.key == entry.key) {
+            if(owned) {
+                existing.value = std::move(entry.value);
+                return node;
+            }
+            return remake(node, false, node->dataMap, node->nodeMap, bit, &entry, NULL);
+        }
+        added = true;
+        Node *child;
+        if(owned) {
+            child = mergeEntries(shift + BITS_PER_LEVEL, existing, entry);
+        } else {
+            Entry copy(existing);
+            child = mergeEntries(shift + BITS_PER_LEVEL, copy, entry);
+        }
+        return remake(node, owned, node->dataMap ^ bit, node->nodeMap | bit, bit, NULL, child);
+    }
+    if(node->nodeMap & bit) {
+        int pos = indexOf(node->nodeMap, bit);
+        Node *child = node->children[pos];
+        bool childOwned = owned && child->refs.load(std::memory_order_acquire) == 1;
+        Node *updated = assoc(child, childOwned, shift + BITS_PER_LEVEL, entry, added);
+        if(updated == child) return node;
+        if(!owned) return remake(node, false, node->dataMap, node->nodeMap, bit, NULL, updated);
+        if(!childOwned) release(child);
+        node->children[pos] = updated;
+        return node;
+    }
+    added = true;
+    return remake(node, owned, node->dataMap | bit, node->nodeMap, bit, &entry, NULL);
+}
+
+/*
+ * 实现笔记：dissoc
+ * ---------------
+ * 删除之后保持树的规范形式：除根结点以外，没有只含一个条目、没有子结点的结点。
+ * 子树删除后只剩一个条目时，父结点把这个条目收回到自己的分支中（nodeMap -> dataMap），
+ * 这个过程可能一直向上传递，所以删除所有插入过的key之后树会还原为插入之前的形状。
+ */
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::Node *
+MyPersistentHashMap<KeyType, ValueType>::dissoc(Node *node, bool owned, int shift, unsigned long long hash, const KeyType &key, bool &removed) {
+    if(shift >= HASH_BITS) {
+        for(int i = 0; i < node->nEntries; ++i) {
+            if(node->entries[i].key == key) {
+                removed = true;
+                return remakeCollision(node, owned, i, NULL);
+            }
+        }
+        return node;
+    }
+    unsigned bit = bitOf(hash, shift);
+    if(node->dataMap & bit) {
+        Entry &existing = node->entries[indexOf(node->dataMap, bit)];
+        if(!(existing.hash == hash && existing.key == key)) return node;
+        removed = true;
+        if(node->nEntries == 1 && node->nChildren == 0) {
+            if(owned) freeNode(node);
+            return NULL;
+        }
+        return remake(node, owned, node->dataMap ^ bit, node->nodeMap, bit, NULL, NULL);
+    }
+    if(node->nodeMap & bit) {
+        int pos = indexOf(node->nodeMap, bit);
+        Node *child = node->children[pos];
+        bool childOwned = owned && child->refs.load(std::memory_order_acquire) == 1;
+        Node *updated = dissoc(child, childOwned, shift + BITS_PER_LEVEL, hash, key, removed);
+        if(updated == child) return node;
+        Node *result = node;
+        if(updated == NULL) {
+            if(node->nEntries == 0 && node->nChildren == 1) {
+                if(owned) freeNode(node);
+                result = NULL;
+            } else {
+                result = remake(node, owned, node->dataMap, node->nodeMap ^ bit, bit, NULL, NULL);
+            }
+        } else if(updated->nEntries == 1 && updated->nChildren == 0) {
+            result = remake(node, owned, node->dataMap | bit, node->nodeMap ^ bit, bit, &updated->entries[0], NULL);
+            freeNode(updated);
+        } else if(owned) {
+            node->children[pos] = updated;
+        } else {
+            result = remake(node, false, node->dataMap, node->nodeMap, bit, NULL, updated);
+        }
+        // 独占的父结点不再引用被共享的旧子结点
+        if(owned && !childOwned) release(child);
+        return result;
+    }
+    return node;
+}
+
+/*
+ * 实现笔记：put
+ * ------------
+ * 根结点的引用计数为1时这个map独占整棵树的根，assoc沿路径逐层判断子结点是否也被独占。
+ * 根结点被共享时assoc复制整条路径，得到新的根后释放对旧根的引用。
+ */
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::put(const KeyType &key, const ValueType &value) {
+    Entry entry(hashCode(key), key, value);
+    if(root == NULL) {
+        root = allocate(1, 0);
+        root->dataMap = bitOf(entry.hash, 0);
+        new (&root->entries[0]) Entry(std::move(entry));
+        count = 1;
+        return;
+    }
+    bool owned = root->refs.load(std::memory_order_acquire) == 1;
+    bool added = false;
+    Node *updated = assoc(root, owned, 0, entry, added);
+    if(updated != root) {
+        if(!owned) release(root);
+        root = updated;
+    }
+    if(added) count++;
+}
+
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::remove(const KeyType &key) {
+    if(root == NULL) return;
+    bool owned = root->refs.load(std::memory_order_acquire) == 1;
+    bool removed = false;
+    Node *updated = dissoc(root, owned, 0, hashCode(key), key, removed);
+    if(updated != root) {
+        if(!owned) release(root);
+        root = updated;
+    }
+    if(removed) count--;
+}
+
+template <typename KeyType, typename ValueType>
+MyPersistentHashMap<KeyType, ValueType> MyPersistentHashMap<KeyType, ValueType>::with(const KeyType &key, const ValueType &value) const {
+    MyPersistentHashMap<KeyType, ValueType> next(*this);
+    next.put(key, value);
+    return next;
+}
+
+template <typename KeyType, typename ValueType>
+MyPersistentHashMap<KeyType, ValueType> MyPersistentHashMap<KeyType, ValueType>::without(const KeyType &key) const {
+    MyPersistentHashMap<KeyType, ValueType> next(*this);
+    next.remove(key);
+    return next;
+}
+
+template <typename KeyType, typename ValueType>
+const typename MyPersistentHashMap<KeyType, ValueType>::Entry * MyPersistentHashMap<KeyType, ValueType>::findEntry(const KeyType &key) const {
+    unsigned long long hash = hashCode(key);
+    const Node *node = root;
+    for(int shift = 0; node != NULL; shift += BITS_PER_LEVEL) {
+        if(shift >= HASH_BITS) {
+            for(int i = 0; i < node->nEntries; ++i) {
+                if(node->entries[i].key == key) return &node->entries[i];
+            }
+            return NULL;
+        }
+        unsigned bit = bitOf(hash, shift);
+        if(node->dataMap & bit) {
+            const Entry *ep = &node->entries[indexOf(node->dataMap, bit)];
+            return (ep->hash == hash && ep->key == key) ? ep : NULL;
+        }
+        if(!(node->nodeMap & bit)) return NULL;
+        node = node->children[indexOf(node->nodeMap, bit)];
+    }
+    return NULL;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType MyPersistentHashMap<KeyType, ValueType>::get(const KeyType &key) const {
+    const Entry *ep = findEntry(key);
+    return (ep == NULL) ? ValueType() : ep->value;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyPersistentHashMap<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) const {
+    const Entry *ep = findEntry(key);
+    if(ep == NULL) return false;
+    out = ep->value;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyPersistentHashMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    return findEntry(key) != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType * MyPersistentHashMap<KeyType, ValueType>::find(const KeyType &key) const {
+    const Entry *ep = findEntry(key);
+    return (ep == NULL) ? NULL : &ep->value;
+}
+
+template <typename KeyType, typename ValueType>
+int MyPersistentHashMap<KeyType, ValueType>::size() const {
+    return count;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyPersistentHashMap<KeyType, ValueType>::isEmpty() const {
+    return count == 0;
+}
+
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::clear() {
+    if(root != NULL) release(root);
+    root = NULL;
+    count = 0;
+}
+
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::const_iterator MyPersistentHashMap<KeyType, ValueType>::begin() const {
+    return const_iterator(root);
+}
+
+template <typename KeyType, typename ValueType>
+typename MyPersistentHashMap<KeyType, ValueType>::const_iterator MyPersistentHashMap<KeyType, ValueType>::end() const {
+    return const_iterator();
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyPersistentHashMap<KeyType, ValueType>::keys() const {
+    MyVector<KeyType> keys;
+    for(const_iterator it = begin(); it != end(); ++it) {
+        keys.add(it.key());
+    }
+    return keys;
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<ValueType> MyPersistentHashMap<KeyType, ValueType>::values() const {
+    MyVector<ValueType> values;
+    for(const_iterator it = begin(); it != end(); ++it) {
+        values.add(it.value());
+    }
+    return values;
+}
+
+template <typename KeyType, typename ValueType>
+void MyPersistentHashMap<KeyType, ValueType>::mapAll(void (*fn) (const KeyType &, const ValueType &)) const {
+    for(const_iterator it = begin(); it != end(); ++it) {
+        fn(it.key(), it.value());
+    }
+}
+
+template <typename KeyType, typename ValueType>
+bool MyPersistentHashMap<KeyType, ValueType>::equals(const MyPersistentHashMap<KeyType, ValueType> &src) const {
+    if(root == src.root) return true;
+    if(count != src.count) return false;
+    for(const_iterator it = begin(); it != end(); ++it) {
+        const ValueType *vp = src.find(it.key());
+        if(vp == NULL || *vp != it.value()) return false;
+    }
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyPersistentHashMap<KeyType, ValueType>::operator == (const MyPersistentHashMap<KeyType, ValueType> &src) const {
+    return equals(src);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyPersistentHashMap<KeyType, ValueType>::operator != (const MyPersistentHashMap<KeyType, ValueType> &src) const {
+    return !equals(src);
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyPersistentHashMap<KeyType, ValueType>::toString() const {
+    std::ostringstream oss;
+    for(const_iterator it = begin(); it != end(); ++it) {
+        oss << "{" << it.key() << ": " << it.value() << "}";
+    }
+    return oss.str();
+}
+
+/*
+ * 实现笔记：operator<<
+ * -------------------
+ * 利用toString()使得插入操作符支持类MyPersistentHashMap
+ */
+template <typename KeyType, typename ValueType>
+std::ostream & operator<< (std::ostream &os, const MyPersistentHashMap<KeyType, ValueType> &pmap) {
+    return os << pmap.toString();
+}
+
+#endif // _mypersistenthashmap_h
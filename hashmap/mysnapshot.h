@@ -0,0 +1,208 @@
+/*
+ * File: mysnapshot.h
+ * ------------------
+ * MyHashMap::saveSnapshot写出、MyMappedHashMap通过mmap直接读取的二进制快照格式。
+ * 文件中只有相对文件开头的偏移量，没有指针，所以可以被映射到任意地址直接使用：
+ *
+ *      [MySnapshotHeader]
+ *      [slot数组]   capacity个uint64，0表示空槽，否则是一条记录的偏移量（线性探测）
+ *      [记录 ...]   每条记录：uint64 hash | uint32 key长度 | uint32 value长度 | key字节 | value字节，
+ *                   按8字节对齐
+ *
+ * hash由mysnapshotHash对key的字节计算，使用固定的种子，与进程的myhashSeed无关，
+ * 所以快照可以被另一个进程（即使使用了随机种子）读取。key按字节比较。
+ * 文件使用本机的字节序和类型大小，只能在相同架构的机器之间共享。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: TAG加入类型的种类（MySnapshotKind），不再只比较大小；版本号改为2。
+ *      3. 2026.10.18: mysnapshotSave的slot数组改用size_t下标，超过2^31个slot时不再溢出int。
+ */
+
+#ifndef _mysnapshot_h
+#define _mysnapshot_h
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "myhashcode.h"
+
+/*
+ * 类：MySnapshotCodec<T>
+ * 使用：MySnapshotCodec<T>::data(value), MySnapshotCodec<T>::size(value)
+ * -------------------------------------------------------------------
+ * 决定一个类型在快照中的字节表示：
+ *      可平凡复制（trivially copyable）的类型：直接使用它的sizeof(T)个字节；
+ *      std::string：它的字符，长度可变。
+ * TAG写入文件头，打开快照时用来检查key、value的类型是否与保存时一致：
+ * 它由类型的种类（MySnapshotKind）和sizeof(T)组成，所以能区分int和float、int和unsigned等；
+ * 但自己定义的结构体只能按大小检查，两个大小相同的结构体无法区分。
+ * 作为key的类型必须每个值只有一种字节表示（整数、枚举、std::string、没有填充字节的结构体）。
+ */
+template <typename T, typename Enable = void>
+struct MySnapshotCodec;
+
+/*
+ * 类：MySnapshotKind<T>
+ * --------------------
+ * 可平凡复制的类型的种类编号，与sizeof(T)一起组成MySnapshotCodec<T>::TAG。
+ */
+template <typename T>
+struct MySnapshotKind {
+    static const unsigned long long value =
+        std::is_same<T, bool>::value ? 1 :
+        std::is_floating_point<T>::value ? 2 :
+        std::is_enum<T>::value ? 3 :
+        (std::is_integral<T>::value && std::is_signed<T>::value) ? 4 :
+        std::is_integral<T>::value ? 5 :
+        std::is_pointer<T>::value ? 6 : 7;
+};
+
+template <typename T>
+struct MySnapshotCodec<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+    static const unsigned long long TAG = (MySnapshotKind<T>::value << 32) | sizeof(T);
+    static const char * data(const T &value) { return reinterpret_cast<const char *>(&value); }
+    static size_t size(const T &) { return sizeof(T); }
+    static T decode(const char *bytes, size_t) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+};
+
+template <>
+struct MySnapshotCodec<std::string> {
+    static const unsigned long long TAG = ~0ULL;
+    static const char * data(const std::string &value) { return value.data(); }
+    static size_t size(const std::string &value) { return value.size(); }
+    static std::string decode(const char *bytes, size_t length) { return std::string(bytes, length); }
+};
+
+/*
+ * 结构体：MySnapshotHeader
+ * -----------------------
+ * 快照的文件头，所有偏移量都相对于文件开头。
+ */
+struct MySnapshotHeader {
+    char magic[8];                  // "MYHMSNAP"
+    unsigned int version;
+    unsigned int byteOrder;         // 写入时为0x01020304，用来发现字节序不同的机器
+    unsigned long long count;       // 条目数
+    unsigned long long capacity;    // slot数，2的幂
+    unsigned long long slotsOffset;
+    unsigned long long fileSize;
+    unsigned long long keyTag;      // MySnapshotCodec<KeyType>::TAG
+    unsigned long long valueTag;    // MySnapshotCodec<ValueType>::TAG
+};
+
+/* 记录的固定部分，后面紧跟key和value的字节 */
+struct MySnapshotRecord {
+    unsigned long long hash;
+    unsigned int keyLength;
+    unsigned int valueLength;
+};
+
+static const char MY_SNAPSHOT_MAGIC[8] = {'M', 'Y', 'H', 'M', 'S', 'N', 'A', 'P'};
+static const unsigned int MY_SNAPSHOT_VERSION = 2;
+static const unsigned long long MY_SNAPSHOT_SEED = 0x5eed5eed5eed5eedULL;
+
+/*
+ * 函数：mysnapshotHash
+ * 使用：unsigned long long h = mysnapshotHash(bytes, length);
+ * ----------------------------------------------------------
+ * 快照中使用的hash Code：固定种子的myhashCode。
+ */
+inline unsigned long long mysnapshotHash(const char *bytes, size_t length) {
+    return myhashCode(bytes, length, MY_SNAPSHOT_SEED);
+}
+
+/*
+ * 函数：mysnapshotSave
+ * 使用：mysnapshotSave<KeyType, ValueType>(map, path);
+ * --------------------------------------------------
+ * 把map（任意提供const_iterator、key()、value()的MyHashMap）写成快照文件path。
+ * 先在内存中建立slot数组，记录直接顺序写入文件，最后回到开头写文件头和slot数组。
+ * slot数组的长度可以超过2^31（map.size()超过2^30时），所以它不用MyVector，而是按size_t下标的普通数组。
+ * 打开或写入文件失败时抛出std::runtime_error，单个key或value超过4GB时抛出std::length_error。
+ */
+template <typename KeyType, typename ValueType, typename Map>
+void mysnapshotSave(const Map &map, const std::string &path) {
+    unsigned long long capacity = 16;
+    while(capacity < 2 * (unsigned long long)map.size()) {
+        capacity *= 2;
+    }
+    MySnapshotHeader header;
+    std::memcpy(header.magic, MY_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = MY_SNAPSHOT_VERSION;
+    header.byteOrder = 0x01020304;
+    header.count = (unsigned long long)map.size();
+    header.capacity = capacity;
+    header.slotsOffset = (sizeof(MySnapshotHeader) + 7) / 8 * 8;
+    header.keyTag = MySnapshotCodec<KeyType>::TAG;
+    header.valueTag = MySnapshotCodec<ValueType>::TAG;
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if(file == NULL) {
+        throw std::runtime_error("saveSnapshot: can not open " + path);
+    }
+    unsigned long long *slots = NULL;
+    try {
+        if(capacity > SIZE_MAX / sizeof(unsigned long long)) {
+            throw std::length_error("saveSnapshot: the map is too large for this platform");
+        }
+        slots = new unsigned long long[size_t(capacity)]();
+        unsigned long long offset = header.slotsOffset + capacity * sizeof(unsigned long long);
+        if(std::fseek(file, long(offset), SEEK_SET) != 0) {
+            throw std::runtime_error("saveSnapshot: can not write " + path);
+        }
+        static const char padding[8] = {0};
+        for(typename Map::const_iterator it = map.begin(); it != map.end(); ++it) {
+            size_t keyLength = MySnapshotCodec<KeyType>::size(it.key());
+            size_t valueLength = MySnapshotCodec<ValueType>::size(it.value());
+            if(keyLength > 0xFFFFFFFFULL || valueLength > 0xFFFFFFFFULL) {
+                throw std::length_error("saveSnapshot: a key or value is larger than 4GB");
+            }
+            MySnapshotRecord record;
+            record.hash = mysnapshotHash(MySnapshotCodec<KeyType>::data(it.key()), keyLength);
+            record.keyLength = (unsigned int)keyLength;
+            record.valueLength = (unsigned int)valueLength;
+            size_t total = sizeof(record) + keyLength + valueLength;
+            size_t pad = (8 - total % 8) % 8;
+            if(std::fwrite(&record, sizeof(record), 1, file) != 1
+               || std::fwrite(MySnapshotCodec<KeyType>::data(it.key()), 1, keyLength, file) != keyLength
+               || std::fwrite(MySnapshotCodec<ValueType>::data(it.value()), 1, valueLength, file) != valueLength
+               || std::fwrite(padding, 1, pad, file) != pad) {
+                throw std::runtime_error("saveSnapshot: can not write " + path);
+            }
+
+            unsigned long long i = record.hash & (capacity - 1);
+            while(slots[size_t(i)] != 0) {
+                i = (i + 1) & (capacity - 1);
+            }
+            slots[size_t(i)] = offset;
+            offset += total + pad;
+        }
+        header.fileSize = offset;
+
+        if(std::fseek(file, 0, SEEK_SET) != 0
+           || std::fwrite(&header, sizeof(header), 1, file) != 1
+           || std::fwrite(padding, 1, header.slotsOffset - sizeof(header), file) != header.slotsOffset - sizeof(header)
+           || std::fwrite(slots, sizeof(unsigned long long), size_t(capacity), file) != size_t(capacity)) {
+            throw std::runtime_error("saveSnapshot: can not write " + path);
+        }
+    }
+    catch(...) {
+        delete [] slots;
+        std::fclose(file);
+        throw;
+    }
+    delete [] slots;
+    if(std::fclose(file) != 0) {
+        throw std::runtime_error("saveSnapshot: can not write " + path);
+    }
+}
+
+#endif // _mysnapshot_h
@@ -1 +1 @@
-g++ -std=c++11 -I ../vector/ -I ../hashmap/ -o main main.cpp ../hashmap/myhashcode.cpp
+g++ -std=c++11 -I ../vector/ -I ../pool/ -I ../hashmap/ -o main main.cpp ../hashmap/myhashcode.cpp
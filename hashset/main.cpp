@@ -66,6 +66,63 @@ int main() {
     // s3.clear();
     // assert(s3.last() == 'b');
     // s3.first();
+    MyVector<int> numbers;
+    for(int i = 0; i < 1000; ++i) {
+        numbers.add(i % 600);
+    }
+    MyHashSet<int> bulk(10);
+    bulk.add(-1);
+    bulk.addAll(numbers);
+    assert(bulk.size() == 601 && bulk.contains(-1) && bulk.contains(599) && !bulk.contains(600));
+    bulk.reserve(5000);
+    assert(bulk.size() == 601 && bulk.contains(0));
+    for(int i = 0; i < 600; ++i) {
+        bulk.remove(i);
+    }
+    bulk.compact();
+    assert(bulk.size() == 1 && bulk.contains(-1) && !bulk.contains(0));
+
+    MyHashSet<string> names;
+    names.add("ada");
+    assert(names.contains("ada") && !names.contains("bob"));
+    names.remove("ada");
+    assert(names.isEmpty());
+
+    // Range-based for visits every element once; the operators iterate in place.
+    MyHashSet<int> evens, threes;
+    for(int i = 0; i <= 20; ++i) {
+        if(i % 2 == 0) evens.add(i);
+        if(i % 3 == 0) threes.add(i);
+    }
+    int sum = 0;
+    for(int value : evens) {
+        sum += value;
+    }
+    assert(sum == 110 && evens.first() == 0 && evens.last() == 20);
+    MyHashSet<int> common = evens * threes;
+    assert(common.size() == 4 && common.contains(18) && common.isSubsetOf(threes));
+    assert((evens - threes).size() == 7 && (evens + threes).size() == 14);
+    MyHashSet<int> both = evens;
+    both += both;
+    assert(both == evens);
+    both -= both;
+    assert(both.isEmpty() && both.toString() == "{}");
+
+    // A Bloom filter in front of the table: absent elements are usually rejected without probing.
+    MyHashSet<string> seen;
+    seen.enableBloomFilter(0.01);
+    for(int i = 0; i < 5000; ++i) {
+        seen.add("url" + to_string(i));
+    }
+    for(int i = 0; i < 10000; ++i) {
+        assert(seen.contains("url" + to_string(i)) == (i < 5000));
+    }
+    seen.remove("url0");
+    assert(!seen.contains("url0") && seen.hasBloomFilter());
+    MyHashSet<string> seenCopy = seen;
+    seen.disableBloomFilter();
+    assert(!seen.hasBloomFilter() && seenCopy.hasBloomFilter() && seenCopy.contains("url4999"));
+
     cout << "Class MyHashSet unit test succeed." << endl;
     return 0;
 }
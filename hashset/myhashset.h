@@ -26,6 +26,12 @@
  * 时间：
  *      1. 2024.4.14: 第一版
  *      2. 2024.4.24: 添加mapAll方法
+ *      3. 2026.10.18: 添加reserve、指定预期大小的构造函数以及批量插入的addAll
+ *      4. 2026.10.18: contains和remove支持异构查找（见MyTransparentLookup）
+ *      5. 2026.10.18: 添加迭代器（支持基于范围的for循环），first、last、isSubsetOf、toString以及
+ *                     各个集合运算符直接沿迭代器遍历，不再先用keys()复制出所有元素。
+ *      6. 2026.10.18: 添加compact；remove、clear之后底层的MyHashMap会自动缩小散列表。
+ *      7. 2026.10.18: 添加enableBloomFilter，contains先查询Bloom filter，不存在的元素不必读取散列表。
  */
 
 template <typename ValueType>
@@ -40,6 +46,15 @@ public:
 
     MyHashSet();
 
+    /*
+     * Constructor: MyHashSet
+     * Usage: MyHashSet<ValueType> set(expectedSize);
+     * ----------------------------------------------
+     * Initializes an empty set whose table is already large enough to hold
+     * expectedSize elements without rehashing.
+     */
+    explicit MyHashSet(int expectedSize);
+
     /*
      * Destructor: ~MyHashSet
      * ----------------------
@@ -71,6 +86,23 @@ public:
      */
     void add(const ValueType &value);
 
+    /*
+     * Method: addAll
+     * Usage: set.addAll(values);
+     * --------------------------
+     * Adds every element of values to this set. The table is sized once
+     * for size() + values.size() elements before the first insertion.
+     */
+    void addAll(const MyVector<ValueType> &values);
+
+    /*
+     * Method: reserve
+     * Usage: set.reserve(n);
+     * ----------------------
+     * Grows the table so that n elements fit without rehashing.
+     */
+    void reserve(int n);
+
     /*
      * Method: remove
      * Usage: set.remove(value);
@@ -89,6 +121,20 @@ public:
      */
     bool contains(const ValueType &value) const;
 
+    /*
+     * Heterogeneous lookup
+     * Usage: MyHashSet<std::string> set;
+     *        if(set.contains("word")) ...
+     * -----------------------------------
+     * When MyTransparentLookup<ValueType, LookupType>::value is true (see
+     * myhashcode.h), contains and remove accept a LookupType directly, so no
+     * temporary ValueType is constructed.
+     */
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<ValueType, LookupType>::value>::type>
+    bool contains(const LookupType &value) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentLookup<ValueType, LookupType>::value>::type>
+    void remove(const LookupType &value);
+
     /*
      * Method: difference
      * Usage: set1.difference(set2);
@@ -136,6 +182,31 @@ public:
      */
     void clear();
 
+    /*
+     * Method: compact
+     * Usage: set.compact();
+     * ---------------------
+     * Releases the memory left over from a burst of insertions: the cells
+     * are moved into a compact pool and the table is shrunk to fit the
+     * current elements (see MyHashMap::compact). Iterators are invalidated.
+     */
+    void compact();
+
+    /*
+     * Method: enableBloomFilter, disableBloomFilter, hasBloomFilter
+     * Usage: set.enableBloomFilter(0.01);
+     *        set.enableBloomFilter(0.01, maxBytes);
+     * ----------------------------------------------
+     * Attaches a blocked Bloom filter to the underlying map, so that contains
+     * rejects most absent elements without touching the hash table.
+     * falsePositiveRate is the fraction of absent elements that still reach
+     * the table; a nonzero maxBytes caps the size of the filter
+     * (see MyHashMap::enableBloomFilter).
+     */
+    void enableBloomFilter(double falsePositiveRate = 0.01, size_t maxBytes = 0);
+    void disableBloomFilter();
+    bool hasBloomFilter() const;
+
     /*
      * Method: isSubsetOf
      * Usage: if(set.isSubsetOf(set2)) . . .
@@ -278,6 +349,19 @@ public:
      */
     void mapAll(void (*fn) (const ValueType &)) const;
 
+    /*
+     * Iterators
+     * Usage: for(const ValueType &value : set) . . .
+     * ----------------------------------------------
+     * Range-based for loops visit the elements in unpredictable order. The iterators are
+     * those of the underlying map, so the elements are read in place and
+     * never copied. An iterator becomes invalid once the set is modified.
+     */
+    typedef typename MyHashMap<ValueType, bool>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+    const_iterator begin() const;
+    const_iterator end() const;
+
     // The private section of the class goes here.
 
     /*
@@ -308,6 +392,11 @@ MyHashSet<ValueType>::MyHashSet() {
     /* Empty */
 }
 
+template <typename ValueType>
+MyHashSet<ValueType>::MyHashSet(int expectedSize) : map(expectedSize) {
+    /* Empty */
+}
+
 template <typename ValueType>
 MyHashSet<ValueType>::~MyHashSet() {
     /* Empty */
@@ -334,6 +423,19 @@ void MyHashSet<ValueType>::add(const ValueType &value) {
     map.put(value, true);
 }
 
+template <typename ValueType>
+void MyHashSet<ValueType>::addAll(const MyVector<ValueType> &values) {
+    map.reserve(map.size() + values.size());
+    for(int i = 0; i < values.size(); ++i) {
+        map.put(values[i], true);
+    }
+}
+
+template <typename ValueType>
+void MyHashSet<ValueType>::reserve(int n) {
+    map.reserve(n);
+}
+
 template <typename ValueType>
 void MyHashSet<ValueType>::remove(const ValueType &value) {
     map.remove(value);
@@ -344,6 +446,18 @@ bool MyHashSet<ValueType>::contains(const ValueType &value) const {
     return map.containsKey(value);
 }
 
+template <typename ValueType>
+template <typename LookupType, typename>
+bool MyHashSet<ValueType>::contains(const LookupType &value) const {
+    return map.containsKey(value);
+}
+
+template <typename ValueType>
+template <typename LookupType, typename>
+void MyHashSet<ValueType>::remove(const LookupType &value) {
+    map.remove(value);
+}
+
 template <typename ValueType>
 MyHashSet<ValueType> & MyHashSet<ValueType>::difference(const MyHashSet<ValueType> &set2) {
     return *this -= set2;
@@ -354,11 +468,21 @@ bool MyHashSet<ValueType>::equals(const MyHashSet<ValueType>& set2) const {
     return *this == set2;
 }
 
+/*
+ * Implementation notes: first, last
+ * ---------------------------------
+ * The order of the keys in the hash table has nothing to do with their
+ * sorted order, so these methods scan all elements with the < operator.
+ */
 template <typename ValueType>
 ValueType MyHashSet<ValueType>::first() const {
     if(isEmpty()) throw std::out_of_range("Set is empty.");
-    MyVector<ValueType> values = (this->map).keys();
-    return values[0];
+    const_iterator it = begin();
+    const ValueType *smallest = &*it;
+    for(++it; it != end(); ++it) {
+        if(*it < *smallest) smallest = &*it;
+    }
+    return *smallest;
 }
 
 template <typename ValueType>
@@ -371,6 +495,26 @@ void MyHashSet<ValueType>::clear() {
     map.clear();
 }
 
+template <typename ValueType>
+void MyHashSet<ValueType>::compact() {
+    map.compact();
+}
+
+template <typename ValueType>
+void MyHashSet<ValueType>::enableBloomFilter(double falsePositiveRate, size_t maxBytes) {
+    map.enableBloomFilter(falsePositiveRate, maxBytes);
+}
+
+template <typename ValueType>
+void MyHashSet<ValueType>::disableBloomFilter() {
+    map.disableBloomFilter();
+}
+
+template <typename ValueType>
+bool MyHashSet<ValueType>::hasBloomFilter() const {
+    return map.hasBloomFilter();
+}
+
 /*
  * Implementation notes: isSubset
  * ------------------------------
@@ -379,9 +523,11 @@ void MyHashSet<ValueType>::clear() {
  */
 template <typename ValueType>
 bool MyHashSet<ValueType>::isSubsetOf(const MyHashSet<ValueType> &set2) const {
-    MyVector<ValueType> values = (this->map).keys();
-    for(int i = 0; i < values.size(); ++i) {
-        if(!set2.contains(values[i])) {
+    if(size() > set2.size()) {
+        return false;
+    }
+    for(const ValueType &value : *this) {
+        if(!set2.contains(value)) {
             return false;
         }
     }
@@ -396,8 +542,12 @@ bool MyHashSet<ValueType>::isSupersetOf(const MyHashSet<ValueType> & set2) const
 template <typename ValueType>
 ValueType MyHashSet<ValueType>::last() const {
     if(isEmpty()) throw std::out_of_range("Set is empty.");
-    MyVector<ValueType> values = (this->map).keys();
-    return values[values.size()-1];
+    const_iterator it = begin();
+    const ValueType *largest = &*it;
+    for(++it; it != end(); ++it) {
+        if(*largest < *it) largest = &*it;
+    }
+    return *largest;
 }
 
 
@@ -405,12 +555,14 @@ ValueType MyHashSet<ValueType>::last() const {
  * Implementation notes: operator==, operator!=
  * --------------------------------------------
  * These operators make use of the fact that two sets are equal only
- * if each set is a subset of the other.
+ * if each set is a subset of the other. Two sets of the same size are
+ * equal as soon as one of them is a subset of the other, so only one
+ * direction has to be checked.
  */
 
 template <typename ValueType>
 bool MyHashSet<ValueType>::operator == (const MyHashSet<ValueType> &set2) const {
-    return isSubsetOf(set2) && set2.isSubsetOf(*this);
+    return size() == set2.size() && isSubsetOf(set2);
 }
 
 template <typename ValueType>
@@ -426,15 +578,9 @@ bool MyHashSet<ValueType>::operator != (const MyHashSet<ValueType> &set2) const
  */
 template <typename ValueType>
 MyHashSet<ValueType> MyHashSet<ValueType>::operator+ (const MyHashSet<ValueType> &set2) const {
-
     MyHashSet<ValueType> unionSet = *this;
-    MyHashSet<ValueType> difference = set2 - (*this);
-    MyVector<ValueType> values = difference.map.keys();
-    for(int i = 0; i < values.size(); ++i) {
-        unionSet.add(values[i]);
-    }
+    unionSet += set2;
     return unionSet;
-
 }
 
 
@@ -455,11 +601,9 @@ MyHashSet<ValueType> MyHashSet<ValueType>::operator+ (const ValueType &value) co
 template <typename ValueType>
 MyHashSet<ValueType> MyHashSet<ValueType>::operator* (const MyHashSet<ValueType> &set2) const {
     MyHashSet<ValueType> intersectionSet;
-
-    MyVector<ValueType> values = (*this).map.keys();
-    for(int i = 0; i < values.size(); ++i) {
-        if(set2.contains(values[i])) {
-            intersectionSet.add(values[i]);
+    for(const ValueType &value : *this) {
+        if(set2.contains(value)) {
+            intersectionSet.add(value);
         }
     }
     return intersectionSet;
@@ -473,16 +617,13 @@ MyHashSet<ValueType> MyHashSet<ValueType>::operator* (const MyHashSet<ValueType>
  */
 template <typename ValueType>
 MyHashSet<ValueType> MyHashSet<ValueType>::operator- (const MyHashSet<ValueType> &set2) const {
-
     MyHashSet<ValueType> differenceSet;
-    MyVector<ValueType> values = (*this).map.keys();
-    for(int i = 0; i < values.size(); ++i) {
-        if(!set2.contains(values[i])) {
-            differenceSet.add(values[i]);
+    for(const ValueType &value : *this) {
+        if(!set2.contains(value)) {
+            differenceSet.add(value);
         }
     }
     return differenceSet;
-
 }
 
 template <typename ValueType>
@@ -495,19 +636,27 @@ MyHashSet<ValueType> MyHashSet<ValueType>::operator- (const ValueType &value) co
 /*
  * Implementation notes: shorthand assignment operators
  * ----------------------------------------------------
- * These operators modify the current set but are otherwise similar to
- * the operators that create new sets.
+ * These operators modify the current set in place while iterating over
+ * set2, instead of building a new set and copying it back. When set2 is
+ * the current set itself, the loop would modify the set it is iterating
+ * over, so that case is handled first. *= still builds a new set, because
+ * it has to remove elements of the set it iterates over.
  */
 template <typename ValueType>
 MyHashSet<ValueType>& MyHashSet<ValueType>::operator+= (const MyHashSet<ValueType> &set2) {
-    *this = *this + set2;
+    if(this == &set2) {
+        return *this;
+    }
+    for(const ValueType &value : set2) {
+        add(value);
+    }
     return *this;
 }
 
 
 template <typename ValueType>
 MyHashSet<ValueType>& MyHashSet<ValueType>::operator+= (const ValueType &value) {
-    *this = *this + value;
+    add(value);
     return *this;
 }
 
@@ -519,22 +668,37 @@ MyHashSet<ValueType> & MyHashSet<ValueType>::operator*= (const MyHashSet<ValueTy
 
 template <typename ValueType>
 MyHashSet<ValueType> & MyHashSet<ValueType>::operator-= (const MyHashSet<ValueType> &set2) {
-    *this = *this - set2;
+    if(this == &set2) {
+        clear();
+        return *this;
+    }
+    for(const ValueType &value : set2) {
+        remove(value);
+    }
     return *this;
-
 }
 
 template <typename ValueType>
 MyHashSet<ValueType> & MyHashSet<ValueType>::operator-= (const ValueType &value) {
-    *this = *this - value;
+    remove(value);
     return *this;
 }
 
 
 template <typename ValueType>
 std::string MyHashSet<ValueType>::toString() const {
-    MyVector<ValueType> keys = this->map.keys();
-    return keys.toString();
+    std::ostringstream oss;
+    oss << "{";
+    bool first = true;
+    for(const ValueType &value : *this) {
+        if(!first) {
+            oss << ", ";
+        }
+        first = false;
+        oss << value;
+    }
+    oss << "}";
+    return oss.str();
 }
 
 template <typename ValueType>
@@ -561,8 +725,19 @@ std::istream & operator>> (std::istream &is, MyHashSet<ValueType> &set) {
 }
 template <typename ValueType>
 void MyHashSet<ValueType>::mapAll(void (*fn) (const ValueType &)) const {
-    MyVector<ValueType> keys = this->map.keys();
-    keys.mapAll(fn);
+    for(const ValueType &value : *this) {
+        fn(value);
+    }
+}
+
+template <typename ValueType>
+typename MyHashSet<ValueType>::const_iterator MyHashSet<ValueType>::begin() const {
+    return map.begin();
+}
+
+template <typename ValueType>
+typename MyHashSet<ValueType>::const_iterator MyHashSet<ValueType>::end() const {
+    return map.end();
 }
 
 
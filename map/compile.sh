@@ -1 +1 @@
-g++ -std=c++11 -I ../vector/ -o main main.cpp
+g++ -std=c++11 -I ../vector/ -I ../pool/ -o main main.cpp
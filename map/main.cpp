@@ -2,6 +2,7 @@
 #include <cassert>
 #include <string>
 #include "mymap.h"
+#include "mymultimap.h"
 #include "myvector.h"
 using namespace std;
 int main() {
@@ -53,6 +54,141 @@ int main() {
     // cout << keys << endl;
     // MyVector<string> values = mhp.values();
     // cout << values << endl;
+    // Nodes come from the map's pool; clear() keeps the chunks for reuse.
+    MyMap<int, int> pooled;
+    for(int i = 0; i < 100; ++i) {
+        pooled[i] = i;
+    }
+    MyPoolStats stats = pooled.poolStats();
+    assert(stats.live == 100 && stats.capacity >= 100);
+    pooled.remove(50);
+    assert(pooled.poolStats().live == 99 && pooled.poolStats().freeList == 1);
+    pooled.clear();
+    assert(pooled.size() == 0 && pooled.poolStats().live == 0);
+    assert(pooled.poolStats().chunks == stats.chunks);
+    pooled[7] = 7;
+    assert(pooled.size() == 1 && pooled[7] == 7);
+    // compact() moves the surviving nodes into a fresh pool and returns the old chunks.
+    MyMap<string, int> shrinking;
+    for(int i = 0; i < 5000; ++i) {
+        shrinking[to_string(i)] = i;
+    }
+    for(int i = 10; i < 5000; ++i) {
+        shrinking.remove(to_string(i));
+    }
+    assert(shrinking.poolStats().capacity >= 5000);
+    shrinking.compact();
+    assert(shrinking.size() == 10 && shrinking.poolStats().live == 10 && shrinking.poolStats().capacity < 100);
+    int expected = 0;
+    for(const auto &key : shrinking.keysView()) {
+        assert(key == to_string(expected++));
+    }
+    assert(expected == 10 && shrinking["9"] == 9);
+    shrinking["10"] = 10;
+    assert(shrinking.size() == 11 && shrinking.get("10") == 10);
+
+    // Lookups with a C string do not build a temporary std::string.
+    MyMap<string, int> words;
+    words.put("apple", 1);
+    words["pear"] = 2;
+    const char *pear = "pear";
+    assert(words.containsKey("apple") && words.containsKey(pear) && !words.containsKey("plum"));
+    assert(words.get("pear") == 2 && words.get("plum") == 0);
+    assert(*words.find("apple") == 1 && words.find("plum") == nullptr);
+    *words.find(string("apple")) = 5;
+    assert(words["apple"] == 5);
+    words.remove("apple");
+    assert(words.size() == 1 && !words.containsKey(string("apple")));
+
+    // Single-descent upserts; get on a missing key returns the default value.
+    MyMap<string, int> counts;
+    assert(counts.get("none") == 0);
+    int out = -1;
+    assert(!counts.tryGet("none", out) && out == -1);
+    assert(counts.tryEmplace("a", 1).second && !counts.tryEmplace("a", 9).second);
+    assert(counts["a"] == 1);
+    assert(!counts.insertOrAssign("a", 2).second && counts["a"] == 2);
+    int calls = 0;
+    counts.computeIfAbsent("b", [&calls](const string &k) { calls++; return int(k.size()); });
+    counts.computeIfAbsent("b", [&calls](const string &) { calls++; return 0; });
+    assert(calls == 1 && counts["b"] == 1);
+    counts.merge("b", 5, [](int old, int v) { return old + v; });
+    counts.merge("c", 5, [](int old, int v) { return old + v; });
+    assert(counts["b"] == 6 && counts["c"] == 5 && counts.tryGet("c", out) && out == 5);
+
+    // Iterators walk the keys in ascending order without copying the tree.
+    MyMap<int, int> ordered;
+    int inserted[] = {50, 20, 80, 10, 30, 70, 90, 25, 35, 85};
+    for(int key : inserted) {
+        ordered[key] = -key;
+    }
+    int previous = 0, visited = 0;
+    for(const int &key : ordered) {
+        assert(key > previous);
+        previous = key;
+        visited++;
+    }
+    assert(visited == ordered.size() && previous == 90);
+    int valueSum = 0;
+    for(int value : ordered.valuesView()) {
+        valueSum += value;
+    }
+    assert(valueSum == -495);
+    for(MyMap<int, int>::const_iterator it = ordered.begin(); it != ordered.end(); it++) {
+        assert(it.value() == -it.key());
+    }
+    MyMap<int, int> sameOrdered = ordered;
+    assert(sameOrdered.equals(ordered) && *sameOrdered.keysView().begin() == 10);
+    sameOrdered[35] = 0;
+    assert(!sameOrdered.equals(ordered));
+    MyMap<int, int> noEntries;
+    assert(noEntries.begin() == noEntries.end() && noEntries.toString() == "");
+
+    // 一对多的有序映射：key按排序顺序遍历，每个key的value保持添加的顺序
+    MyMultiMap<int, string> byLength;
+    assert(byLength.isEmpty() && byLength.getAll(1).isEmpty());
+    string quote[] = {"to", "be", "or", "not", "to", "be", "that", "is", "the", "question"};
+    for(const string &word : quote) {
+        byLength.add(int(word.size()), word);
+    }
+    assert(byLength.size() == 10 && byLength.keyCount() == 4);
+    assert(byLength.count(2) == 6 && byLength.getAll(2)[4] == "be" && byLength.count(5) == 0);
+    assert(byLength.toString() == "{2: {to, be, or, to, be, is}}, {3: {not, the}}, {4: {that}}, {8: {question}}");
+    assert(byLength.remove(2, "to") && byLength.getAll(2)[0] == "be" && byLength.count(2) == 5);
+    assert(byLength.remove(8, "question") && !byLength.containsKey(8) && !byLength.remove(8, "question"));
+    MyVector<int> lengths = byLength.keys();
+    assert(lengths.size() == 3 && lengths[0] == 2 && lengths[2] == 4);
+    assert(byLength.removeAll(3) == 2 && byLength.removeAll(3) == 0 && byLength.size() == 6);
+    MyMultiMap<int, int> wide;
+    for(int i = 0; i < 2000; ++i) {
+        wide.add(i % 100, i);
+    }
+    for(int k = 0; k < 100; k += 2) {
+        assert(wide.removeAll(k) == 20);
+    }
+    wide.compact();
+    MySpan<int> odd = wide.getAll(99);
+    assert(wide.size() == 1000 && odd.size() == 20 && odd[0] == 99 && odd[19] == 1999);
+    wide.clear();
+    assert(wide.isEmpty() && wide.keyCount() == 0);
+
+    // 有序插入得到一条很深的链：迭代器的栈超过内联的层数之后转到堆上
+    MyMap<int, int> chain;
+    for(int i = 0; i < 200; ++i) {
+        chain.put(200 - i, i);
+    }
+    MyMap<int, int>::const_iterator deep = chain.begin();
+    MyMap<int, int>::const_iterator deepCopy = deep++;
+    assert(*deepCopy == 1 && *deep == 2 && deepCopy != deep);
+    int expectedKey = 1;
+    for(const int &key : chain) {
+        assert(key == expectedKey++);
+    }
+    assert(expectedKey == 201 && chain.equals(MyMap<int, int>(chain)));
+    assert(*chain.firstKey() == 1 && *chain.lastKey() == 200);
+    chain.clear();
+    assert(chain.firstKey() == nullptr && chain.lastKey() == nullptr);
+
     cout << "Class MyMap unit test succeed." << endl;
 
     return 0;
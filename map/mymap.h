@@ -1,8 +1,17 @@
 #ifndef _mymap_h
 #define _mymap_h
 
+#include <cstddef>
+#include <iterator>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include "mynodepool.h"
+#include "mysmallvector.h"
 #include "myvector.h"
 /*
  * 映射内部使用二叉搜索树（BST）结构。由于选择了这种内部表示法，因此存储在 Map 中的键的 KeyType
@@ -36,8 +45,45 @@
                       bool equalsRec(const TreeNode *lhs, const TreeNode *rhs) const;
                       尽管我原先是为了使MyMap对MySet更加支持 bool isSubsetOf(const MySet<ValueType> &set2) const;
         4. 添加mapAll支持callback函数
+ *      5. 2026.10.18: TreeNode改为从每个map自己的结点池（MyNodePool）中分配，clear()整体归还，
+ *                     添加poolStats()查看结点池的占用情况。
+ *      6. 2026.10.18: 添加find，get、containsKey、remove、find支持异构查找（见MyTransparentCompare）。
+ *      7. 2026.10.18: 添加tryGet、tryEmplace、insertOrAssign、computeIfAbsent、merge，每个只沿BST查找一次；
+ *                     get在key不存在时返回ValueType的默认值（原来返回""，只适用于字符串）。
+ *      8. 2026.10.18: 添加按key升序的迭代器（支持基于范围的for循环）以及借用map的keysView()、valuesView()；
+ *                     equals、keys、values、toString改为沿迭代器遍历，不再用inOrder先复制出所有的key-value对。
+ *      9. 2026.10.18: 添加compact()，把TreeNode复制到紧凑的新结点池中并把旧的块还给系统。
+ *     10. 2026.10.18: 迭代器的栈改为MySmallVector，前32层存放在迭代器内部，end()和复制迭代器不再分配内存。
+ *     11. 2026.10.18: 添加firstKey、lastKey，沿最左、最右的路径找到最小、最大的key。
  */
 
+/*
+ * 类：MyTransparentCompare<KeyType, LookupType>
+ * 使用：if(MyTransparentCompare<std::string, const char *>::value) ...
+ * -----------------------------------------------------------------
+ * 标记可以直接用LookupType在MyMap<KeyType, ...>中查找的组合（heterogeneous lookup），
+ * 这样查找时不必先构造一个临时的KeyType。value为true时，KeyType与LookupType之间的
+ * == 和 < （两个方向）必须与先转换成KeyType再比较的结果相同。
+ * 这里为std::string提供了C字符串和C++17的std::string_view，其他类型可以特化该模板。
+ */
+template <typename KeyType, typename LookupType, typename Enable = void>
+struct MyTransparentCompare {
+    static const bool value = false;
+};
+
+template <typename LookupType>
+struct MyTransparentCompare<std::string, LookupType,
+                            typename std::enable_if<std::is_convertible<LookupType, const char *>::value>::type> {
+    static const bool value = true;
+};
+
+#if __cplusplus >= 201703L
+template <>
+struct MyTransparentCompare<std::string, std::string_view> {
+    static const bool value = true;
+};
+#endif
+
 template <typename KeyType, typename ValueType>
 class MyMap{
 public:
@@ -61,10 +107,20 @@ public:
      * 方法：clear
      * 使用：map.clear();
      * -----------------
-     * 将BST设置为空
+     * 将BST设置为空。结点池的块保留下来供之后的插入复用。
      */
     void clear();
 
+    /*
+     * 方法：compact
+     * 使用：map.compact();
+     * -------------------
+     * remove只把TreeNode放回结点池的空闲链表，大量删除之后块仍然占着内存。
+     * compact按原来的形状把BST复制到一个新的结点池中（结点连续存放），
+     * 之后释放旧池的所有块。需要O(N)的时间；find返回的指针和迭代器会失效。
+     */
+    void compact();
+
     /* 方法：containsKey
      * 使用：if(map.containsKey(key)) . . .
      * -----------------------------------
@@ -84,10 +140,18 @@ public:
      * 方法： get
      * 使用：ValueType value = map.get(key);
      * ------------------------------------
-     * 返回map中键为key对应的value。如果没有这个key，则返回“”
+     * 返回map中键为key对应的value。如果没有这个key，则返回ValueType的默认值
      */
     ValueType get(const KeyType &key) const;
 
+    /*
+     * 方法：tryGet
+     * 使用：if(map.tryGet(key, value)) ...
+     * -----------------------------------
+     * 如果key存在，把对应的value复制到out中并返回true；否则返回false，out不变。
+     */
+    bool tryGet(const KeyType &key, ValueType &out) const;
+
     /*
      * 方法：isEmpty
      * 使用：if(map.isEmpty()) . . .
@@ -124,6 +188,70 @@ public:
      */
     void remove(const KeyType &key);
 
+    /*
+     * 方法：find
+     * 使用：ValueType *vp = map.find(key);
+     * ----------------------------------
+     * 返回指向key对应的value的指针，如果key不存在则返回nullptr。
+     * 只查找一次，可以代替"先containsKey再get"。
+     */
+    ValueType * find(const KeyType &key);
+    const ValueType * find(const KeyType &key) const;
+
+    /*
+     * 方法：firstKey, lastKey
+     * 使用：const KeyType *kp = map.lastKey();
+     * --------------------------------------
+     * 返回指向最小（最大）的key的指针，map为空时返回nullptr。
+     * 只沿根的最左（最右）路径向下，时间与树高成正比，不需要遍历整个map。
+     */
+    const KeyType * firstKey() const;
+    const KeyType * lastKey() const;
+
+    /*
+     * 单次查找的插入/更新（upsert）
+     * 使用：std::pair<ValueType *, bool> r = map.tryEmplace(key, args...);
+     *      map.insertOrAssign(key, value);
+     *      ValueType &v = map.computeIfAbsent(key, [](const KeyType &k) { return ...; });
+     *      map.merge(key, 1, [](const ValueType &old, const ValueType &v) { return old + v; });
+     * -------------------------------------------------------------------------------------
+     * 含义与MyHashMap中的同名方法相同，每个方法只从根向下查找一次：
+     *      tryEmplace：key不存在时插入用args构造的value，存在时什么都不做；
+     *                  返回指向value的指针以及是否插入了新条目。
+     *      insertOrAssign：key不存在时插入value，存在时用value覆盖；返回值同tryEmplace。
+     *      computeIfAbsent：key不存在时插入fn(key)，fn只在这时被调用；返回value的引用。
+     *      merge：key不存在时插入value，否则把value改为combine(旧value, value)；返回value的引用。
+     * 注意：remove可能把另一个结点的key-value搬到被删除的结点中，所以返回的指针和引用
+     * 只在下一次remove之前有效。fn和combine中不能修改这个map。
+     */
+    template <typename... Args>
+    std::pair<ValueType *, bool> tryEmplace(const KeyType &key, Args&&... args);
+    std::pair<ValueType *, bool> insertOrAssign(const KeyType &key, const ValueType &value);
+    template <typename Fn>
+    ValueType & computeIfAbsent(const KeyType &key, Fn fn);
+    template <typename Fn>
+    ValueType & merge(const KeyType &key, const ValueType &value, Fn combine);
+
+    /*
+     * 异构查找（heterogeneous lookup）
+     * 使用：MyMap<std::string, int> map;
+     *      if(map.containsKey("key")) ...          // 不构造临时的std::string
+     * -----------------------------------------------------------------
+     * 当MyTransparentCompare<KeyType, LookupType>::value为true时，
+     * get、containsKey、remove和find可以直接接受LookupType类型的参数，
+     * 沿BST比较时不会构造KeyType。只有插入（put、operator[]）才需要真正的KeyType。
+     */
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentCompare<KeyType, LookupType>::value>::type>
+    ValueType get(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentCompare<KeyType, LookupType>::value>::type>
+    bool containsKey(const LookupType &key) const;
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentCompare<KeyType, LookupType>::value>::type>
+    void remove(const LookupType &key);
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentCompare<KeyType, LookupType>::value>::type>
+    ValueType * find(const LookupType &key);
+    template <typename LookupType, typename = typename std::enable_if<MyTransparentCompare<KeyType, LookupType>::value>::type>
+    const ValueType * find(const LookupType &key) const;
+
     /*
      * 方法：size
      * 使用：int count = map.size();
@@ -193,6 +321,121 @@ public:
      * The keys are processed in ascending order, as defined by the comparison function.
      */
     void mapAll(void (*fn) (const KeyType &, const ValueType &)) const;
+
+    /*
+     * 方法：poolStats
+     * 使用：MyPoolStats s = map.poolStats();
+     * -------------------------------------
+     * 返回存放TreeNode的结点池的占用情况，见mynodepool.h。
+     */
+    MyPoolStats poolStats() const;
+
+private:
+    struct TreeNode;
+
+    struct KeyOf {
+        typedef KeyType type;
+        static const KeyType & get(const TreeNode *np) { return np->key; }
+    };
+    struct ValueOf {
+        typedef ValueType type;
+        static const ValueType & get(const TreeNode *np) { return np->value; }
+    };
+
+public:
+    /*
+     * 迭代器
+     * 使用：for(const KeyType &key : map) ...
+     *      for(MyMap<KeyType, ValueType>::const_iterator it = map.begin(); it != map.end(); ++it) {
+     *          cout << it.key() << ": " << it.value() << endl;
+     *      }
+     * ---------------------------------------------------------------------------------
+     * 基于范围的for循环按升序遍历map中的key。TreeNode中没有指向父结点的指针，
+     * 所以迭代器用一个栈保存从根到当前结点的路径上还没有访问的祖先（中序遍历），
+     * 额外内存与树高成正比，不会复制任何key-value。栈的前PATH_INLINE层存放在迭代器内部，
+     * 所以end()以及树高不超过PATH_INLINE时的创建、复制都不分配内存。key()和value()同时给出当前条目的key和value。
+     * 修改map（put、remove、operator[]、clear等）之后，已有的迭代器失效。
+     */
+    template <typename Proj>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename Proj::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type * pointer;
+        typedef const value_type & reference;
+
+        Iterator() {}
+
+        reference operator*() const { return Proj::get(current()); }
+        pointer operator->() const { return &Proj::get(current()); }
+        const KeyType & key() const { return current()->key; }
+        const ValueType & value() const { return current()->value; }
+
+        /* 弹出当前结点，然后走到右子树中最左边的结点 */
+        Iterator & operator++() {
+            const TreeNode *np = current();
+            path.remove(path.size() - 1);
+            pushLeft(np->right);
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iterator &rhs) const { return current() == rhs.current(); }
+        bool operator!=(const Iterator &rhs) const { return current() != rhs.current(); }
+
+    private:
+        friend class MyMap;
+
+        explicit Iterator(const TreeNode *root) {
+            pushLeft(root);
+        }
+
+        void pushLeft(const TreeNode *np) {
+            while(np != nullptr) {
+                path.add(np);
+                np = np->left;
+            }
+        }
+
+        /* 栈顶就是当前结点，栈为空时表示遍历结束（即end()） */
+        const TreeNode * current() const {
+            return path.isEmpty() ? nullptr : path[path.size() - 1];
+        }
+
+        static const int PATH_INLINE = 32;
+        MySmallVector<const TreeNode *, PATH_INLINE> path;
+    };
+
+    /*
+     * 视图：keysView, valuesView
+     * 使用：for(const ValueType &value : map.valuesView()) ...
+     * -----------------------------------------------------
+     * 返回借用这个map的视图，按key的升序遍历，不像keys()/values()那样复制所有条目。
+     * 视图在map被修改之前有效。
+     */
+    template <typename It>
+    class View {
+    public:
+        View(It first, It last) : first(first), last(last) {}
+        It begin() const { return first; }
+        It end() const { return last; }
+    private:
+        It first, last;
+    };
+
+    typedef Iterator<KeyOf> const_iterator;
+    typedef const_iterator iterator;
+    typedef Iterator<ValueOf> value_iterator;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    View<const_iterator> keysView() const;
+    View<value_iterator> valuesView() const;
+
 private:
     struct TreeNode {
         KeyType key;
@@ -204,6 +447,7 @@ private:
 
     TreeNode *root;     // BST
     int entries;        // BST中key-value对的数量
+    MyNodePool<TreeNode> pool;  // 所有TreeNode都从这里分配
 
     /*
      * 方法：deepCopy，deepCopyRec
@@ -216,6 +460,15 @@ private:
     void deepCopy(const MyMap<KeyType, ValueType> &src);
     void deepCopyRec(const TreeNode *rhs);
 
+    /*
+     * 方法：copyShape
+     * 使用：copyShape(root, newRoot, newPool);
+     * ---------------------------------------
+     * 在into中构造一棵与src形状相同的BST，挂在dst上。先挂上父结点再复制子树，
+     * 所以中途抛出异常时已经复制的结点都能从dst找到。
+     */
+    static void copyShape(const TreeNode *src, TreeNode *&dst, MyNodePool<TreeNode> &into);
+
     /*
      * 方法：findTreeNode
      * 使用：TreeNode *cp = findTreeNode(map.root, key);
@@ -223,20 +476,43 @@ private:
      * 在map中查找键为key的结点，因为这里可能需要插入和移除
      * 所以返回类型为引用以改变map中BST当前结点
      */
-    TreeNode * &findTreeNode(TreeNode *&root, const KeyType &key);
+    template <typename LookupType>
+    TreeNode * &findTreeNode(TreeNode *&root, const LookupType &key);
     /*
      * 方法：isExist
      * 使用：TreeNode* cp = isExist(map.root, key);
      * -------------------------------------------
      * 因为像get方法为const限定，所以无法使用像findTreeNode这类会修改BST的方法（非const限定）
      * 所以该方法可以看作是findTreeNode的const限定版本
+     * 这两个方法中的key可以是KeyType，也可以是异构查找的LookupType。
      */
-    TreeNode* isExist(TreeNode *root, const KeyType &key) const;
+    template <typename LookupType>
+    TreeNode* isExist(TreeNode *root, const LookupType &key) const;
+
+    /*
+     * 方法：removeKey
+     * 使用：removeKey(key);
+     * --------------------
+     * remove的实现，key可以是KeyType或异构查找的LookupType。
+     */
+    template <typename LookupType>
+    void removeKey(const LookupType &key);
+
+    /*
+     * 方法：findOrInsert
+     * 使用：std::pair<TreeNode *, bool> r = findOrInsert(key, args...);
+     * ----------------------------------------------------------------
+     * 沿BST查找一次key，不存在时在找到的空位置上插入用args构造value的新结点。
+     * 返回key所在的结点以及是否插入了新结点。
+     */
+    template <typename... Args>
+    std::pair<TreeNode *, bool> findOrInsert(const KeyType &key, Args&&... args);
     /*
      * 方法：deleteTree;
      * 使用：deleteTree(map.root);
      * --------------------------
-     * 使用后序遍历(PostOrder)来释放BST的内存
+     * 使用后序遍历(PostOrder)对BST中的结点调用析构函数，
+     * 结点的内存随后由pool.releaseAll()整体回收
      */
     void deleteTree(TreeNode *root);
 
@@ -257,14 +533,6 @@ private:
     TreeNode* rightMostNodeInLeftSubTree(TreeNode *root);
 
     TreeNode* leftMostNodeInRightSubTree(TreeNode *root);
-    /*
-     * 方法：inOrder
-     * 使用：inOrder(map.root, os);
-     * ---------------------------
-     * 因为toString需要遍历整个BST，同时保持key的有序，所以使用
-     * 该函数进行遍历，并且将输出存入在ostream对象内
-     */
-    void inOrder(TreeNode *root, MyVector<std::pair<KeyType, ValueType>> &res) const;
 
     void mapAll(TreeNode *root, void (*fn) (const KeyType &, const ValueType &)) const;
 };
@@ -285,13 +553,54 @@ MyMap<KeyType, ValueType>::~MyMap() {
  * 实现笔记：clear
  * -------------
  * 最后需要将root设置为nullptr，否则导致root为悬挂指针会带来安全隐患。
+ * 如果key和value都不需要析构，就不必遍历BST，直接把结点池整体归还。
  */
 template <typename KeyType, typename ValueType>
 void MyMap<KeyType, ValueType>::clear() {
-    deleteTree(root);
+    if(std::is_trivially_destructible<TreeNode>::value) {
+        entries = 0;
+    }
+    else {
+        deleteTree(root);
+    }
+    pool.releaseAll();
     root = nullptr;
 }
 
+template <typename KeyType, typename ValueType>
+void MyMap<KeyType, ValueType>::compact() {
+    MyNodePool<TreeNode> compacted;
+    TreeNode *newRoot = nullptr;
+    int n = entries;
+    try {
+        copyShape(root, newRoot, compacted);
+    }
+    catch(...) {
+        deleteTree(newRoot);
+        entries = n;
+        throw;
+    }
+    deleteTree(root);
+    entries = n;
+    pool.purge();
+    pool.adopt(compacted);
+    root = newRoot;
+}
+
+template <typename KeyType, typename ValueType>
+void MyMap<KeyType, ValueType>::copyShape(const TreeNode *src, TreeNode *&dst, MyNodePool<TreeNode> &into) {
+    if(src != nullptr) {
+        dst = into.create(src->key, src->value, nullptr, nullptr);
+        copyShape(src->left, dst->left, into);
+        copyShape(src->right, dst->right, into);
+    }
+}
+
+template <typename KeyType, typename ValueType>
+MyPoolStats MyMap<KeyType, ValueType>::poolStats() const {
+    return pool.stats();
+}
+
 template <typename KeyType, typename ValueType>
 bool MyMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
     TreeNode *cp = isExist(root, key);
@@ -299,26 +608,94 @@ bool MyMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
 }
 
 
+/*
+ * 实现笔记：equals
+ * --------------
+ * 两个map的迭代器都按key升序前进，所以同时推进两个迭代器逐个比较即可，
+ * 不需要先把两棵树都复制到数组中。
+ */
 template <typename KeyType, typename ValueType>
 bool MyMap<KeyType, ValueType>::equals(const MyMap<KeyType, ValueType> &map) const {
-    MyVector<std::pair<KeyType, ValueType>> inOrder1, inOrder2;
-    inOrder(this->root, inOrder1);
-    inOrder(map.root, inOrder2);
-    if(inOrder1.size() != inOrder2.size()) {
+    if(size() != map.size()) {
         return false;
     }
-    for(int i = 0; i < inOrder1.size(); ++i) {
-        if(inOrder1[i].first != inOrder2[i].first || inOrder1[i].second != inOrder2[i].second) {
+    const_iterator last = end();
+    for(const_iterator it1 = begin(), it2 = map.begin(); it1 != last; ++it1, ++it2) {
+        if(it1.key() != it2.key() || it1.value() != it2.value()) {
             return false;
         }
     }
     return true;
 }
 
+template <typename KeyType, typename ValueType>
+const KeyType * MyMap<KeyType, ValueType>::firstKey() const {
+    if(root == nullptr) return nullptr;
+    const TreeNode *np = root;
+    while(np->left != nullptr) {
+        np = np->left;
+    }
+    return &np->key;
+}
+
+template <typename KeyType, typename ValueType>
+const KeyType * MyMap<KeyType, ValueType>::lastKey() const {
+    if(root == nullptr) return nullptr;
+    const TreeNode *np = root;
+    while(np->right != nullptr) {
+        np = np->right;
+    }
+    return &np->key;
+}
+
 template <typename KeyType, typename ValueType>
 ValueType MyMap<KeyType, ValueType>::get(const KeyType& key) const {
     TreeNode* cp = isExist(root, key);
-    return (cp == nullptr) ? "" : cp->value;
+    return (cp == nullptr) ? ValueType() : cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType * MyMap<KeyType, ValueType>::find(const KeyType &key) {
+    TreeNode *cp = isExist(root, key);
+    return (cp == nullptr) ? nullptr : &cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+const ValueType * MyMap<KeyType, ValueType>::find(const KeyType &key) const {
+    TreeNode *cp = isExist(root, key);
+    return (cp == nullptr) ? nullptr : &cp->value;
+}
+
+/*
+ * 实现笔记：异构查找
+ * ---------------
+ * 与对应的非模板版本相同，isExist和findTreeNode直接用LookupType与结点中的key比较。
+ */
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+ValueType MyMap<KeyType, ValueType>::get(const LookupType &key) const {
+    TreeNode *cp = isExist(root, key);
+    return (cp == nullptr) ? ValueType() : cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+bool MyMap<KeyType, ValueType>::containsKey(const LookupType &key) const {
+    return isExist(root, key) != nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+ValueType * MyMap<KeyType, ValueType>::find(const LookupType &key) {
+    TreeNode *cp = isExist(root, key);
+    return (cp == nullptr) ? nullptr : &cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+const ValueType * MyMap<KeyType, ValueType>::find(const LookupType &key) const {
+    TreeNode *cp = isExist(root, key);
+    return (cp == nullptr) ? nullptr : &cp->value;
 }
 
 template <typename KeyType, typename ValueType>
@@ -329,15 +706,34 @@ bool MyMap<KeyType, ValueType>::isEmpty() const {
 template <typename KeyType, typename ValueType>
 MyVector<KeyType> MyMap<KeyType, ValueType>::keys() const {
     MyVector<KeyType> res;
-
-    MyVector<std::pair<KeyType, ValueType>> inOrder1;
-    inOrder(this->root, inOrder1);
-    for(int i = 0; i < inOrder1.size(); ++i) {
-        res.add(inOrder1[i].first);
+    for(const KeyType &key : *this) {
+        res.add(key);
     }
     return res;
 }
 
+template <typename KeyType, typename ValueType>
+typename MyMap<KeyType, ValueType>::const_iterator MyMap<KeyType, ValueType>::begin() const {
+    return const_iterator(root);
+}
+
+template <typename KeyType, typename ValueType>
+typename MyMap<KeyType, ValueType>::const_iterator MyMap<KeyType, ValueType>::end() const {
+    return const_iterator();
+}
+
+template <typename KeyType, typename ValueType>
+typename MyMap<KeyType, ValueType>::template View<typename MyMap<KeyType, ValueType>::const_iterator>
+MyMap<KeyType, ValueType>::keysView() const {
+    return View<const_iterator>(begin(), end());
+}
+
+template <typename KeyType, typename ValueType>
+typename MyMap<KeyType, ValueType>::template View<typename MyMap<KeyType, ValueType>::value_iterator>
+MyMap<KeyType, ValueType>::valuesView() const {
+    return View<value_iterator>(value_iterator(root), value_iterator());
+}
+
 /*
  * 实现笔记： put
  * ------------
@@ -346,14 +742,70 @@ MyVector<KeyType> MyMap<KeyType, ValueType>::keys() const {
  */
 template <typename KeyType, typename ValueType>
 void MyMap<KeyType, ValueType>::put(const KeyType &key, const ValueType &value){
+    insertOrAssign(key, value);
+}
+
+/*
+ * 实现笔记：findOrInsert
+ * --------------------
+ * 与put一样利用findTreeNode返回的引用：cp为nullptr时它就是新结点应该挂上的位置，
+ * 新结点直接在结点池中用key和value构造。
+ */
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+std::pair<typename MyMap<KeyType, ValueType>::TreeNode *, bool> MyMap<KeyType, ValueType>::findOrInsert(const KeyType &key, Args&&... args) {
+    TreeNode *&cp = findTreeNode(root, key);
+    if(cp != nullptr) {
+        return std::make_pair(cp, false);
+    }
+    cp = pool.create(key, ValueType(std::forward<Args>(args)...), nullptr, nullptr);
+    entries++;
+    return std::make_pair(cp, true);
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMap<KeyType, ValueType>::tryGet(const KeyType &key, ValueType &out) const {
+    TreeNode *cp = isExist(root, key);
+    if(cp == nullptr) return false;
+    out = cp->value;
+    return true;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename... Args>
+std::pair<ValueType *, bool> MyMap<KeyType, ValueType>::tryEmplace(const KeyType &key, Args&&... args) {
+    std::pair<TreeNode *, bool> r = findOrInsert(key, std::forward<Args>(args)...);
+    return std::make_pair(&r.first->value, r.second);
+}
+
+template <typename KeyType, typename ValueType>
+std::pair<ValueType *, bool> MyMap<KeyType, ValueType>::insertOrAssign(const KeyType &key, const ValueType &value) {
+    std::pair<TreeNode *, bool> r = findOrInsert(key, value);
+    if(!r.second) {
+        r.first->value = value;
+    }
+    return std::make_pair(&r.first->value, r.second);
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+ValueType & MyMap<KeyType, ValueType>::computeIfAbsent(const KeyType &key, Fn fn) {
     TreeNode *&cp = findTreeNode(root, key);
     if(cp == nullptr) {
-        cp = new TreeNode;
-        cp->key = key;
-        cp->left = cp->right = nullptr;
+        cp = pool.create(key, fn(key), nullptr, nullptr);
         entries++;
     }
-    cp->value = value;
+    return cp->value;
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Fn>
+ValueType & MyMap<KeyType, ValueType>::merge(const KeyType &key, const ValueType &value, Fn combine) {
+    std::pair<TreeNode *, bool> r = findOrInsert(key, value);
+    if(!r.second) {
+        r.first->value = combine(r.first->value, value);
+    }
+    return r.first->value;
 }
 
 /*
@@ -371,11 +823,23 @@ void MyMap<KeyType, ValueType>::put(const KeyType &key, const ValueType &value){
  */
 template <typename KeyType, typename ValueType>
 void MyMap<KeyType, ValueType>::remove(const KeyType &key) {
+    removeKey(key);
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType, typename>
+void MyMap<KeyType, ValueType>::remove(const LookupType &key) {
+    removeKey(key);
+}
+
+template <typename KeyType, typename ValueType>
+template <typename LookupType>
+void MyMap<KeyType, ValueType>::removeKey(const LookupType &key) {
     TreeNode *&cp = findTreeNode(root, key);
     if(cp != nullptr) {
         // 1. 该结点没有孩子
         if(cp->left == nullptr && cp->right == nullptr) {
-            delete cp;
+            pool.destroy(cp);
             cp = nullptr;
             entries--;
         }
@@ -409,13 +873,14 @@ int MyMap<KeyType, ValueType>::size() const {
 template <typename KeyType, typename ValueType>
 std::string MyMap<KeyType, ValueType>::toString() const {
     std::ostringstream os;
-    MyVector<std::pair<KeyType, ValueType>> inOrderResult;
-    inOrder(this->root, inOrderResult);
-    for(int i = 0; i < inOrderResult.size(); ++i) {
-        if(os.str() != "") {
+    bool first = true;
+    const_iterator last = end();
+    for(const_iterator it = begin(); it != last; ++it) {
+        if(!first) {
             os << ", ";
         }
-        os << "{" << inOrderResult[i].first << ": " << inOrderResult[i].second << "}";
+        first = false;
+        os << "{" << it.key() << ": " << it.value() << "}";
     }
 
     return os.str();
@@ -424,11 +889,8 @@ std::string MyMap<KeyType, ValueType>::toString() const {
 template <typename KeyType, typename ValueType>
 MyVector<ValueType> MyMap<KeyType, ValueType>::values() const {
     MyVector<ValueType> res;
-
-    MyVector<std::pair<KeyType, ValueType>> inOrder1;
-    inOrder(this->root, inOrder1);
-    for(int i = 0; i < inOrder1.size(); ++i) {
-        res.add(inOrder1[i].second);
+    for(const ValueType &value : valuesView()) {
+        res.add(value);
     }
     return res;
 }
@@ -446,15 +908,7 @@ std::ostream& operator << (std::ostream &os, const MyMap<KeyType, ValueType> &ma
 
 template <typename KeyType, typename ValueType>
 ValueType & MyMap<KeyType, ValueType>::operator [] (const KeyType &key) {
-    TreeNode *&cp = findTreeNode(root, key);
-    if(cp == nullptr) {
-        cp = new TreeNode;
-        cp->key = key;
-        cp->value = ValueType();
-        cp->left = cp->right = nullptr;
-        entries++;
-    }
-    return cp->value;
+    return findOrInsert(key).first->value;
 }
 
 template <typename KeyType, typename ValueType>
@@ -502,17 +956,6 @@ void MyMap<KeyType, ValueType>::deepCopyRec(const TreeNode *rhs) {
 
 
 
-template <typename KeyType, typename ValueType>
-void MyMap<KeyType, ValueType>::inOrder(TreeNode *root, MyVector<std::pair<KeyType, ValueType>> &res) const{
-    if(root == nullptr) {
-        return ;
-    }
-    else {
-        inOrder(root->left, res);
-        res.add(std::pair<KeyType, ValueType>(root->key, root->value));
-        inOrder(root->right, res);
-    }
-}
 
 
 
@@ -524,7 +967,7 @@ void MyMap<KeyType, ValueType>::deleteTree(TreeNode *root) {
     else {
         deleteTree(root->left);
         deleteTree(root->right);
-        delete root;
+        root->~TreeNode();
         entries--;
     }
 }
@@ -559,7 +1002,8 @@ template <typename KeyType, typename ValueType>
  * --------------------
  * 返回引用使得像put和remove方法可以修改BST生效。
  */
-typename MyMap<KeyType, ValueType>::TreeNode *& MyMap<KeyType, ValueType>::findTreeNode(TreeNode *&root, const KeyType &key) {
+template <typename LookupType>
+typename MyMap<KeyType, ValueType>::TreeNode *& MyMap<KeyType, ValueType>::findTreeNode(TreeNode *&root, const LookupType &key) {
     if(root == nullptr) {
         return root;
     }
@@ -578,7 +1022,8 @@ typename MyMap<KeyType, ValueType>::TreeNode *& MyMap<KeyType, ValueType>::findT
 }
 
 template <typename KeyType, typename ValueType>
-typename MyMap<KeyType, ValueType>::TreeNode *  MyMap<KeyType, ValueType>::isExist(TreeNode *root, const KeyType &key) const {
+template <typename LookupType>
+typename MyMap<KeyType, ValueType>::TreeNode *  MyMap<KeyType, ValueType>::isExist(TreeNode *root, const LookupType &key) const {
     if(root == nullptr) {
         return root;
     }
@@ -0,0 +1,264 @@
+/*
+ * File: mymultimap.h
+ * ------------------
+ * 该类实现了一个key对应多个value的有序映射（multimap），是MyHashMultiMap的BST版本：
+ * key按排序顺序遍历，添加/访问/删除只需O(logN)。
+ * 每个key的value列表是一个MySmallVector：前INLINE_VALUES个value直接存放在树结点中，
+ * 更多的value才搬到一个按两倍扩容的连续数组中，而不是像MyMap<KeyType, MyVector<ValueType>>
+ * 那样为每个key分配一个至少有INITIAL_CAPACITY（10）个元素的数组。
+ * 同一个key的value保持添加的顺序，getAll直接返回借用它们的MySpan。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ */
+
+#ifndef _mymultimap_h
+#define _mymultimap_h
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include "mymap.h"
+#include "mysmallvector.h"
+#include "myvector.h"
+
+template <typename KeyType, typename ValueType>
+class MyMultiMap {
+public:
+    /* 每个key内联存放的value个数，超过时才为这个key分配数组 */
+    static const int INLINE_VALUES = 2;
+    typedef MySmallVector<ValueType, INLINE_VALUES> ValueList;
+
+    /*
+     * 方法：MyMultiMap
+     * 使用：MyMultiMap<KeyType, ValueType> multimap;
+     * -------------------------------------------
+     * 构造一个空的multimap。
+     */
+    MyMultiMap();
+
+    /*
+     * 方法：add
+     * 使用：multimap.add(key, value);
+     * -----------------------------
+     * 把value添加到key的value列表的末尾。同一个key可以添加相同的value多次。
+     */
+    void add(const KeyType &key, const ValueType &value);
+
+    /*
+     * 方法：getAll
+     * 使用：for(const ValueType &value : multimap.getAll(key)) ...
+     * ---------------------------------------------------------
+     * 按添加的顺序返回key的所有value，key不存在时返回空的MySpan。
+     * 返回的MySpan借用multimap中的value，不复制任何元素，在multimap被修改之前有效。
+     */
+    MySpan<ValueType> getAll(const KeyType &key) const;
+
+    /*
+     * 方法：count
+     * 使用：int n = multimap.count(key);
+     * --------------------------------
+     * 返回key的value个数，key不存在时返回0。
+     */
+    int count(const KeyType &key) const;
+
+    /*
+     * 方法：containsKey
+     * 使用：if(multimap.containsKey(key)) ...
+     * -------------------------------------
+     * 如果key至少有一个value，则返回true。
+     */
+    bool containsKey(const KeyType &key) const;
+
+    /*
+     * 方法：removeAll
+     * 使用：int n = multimap.removeAll(key);
+     * ------------------------------------
+     * 删除key的所有value，返回删除的个数。
+     */
+    int removeAll(const KeyType &key);
+
+    /*
+     * 方法：remove
+     * 使用：if(multimap.remove(key, value)) ...
+     * ---------------------------------------
+     * 删除key的value列表中第一个等于value的元素，其余value保持原来的顺序；
+     * 删除了元素时返回true。key的最后一个value被删除后，key也不再存在。
+     */
+    bool remove(const KeyType &key, const ValueType &value);
+
+    /*
+     * 方法：size, keyCount, isEmpty
+     * 使用：int n = multimap.size();
+     * ----------------------------
+     * size返回所有key的value个数之和，keyCount返回不同的key的个数。
+     */
+    int size() const;
+    int keyCount() const;
+    bool isEmpty() const;
+
+    /*
+     * 方法：clear
+     * 使用：multimap.clear();
+     * ---------------------
+     * 删除所有的key和value。
+     */
+    void clear();
+
+    /*
+     * 方法：compact
+     * 使用：multimap.compact();
+     * -----------------------
+     * 见MyMap::compact，大量removeAll之后释放多余的内存。
+     */
+    void compact();
+
+    /*
+     * 方法：keys
+     * 使用：MyVector<KeyType> keys = multimap.keys();
+     * ---------------------------------------------
+     * 按排序顺序返回所有不同的key。
+     */
+    MyVector<KeyType> keys() const;
+
+    /*
+     * 方法：mapAll
+     * 使用：multimap.mapAll(fn);
+     * ------------------------
+     * 按key的排序顺序对每个key调用一次fn(key, values)，values是这个key的所有value。
+     */
+    void mapAll(void (*fn) (const KeyType &, MySpan<ValueType>)) const;
+
+    /*
+     * 方法：toString
+     * 使用：string str = multimap.toString();
+     * -------------------------------------
+     * 与MyMap的格式相同，value列表写成MyVector的格式，例如"{k1: {v1, v2}}, {k2: {v3}}"。
+     */
+    std::string toString() const;
+
+private:
+    MyMap<KeyType, ValueList> map;
+    int nValues;            // 所有value列表的长度之和
+};
+
+template <typename KeyType, typename ValueType>
+MyMultiMap<KeyType, ValueType>::MyMultiMap() : nValues(0) {
+}
+
+/*
+ * 实现笔记：add
+ * ------------
+ * tryEmplace只查找一次：key不存在时就地构造一个空的ValueList。
+ * 添加value抛出异常时，刚插入的key被删除，不会留下没有value的key。
+ */
+template <typename KeyType, typename ValueType>
+void MyMultiMap<KeyType, ValueType>::add(const KeyType &key, const ValueType &value) {
+    std::pair<ValueList *, bool> slot = map.tryEmplace(key);
+    try {
+        slot.first->add(value);
+    }
+    catch(...) {
+        if(slot.second) map.remove(key);
+        throw;
+    }
+    nValues++;
+}
+
+template <typename KeyType, typename ValueType>
+MySpan<ValueType> MyMultiMap<KeyType, ValueType>::getAll(const KeyType &key) const {
+    const ValueList *list = map.find(key);
+    return (list == nullptr) ? MySpan<ValueType>() : list->view();
+}
+
+template <typename KeyType, typename ValueType>
+int MyMultiMap<KeyType, ValueType>::count(const KeyType &key) const {
+    const ValueList *list = map.find(key);
+    return (list == nullptr) ? 0 : list->size();
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMultiMap<KeyType, ValueType>::containsKey(const KeyType &key) const {
+    return map.containsKey(key);
+}
+
+template <typename KeyType, typename ValueType>
+int MyMultiMap<KeyType, ValueType>::removeAll(const KeyType &key) {
+    const ValueList *list = map.find(key);
+    if(list == nullptr) return 0;
+    int n = list->size();
+    map.remove(key);
+    nValues -= n;
+    return n;
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMultiMap<KeyType, ValueType>::remove(const KeyType &key, const ValueType &value) {
+    ValueList *list = map.find(key);
+    if(list == nullptr) return false;
+    for(int i = 0; i < list->size(); ++i) {
+        if((*list)[i] == value) {
+            list->remove(i);
+            nValues--;
+            if(list->isEmpty()) map.remove(key);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename KeyType, typename ValueType>
+int MyMultiMap<KeyType, ValueType>::size() const {
+    return nValues;
+}
+
+template <typename KeyType, typename ValueType>
+int MyMultiMap<KeyType, ValueType>::keyCount() const {
+    return map.size();
+}
+
+template <typename KeyType, typename ValueType>
+bool MyMultiMap<KeyType, ValueType>::isEmpty() const {
+    return nValues == 0;
+}
+
+template <typename KeyType, typename ValueType>
+void MyMultiMap<KeyType, ValueType>::clear() {
+    map.clear();
+    nValues = 0;
+}
+
+template <typename KeyType, typename ValueType>
+void MyMultiMap<KeyType, ValueType>::compact() {
+    map.compact();
+}
+
+template <typename KeyType, typename ValueType>
+MyVector<KeyType> MyMultiMap<KeyType, ValueType>::keys() const {
+    return map.keys();
+}
+
+template <typename KeyType, typename ValueType>
+void MyMultiMap<KeyType, ValueType>::mapAll(void (*fn) (const KeyType &, MySpan<ValueType>)) const {
+    typename MyMap<KeyType, ValueList>::const_iterator last = map.end();
+    for(typename MyMap<KeyType, ValueList>::const_iterator it = map.begin(); it != last; ++it) {
+        fn(it.key(), it.value().view());
+    }
+}
+
+template <typename KeyType, typename ValueType>
+std::string MyMultiMap<KeyType, ValueType>::toString() const {
+    return map.toString();
+}
+
+/*
+ * 实现笔记：operator<<
+ * -------------------
+ * 利用toString()使得插入操作符支持类MyMultiMap
+ */
+template <typename KeyType, typename ValueType>
+std::ostream & operator<< (std::ostream &os, const MyMultiMap<KeyType, ValueType> &multimap) {
+    return os << multimap.toString();
+}
+
+#endif // _mymultimap_h
@@ -0,0 +1 @@
+g++ -std=c++11 -o main main.cpp
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include "mynodepool.h"
+using namespace std;
+
+struct Node {
+    string key;
+    int value;
+    Node *link;
+};
+
+int main() {
+    MyNodePool<Node> pool;
+    MyPoolStats s = pool.stats();
+    assert(s.chunks == 0 && s.live == 0 && s.bytesReserved == 0);
+
+    Node *a = pool.create();
+    assert(a->key == "" && a->value == 0 && a->link == nullptr);
+    a->key = "A";
+    Node *b = pool.create();
+    assert(a != b);
+    s = pool.stats();
+    assert(s.chunks == 1 && s.capacity == 16 && s.live == 2 && s.freeList == 0);
+
+    // Freed nodes are reused before the chunk is cut further.
+    pool.destroy(b);
+    assert(pool.stats().freeList == 1);
+    Node *c = pool.create();
+    assert(c == b && pool.stats().freeList == 0);
+
+    // Chunks grow geometrically.
+    Node *nodes[1000];
+    for(int i = 0; i < 1000; ++i) {
+        nodes[i] = pool.create();
+        nodes[i]->value = i;
+    }
+    for(int i = 0; i < 1000; ++i) {
+        assert(nodes[i]->value == i);
+    }
+    s = pool.stats();
+    assert(s.live == 1002 && s.capacity >= 1002 && s.chunks < 10);
+
+    // releaseAll keeps the chunks and hands out the same memory again.
+    for(int i = 0; i < 1000; ++i) {
+        nodes[i]->~Node();
+    }
+    a->~Node();
+    c->~Node();
+    size_t chunks = s.chunks;
+    pool.releaseAll();
+    s = pool.stats();
+    assert(s.live == 0 && s.chunks == chunks);
+    Node *first = pool.create();
+    assert(first == a);
+    pool.destroy(first);
+
+    pool.purge();
+    s = pool.stats();
+    assert(s.chunks == 0 && s.capacity == 0 && s.bytesReserved == 0);
+
+    // adopt moves nodes between pools without moving them in memory.
+    MyNodePool<Node> left, right;
+    Node *kept = right.create();
+    kept->value = 42;
+    for(int i = 0; i < 40; ++i) {
+        right.create();
+    }
+    left.create();
+    size_t rightChunks = right.stats().chunks;
+    left.adopt(right);
+    assert(right.stats().chunks == 0 && right.stats().live == 0);
+    s = left.stats();
+    assert(s.live == 42 && kept->value == 42 && s.chunks == rightChunks + 1);
+    left.destroy(kept);
+    assert(left.stats().live == 41);
+    left.releaseAll();
+    for(size_t i = 0; i < s.capacity; ++i) {
+        left.create();
+    }
+    assert(left.stats().chunks == s.chunks);
+
+    cout << "Class MyNodePool unit test succeed." << endl;
+    return 0;
+}
@@ -0,0 +1,318 @@
+/*
+ * File: mynodepool.h
+ * ------------------
+ * 该类是基于链式容器（MyHashMap的Cell、MyMap的TreeNode）的结点池（slab allocator）。
+ * 结点从按块（chunk）分配的大块内存中切出：块内还有空位时分配只需移动一个下标，
+ * 被释放的结点进入空闲链表（free list），之后的分配优先复用它们。
+ * 容器的clear()不需要逐个归还结点，只需调用releaseAll()把所有块整体标记为未使用，
+ * 块本身保留下来供之后的插入使用，直到purge()或析构时才还给系统。
+ *
+ * 每个容器拥有自己的结点池，所以结点池不需要加锁，也不能被拷贝。
+ * -------------------------------------------------------------------------------
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ *      2. 2026.10.18: create可以接受参数，直接在池中构造结点
+ *      3. 2026.10.18: 添加adopt，接管另一个结点池的块以及其中的结点（并行构建散列表时使用）
+ */
+
+#ifndef _mynodepool_h
+#define _mynodepool_h
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ * 结构体：MyPoolStats
+ * ------------------
+ * 结点池的占用情况，由MyNodePool::stats()（以及使用结点池的容器的poolStats()）返回。
+ */
+struct MyPoolStats {
+    size_t chunks;          // 已向系统申请的块数
+    size_t capacity;        // 所有块中结点的总数
+    size_t live;            // 正在使用的结点数
+    size_t freeList;        // 空闲链表中可复用的结点数
+    size_t bytesReserved;   // 所有块占用的字节数
+};
+
+template <typename T>
+class MyNodePool {
+public:
+    /*
+     * Constructor: MyNodePool
+     * Usage: MyNodePool<Node> pool;
+     * -----------------------------
+     * Initializes an empty pool. No chunk is allocated until the first
+     * call to create.
+     */
+    MyNodePool();
+
+    /*
+     * Destructor: ~MyNodePool
+     * Usage: (usually implicit)
+     * -------------------------
+     * Returns every chunk to the system. The destructors of nodes that are
+     * still live are NOT called; the owning container must do that first.
+     */
+    ~MyNodePool();
+
+    /*
+     * Method: create
+     * Usage: Node *p = pool.create();
+     *        Node *p = pool.create(key, value, nullptr);
+     * ----------------------------------------------
+     * Returns a node initialized with T{args...} (value-initialized when
+     * there are no arguments), taken from the free list if possible,
+     * otherwise from the current chunk. A new chunk (twice as large as the
+     * previous one, up to MAX_CHUNK_NODES nodes) is allocated only when every
+     * existing chunk is in use.
+     */
+    template <typename... Args>
+    T * create(Args&&... args);
+
+    /*
+     * Method: destroy
+     * Usage: pool.destroy(p);
+     * -----------------------
+     * Calls the destructor of p and puts its memory on the free list.
+     */
+    void destroy(T *p);
+
+    /*
+     * Method: releaseAll
+     * Usage: pool.releaseAll();
+     * -------------------------
+     * Marks every node as unused in O(1) (plus one step per chunk), keeping
+     * the chunks for later use. The caller must already have called the
+     * destructors of the live nodes, if their type needs one.
+     */
+    void releaseAll();
+
+    /*
+     * Method: purge
+     * Usage: pool.purge();
+     * --------------------
+     * Like releaseAll, but also returns every chunk to the system.
+     */
+    void purge();
+
+    /*
+     * Method: adopt
+     * Usage: pool.adopt(other);
+     * -------------------------
+     * Moves every chunk of other, together with the live nodes in it, into
+     * this pool, and leaves other empty. Nodes keep their addresses, so
+     * pointers to them stay valid and they can later be destroyed through
+     * this pool. Lets several threads fill private pools without locking
+     * and hand the result to one owner. Chunks of other that were never
+     * used are returned to the system.
+     */
+    void adopt(MyNodePool<T> &other);
+
+    /*
+     * Method: stats
+     * Usage: MyPoolStats s = pool.stats();
+     * ------------------------------------
+     * Returns the current occupancy of the pool.
+     */
+    MyPoolStats stats() const;
+
+private:
+    /* 块中的一个位置：未使用时存放空闲链表的指针，使用时存放结点 */
+    union Block {
+        Block *next;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+    };
+
+    struct Chunk {
+        Chunk *next;
+        int capacity;
+        Block *blocks;
+    };
+
+    /* 第一个块的结点数以及块大小的上限 */
+    static const int FIRST_CHUNK_NODES = 16;
+    static const int MAX_CHUNK_NODES = 4096;
+
+    Chunk *head;        // 块链表，按分配顺序排列
+    Chunk *current;     // 正在切分的块
+    int used;           // current中已经切出的结点数
+    Block *freeList;
+    size_t nChunks;
+    size_t nBlocks;
+    size_t nLive;
+    size_t nFree;
+
+    /* 结点池不能被拷贝 */
+    MyNodePool(const MyNodePool &);
+    MyNodePool & operator=(const MyNodePool &);
+
+    Block * nextBlock();
+};
+
+template <typename T>
+MyNodePool<T>::MyNodePool() {
+    head = current = nullptr;
+    used = 0;
+    freeList = nullptr;
+    nChunks = nBlocks = nLive = nFree = 0;
+}
+
+template <typename T>
+MyNodePool<T>::~MyNodePool() {
+    purge();
+}
+
+template <typename T>
+template <typename... Args>
+T * MyNodePool<T>::create(Args&&... args) {
+    Block *b;
+    if(freeList != nullptr) {
+        b = freeList;
+        freeList = b->next;
+        nFree--;
+    }
+    else {
+        b = nextBlock();
+    }
+    T *p;
+    try {
+        p = new (&b->storage) T{std::forward<Args>(args)...};
+    }
+    catch(...) {
+        b->next = freeList;     // 构造失败时把位置还给空闲链表
+        freeList = b;
+        nFree++;
+        throw;
+    }
+    nLive++;
+    return p;
+}
+
+/*
+ * 实现笔记：nextBlock
+ * -----------------
+ * releaseAll之后current回到第一个块，所以先沿着已有的块前进，
+ * 只有走到最后一个块的末尾才向系统申请新块。
+ */
+template <typename T>
+typename MyNodePool<T>::Block * MyNodePool<T>::nextBlock() {
+    if(current == nullptr || used == current->capacity) {
+        if(current != nullptr && current->next != nullptr) {
+            current = current->next;
+        }
+        else {
+            int n = (current == nullptr) ? FIRST_CHUNK_NODES : current->capacity * 2;
+            if(n > MAX_CHUNK_NODES) n = MAX_CHUNK_NODES;
+            Chunk *chunk = new Chunk;
+            chunk->next = nullptr;
+            chunk->capacity = n;
+            chunk->blocks = new Block[n];
+            if(current == nullptr) head = chunk;
+            else current->next = chunk;
+            current = chunk;
+            nChunks++;
+            nBlocks += n;
+        }
+        used = 0;
+    }
+    return &current->blocks[used++];
+}
+
+template <typename T>
+void MyNodePool<T>::destroy(T *p) {
+    p->~T();
+    Block *b = reinterpret_cast<Block *>(p);
+    b->next = freeList;
+    freeList = b;
+    nLive--;
+    nFree++;
+}
+
+template <typename T>
+void MyNodePool<T>::releaseAll() {
+    current = head;
+    used = 0;
+    freeList = nullptr;
+    nLive = nFree = 0;
+}
+
+template <typename T>
+void MyNodePool<T>::purge() {
+    while(head != nullptr) {
+        Chunk *next = head->next;
+        delete [] head->blocks;
+        delete head;
+        head = next;
+    }
+    current = nullptr;
+    used = 0;
+    freeList = nullptr;
+    nChunks = nBlocks = nLive = nFree = 0;
+}
+
+/*
+ * 实现笔记：adopt
+ * -------------
+ * other中已经用过的块（head到current）插到本池块链表的最前面，这样
+ * "current之后的块都没有用过"仍然成立，releaseAll之后也会沿链表用到它们。
+ * other的current中还没切出的位置放进本池的空闲链表，current之后的块直接释放。
+ */
+template <typename T>
+void MyNodePool<T>::adopt(MyNodePool<T> &other) {
+    if(&other == this || other.head == nullptr) return;
+
+    Chunk *unused = other.current->next;
+    while(unused != nullptr) {
+        Chunk *next = unused->next;
+        other.nChunks--;
+        other.nBlocks -= unused->capacity;
+        delete [] unused->blocks;
+        delete unused;
+        unused = next;
+    }
+    for(int i = other.used; i < other.current->capacity; ++i) {
+        Block *b = &other.current->blocks[i];
+        b->next = other.freeList;
+        other.freeList = b;
+        other.nFree++;
+    }
+    other.current->next = head;
+    head = other.head;
+    if(current == nullptr) {
+        current = other.current;
+        used = other.current->capacity;
+    }
+
+    if(other.freeList != nullptr) {
+        Block *tail = other.freeList;
+        while(tail->next != nullptr) {
+            tail = tail->next;
+        }
+        tail->next = freeList;
+        freeList = other.freeList;
+    }
+    nChunks += other.nChunks;
+    nBlocks += other.nBlocks;
+    nLive += other.nLive;
+    nFree += other.nFree;
+
+    other.head = other.current = nullptr;
+    other.used = 0;
+    other.freeList = nullptr;
+    other.nChunks = other.nBlocks = other.nLive = other.nFree = 0;
+}
+
+template <typename T>
+MyPoolStats MyNodePool<T>::stats() const {
+    MyPoolStats s;
+    s.chunks = nChunks;
+    s.capacity = nBlocks;
+    s.live = nLive;
+    s.freeList = nFree;
+    s.bytesReserved = nChunks * sizeof(Chunk) + nBlocks * sizeof(Block);
+    return s;
+}
+
+#endif // _mynodepool_h
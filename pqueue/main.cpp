@@ -1,4 +1,5 @@
 
+#include <cassert>
 #include <iostream>
 #include <string>
 #include "mypqueue.h"
@@ -16,5 +17,32 @@ int main() {
     while(!mpq.isEmpty()) {
         cout << mpq.dequeue() << endl;
     }
+
+    // The heap array shrinks back after a burst; the order is unaffected.
+    MyPQueue<int> burst;
+    for(int i = 0; i < 10000; ++i) {
+        burst.enqueue(i, (i * 7919) % 10000);
+    }
+    int previous = -1;
+    for(int i = 0; i < 9990; ++i) {
+        int value = burst.dequeue();
+        int priority = (value * 7919) % 10000;
+        assert(priority > previous);
+        previous = priority;
+    }
+    burst.shrinkToFit();
+    for(int i = 0; i < 100; ++i) {
+        burst.enqueue(-1, -1);
+        assert(burst.dequeue() == -1);
+    }
+    for(int i = 0; i < 10; ++i) {
+        int priority = (burst.dequeue() * 7919) % 10000;
+        assert(priority > previous);
+        previous = priority;
+    }
+    assert(burst.isEmpty());
+    burst.shrinkToFit();
+    burst.enqueue(1, 1);
+    assert(burst.dequeue() == 1);
     return 0;
 }
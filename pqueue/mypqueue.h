@@ -14,7 +14,7 @@
  * 参考：https://web.stanford.edu/dept/cs_edu/resources/cslib_docs/PriorityQueue
  * 更新：
  *      1. 2024.4.11: 第一版
- *
+ *      2. 2026.10.18: dequeue之后元素不足容量的1/4时把heap数组缩小一半，添加shrinkToFit。
  *
  */
 
@@ -41,10 +41,18 @@ public:
      * 方法：clear
      * 使用：pqueue.clear();
      * --------------------
-     * 删除优先级队列中的所有元素。
+     * 删除优先级队列中的所有元素。heap数组保留，需要释放时再调用shrinkToFit。
      */
     void clear();
 
+    /*
+     * 方法：shrinkToFit
+     * 使用：pqueue.shrinkToFit();
+     * --------------------------
+     * 把heap数组缩小到刚好容纳当前的元素。
+     */
+    void shrinkToFit();
+
 
     /*
      * 方法：enqueue
@@ -67,6 +75,8 @@ public:
      * 使用：pqueue.dequeue();
      * ----------------------
      * 删除并返回最前端（最紧急）的值。
+     * 元素不足容量的1/4时把heap数组缩小一半（但不小于初始容量），
+     * 缩小后离下一次扩容还有一半的空间，所以交替enqueue、dequeue不会反复分配。
      */
     ValueType dequeue();
 
@@ -110,6 +120,11 @@ private:
      * 原来空间的两倍。
      */
     void expandCapacity();
+
+    /*
+     * 把heap换成容量为newCapacity的数组，expandCapacity、dequeue和shrinkToFit共用。
+     */
+    void reallocate(int newCapacity);
 };
 
 
@@ -139,6 +154,16 @@ void MyPQueue<ValueType>::clear() {
     entries = 0;
 }
 
+/*
+ * 实现笔记：shrinkToFit
+ * -------------------
+ * heap从下标1开始，所以entries个元素需要entries + 1个位置。
+ */
+template <typename ValueType>
+void MyPQueue<ValueType>::shrinkToFit() {
+    if(capacity != entries + 1) reallocate(entries + 1);
+}
+
 /*
  * 实现笔记：enqueue
  * ---------------
@@ -172,6 +197,9 @@ ValueType MyPQueue<ValueType>::dequeue() {
     ValueType result = heap[1].value;
     heap[1] = heap[entries--];
     down(1);
+    if(capacity > INITIAL_CAPACITY && entries + 1 <= capacity / 4) {
+        reallocate(capacity / 2 > INITIAL_CAPACITY ? capacity / 2 : INITIAL_CAPACITY);
+    }
     return result;
 }
 
@@ -241,14 +269,18 @@ void MyPQueue<ValueType>::up(int index) {
 
 template <typename ValueType>
 void MyPQueue<ValueType>::expandCapacity() {
-    Cell *oldHeap = heap;
+    reallocate(capacity * 2);
+}
 
-    capacity *= 2;
-    heap = new Cell[capacity];
+template <typename ValueType>
+void MyPQueue<ValueType>::reallocate(int newCapacity) {
+    Cell *newHeap = new Cell[newCapacity];
     for(int i = 1; i <= entries; ++i) {
-        heap[i] = oldHeap[i];
+        newHeap[i] = heap[i];
     }
-    delete [] oldHeap;
+    delete [] heap;
+    heap = newHeap;
+    capacity = newCapacity;
 }
 
 #endif // mypqueue_h
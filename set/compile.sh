@@ -1 +1 @@
-g++ -std=c++11 -I ../vector/ -I ../map/ -o main main.cpp
+g++ -std=c++11 -I ../vector/ -I ../pool/ -I ../map/ -o main main.cpp
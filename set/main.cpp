@@ -66,6 +66,29 @@ int main() {
     // s3.clear();
     // assert(s3.last() == 'b');
     // s3.first();
+
+    // Range-based for visits the elements in sorted order; the operators iterate in place.
+    MySet<int> evens, threes;
+    for(int i = 20; i >= 0; --i) {
+        if(i % 2 == 0) evens.add(i);
+        if(i % 3 == 0) threes.add(i);
+    }
+    int previous = -1;
+    for(int value : evens) {
+        assert(value > previous);
+        previous = value;
+    }
+    assert(evens.first() == 0 && evens.last() == 20 && threes.last() == 18);
+    assert((evens * threes).toString() == "{0, 6, 12, 18}");
+    assert((evens - threes).size() == 7 && (evens + threes).size() == 14);
+    MySet<int> both = evens;
+    both += both;
+    assert(both == evens);
+    both -= both;
+    assert(both.isEmpty() && both.toString() == "{}");
+    evens -= threes;
+    evens.compact();
+    assert(evens.toString() == "{2, 4, 8, 10, 14, 16, 20}");
     cout << "Class MySet unit test succeed." << endl;
     return 0;
 }
@@ -28,6 +28,9 @@
  *      1. 2024.4.13: 第一版
  *      2. 2024.4.14: 添加operator>> 以支持输入
  *      3. 加入mapAll方法以支持callback函数，同时在>>中接收流数据前清空set中的数据(set.clear()).
+ *      4. 2026.10.18: 添加迭代器（支持基于范围的for循环），first、last、isSubsetOf、toString以及
+ *                     各个集合运算符直接沿迭代器遍历，不再先用keys()复制出所有元素。
+ *      5. 2026.10.18: 添加compact。
  */
 
 template <typename ValueType>
@@ -138,6 +141,15 @@ public:
      */
     void clear();
 
+    /*
+     * Method: compact
+     * Usage: set.compact();
+     * ---------------------
+     * Returns the memory of removed elements to the system by copying the
+     * tree into a compact pool (see MyMap::compact). Iterators are invalidated.
+     */
+    void compact();
+
     /*
      * Method: isSubsetOf
      * Usage: if(set.isSubsetOf(set2)) . . .
@@ -280,6 +292,19 @@ public:
      *
      */
     void mapAll(void (*fn) (const ValueType &)) const;
+
+    /*
+     * Iterators
+     * Usage: for(const ValueType &value : set) . . .
+     * ----------------------------------------------
+     * Range-based for loops visit the elements in sorted order. The iterators are
+     * those of the underlying map, so the elements are read in place and
+     * never copied. An iterator becomes invalid once the set is modified.
+     */
+    typedef typename MyMap<ValueType, bool>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+    const_iterator begin() const;
+    const_iterator end() const;
     // The private section of the class goes here.
 
     /*
@@ -371,11 +396,17 @@ bool MySet<ValueType>::equals(const MySet<ValueType>& set2) const {
     return *this == set2;
 }
 
+/*
+ * Implementation notes: first, last
+ * ---------------------------------
+ * The smallest and largest elements sit at the ends of the left and right
+ * spines of the tree, so both follow one path down from the root instead
+ * of iterating over the set.
+ */
 template <typename ValueType>
 ValueType MySet<ValueType>::first() const {
     if(isEmpty()) throw std::out_of_range("Set is empty.");
-    MyVector<ValueType> values = (this->map).keys();
-    return values[0];
+    return *map.firstKey();
 }
 
 template <typename ValueType>
@@ -388,6 +419,11 @@ void MySet<ValueType>::clear() {
     map.clear();
 }
 
+template <typename ValueType>
+void MySet<ValueType>::compact() {
+    map.compact();
+}
+
 /*
  * Implementation notes: isSubset
  * ------------------------------
@@ -396,9 +432,11 @@ void MySet<ValueType>::clear() {
  */
 template <typename ValueType>
 bool MySet<ValueType>::isSubsetOf(const MySet<ValueType> &set2) const {
-    MyVector<ValueType> values = (this->map).keys();
-    for(int i = 0; i < values.size(); ++i) {
-        if(!set2.contains(values[i])) {
+    if(size() > set2.size()) {
+        return false;
+    }
+    for(const ValueType &value : *this) {
+        if(!set2.contains(value)) {
             return false;
         }
     }
@@ -413,8 +451,7 @@ bool MySet<ValueType>::isSupersetOf(const MySet<ValueType> & set2) const {
 template <typename ValueType>
 ValueType MySet<ValueType>::last() const {
     if(isEmpty()) throw std::out_of_range("Set is empty.");
-    MyVector<ValueType> values = (this->map).keys();
-    return values[values.size()-1];
+    return *map.lastKey();
 }
 
 
@@ -422,12 +459,14 @@ ValueType MySet<ValueType>::last() const {
  * Implementation notes: operator==, operator!=
  * --------------------------------------------
  * These operators make use of the fact that two sets are equal only
- * if each set is a subset of the other.
+ * if each set is a subset of the other. Two sets of the same size are
+ * equal as soon as one of them is a subset of the other, so only one
+ * direction has to be checked.
  */
 
 template <typename ValueType>
 bool MySet<ValueType>::operator == (const MySet<ValueType> &set2) const {
-    return isSubsetOf(set2) && set2.isSubsetOf(*this);
+    return size() == set2.size() && isSubsetOf(set2);
 }
 
 template <typename ValueType>
@@ -443,15 +482,9 @@ bool MySet<ValueType>::operator != (const MySet<ValueType> &set2) const {
  */
 template <typename ValueType>
 MySet<ValueType> MySet<ValueType>::operator+ (const MySet<ValueType> &set2) const {
-
     MySet<ValueType> unionSet = *this;
-    MySet<ValueType> difference = set2 - (*this);
-    MyVector<ValueType> values = difference.map.keys();
-    for(int i = 0; i < values.size(); ++i) {
-        unionSet.add(values[i]);
-    }
+    unionSet += set2;
     return unionSet;
-
 }
 
 
@@ -472,11 +505,9 @@ MySet<ValueType> MySet<ValueType>::operator+ (const ValueType &value) const {
 template <typename ValueType>
 MySet<ValueType> MySet<ValueType>::operator* (const MySet<ValueType> &set2) const {
     MySet<ValueType> intersectionSet;
-
-    MyVector<ValueType> values = (*this).map.keys();
-    for(int i = 0; i < values.size(); ++i) {
-        if(set2.contains(values[i])) {
-            intersectionSet.add(values[i]);
+    for(const ValueType &value : *this) {
+        if(set2.contains(value)) {
+            intersectionSet.add(value);
         }
     }
     return intersectionSet;
@@ -490,16 +521,13 @@ MySet<ValueType> MySet<ValueType>::operator* (const MySet<ValueType> &set2) cons
  */
 template <typename ValueType>
 MySet<ValueType> MySet<ValueType>::operator- (const MySet<ValueType> &set2) const {
-
     MySet<ValueType> differenceSet;
-    MyVector<ValueType> values = (*this).map.keys();
-    for(int i = 0; i < values.size(); ++i) {
-        if(!set2.contains(values[i])) {
-            differenceSet.add(values[i]);
+    for(const ValueType &value : *this) {
+        if(!set2.contains(value)) {
+            differenceSet.add(value);
         }
     }
     return differenceSet;
-
 }
 
 template <typename ValueType>
@@ -512,19 +540,27 @@ MySet<ValueType> MySet<ValueType>::operator- (const ValueType &value) const {
 /*
  * Implementation notes: shorthand assignment operators
  * ----------------------------------------------------
- * These operators modify the current set but are otherwise similar to
- * the operators that create new sets.
+ * These operators modify the current set in place while iterating over
+ * set2, instead of building a new set and copying it back. When set2 is
+ * the current set itself, the loop would modify the set it is iterating
+ * over, so that case is handled first. *= still builds a new set, because
+ * it has to remove elements of the set it iterates over.
  */
 template <typename ValueType>
 MySet<ValueType>& MySet<ValueType>::operator+= (const MySet<ValueType> &set2) {
-    *this = *this + set2;
+    if(this == &set2) {
+        return *this;
+    }
+    for(const ValueType &value : set2) {
+        add(value);
+    }
     return *this;
 }
 
 
 template <typename ValueType>
 MySet<ValueType>& MySet<ValueType>::operator+= (const ValueType &value) {
-    *this = *this + value;
+    add(value);
     return *this;
 }
 
@@ -536,22 +572,37 @@ MySet<ValueType> & MySet<ValueType>::operator*= (const MySet<ValueType> &set2) {
 
 template <typename ValueType>
 MySet<ValueType> & MySet<ValueType>::operator-= (const MySet<ValueType> &set2) {
-    *this = *this - set2;
+    if(this == &set2) {
+        clear();
+        return *this;
+    }
+    for(const ValueType &value : set2) {
+        remove(value);
+    }
     return *this;
-
 }
 
 template <typename ValueType>
 MySet<ValueType> & MySet<ValueType>::operator-= (const ValueType &value) {
-    *this = *this - value;
+    remove(value);
     return *this;
 }
 
 
 template <typename ValueType>
 std::string MySet<ValueType>::toString() const {
-    MyVector<ValueType> keys = this->map.keys();
-    return keys.toString();
+    std::ostringstream oss;
+    oss << "{";
+    bool first = true;
+    for(const ValueType &value : *this) {
+        if(!first) {
+            oss << ", ";
+        }
+        first = false;
+        oss << value;
+    }
+    oss << "}";
+    return oss.str();
 }
 
 template <typename ValueType>
@@ -583,8 +634,19 @@ std::istream & operator>> (std::istream &is, MySet<ValueType> &set) {
 
 template <typename ValueType>
 void MySet<ValueType>::mapAll(void (*fn) (const ValueType &)) const {
-    MyVector<ValueType> keys = this->map.keys();
-    keys.mapAll(fn);
+    for(const ValueType &value : *this) {
+        fn(value);
+    }
+}
+
+template <typename ValueType>
+typename MySet<ValueType>::const_iterator MySet<ValueType>::begin() const {
+    return map.begin();
+}
+
+template <typename ValueType>
+typename MySet<ValueType>::const_iterator MySet<ValueType>::end() const {
+    return map.end();
 }
 
 #endif //_myset_h
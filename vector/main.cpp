@@ -1,5 +1,8 @@
 #include <iostream>
+#include <cassert>
+#include <string>
 #include "myvector.h"
+#include "mysmallvector.h"
 
 void printInt(const int &value) {
     std::cout << value << " ";
@@ -84,6 +87,140 @@ int main() {
     }
     std::cout << std::endl;
 
+    // Test the bit-packed MyVector<bool>
+    MyVector<bool> flags(130, false);
+    assert(flags.count() == 0);
+    assert(flags.findFirst() == -1);
+    flags[3] = true;
+    flags.set(64, true);
+    flags[129] = true;
+    assert(flags.count() == 3);
+    assert(flags.findFirst() == 3);
+    assert(flags.findNext(3) == 64);
+    assert(flags.findNext(64) == 129);
+    assert(flags.findNext(129) == -1);
+
+    flags.insert(0, true);
+    assert(flags.size() == 131);
+    assert(flags[0] && flags[4] && flags[65] && flags[130]);
+    flags.remove(0);
+    assert(flags.size() == 130);
+    assert(flags[3] && flags[64] && flags[129] && !flags[4]);
+
+    MyVector<bool> mask(130, true);
+    mask[64] = false;
+    MyVector<bool> both = flags;
+    both &= mask;
+    assert(both.count() == 2 && !both[64]);
+    both |= flags;
+    assert(both.equals(flags));
+    both ^= flags;
+    assert(both.count() == 0);
+
+    MyVector<bool> bits;
+    for(int i = 0; i < 200; ++i) {
+        bits.add(i % 3 == 0);
+    }
+    assert(bits.count() == 67);
+    bits.sort();
+    assert(bits.findFirst() == 200 - 67);
+    int ones = 0;
+    for(bool b : bits) {
+        ones += b;
+    }
+    assert(ones == 67);
+    std::cout << "MyVector<bool>: " << MyVector<bool>(4, true) << std::endl;
+
+    // Test shrinking
+    MyVector<int> burst;
+    for(int i = 0; i < 1000; ++i) {
+        burst.add(i);
+    }
+    int peak = burst.getCapacity();
+    assert(peak >= 1000);
+    while(burst.size() > 10) {
+        burst.remove(burst.size() - 1);
+    }
+    assert(burst.getCapacity() < peak / 4);
+    assert(burst.getCapacity() >= burst.size());
+    for(int i = 0; i < 10; ++i) {
+        assert(burst[i] == i);
+    }
+    // 在缩容的边界上交替add/remove不会每次都重新分配
+    int settled = burst.getCapacity();
+    for(int i = 0; i < 100; ++i) {
+        burst.add(i);
+        burst.remove(burst.size() - 1);
+    }
+    assert(burst.getCapacity() == settled);
+    burst.clear();
+    assert(burst.getCapacity() == settled);
+    burst.shrinkToFit();
+    assert(burst.getCapacity() == 0 && burst.isEmpty());
+    burst.add(7);
+    assert(burst.size() == 1 && burst[0] == 7);
+    burst.add(8);
+    burst.add(9);
+    burst.shrinkToFit();
+    assert(burst.getCapacity() == 3 && burst[2] == 9);
+    MyVector<int> zero(0, 0);
+    zero.add(1);
+    assert(zero.size() == 1 && zero[0] == 1);
+
+    MyVector<bool> wide;
+    for(int i = 0; i < 1000; ++i) {
+        wide.add(i % 2 == 0);
+    }
+    while(wide.size() > 70) {
+        wide.remove(wide.size() - 1);
+    }
+    assert(wide.getCapacity() <= 512 && wide.getCapacity() % 64 == 0);
+    assert(wide.count() == 35);
+    wide.shrinkToFit();
+    assert(wide.getCapacity() == 128 && wide.count() == 35);
+    wide.clear();
+    wide.shrinkToFit();
+    assert(wide.getCapacity() == 64);
+
+    // MySmallVector keeps the first N elements inline and only then moves to the heap.
+    MySmallVector<std::string, 2> small;
+    assert(small.isEmpty() && small.isInline() && small.view().isEmpty());
+    small.add("a");
+    small.add("b");
+    assert(small.isInline() && small.size() == 2 && small[1] == "b");
+    small.add(small[0]);
+    assert(!small.isInline() && small.size() == 3 && small[2] == "a" && small.getCapacity() == 4);
+    for(int i = 0; i < 20; ++i) {
+        small.add(std::to_string(i));
+    }
+    MySpan<std::string> span = small.view();
+    assert(span.size() == 23 && span[3] == "0" && span[22] == "19");
+    small.remove(0);
+    assert(small.size() == 22 && small[0] == "b");
+    MySmallVector<std::string, 2> copied = small, moved;
+    assert(copied == small && copied.getCapacity() == 22);
+    moved = std::move(copied);
+    assert(moved == small && copied.isEmpty() && copied.isInline());
+    MySmallVector<std::string, 2> pair;
+    pair.add("x");
+    pair.add("y");
+    MySmallVector<std::string, 2> pairCopy(pair);
+    assert(pairCopy.isInline() && pairCopy == pair && pairCopy != small);
+    moved = pair;
+    assert(moved.size() == 2 && moved.isInline());
+    int joined = 0;
+    for(const std::string &s : pair) {
+        joined += int(s.size());
+    }
+    assert(joined == 2);
+    try {
+        span[23];
+        assert(false);
+    } catch(std::out_of_range &) {}
+    small.clear();
+    assert(small.isEmpty() && small.isInline());
+    std::cout << "small: " << pair << std::endl;
+
     // Test stream operators
     std::cout << "Enter elements for vec1 (comma separated): ";
     std::cin >> vec1;
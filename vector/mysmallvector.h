@@ -0,0 +1,440 @@
+/*
+ * File: mysmallvector.h
+ * ---------------------
+ * MySmallVector<ValueType, N>：前N个元素直接存放在对象内部（inline），不分配任何堆内存；
+ * 超过N个元素时才把它们搬到堆上的连续数组中，之后与MyVector一样按两倍扩容。
+ * 适合"大多数只有一两个元素"的场景，例如multimap中每个key对应的value列表：
+ * MyVector即使只有一个元素也要分配INITIAL_CAPACITY（10）个元素的数组。
+ * 无论存放在哪里，元素总是连续的，可以用view()得到一个借用的MySpan。
+ *
+ * MySpan<ValueType>：一段连续元素的只读视图，只保存首尾两个指针，不拥有元素。
+ * -------------------------------------------------------------------------------
+ * 参考：https://llvm.org/docs/ProgrammersManual.html#llvm-adt-smallvector-h
+ * 时间：
+ *      1. 2026.10.18: 第一版
+ */
+
+#ifndef _mysmallvector_h
+#define _mysmallvector_h
+
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename ValueType>
+class MySpan {
+public:
+    /*
+     * Constructor: MySpan
+     * Usage: MySpan<ValueType> span(first, last);
+     * -------------------------------------------
+     * Creates a view of the elements in [first, last). The default
+     * constructor creates an empty view.
+     */
+    MySpan() : first(NULL), last(NULL) {}
+    MySpan(const ValueType *first, const ValueType *last) : first(first), last(last) {}
+
+    /*
+     * Method: size, isEmpty
+     * Usage: int n = span.size();
+     * ---------------------------
+     * Returns the number of elements in the view, or whether it is empty.
+     */
+    int size() const { return int(last - first); }
+    bool isEmpty() const { return first == last; }
+
+    /*
+     * Operator: []
+     * Usage: span[index]
+     * ------------------
+     * Selects an element; throws std::out_of_range if index is outside the view.
+     */
+    const ValueType & operator[](int index) const {
+        if(!(index >= 0 && index < size())) throw std::out_of_range("operator []: the index is not in the span.");
+        return first[index];
+    }
+
+    typedef const ValueType * iterator;
+    iterator begin() const { return first; }
+    iterator end() const { return last; }
+
+private:
+    const ValueType *first;
+    const ValueType *last;
+};
+
+template <typename ValueType, int N>
+class MySmallVector {
+public:
+    /*
+     * Constructor: MySmallVector
+     * Usage: MySmallVector<ValueType, N> vec;
+     * ---------------------------------------
+     * Initializes a new empty vector. No memory is allocated until the
+     * (N + 1)-th element is added.
+     */
+    MySmallVector();
+
+    /*
+     * Destructor: ~MySmallVector
+     * --------------------------
+     * Destroys the elements and frees the heap array, if any.
+     */
+    ~MySmallVector();
+
+    /*
+     * Method: size, isEmpty, getCapacity, isInline
+     * Usage: int n = vec.size();
+     * --------------------------
+     * size returns the number of elements; getCapacity returns how many
+     * elements fit before the next reallocation; isInline returns true while
+     * the elements are still stored inside the object.
+     */
+    int size() const;
+    bool isEmpty() const;
+    int getCapacity() const;
+    bool isInline() const;
+
+    /*
+     * Method: add
+     * Usage: vec.add(value);
+     * ----------------------
+     * Adds value to the end of this vector. value may refer to an element of
+     * this vector.
+     */
+    void add(const ValueType &value);
+
+    /*
+     * Method: remove
+     * Usage: vec.remove(index);
+     * -------------------------
+     * Removes the element at index, shifting the following elements down.
+     * Throws std::out_of_range if index is not valid.
+     */
+    void remove(int index);
+
+    /*
+     * Method: clear
+     * Usage: vec.clear();
+     * -------------------
+     * Removes all elements and returns to the inline storage.
+     */
+    void clear();
+
+    /*
+     * Method: view
+     * Usage: MySpan<ValueType> span = vec.view();
+     * -------------------------------------------
+     * Returns a view of the elements. It stays valid until the vector is
+     * modified or destroyed.
+     */
+    MySpan<ValueType> view() const;
+
+    /*
+     * Operator: []
+     * Usage: vec[index]
+     * -----------------
+     * Selects an element; throws std::out_of_range if index is not valid.
+     */
+    ValueType & operator[](int index);
+    const ValueType & operator[](int index) const;
+
+    typedef ValueType * iterator;
+    typedef const ValueType * const_iterator;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Copy constructor, move constructor and assignment operators
+     * -----------------------------------------------------------
+     * Copies are independent. A moved-from vector is left empty; moving a
+     * vector whose elements are on the heap only transfers the pointer.
+     */
+    MySmallVector(const MySmallVector<ValueType, N> &src);
+    MySmallVector(MySmallVector<ValueType, N> &&src);
+    MySmallVector<ValueType, N> & operator=(const MySmallVector<ValueType, N> &src);
+    MySmallVector<ValueType, N> & operator=(MySmallVector<ValueType, N> &&src);
+
+    /*
+     * Operator: ==, !=
+     * Usage: if(vec1 == vec2) . . .
+     * -----------------------------
+     * Two vectors are equal if they contain the same elements in the same order.
+     */
+    bool operator==(const MySmallVector<ValueType, N> &rhs) const;
+    bool operator!=(const MySmallVector<ValueType, N> &rhs) const;
+
+private:
+    typedef typename std::aligned_storage<sizeof(ValueType), alignof(ValueType)>::type Storage;
+
+    int count;
+    int capacity;           // N while inline, otherwise the length of heap
+    union {
+        Storage local[N];
+        ValueType *heap;
+    };
+
+    ValueType * data();
+    const ValueType * data() const;
+
+    /* Moves the elements into a heap array of newCapacity elements and then constructs value at the end */
+    void growAndAdd(int newCapacity, const ValueType &value);
+    /* Destroys the elements, frees the heap array and returns to inline storage */
+    void release();
+    /* Takes over src's elements; this vector must be empty and inline */
+    void steal(MySmallVector<ValueType, N> &src);
+};
+
+/*
+ * Implementation notes: representation
+ * ------------------------------------
+ * While capacity == N the elements live in local[]; afterwards the same
+ * bytes hold the pointer to the heap array, so the object is no larger
+ * than max(N * sizeof(ValueType), sizeof(pointer)) plus two ints.
+ */
+template <typename ValueType, int N>
+MySmallVector<ValueType, N>::MySmallVector() : count(0), capacity(N) {
+    static_assert(N > 0, "MySmallVector needs at least one inline element");
+}
+
+template <typename ValueType, int N>
+MySmallVector<ValueType, N>::~MySmallVector() {
+    release();
+}
+
+template <typename ValueType, int N>
+ValueType * MySmallVector<ValueType, N>::data() {
+    return capacity == N ? reinterpret_cast<ValueType *>(local) : heap;
+}
+
+template <typename ValueType, int N>
+const ValueType * MySmallVector<ValueType, N>::data() const {
+    return capacity == N ? reinterpret_cast<const ValueType *>(local) : heap;
+}
+
+template <typename ValueType, int N>
+int MySmallVector<ValueType, N>::size() const {
+    return count;
+}
+
+template <typename ValueType, int N>
+bool MySmallVector<ValueType, N>::isEmpty() const {
+    return count == 0;
+}
+
+template <typename ValueType, int N>
+int MySmallVector<ValueType, N>::getCapacity() const {
+    return capacity;
+}
+
+template <typename ValueType, int N>
+bool MySmallVector<ValueType, N>::isInline() const {
+    return capacity == N;
+}
+
+template <typename ValueType, int N>
+void MySmallVector<ValueType, N>::add(const ValueType &value) {
+    if(count == capacity) {
+        growAndAdd(capacity * 2, value);
+        return;
+    }
+    new (data() + count) ValueType(value);
+    count++;
+}
+
+/*
+ * Implementation notes: growAndAdd
+ * --------------------------------
+ * The new element is constructed first, while value (which may be one of
+ * our own elements) is still valid. If constructing or moving an element
+ * throws, the new array is discarded and the vector is unchanged
+ * (elements are only moved when their move constructor cannot throw).
+ */
+template <typename ValueType, int N>
+void MySmallVector<ValueType, N>::growAndAdd(int newCapacity, const ValueType &value) {
+    ValueType *fresh = static_cast<ValueType *>(::operator new(sizeof(ValueType) * newCapacity));
+    ValueType *old = data();
+    int built = -1;
+    try {
+        new (fresh + count) ValueType(value);
+        for(built = 0; built < count; ++built) {
+            new (fresh + built) ValueType(std::move_if_noexcept(old[built]));
+        }
+    }
+    catch(...) {
+        if(built >= 0) fresh[count].~ValueType();
+        for(int i = 0; i < built; ++i) {
+            fresh[i].~ValueType();
+        }
+        ::operator delete(fresh);
+        throw;
+    }
+    int n = count;
+    release();
+    heap = fresh;
+    capacity = newCapacity;
+    count = n + 1;
+}
+
+template <typename ValueType, int N>
+void MySmallVector<ValueType, N>::remove(int index) {
+    if(!(index >= 0 && index < count)) throw std::out_of_range("remove: the index is not in the array index.");
+    ValueType *p = data();
+    for(int i = index; i < count - 1; ++i) {
+        p[i] = std::move(p[i + 1]);
+    }
+    p[count - 1].~ValueType();
+    count--;
+}
+
+template <typename ValueType, int N>
+void MySmallVector<ValueType, N>::clear() {
+    release();
+}
+
+template <typename ValueType, int N>
+void MySmallVector<ValueType, N>::release() {
+    ValueType *p = data();
+    for(int i = 0; i < count; ++i) {
+        p[i].~ValueType();
+    }
+    if(capacity != N) {
+        ::operator delete(heap);
+        capacity = N;
+    }
+    count = 0;
+}
+
+template <typename ValueType, int N>
+MySpan<ValueType> MySmallVector<ValueType, N>::view() const {
+    return MySpan<ValueType>(data(), data() + count);
+}
+
+template <typename ValueType, int N>
+ValueType & MySmallVector<ValueType, N>::operator[](int index) {
+    if(!(index >= 0 && index < count)) throw std::out_of_range("operator []: the index is not in the array index.");
+    return data()[index];
+}
+
+template <typename ValueType, int N>
+const ValueType & MySmallVector<ValueType, N>::operator[](int index) const {
+    if(!(index >= 0 && index < count)) throw std::out_of_range("operator []: the index is not in the array index.");
+    return data()[index];
+}
+
+template <typename ValueType, int N>
+typename MySmallVector<ValueType, N>::iterator MySmallVector<ValueType, N>::begin() {
+    return data();
+}
+
+template <typename ValueType, int N>
+typename MySmallVector<ValueType, N>::iterator MySmallVector<ValueType, N>::end() {
+    return data() + count;
+}
+
+template <typename ValueType, int N>
+typename MySmallVector<ValueType, N>::const_iterator MySmallVector<ValueType, N>::begin() const {
+    return data();
+}
+
+template <typename ValueType, int N>
+typename MySmallVector<ValueType, N>::const_iterator MySmallVector<ValueType, N>::end() const {
+    return data() + count;
+}
+
+/*
+ * Implementation notes: copying and moving
+ * ----------------------------------------
+ * A copy gets exactly as much room as the source needs: inline if the
+ * elements fit, otherwise a heap array of src.count elements.
+ */
+template <typename ValueType, int N>
+MySmallVector<ValueType, N>::MySmallVector(const MySmallVector<ValueType, N> &src) : count(0), capacity(N) {
+    *this = src;
+}
+
+template <typename ValueType, int N>
+MySmallVector<ValueType, N>::MySmallVector(MySmallVector<ValueType, N> &&src) : count(0), capacity(N) {
+    steal(src);
+}
+
+template <typename ValueType, int N>
+MySmallVector<ValueType, N> & MySmallVector<ValueType, N>::operator=(const MySmallVector<ValueType, N> &src) {
+    if(this != &src) {
+        MySmallVector<ValueType, N> copy;
+        if(src.count > N) {
+            copy.heap = static_cast<ValueType *>(::operator new(sizeof(ValueType) * src.count));
+            copy.capacity = src.count;
+        }
+        const ValueType *from = src.data();
+        for(int i = 0; i < src.count; ++i) {
+            new (copy.data() + i) ValueType(from[i]);
+            copy.count++;
+        }
+        release();
+        steal(copy);
+    }
+    return *this;
+}
+
+template <typename ValueType, int N>
+MySmallVector<ValueType, N> & MySmallVector<ValueType, N>::operator=(MySmallVector<ValueType, N> &&src) {
+    if(this != &src) {
+        release();
+        steal(src);
+    }
+    return *this;
+}
+
+template <typename ValueType, int N>
+void MySmallVector<ValueType, N>::steal(MySmallVector<ValueType, N> &src) {
+    if(src.capacity != N) {
+        heap = src.heap;
+        capacity = src.capacity;
+        count = src.count;
+        src.capacity = N;
+        src.count = 0;
+        return;
+    }
+    ValueType *from = src.data();
+    for(; count < src.count; ++count) {
+        new (data() + count) ValueType(std::move(from[count]));
+    }
+    src.release();
+}
+
+template <typename ValueType, int N>
+bool MySmallVector<ValueType, N>::operator==(const MySmallVector<ValueType, N> &rhs) const {
+    if(count != rhs.count) return false;
+    for(int i = 0; i < count; ++i) {
+        if(!(data()[i] == rhs.data()[i])) return false;
+    }
+    return true;
+}
+
+template <typename ValueType, int N>
+bool MySmallVector<ValueType, N>::operator!=(const MySmallVector<ValueType, N> &rhs) const {
+    return !(*this == rhs);
+}
+
+/*
+ * Operator: <<
+ * Usage: cout << vec;
+ * -------------------
+ * Outputs the elements in the same format as MyVector, e.g. "{1, 2, 3}".
+ */
+template <typename ValueType, int N>
+std::ostream & operator<<(std::ostream &os, const MySmallVector<ValueType, N> &vec) {
+    os << "{";
+    for(int i = 0; i < vec.size(); ++i) {
+        if(i > 0) os << ", ";
+        os << vec[i];
+    }
+    return os << "}";
+}
+
+#endif // _mysmallvector_h
@@ -9,6 +9,9 @@
  *      1. 2024.4.12: 第一版
  *      2. 2024.4.14: 添加operator>> 以支持输入
  *      3. 2024.4.24: 添加mapAll以支持callback函数，同时在>>中加入vec.clear()以接收流数据前清空容器。
+ *      4. 2026.10.18: 添加MyVector<bool>的位压缩特化，支持count、findFirst/findNext以及按字的位运算。
+ *      5. 2026.10.18: remove之后元素不足容量的1/4时把数组缩小一半（滞后缩容，避免在边界上反复扩容/缩容），
+ *                     添加shrinkToFit、getCapacity；容量为0的vector（例如MyVector(0, value)）add时不再越界。
  *
  */
 
@@ -17,6 +20,7 @@
 #include <sstream>
 #include <iostream>
 #include <cctype>
+#include <stdexcept>
 template <typename ValueType>
 class MyVector {
 public:
@@ -86,10 +90,22 @@ public:
      * Method: clear
      * Usage: vec.clear();
      * -------------------
-     * Removes all elements from this vector.
+     * Removes all elements from this vector. The array is kept, so a vector
+     * that is cleared and refilled (a reused buffer) does not reallocate;
+     * call shrinkToFit afterwards to release it.
      */
     void clear();
 
+    /*
+     * Method: shrinkToFit, getCapacity
+     * Usage: vec.shrinkToFit();
+     * -------------------------
+     * shrinkToFit reallocates the array so that its capacity equals the
+     * number of elements; getCapacity returns the current capacity.
+     */
+    void shrinkToFit();
+    int getCapacity() const;
+
     /*
      * Method: equals
      * Usage: if(vec1.equals(vec2)) . . .
@@ -140,6 +156,8 @@ public:
      * Removes the element at the specified from this vector. All
      * subsequent elements are shifted one position to the left. This
      * method signals an error if the index is outside the array range.
+     * When the vector drops to a quarter of its capacity, the array is
+     * halved (but never below the initial capacity).
      */
     void remove(int index);
 
@@ -207,6 +225,7 @@ private:
 
     void deepCopy(const MyVector<ValueType> &src);
     void expandCapacity();
+    void reallocate(int newCapacity);
 
     void heapSort();
     void down(int index, int size);
@@ -321,6 +340,16 @@ void MyVector<ValueType>::clear() {
     count = 0;
 }
 
+template <typename ValueType>
+void MyVector<ValueType>::shrinkToFit() {
+    if(capacity != count) reallocate(count);
+}
+
+template <typename ValueType>
+int MyVector<ValueType>::getCapacity() const {
+    return capacity;
+}
+
 template <typename ValueType>
 bool MyVector<ValueType>::equals(const MyVector& v) const {
     if(count != v.count) return false;
@@ -375,6 +404,9 @@ void MyVector<ValueType>::remove(int index) {
         array[i] = array[i+1];
     }
     count--;
+    if(capacity > INITIAL_CAPACITY && count <= capacity / 4) {
+        reallocate(capacity / 2 > INITIAL_CAPACITY ? capacity / 2 : INITIAL_CAPACITY);
+    }
 }
 
 template <typename ValueType>
@@ -441,20 +473,28 @@ void MyVector<ValueType>::deepCopy(const MyVector<ValueType> &src) {
 }
 
 /*
- * Implementation notes: expandCapacity
- * ------------------------------------
- * This method doubles the array capacity whenever it runs out of space.
+ * Implementation notes: expandCapacity, reallocate
+ * ------------------------------------------------
+ * expandCapacity doubles the array capacity whenever it runs out of space
+ * (an empty array starts over at INITIAL_CAPACITY). reallocate moves the
+ * elements into a new array of the given capacity; remove uses it to halve
+ * the array only after the vector has dropped to a quarter of its capacity,
+ * so alternating add and remove at a boundary never reallocates every time.
  */
 template <typename ValueType>
 void MyVector<ValueType>::expandCapacity() {
-    ValueType * oldArray = array;
+    reallocate(capacity > 0 ? capacity * 2 : INITIAL_CAPACITY);
+}
 
-    capacity *= 2;
-    array = new ValueType[capacity];
+template <typename ValueType>
+void MyVector<ValueType>::reallocate(int newCapacity) {
+    ValueType *newArray = new ValueType[newCapacity];
     for(int i = 0; i < count; ++i) {
-        array[i] = oldArray[i];
+        newArray[i] = array[i];
     }
-    delete [] oldArray;
+    delete [] array;
+    array = newArray;
+    capacity = newCapacity;
 }
 
 template <typename ValueType>
@@ -547,4 +587,494 @@ typename MyVector<ValueType>::iterator MyVector<ValueType>::end() const {
 }
 
 
+/*
+ * Class: MyVector<bool>
+ * ---------------------
+ * This specialization stores the flags of a MyVector<bool> packed into
+ * 64-bit words, so every element takes one bit instead of one byte.
+ * Besides the MyVector interface it exports count, findFirst, findNext
+ * and the bulk operators &=, |=, ^=, which all work a word at a time.
+ *
+ * Because a single bit cannot be addressed, operator[] and the iterators
+ * return a proxy object that converts to bool and accepts assignments.
+ */
+template <>
+class MyVector<bool> {
+private:
+    typedef unsigned long long Word;
+
+public:
+    /*
+     * Class: MyVector<bool>::reference
+     * --------------------------------
+     * A proxy for one bit of the vector. It behaves like a bool& for the
+     * purposes of reading, assigning and flipping the element.
+     */
+    class reference {
+    public:
+        operator bool() const {
+            return (*word & mask) != 0;
+        }
+
+        reference & operator=(bool value) {
+            if(value) *word |= mask;
+            else *word &= ~mask;
+            return *this;
+        }
+
+        reference & operator=(const reference &src) {
+            return *this = bool(src);
+        }
+
+        void flip() {
+            *word ^= mask;
+        }
+
+    private:
+        friend class MyVector<bool>;
+        reference(Word *word, Word mask) : word(word), mask(mask) {}
+
+        Word *word;
+        Word mask;
+    };
+
+    MyVector();
+    MyVector(int n, bool value = false);
+    ~MyVector();
+
+    int size() const;
+    void sort();
+    std::string toString() const;
+    bool isEmpty() const;
+    void clear();
+    void shrinkToFit();
+    int getCapacity() const;
+    bool equals(const MyVector<bool> &v) const;
+    bool get(int index) const;
+    void set(int index, bool value);
+    void insert(int index, bool value);
+    void remove(int index);
+    void add(bool value);
+
+    reference operator[](int index);
+    bool operator[](int index) const;
+
+    MyVector(const MyVector<bool> &src);
+    MyVector<bool> & operator=(const MyVector<bool> &src);
+
+    void mapAll(void (*fn) (const bool &)) const;
+
+    /*
+     * Method: count
+     * Usage: int n = flags.count();
+     * -----------------------------
+     * Returns the number of elements that are true. The bits are counted
+     * one word at a time with a population count.
+     */
+    int count() const;
+
+    /*
+     * Method: findFirst
+     * Usage: int index = flags.findFirst();
+     * -------------------------------------
+     * Returns the index of the first element that is true, or -1 if there
+     * is no such element.
+     */
+    int findFirst() const;
+
+    /*
+     * Method: findNext
+     * Usage: for(int i = flags.findFirst(); i != -1; i = flags.findNext(i)) . . .
+     * --------------------------------------------------------------------------
+     * Returns the index of the first true element after the specified index,
+     * or -1 if there is no such element.
+     */
+    int findNext(int index) const;
+
+    /*
+     * Operator: &=, |=, ^=
+     * Usage: flags1 &= flags2;
+     * ------------------------
+     * Combines this vector with another vector of the same size, element
+     * by element. These operators signal an error if the sizes differ.
+     */
+    MyVector<bool> & operator&=(const MyVector<bool> &v);
+    MyVector<bool> & operator|=(const MyVector<bool> &v);
+    MyVector<bool> & operator^=(const MyVector<bool> &v);
+
+    /*
+     * Iterators
+     * ---------
+     * The mutable iterator dereferences to a reference proxy, the const
+     * iterator dereferences to a plain bool value.
+     */
+    class iterator {
+    public:
+        iterator(MyVector<bool> *vec, int index) : vec(vec), index(index) {}
+        reference operator*() const { return (*vec)[index]; }
+        iterator & operator++() { ++index; return *this; }
+        bool operator==(const iterator &rhs) const { return index == rhs.index; }
+        bool operator!=(const iterator &rhs) const { return index != rhs.index; }
+    private:
+        MyVector<bool> *vec;
+        int index;
+    };
+
+    class const_iterator {
+    public:
+        const_iterator(const MyVector<bool> *vec, int index) : vec(vec), index(index) {}
+        bool operator*() const { return (*vec)[index]; }
+        const_iterator & operator++() { ++index; return *this; }
+        bool operator==(const const_iterator &rhs) const { return index == rhs.index; }
+        bool operator!=(const const_iterator &rhs) const { return index != rhs.index; }
+    private:
+        const MyVector<bool> *vec;
+        int index;
+    };
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Notes on the representation
+     * ---------------------------
+     * Element i lives in bit (i % 64) of words[i / 64]. The bits at and after
+     * index count are always kept zero, which lets count, equals and the bulk
+     * operators work on whole words without masking the last one.
+     */
+private:
+    static const int BITS_PER_WORD = 64;
+    static const int INITIAL_CAPACITY = 64;
+
+    Word *words;
+    int capacity;           // Capacity in bits, always a multiple of BITS_PER_WORD
+    int nBits;
+
+    static int wordsFor(int bits);
+    static Word lowMask(int bits);
+    static int popcount(Word w);
+    static int lowestBit(Word w);
+
+    void deepCopy(const MyVector<bool> &src);
+    void expandCapacity();
+    void reallocate(int newCapacity);
+    void checkSameSize(const MyVector<bool> &v, const char *op) const;
+};
+
+/*
+ * Implementation notes: word helpers
+ * ----------------------------------
+ * popcount and lowestBit use the compiler builtins when they exist and
+ * fall back to portable loops otherwise.
+ */
+inline int MyVector<bool>::wordsFor(int bits) {
+    return (bits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+inline MyVector<bool>::Word MyVector<bool>::lowMask(int bits) {
+    return bits == 0 ? 0 : (~Word(0) >> (BITS_PER_WORD - bits));
+}
+
+inline int MyVector<bool>::popcount(Word w) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    int n = 0;
+    while(w) {
+        w &= w - 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+inline int MyVector<bool>::lowestBit(Word w) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    int n = 0;
+    while(!(w & 1)) {
+        w >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+inline MyVector<bool>::MyVector() {
+    capacity = INITIAL_CAPACITY;
+    words = new Word[wordsFor(capacity)]();
+    nBits = 0;
+}
+
+inline MyVector<bool>::MyVector(int n, bool value) {
+    int nWords = wordsFor(n > 0 ? n : 1);
+    capacity = nWords * BITS_PER_WORD;
+    words = new Word[nWords]();
+    nBits = n;
+    if(value) {
+        for(int i = 0; i < n / BITS_PER_WORD; ++i) {
+            words[i] = ~Word(0);
+        }
+        if(n % BITS_PER_WORD) {
+            words[n / BITS_PER_WORD] = lowMask(n % BITS_PER_WORD);
+        }
+    }
+}
+
+inline MyVector<bool>::~MyVector() {
+    delete [] words;
+}
+
+inline int MyVector<bool>::size() const {
+    return nBits;
+}
+
+/*
+ * Implementation notes: sort
+ * --------------------------
+ * Sorting a vector of flags only needs the number of true elements:
+ * the false elements go first and the true elements fill the tail.
+ */
+inline void MyVector<bool>::sort() {
+    int ones = count();
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        words[i] = 0;
+    }
+    for(int i = nBits - ones; i < nBits; ++i) {
+        words[i / BITS_PER_WORD] |= Word(1) << (i % BITS_PER_WORD);
+    }
+}
+
+inline std::string MyVector<bool>::toString() const {
+    std::ostringstream oss;
+    oss << "{";
+    for(int i = 0; i < nBits; ++i) {
+        if(i) {
+            oss << ", ";
+        }
+        oss << (*this)[i];
+    }
+    oss << "}";
+    return oss.str();
+}
+
+inline bool MyVector<bool>::isEmpty() const {
+    return nBits == 0;
+}
+
+inline void MyVector<bool>::clear() {
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        words[i] = 0;
+    }
+    nBits = 0;
+}
+
+inline void MyVector<bool>::shrinkToFit() {
+    int fit = wordsFor(nBits > 0 ? nBits : 1) * BITS_PER_WORD;
+    if(capacity != fit) reallocate(fit);
+}
+
+inline int MyVector<bool>::getCapacity() const {
+    return capacity;
+}
+
+inline bool MyVector<bool>::equals(const MyVector<bool> &v) const {
+    if(nBits != v.nBits) return false;
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        if(words[i] != v.words[i]) return false;
+    }
+    return true;
+}
+
+inline bool MyVector<bool>::get(int index) const {
+    if(!(index >= 0 && index < nBits)) throw std::out_of_range("get: the index is not in the array index.");
+    return (*this)[index];
+}
+
+inline void MyVector<bool>::set(int index, bool value) {
+    if(!(index >= 0 && index < nBits)) throw std::out_of_range("set: the index is not in the array index.");
+    (*this)[index] = value;
+}
+
+/*
+ * Implementation notes: insert, remove
+ * ------------------------------------
+ * Instead of moving one element at a time, these methods shift whole words
+ * by one bit and carry the bit that falls off one word into the next.
+ */
+inline void MyVector<bool>::insert(int index, bool value) {
+    if(!(index >= 0 && index <= nBits)) throw std::out_of_range("insert: the index is not in the array index.");
+    if(nBits == capacity) expandCapacity();
+
+    int w = index / BITS_PER_WORD;
+    int b = index % BITS_PER_WORD;
+    Word carry = words[w] >> (BITS_PER_WORD - 1);
+    Word low = words[w] & lowMask(b);
+    words[w] = low | ((words[w] & ~lowMask(b)) << 1);
+    for(int i = w + 1; i < wordsFor(nBits + 1); ++i) {
+        Word next = words[i] >> (BITS_PER_WORD - 1);
+        words[i] = (words[i] << 1) | carry;
+        carry = next;
+    }
+    nBits++;
+    (*this)[index] = value;
+}
+
+inline void MyVector<bool>::remove(int index) {
+    if(!(index >= 0 && index < nBits)) throw std::out_of_range("remove: the index is not in the array index.");
+
+    int w = index / BITS_PER_WORD;
+    int b = index % BITS_PER_WORD;
+    Word high = (b == BITS_PER_WORD - 1) ? 0 : (words[w] >> (b + 1)) << b;
+    words[w] = (words[w] & lowMask(b)) | high;
+    for(int i = w + 1; i < wordsFor(nBits); ++i) {
+        words[i - 1] |= (words[i] & 1) << (BITS_PER_WORD - 1);
+        words[i] >>= 1;
+    }
+    nBits--;
+    if(capacity > INITIAL_CAPACITY && nBits <= capacity / 4) {
+        reallocate(capacity / 2);
+    }
+}
+
+inline void MyVector<bool>::add(bool value) {
+    if(nBits == capacity) expandCapacity();
+    nBits++;
+    (*this)[nBits - 1] = value;
+}
+
+inline MyVector<bool>::reference MyVector<bool>::operator[](int index) {
+    if(!(index >= 0 && index < nBits)) throw std::out_of_range("operator []: the index is not in the array index.");
+    return reference(&words[index / BITS_PER_WORD], Word(1) << (index % BITS_PER_WORD));
+}
+
+inline bool MyVector<bool>::operator[](int index) const {
+    if(!(index >= 0 && index < nBits)) throw std::out_of_range("operator []: the index is not in the array index.");
+    return (words[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+}
+
+inline MyVector<bool>::MyVector(const MyVector<bool> &src) {
+    deepCopy(src);
+}
+
+inline MyVector<bool> & MyVector<bool>::operator=(const MyVector<bool> &src) {
+    if(this != &src) {
+        delete [] words;
+        deepCopy(src);
+    }
+    return *this;
+}
+
+inline void MyVector<bool>::deepCopy(const MyVector<bool> &src) {
+    capacity = src.capacity;
+    nBits = src.nBits;
+    words = new Word[wordsFor(capacity)];
+    for(int i = 0; i < wordsFor(capacity); ++i) {
+        words[i] = src.words[i];
+    }
+}
+
+/*
+ * Implementation notes: expandCapacity, reallocate
+ * ------------------------------------------------
+ * expandCapacity doubles the number of words. reallocate copies the words
+ * that hold elements into a new array of the given capacity (a multiple of
+ * BITS_PER_WORD); the other new words start out zero so that the bits after
+ * nBits stay clear.
+ */
+inline void MyVector<bool>::expandCapacity() {
+    reallocate(capacity * 2);
+}
+
+inline void MyVector<bool>::reallocate(int newCapacity) {
+    Word *newWords = new Word[wordsFor(newCapacity)]();
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        newWords[i] = words[i];
+    }
+    delete [] words;
+    words = newWords;
+    capacity = newCapacity;
+}
+
+inline void MyVector<bool>::mapAll(void (*fn) (const bool &)) const {
+    for(int i = 0; i < nBits; ++i) {
+        bool value = (*this)[i];
+        fn(value);
+    }
+}
+
+inline int MyVector<bool>::count() const {
+    int n = 0;
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        n += popcount(words[i]);
+    }
+    return n;
+}
+
+inline int MyVector<bool>::findFirst() const {
+    return findNext(-1);
+}
+
+inline int MyVector<bool>::findNext(int index) const {
+    int start = index + 1;
+    if(start < 0) start = 0;
+    if(start >= nBits) return -1;
+
+    int w = start / BITS_PER_WORD;
+    Word word = words[w] & ~lowMask(start % BITS_PER_WORD);
+    while(true) {
+        if(word) return w * BITS_PER_WORD + lowestBit(word);
+        if(++w >= wordsFor(nBits)) return -1;
+        word = words[w];
+    }
+}
+
+inline void MyVector<bool>::checkSameSize(const MyVector<bool> &v, const char *op) const {
+    if(nBits != v.nBits) throw std::invalid_argument(std::string(op) + ": the vectors have different sizes.");
+}
+
+inline MyVector<bool> & MyVector<bool>::operator&=(const MyVector<bool> &v) {
+    checkSameSize(v, "operator &=");
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        words[i] &= v.words[i];
+    }
+    return *this;
+}
+
+inline MyVector<bool> & MyVector<bool>::operator|=(const MyVector<bool> &v) {
+    checkSameSize(v, "operator |=");
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        words[i] |= v.words[i];
+    }
+    return *this;
+}
+
+inline MyVector<bool> & MyVector<bool>::operator^=(const MyVector<bool> &v) {
+    checkSameSize(v, "operator ^=");
+    for(int i = 0; i < wordsFor(nBits); ++i) {
+        words[i] ^= v.words[i];
+    }
+    return *this;
+}
+
+inline MyVector<bool>::iterator MyVector<bool>::begin() {
+    return iterator(this, 0);
+}
+
+inline MyVector<bool>::iterator MyVector<bool>::end() {
+    return iterator(this, nBits);
+}
+
+inline MyVector<bool>::const_iterator MyVector<bool>::begin() const {
+    return const_iterator(this, 0);
+}
+
+inline MyVector<bool>::const_iterator MyVector<bool>::end() const {
+    return const_iterator(this, nBits);
+}
+
+
 #endif